@@ -0,0 +1,171 @@
+#include <BenchSetup.h>
+
+#include <Data/CoefDistr.h>
+#include <Data/PolLink.h>
+#include <Data/PredDistr.h>
+#include <Data/PredLink.h>
+#include <GlobalVar/Chiral.h>
+#include <ToyMeas/ToyGen.h>
+
+#include <fstream>
+#include <stdexcept>
+
+namespace PrEW {
+namespace Bench {
+
+//------------------------------------------------------------------------------
+// Internal helpers
+
+namespace {
+  struct FctSetup {
+    /** Fit parameters, function link and coefficients needed to apply a
+        parametrisation function to the LR prediction.
+    **/
+    Fit::ParVec m_pars {};
+    Data::FctLink m_link {};
+    Data::CoefDistrVec m_coefs {};
+  };
+
+  FctSetup get_fct_setup(
+    const std::string & fct_name,
+    const Data::DistrInfo & info,
+    const std::vector<double> & sigmas
+  ) {
+    /** Parameters and coefficients for the given parametrisation function.
+    **/
+    FctSetup setup {};
+    if (fct_name == "Constant") {
+      setup.m_pars = { {"A_LR", 1, 0.1} };
+      setup.m_link = { fct_name, {"A_LR"}, {} };
+    } else if (fct_name == "Quadratic1DPolynomial") {
+      setup.m_pars = { {"p0", 1, 0.1}, {"p1", 0.1, 0.1}, {"p2", 0.05, 0.1} };
+      setup.m_link = { fct_name, {"p0", "p1", "p2"}, {} };
+    } else if (fct_name == "Gaussian1D") {
+      setup.m_pars = { {"amp", 1, 0.1}, {"mu", 0, 0.1}, {"sigma", 1, 0.1} };
+      setup.m_link = { fct_name, {"amp", "mu", "sigma"}, {} };
+    } else if (fct_name == "General2fParam_LR") {
+      setup.m_pars = { {"xs0", 1, 0.01}, {"Ae", 0.2, 0.01}, {"Af", 0.1, 0.01},
+                       {"ef", 0, 0.01}, {"k0", 0.1, 0.01}, {"dk", 0, 0.01} };
+      setup.m_link = { fct_name, {"xs0", "Ae", "Af", "ef", "k0", "dk"},
+                       {"xs_bin", "xs_LR", "xs_RL", "cos_idx"} };
+      double xs_LR = 0;
+      for (const auto & sigma: sigmas) { xs_LR += sigma; }
+      setup.m_coefs = { {"xs_bin", info, sigmas}, {"xs_LR", info, xs_LR},
+                        {"xs_RL", info, 0.5 * xs_LR}, {"cos_idx", info, 0.0} };
+    } else {
+      throw std::invalid_argument("No benchmark setup for function " + 
+                                  fct_name);
+    }
+    return setup;
+  }
+}
+
+//------------------------------------------------------------------------------
+// Constructors
+
+struct BenchSetup::Inputs {
+  Data::PredDistrVec m_pred_distrs {};
+  Data::CoefDistrVec m_coef_distrs {};
+  Data::PredLinkVec m_pred_links {};
+  Data::PolLinkVec m_pol_links {};
+  Fit::ParVec m_pars {};
+  
+  Inputs(size_t n_distrs, size_t n_bins, const std::string & fct_name) {
+    /** Create the synthetic predictions, links and parameters.
+    **/
+    m_pol_links = { Data::PolLink(energy, "e-p+", "ePol", "pPol", "-", "+") };
+    
+    Data::CoordVec coords {};
+    std::vector<double> sig_LR {}, sig_RL {}, bkg {};
+    double width = 2.0 / double(n_bins);
+    for (size_t bin=0; bin<n_bins; bin++) {
+      double low = -1.0 + double(bin) * width;
+      double center = low + 0.5 * width;
+      coords.push_back( Data::BinCoord({center}, {low}, {low + width}) );
+      sig_LR.push_back(100.0 * (1.0 + center) * (1.0 + center) + 1.0);
+      sig_RL.push_back(50.0 * (1.0 - center) * (1.0 - center) + 1.0);
+      bkg.push_back(1.0);
+    }
+    
+    for (size_t d=0; d<n_distrs; d++) {
+      std::string distr_name = "distr_" + std::to_string(d);
+      Data::DistrInfo info_pol {distr_name, "e-p+", energy};
+      Data::DistrInfo info_LR {distr_name, GlobalVar::Chiral::eLpR, energy};
+      Data::DistrInfo info_RL {distr_name, GlobalVar::Chiral::eRpL, energy};
+      
+      auto fct_setup = get_fct_setup(fct_name, info_LR, sig_LR);
+      if (d == 0) { m_pars = fct_setup.m_pars; }
+      m_coef_distrs.insert( m_coef_distrs.end(), 
+                            fct_setup.m_coefs.begin(), fct_setup.m_coefs.end() );
+      
+      m_pred_distrs.push_back( {info_LR, coords, sig_LR, bkg} );
+      m_pred_distrs.push_back( {info_RL, coords, sig_RL, bkg} );
+      m_pred_links.push_back( {info_LR, {fct_setup.m_link}, {}} );
+      m_pred_links.push_back( {info_RL, { {"Constant", {"A_RL"}} }, {}} );
+      m_pred_links.push_back( {info_pol, {}, {}} );
+    }
+    
+    m_pars.push_back( {"A_RL", 1, 0.1} );
+    m_pars.push_back( {"ePol", 0.8, 0.01} );
+    m_pars.push_back( {"pPol", 0.3, 0.01} );
+    m_pars[m_pars.size()-2].set_constrgauss(0.8, 0.01);
+    m_pars[m_pars.size()-1].set_constrgauss(0.3, 0.01);
+  }
+};
+
+BenchSetup::BenchSetup(const Inputs & inputs) :
+  m_connector( inputs.m_pred_distrs, inputs.m_coef_distrs, 
+               inputs.m_pred_links, inputs.m_pol_links ),
+  m_pars(inputs.m_pars)
+{
+  m_distrs = ToyMeas::ToyGen(m_connector, m_pars).get_expected_distrs(energy);
+}
+
+BenchSetup::BenchSetup(
+  size_t n_distrs, 
+  size_t n_bins, 
+  const std::string & fct_name
+) : BenchSetup( Inputs(n_distrs, n_bins, fct_name) ) {}
+
+//------------------------------------------------------------------------------
+// Access functions
+
+const std::vector<std::string> & BenchSetup::get_fct_names() {
+  static const std::vector<std::string> fct_names {
+    "Constant", "Quadratic1DPolynomial", "Gaussian1D", "General2fParam_LR" };
+  return fct_names;
+}
+
+//------------------------------------------------------------------------------
+// Input files
+
+void write_csv_file(const std::string & file_path, size_t n_bins) {
+  /** CSV file in the format read by the CSV input style (one coordinate, one
+      bin-wise coefficient, one global coefficient).
+  **/
+  std::ofstream file (file_path);
+  if (!file.is_open()) {
+    throw std::invalid_argument("Can't write benchmark file " + file_path);
+  }
+  file << "#BEGIN-METADATA\n"
+       << "Name: bench\n"
+       << "Energy: 250\n"
+       << "e-Chirality: -1.0\n"
+       << "e+Chirality: 1.0\n"
+       << "Coef|Global: 0.5\n"
+       << "#END-METADATA\n"
+       << ",BinCenters:coord1,BinLow:coord1,BinUp:coord1,Coef:coef1,"
+       << "Cross sections\n";
+  double width = 2.0 / double(n_bins);
+  for (size_t bin=0; bin<n_bins; bin++) {
+    double low = -1.0 + double(bin) * width;
+    file << bin << "," << low + 0.5 * width << "," << low << "," 
+         << low + width << "," << 0.1 * double(bin % 10) << "," 
+         << 100.0 + double(bin % 50) << "\n";
+  }
+}
+
+//------------------------------------------------------------------------------
+
+}
+}
@@ -0,0 +1,48 @@
+#ifndef LIB_BENCHSETUP_H
+#define LIB_BENCHSETUP_H 1
+
+#include <Connect/DataConnector.h>
+#include <Data/DiffDistr.h>
+#include <Fit/FitPar.h>
+
+#include <string>
+#include <vector>
+
+namespace PrEW {
+namespace Bench {
+
+  class BenchSetup {
+    /** Synthetic fit setup of configurable size for the benchmarks.
+        n_distrs 1D distributions (cos(theta) in [-1,1]) with n_bins bins at
+        a single energy and polarisation configuration.
+        The LR prediction is modified by the chosen parametrisation function
+        (see get_fct_names), the RL prediction by a constant.
+        Measured distributions are the expected distributions at the initial
+        parameter values.
+    **/
+    
+    struct Inputs; // Everything needed to create the data connector
+    BenchSetup(const Inputs & inputs);
+    
+    public:
+      static const int energy = 250;
+      
+      Connect::DataConnector m_connector;
+      Fit::ParVec m_pars {};
+      Data::DiffDistrVec m_distrs {};
+      
+      // Constructors
+      BenchSetup(size_t n_distrs, size_t n_bins, 
+                 const std::string & fct_name="Constant");
+      
+      // Parametrisation functions with which a setup can be created
+      static const std::vector<std::string> & get_fct_names();
+  };
+  
+  // Write a synthetic CSV input file (chiral LR distribution) with n_bins bins
+  void write_csv_file(const std::string & file_path, size_t n_bins);
+
+}
+}
+
+#endif
@@ -0,0 +1,32 @@
+#include <BenchSetup.h>
+
+#include <Fit/FitContainer.h>
+
+#include <benchmark/benchmark.h>
+
+#include <cstdint>
+
+using namespace PrEW;
+
+//------------------------------------------------------------------------------
+// Setting up the fit container from the distributions
+// Arguments: number of distributions, number of bins per distribution,
+//            compiled predictions (0/1)
+
+static void BM_FillFitContainer(benchmark::State & state) {
+  Bench::BenchSetup setup (size_t(state.range(0)), size_t(state.range(1)));
+  for (auto _ : state) {
+    Fit::FitContainer container {};
+    setup.m_connector.fill_fit_container(setup.m_distrs, setup.m_pars, 
+                                         &container, state.range(2) != 0);
+    benchmark::DoNotOptimize(container.m_fit_bins.data());
+  }
+  state.SetItemsProcessed( 
+    state.iterations() * state.range(0) * state.range(1) );
+}
+
+BENCHMARK(BM_FillFitContainer)
+  ->ArgsProduct({ {1, 10, 100}, {100, 1000}, {0, 1} })
+  ->Unit(benchmark::kMillisecond);
+
+//------------------------------------------------------------------------------
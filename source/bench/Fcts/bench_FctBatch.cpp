@@ -0,0 +1,95 @@
+#include <Data/BinCoord.h>
+#include <Fcts/FctMap.h>
+#include <Fcts/FctRegistry.h>
+
+#include <benchmark/benchmark.h>
+
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <string>
+#include <vector>
+
+using namespace PrEW;
+
+//------------------------------------------------------------------------------
+// Benchmarks of single parametrisation functions evaluated for all bins
+// Argument: number of bins
+
+struct FctInput {
+  /** Input of a registered function for n_bins 1D bins in [-1,1], 
+      coefficient columns are contiguous (coordinate index coefficients 0).
+  **/
+  std::shared_ptr<const Data::CoordVec> m_coords {};
+  std::vector<std::vector<double>> m_coef_cols {};
+  std::vector<double> m_par_vals {};
+  
+  FctInput(const Fcts::FctEntry & entry, size_t n_bins) {
+    Data::CoordVec coords {};
+    double width = 2.0 / double(n_bins);
+    for (size_t bin=0; bin<n_bins; bin++) {
+      double low = -1.0 + double(bin) * width;
+      coords.push_back({{low + 0.5 * width}, {low}, {low + width}});
+    }
+    m_coords = std::make_shared<const Data::CoordVec>(coords);
+    for (size_t c=0; c<entry.m_n_coefs; c++) {
+      m_coef_cols.emplace_back(n_bins, c < 3 ? 1.0 + double(c) : 0.0);
+    }
+    m_par_vals.assign(entry.m_n_pars, 0.1);
+  }
+};
+
+static void BM_BoundFct(benchmark::State & state, std::string fct_name) {
+  /** Function bound at each bin (Linker binding).
+  **/
+  const auto & entry = 
+    Fcts::Registry::find_entry(Fcts::prew_fct_registry, fct_name);
+  FctInput input (entry, size_t(state.range(0)));
+  std::vector<size_t> par_idxs {};
+  for (size_t p=0; p<input.m_par_vals.size(); p++) { par_idxs.push_back(p); }
+  std::vector<Fcts::BoundFct> bound_fcts {};
+  for (size_t bin=0; bin<input.m_coords->size(); bin++) {
+    std::vector<double> c {};
+    for (const auto & col: input.m_coef_cols) { c.push_back(col[bin]); }
+    bound_fcts.push_back(entry.m_bind(input.m_coords, bin, c, par_idxs));
+  }
+  std::vector<double> out (bound_fcts.size());
+  for (auto _ : state) {
+    for (size_t bin=0; bin<bound_fcts.size(); bin++) { 
+      out[bin] = bound_fcts[bin](input.m_par_vals.data()); 
+    }
+    benchmark::DoNotOptimize(out.data());
+  }
+  state.SetItemsProcessed(state.iterations() * int64_t(out.size()));
+}
+
+static void BM_BatchFct(benchmark::State & state, std::string fct_name) {
+  /** Batch evaluation over contiguous columns (Registry::eval_batch).
+  **/
+  const auto & entry = 
+    Fcts::Registry::find_entry(Fcts::prew_fct_registry, fct_name);
+  FctInput input (entry, size_t(state.range(0)));
+  std::vector<double*> pars {};
+  for (auto & par_val: input.m_par_vals) { pars.push_back(&par_val); }
+  std::vector<const double*> coef_cols {};
+  for (const auto & col: input.m_coef_cols) { coef_cols.push_back(col.data()); }
+  std::vector<double> out (input.m_coords->size());
+  for (auto _ : state) {
+    Fcts::Registry::eval_batch( fct_name, entry, *(input.m_coords), coef_cols,
+                                pars, out.data() );
+    benchmark::DoNotOptimize(out.data());
+  }
+  state.SetItemsProcessed(state.iterations() * int64_t(out.size()));
+}
+
+#define PREW_BENCH_BATCH(fct_name) \
+  BENCHMARK_CAPTURE(BM_BoundFct, fct_name, std::string(#fct_name)) \
+    ->RangeMultiplier(10)->Range(100, 100000); \
+  BENCHMARK_CAPTURE(BM_BatchFct, fct_name, std::string(#fct_name)) \
+    ->RangeMultiplier(10)->Range(100, 100000);
+
+PREW_BENCH_BATCH(Quadratic3DPolynomial_Coeff)
+PREW_BENCH_BATCH(PolarisationFactor)
+PREW_BENCH_BATCH(General2fParam_LR)
+
+//------------------------------------------------------------------------------
@@ -0,0 +1,61 @@
+#include <BenchSetup.h>
+
+#include <Fit/FitContainer.h>
+#include <Fit/PrdEvaluator.h>
+
+#include <benchmark/benchmark.h>
+
+#include <cstdint>
+#include <string>
+
+using namespace PrEW;
+
+//------------------------------------------------------------------------------
+// Benchmarks of the bin prediction per parametrisation function type
+// Argument: number of bins
+
+static void BM_FitBinPrd(benchmark::State & state, std::string fct_name) {
+  /** Bound prediction functions of the bins (PrdEvaluator::evaluate without
+      compiled program, includes the shared prediction terms).
+  **/
+  Bench::BenchSetup setup (1, size_t(state.range(0)), fct_name);
+  Fit::FitContainer container {};
+  setup.m_connector.fill_fit_container(setup.m_distrs, setup.m_pars, 
+                                       &container);
+  Fit::PrdEvaluator evaluator (&container);
+  for (auto _ : state) {
+    evaluator.evaluate([](size_t, size_t, size_t) {});
+    benchmark::DoNotOptimize(evaluator.get_prds().data());
+  }
+  state.SetItemsProcessed( 
+    state.iterations() * int64_t(container.m_fit_bins.size()) );
+}
+
+static void BM_CompiledPrd(benchmark::State & state, std::string fct_name) {
+  /** Compiled prediction program of the bins (PrdEvaluator::evaluate).
+  **/
+  Bench::BenchSetup setup (1, size_t(state.range(0)), fct_name);
+  Fit::FitContainer container {};
+  setup.m_connector.fill_fit_container(setup.m_distrs, setup.m_pars, 
+                                       &container, true);
+  Fit::PrdEvaluator evaluator (&container);
+  for (auto _ : state) {
+    evaluator.evaluate([](size_t, size_t, size_t) {});
+    benchmark::DoNotOptimize(evaluator.get_prds().data());
+  }
+  state.SetItemsProcessed( 
+    state.iterations() * int64_t(container.m_fit_bins.size()) );
+}
+
+#define PREW_BENCH_FCT(fct_name) \
+  BENCHMARK_CAPTURE(BM_FitBinPrd, fct_name, std::string(#fct_name)) \
+    ->RangeMultiplier(10)->Range(10, 100000); \
+  BENCHMARK_CAPTURE(BM_CompiledPrd, fct_name, std::string(#fct_name)) \
+    ->RangeMultiplier(10)->Range(10, 100000);
+
+PREW_BENCH_FCT(Constant)
+PREW_BENCH_FCT(Quadratic1DPolynomial)
+PREW_BENCH_FCT(Gaussian1D)
+PREW_BENCH_FCT(General2fParam_LR)
+
+//------------------------------------------------------------------------------
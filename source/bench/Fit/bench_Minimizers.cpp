@@ -0,0 +1,66 @@
+#include <BenchSetup.h>
+
+#include <Fit/ChiSqMinimizer.h>
+#include <Fit/FitContainer.h>
+#include <Fit/MinuitFactory.h>
+#include <Fit/PoissonNLLMinimizer.h>
+
+#include <benchmark/benchmark.h>
+
+#include <cstdint>
+
+using namespace PrEW;
+
+static const Fit::MinuitFactory factory (ROOT::Minuit2::kMigrad, 1000, 1000, 
+                                         0.01);
+
+//------------------------------------------------------------------------------
+// Evaluation of the minimized quantity for all bins
+// (reset re-evaluates all bins without using results of earlier evaluations)
+// Arguments: number of bins, number of threads
+
+template<class Minimizer>
+static void BM_Evaluation(benchmark::State & state) {
+  Bench::BenchSetup setup (1, size_t(state.range(0)));
+  Fit::FitContainer container {};
+  setup.m_connector.fill_fit_container(setup.m_distrs, setup.m_pars, 
+                                       &container, true);
+  Minimizer minimizer (&container, factory, size_t(state.range(1)));
+  for (auto _ : state) {
+    minimizer.reset();
+  }
+  state.SetItemsProcessed( 
+    state.iterations() * int64_t(container.m_fit_bins.size()) );
+}
+
+BENCHMARK_TEMPLATE(BM_Evaluation, Fit::ChiSqMinimizer)
+  ->ArgsProduct({ {100, 1000, 10000, 100000}, {1, 4} });
+BENCHMARK_TEMPLATE(BM_Evaluation, Fit::PoissonNLLMinimizer)
+  ->ArgsProduct({ {100, 1000, 10000, 100000}, {1, 4} });
+
+//------------------------------------------------------------------------------
+// Full fits: filling the container and minimizing
+// Arguments: number of distributions, number of bins per distribution,
+//            compiled predictions (0/1)
+
+template<class Minimizer>
+static void BM_Fit(benchmark::State & state) {
+  Bench::BenchSetup setup (size_t(state.range(0)), size_t(state.range(1)));
+  for (auto _ : state) {
+    Fit::FitContainer container {};
+    setup.m_connector.fill_fit_container(setup.m_distrs, setup.m_pars, 
+                                         &container, state.range(2) != 0);
+    Minimizer minimizer (&container, factory);
+    minimizer.minimize();
+    benchmark::DoNotOptimize(minimizer.get_result());
+  }
+}
+
+BENCHMARK_TEMPLATE(BM_Fit, Fit::ChiSqMinimizer)
+  ->ArgsProduct({ {1, 10}, {100, 1000}, {0, 1} })
+  ->Unit(benchmark::kMillisecond);
+BENCHMARK_TEMPLATE(BM_Fit, Fit::PoissonNLLMinimizer)
+  ->ArgsProduct({ {1, 10}, {100, 1000}, {0, 1} })
+  ->Unit(benchmark::kMillisecond);
+
+//------------------------------------------------------------------------------
@@ -0,0 +1,85 @@
+#include <BenchSetup.h>
+
+#include <CppUtils/Sys.h>
+#include <Input/DataReader.h>
+#include <Input/InfoRKFile.h>
+#include <Input/InputInfo.h>
+#include <Input/MultiDataReader.h>
+
+#include <benchmark/benchmark.h>
+
+#include <cstdint>
+#include <cstdio>
+#include <string>
+#include <vector>
+
+using namespace PrEW;
+
+//------------------------------------------------------------------------------
+// Reading of CSV files
+// Argument: number of bins in the (synthetic) file
+
+static void BM_ReadCSV(benchmark::State & state) {
+  std::string file_path = 
+    "PrEW_bench_" + std::to_string(state.range(0)) + ".csv";
+  Bench::write_csv_file(file_path, size_t(state.range(0)));
+  Input::InputInfo info {file_path, "CSV"};
+  for (auto _ : state) {
+    Input::DataReader reader (&info);
+    reader.read_file();
+    benchmark::DoNotOptimize(reader.get_pred_distrs().data());
+  }
+  std::remove(file_path.c_str());
+  state.SetItemsProcessed( state.iterations() * state.range(0) );
+}
+
+BENCHMARK(BM_ReadCSV)->RangeMultiplier(10)->Range(100, 100000)
+  ->Unit(benchmark::kMillisecond);
+
+//------------------------------------------------------------------------------
+// Reading of many CSV files (100 files with 1000 bins each)
+// Argument: number of threads
+
+static void BM_ReadCSVFiles(benchmark::State & state) {
+  const size_t n_files = 100;
+  std::vector<Input::InputInfo> infos {};
+  for (size_t f=0; f<n_files; f++) {
+    std::string file_path = "PrEW_bench_files_" + std::to_string(f) + ".csv";
+    Bench::write_csv_file(file_path, 1000);
+    infos.push_back({file_path, "CSV"});
+  }
+  std::vector<Input::InputInfo*> info_ptrs {};
+  for (auto & info: infos) { info_ptrs.push_back(&info); }
+
+  for (auto _ : state) {
+    Input::MultiDataReader reader (info_ptrs, size_t(state.range(0)));
+    reader.read_files();
+    benchmark::DoNotOptimize(reader.get_pred_distrs().data());
+  }
+  for (const auto & info: infos) { std::remove(info.m_file_path.c_str()); }
+  state.SetItemsProcessed( state.iterations() * int64_t(n_files) );
+}
+
+BENCHMARK(BM_ReadCSVFiles)->Arg(1)->Arg(2)->Arg(4)->Arg(8)
+  ->Unit(benchmark::kMillisecond)->UseRealTime();
+
+//------------------------------------------------------------------------------
+// Reading of RK files (uses the RK example file of the tests)
+
+static void BM_ReadRK(benchmark::State & state) {
+  std::string file_path = "../testdata/RK_examplefile_500_250_2018_04_03.root";
+  if ( !CppUtils::Sys::path_exists(file_path) ) {
+    state.SkipWithError("RK example file not found (unzip testdata)!");
+    return;
+  }
+  Input::InfoRKFile info {file_path, "RK", 250};
+  for (auto _ : state) {
+    Input::DataReader reader (&info);
+    reader.read_file();
+    benchmark::DoNotOptimize(reader.get_pred_distrs().data());
+  }
+}
+
+BENCHMARK(BM_ReadRK)->Unit(benchmark::kMillisecond);
+
+//------------------------------------------------------------------------------
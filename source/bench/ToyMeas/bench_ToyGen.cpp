@@ -0,0 +1,56 @@
+#include <BenchSetup.h>
+
+#include <Fit/MinuitFactory.h>
+#include <ToyMeas/ToyGen.h>
+#include <ToyMeas/ToyRunner.h>
+
+#include <benchmark/benchmark.h>
+
+#include <cstdint>
+
+using namespace PrEW;
+
+//------------------------------------------------------------------------------
+// Generation of fluctuated toy distributions
+// Arguments: number of distributions, number of bins per distribution
+
+static void BM_ToyGeneration(benchmark::State & state) {
+  Bench::BenchSetup setup (size_t(state.range(0)), size_t(state.range(1)));
+  ToyMeas::ToyGen toy_gen (setup.m_connector, setup.m_pars);
+  for (auto _ : state) {
+    auto distrs = toy_gen.get_fluctuated_distrs(Bench::BenchSetup::energy);
+    benchmark::DoNotOptimize(distrs.data());
+  }
+  state.SetItemsProcessed( 
+    state.iterations() * state.range(0) * state.range(1) );
+}
+
+BENCHMARK(BM_ToyGeneration)
+  ->ArgsProduct({ {1, 10}, {100, 1000} });
+
+//------------------------------------------------------------------------------
+// Batches of toy fits
+// Arguments: number of toys, number of threads
+
+static void BM_ToyFits(benchmark::State & state) {
+  Bench::BenchSetup setup (4, 100);
+  ToyMeas::ToyGen toy_gen (setup.m_connector, setup.m_pars);
+  Fit::MinuitFactory factory (ROOT::Minuit2::kMigrad, 1000, 1000, 0.01);
+  for (auto _ : state) {
+    ToyMeas::ToyRunner runner (
+      toy_gen, setup.m_connector, setup.m_pars, Bench::BenchSetup::energy,
+      ToyMeas::ToyRunner::chisq_minimization(factory), 
+      size_t(state.range(1)) );
+    runner.set_compile_prds(true);
+    auto results = runner.run(size_t(state.range(0)));
+    benchmark::DoNotOptimize(results.data());
+  }
+  state.SetItemsProcessed( state.iterations() * state.range(0) );
+}
+
+BENCHMARK(BM_ToyFits)
+  ->ArgsProduct({ {16}, {1, 4} })
+  ->Unit(benchmark::kMillisecond)
+  ->UseRealTime();
+
+//------------------------------------------------------------------------------
@@ -0,0 +1,70 @@
+#ifndef LIB_CHIRALSIGMAS_H
+#define LIB_CHIRALSIGMAS_H 1
+
+#include <CppUtils/Vec.h>
+#include <Fcts/ParametrisationFct.h>
+
+#include <memory>
+#include <vector>
+
+namespace PrEW {
+namespace Connect {
+
+  class ChiralSigmas {
+    /** Modified chiral cross sections (signal and background of every
+        chirality) of a single bin.
+        The polarised predictions of all polarisation configurations of the
+        same distribution and bin are calculated from the same modified cross
+        sections. They can either be calculated for each prediction
+        (get_polarised) or once per evaluation for all of them, e.g. as shared
+        prediction terms of a fit container (calc_modified, polarise).
+        Like the factor functions, it refers to parameters by their index in
+        the parameter-value array given at evaluation.
+        Nothing is stored when evaluating, so predictions evaluated in
+        different threads can use the same object.
+    **/
+
+    // Unmodified cross sections and their factor functions
+    // (signal of all chiralities, then background of all chiralities)
+    std::vector<double> m_sigmas {};
+    CppUtils::Vec::Matrix2D<Fcts::BoundFct> m_alphas {};
+
+    // Internal functions
+    double calc_modified_at(size_t i, const double * par_vals) const;
+    static double apply_alphas( double pred,
+                                const double * par_vals,
+                                const std::vector<Fcts::BoundFct> & alphas );
+
+    public:
+      // Constructors
+      ChiralSigmas(
+        const std::vector<double> & sigmas,
+        const CppUtils::Vec::Matrix2D<Fcts::BoundFct> & alphas
+      );
+
+      // Access functions
+      size_t get_n_sigmas() const;
+
+      // Core functionality
+      void calc_modified(const double * par_vals, double * sigmas_mod) const;
+      double get_polarised(
+        const double * par_vals,
+        const std::vector<Fcts::BoundFct> & pol_factors,
+        const std::vector<Fcts::BoundFct> & alphas_sig,
+        const std::vector<Fcts::BoundFct> & alphas_bkg
+      ) const;
+      static double polarise(
+        const double * par_vals,
+        const double * sigmas_mod,
+        const std::vector<Fcts::BoundFct> & pol_factors,
+        const std::vector<Fcts::BoundFct> & alphas_sig,
+        const std::vector<Fcts::BoundFct> & alphas_bkg
+      );
+  };
+
+  typedef std::vector<std::shared_ptr<const ChiralSigmas>> ChiralSigmasVec;
+
+}
+}
+
+#endif
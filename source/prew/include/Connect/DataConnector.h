@@ -1,13 +1,18 @@
 #ifndef LIB_DATACONNECTOR_H
 #define LIB_DATACONNECTOR_H 1
 
+#include <Connect/ChiralSigmas.h>
+#include <Connect/Linker.h>
 #include <Data/CoefDistr.h>
 #include <Data/DiffDistr.h>
+#include <Data/DistrUtils.h>
 #include <Data/PolLink.h>
 #include <Data/PredDistr.h>
 #include <Data/PredLink.h>
 #include <Fit/FitContainer.h>
 
+#include <vector>
+
 namespace PrEW {
 namespace Connect {
   
@@ -23,6 +28,51 @@ namespace Connect {
     Data::PredLinkVec  m_pred_links {};
     Data::PolLinkVec   m_pol_links {};
     
+    // Indices to find the inputs for a distribution without scanning
+    // (polarisation links indexed by energy and polarisation config)
+    Data::DistrUtils::EnergyNameIdxMap m_pred_distrs_idx {};
+    Data::DistrUtils::EnergyNameIdxMap m_coef_distrs_idx {};
+    Data::DistrUtils::EnergyNameIdxMap m_pred_links_idx {};
+    Data::DistrUtils::EnergyNameIdxMap m_pol_links_idx {};
+    
+    // Everything needed to connect one given distribution
+    // (Chiral vectors in order of GlobalVar::Chiral::all)
+    struct DistrSetup {
+      Data::PolLink m_pol_link {};
+      Data::PredDistrVec m_chiral_preds {};
+      std::vector<Linker> m_chiral_linkers_sig {};
+      std::vector<Linker> m_chiral_linkers_bkg {};
+      std::vector<Linker> m_pol_linkers {}; // Polarised {signal, background}
+    };
+    
+    DistrSetup get_distr_setup(const Data::DiffDistr & diff_distr) const;
+    std::vector<size_t> get_par_idxs( const DistrSetup & setup, 
+                                      const Fit::ParVec & pars ) const;
+    std::vector<size_t> get_chiral_par_idxs( const DistrSetup & setup,
+                                             const Fit::ParVec & pars ) const;
+    ChiralSigmasVec get_chiral_sigmas( const DistrSetup & setup,
+                                       const Data::DiffDistr & diff_distr,
+                                       const Fit::ParVec & pars ) const;
+    void bind_bins( const DistrSetup & setup,
+                    const Data::DiffDistr & diff_distr,
+                    const ChiralSigmasVec & chiral_sigmas,
+                    const std::vector<size_t> & sigma_idxs,
+                    const Fit::ParVec & pars,
+                    Fit::BinVec *bins ) const;
+    std::vector<bool> get_shared_distrs( 
+      const Data::DiffDistrVec & diff_distrs ) const;
+    std::vector<Fit::PrdProgram::Ref> compile_chiral_sigmas(
+      const DistrSetup & setup,
+      const Data::DiffDistr & diff_distr,
+      const Fit::ParVec & pars,
+      size_t segment,
+      Fit::PrdProgram *program ) const;
+    void compile_distr( const DistrSetup & setup,
+                        const Data::DiffDistr & diff_distr,
+                        const Fit::ParVec & pars,
+                        const std::vector<Fit::PrdProgram::Ref> & sigma_cols,
+                        Fit::PrdProgram *program ) const;
+    
     public:
       // Constructor
       DataConnector (
@@ -35,14 +85,21 @@ namespace Connect {
       // Core functionality: providing connected bins
       void fill_bins(
         const Data::DiffDistr & diff_distr,
-        Fit::ParVec *pars,
+        const Fit::ParVec & pars,
         Fit::BinVec *bins
       ) const;
       
+      void compile_bins(
+        const Data::DiffDistr & diff_distr,
+        const Fit::ParVec & pars,
+        Fit::PrdProgram *program
+      ) const;
+      
       void fill_fit_container(
         const Data::DiffDistrVec & diff_distrs,
         const Fit::ParVec        & pars,
-        Fit::FitContainer *fit_container 
+        Fit::FitContainer *fit_container,
+        bool compile_prds = false
       ) const;
       
       // Read functions
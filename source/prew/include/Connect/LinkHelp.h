@@ -1,7 +1,10 @@
 #ifndef LIB_LINKHELP_H
 #define LIB_LINKHELP_H 1
 
+#include <Connect/Linker.h>
+#include <CppUtils/Symbol.h>
 #include <Data/PolLink.h>
+#include <Fcts/ParametrisationFct.h>
 #include <Fit/FitPar.h>
 
 #include <functional>
@@ -15,15 +18,20 @@ namespace LinkHelp {
   /** Functions that help with the linking of predictions.
   **/
   
-  std::function<double()> get_polfactor_lambda(
-    const std::string   & chirality, 
+  Linker get_polfactor_linker(
+    CppUtils::Symbol      chirality, 
+    const Data::PolLink & pol_link
+  );
+  
+  Fcts::BoundFct get_polfactor_lambda(
+    CppUtils::Symbol      chirality, 
     const Data::PolLink & pol_link, 
-    Fit::ParVec *pars
+    const Fit::ParVec & pars
   );
   
-  std::function<double()> get_modified_sigma(
+  Fcts::BoundFct get_modified_sigma(
     double sigma,
-    const std::vector<std::function<double()>>& alphas
+    const std::vector<Fcts::BoundFct>& alphas
   );
 }
 
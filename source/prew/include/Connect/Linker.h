@@ -6,10 +6,14 @@
 #include <Data/CoefDistr.h>
 #include <Data/FctLink.h>
 #include <Fit/FitPar.h>
+#include <Fit/PrdProgram.h>
 #include <Fcts/FctMap.h>
 
 #include <functional>
+#include <memory>
 #include <string>
+#include <unordered_map>
+#include <vector>
 
 namespace PrEW {
 namespace Connect {
@@ -18,11 +22,35 @@ namespace Connect {
     /** Class that takes all the info about how functions for one particular
         distribution are supposed to be bound and can give the functions for 
         each bin of the distribution.
+        Names of coefficients and parameters are looked up in hash maps, each
+        function link is only resolved once for all bins.
+        Functions are taken from the typed function registry, bound functions
+        share the coordinates of the linker and store coefficient values and
+        parameter indices in a fixed-size record (parameter values are given
+        when a bound function is evaluated).
     **/
     
+    using NameIdxMap = std::unordered_map<std::string, size_t>;
+    
+    // Function link with everything it refers to found
+    struct ResolvedLink {
+      const Data::FctLink * m_fct_link {};
+      const Fcts::FctEntry * m_entry {};
+      std::vector<const Data::CoefDistr*> m_coefs {};
+      std::vector<size_t> m_par_idxs {};
+    };
+    
     Data::FctLinkVec m_fcts_links {};
-    Data::CoordVec m_coords {};
+    std::shared_ptr<const Data::CoordVec> m_coords {}; // Shared with bound fcts
     Data::CoefDistrVec m_coefs {};
+    NameIdxMap m_coef_idxs {}; // Coefficient name -> index in m_coefs
+    
+    // Internal functions
+    static NameIdxMap index_pars(const Fit::ParVec &pars);
+    static bool same_in_all_bins(const std::vector<double> &col);
+    ResolvedLink resolve_link( const Data::FctLink &fct_link,
+                               const NameIdxMap &par_idxs ) const;
+    Fcts::BoundFct bind_at_bin( const ResolvedLink &link, size_t bin ) const;
     
     public:
       // Constructors
@@ -32,17 +60,39 @@ namespace Connect {
              );
       
       // Core functionality
-      std::vector<std::function<double()>> get_all_bonded_fcts_at_bin(
+      std::vector<Fcts::BoundFct> get_all_bonded_fcts_at_bin(
         size_t bin,
-        Fit::ParVec *pars
+        const Fit::ParVec &pars
+      ) const;
+      CppUtils::Vec::Matrix2D<Fcts::BoundFct> get_all_bonded_fcts(
+        const Fit::ParVec &pars
+      ) const;
+      
+      std::vector<Fit::PrdProgram::Ref> compile_all_fcts(
+        const Fit::ParVec &pars,
+        size_t segment,
+        Fit::PrdProgram *program
       ) const;
       
+      std::vector<size_t> get_all_par_idxs(const Fit::ParVec &pars) const;
+      
     protected:
-      std::function<double()> get_bonded_fct_at_bin(
+      Fcts::BoundFct get_bonded_fct_at_bin(
         const Data::FctLink &fct_name,
         size_t bin,
-        Fit::ParVec *pars
+        const Fit::ParVec &pars
+      ) const;
+      
+      const Data::CoefDistr & find_coef(const std::string &coef_name) const;
+      std::vector<size_t> find_par_idxs(
+        const Data::FctLink &fct_link,
+        const NameIdxMap &par_idxs
+      ) const;
+      const Fcts::FctEntry & find_entry(const std::string &fct_name) const;
+      const Fcts::ParametrisationFct & find_fct(
+        const std::string &fct_name
       ) const;
+      Fcts::ParametrisationGrad find_grad(const std::string &fct_name) const;
   };
   
 }
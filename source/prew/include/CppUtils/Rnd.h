@@ -14,6 +14,8 @@ namespace Rnd {
   static thread_local std::random_device rnd_device;
   static thread_local std::mt19937 rnd_gen(rnd_device());
   
+  void set_seed(unsigned seed, unsigned stream=0);
+  
   int poisson_fluctuate(double mean);
   double gauss_fluctuate(double mean, double width);
 }
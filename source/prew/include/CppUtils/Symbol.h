@@ -0,0 +1,74 @@
+#ifndef LIB_CPPHELPSYMBOL_H
+#define LIB_CPPHELPSYMBOL_H 1
+
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <ostream>
+#include <string>
+
+namespace PrEW {
+namespace CppUtils {
+
+  class Symbol {
+    /** Interned string.
+        Each distinct string is stored only once in a global (thread-safe)
+        symbol table, a symbol only holds the ID of its string in that table.
+        Copying, comparing and hashing symbols are therefore integer 
+        operations, the string is only needed for I/O (see str).
+        IDs are assigned in order of first use, so they can differ between 
+        runs and must not be written out, only the strings.
+        Ordering (operator<) follows the IDs, not the strings.
+    **/
+    
+    public:
+      using Id = std::uint32_t;
+    
+    private:
+      Id m_id {0}; // ID 0 is the empty string
+      
+      static Id intern(const std::string & str);
+    
+    public:
+      // Constructors
+      Symbol() = default;
+      Symbol(const std::string & str);
+      Symbol(const char * str);
+      
+      // Access functions
+      Id get_id() const;
+      bool empty() const;
+      
+      // String round-trip
+      const std::string & str() const;
+      const char * c_str() const;
+      operator const std::string & () const;
+      
+      // Number of distinct strings interned so far (including empty string)
+      static size_t get_n_symbols();
+  };
+  
+  inline bool operator==(const Symbol & a, const Symbol & b) {
+    return a.get_id() == b.get_id();
+  }
+  inline bool operator!=(const Symbol & a, const Symbol & b) {
+    return a.get_id() != b.get_id();
+  }
+  inline bool operator<(const Symbol & a, const Symbol & b) {
+    return a.get_id() < b.get_id();
+  }
+  
+  std::ostream & operator<<(std::ostream & os, const Symbol & symbol);
+
+} // namespace CppUtils
+} // namespace PrEW
+
+namespace std {
+  template<> struct hash<PrEW::CppUtils::Symbol> {
+    size_t operator()(const PrEW::CppUtils::Symbol & symbol) const {
+      return symbol.get_id();
+    }
+  };
+}
+
+#endif
@@ -2,6 +2,7 @@
 #define LIB_CPPHELPSYS_H 1
 
 #include <string>
+#include <vector>
 
 namespace PrEW {
 namespace CppUtils {
@@ -10,6 +11,8 @@ namespace Sys {
   
   bool path_exists (const std::string& file_path);
   bool file_writable(const std::string& file_path);
+  std::vector<std::string> list_files( const std::string& dir_path,
+                                       const std::string& extension="" );
 
 }
 
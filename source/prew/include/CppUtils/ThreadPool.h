@@ -0,0 +1,62 @@
+#ifndef LIB_CPPHELPTHREADPOOL_H
+#define LIB_CPPHELPTHREADPOOL_H 1
+
+#include <atomic>
+#include <condition_variable>
+#include <exception>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace PrEW {
+namespace CppUtils {
+
+  class ThreadPool {
+    /** Fixed set of worker threads that run a given number of tasks in
+        parallel (see run).
+        The calling thread takes part in the work, a pool with a single thread
+        does not start any additional threads.
+        Which thread performs which task is not fixed, results that are to be
+        reproducible must therefore only depend on the task index.
+    **/
+
+    using TaskFct = std::function<void(size_t task, size_t thread)>;
+
+    std::vector<std::thread> m_workers {};
+
+    std::mutex m_mutex {};
+    std::condition_variable m_cv_start {};
+    std::condition_variable m_cv_done {};
+
+    // Current job
+    const TaskFct * m_task_fct {};
+    size_t m_n_tasks {};
+    std::atomic<size_t> m_next_task {};
+    size_t m_n_busy {};
+    size_t m_job_id {};
+    bool m_stop {};
+    std::exception_ptr m_exception {};
+
+    // Internal functions
+    void work(size_t thread);
+    void worker_loop(size_t thread);
+
+    public:
+      // Constructors
+      ThreadPool(size_t n_threads=1);
+      ThreadPool(const ThreadPool&) = delete;
+      ThreadPool& operator=(const ThreadPool&) = delete;
+      ~ThreadPool();
+
+      // Access functions
+      size_t get_n_threads() const;
+
+      // Core functionality
+      void run(size_t n_tasks, const TaskFct & task_fct);
+  };
+
+}
+}
+
+#endif
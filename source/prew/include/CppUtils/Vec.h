@@ -1,6 +1,7 @@
 #ifndef LIB_CPPHELPVEC_H
 #define LIB_CPPHELPVEC_H 1
 
+#include <cstddef>
 #include <functional>
 #include <vector>
 
@@ -15,6 +16,33 @@ namespace Vec {
                                       F &condition );
   template <class T, class F>
   T element_by_condition( const std::vector<T> &vec, F &condition );
+  
+  template <class T, size_t Align=64>
+  struct AlignedAllocator {
+    /** Allocator that places the first element at an address that is a 
+        multiple of Align (default: cache line size).
+        Used for contiguous numerical arrays whose loops are to be vectorised.
+    **/
+    using value_type = T;
+    template <class U> struct rebind { using other = AlignedAllocator<U,Align>; };
+    
+    AlignedAllocator() = default;
+    template <class U> 
+    AlignedAllocator(const AlignedAllocator<U,Align> &) {}
+    
+    T* allocate(size_t n);
+    void deallocate(T* ptr, size_t n);
+    size_t max_size() const;
+  };
+  
+  template <class T, class U, size_t Align>
+  bool operator==( const AlignedAllocator<T,Align> &, 
+                   const AlignedAllocator<U,Align> & ) { return true; }
+  template <class T, class U, size_t Align>
+  bool operator!=( const AlignedAllocator<T,Align> &, 
+                   const AlignedAllocator<U,Align> & ) { return false; }
+  
+  template <class T> using AlignedVec = std::vector<T, AlignedAllocator<T>>;
 }
 
 }
@@ -4,6 +4,9 @@
 #include <CppUtils/Vec.h>
 
 #include <algorithm>
+#include <cstdint>
+#include <limits>
+#include <new>
 
 namespace PrEW {
 namespace CppUtils {
@@ -39,6 +42,42 @@ T Vec::element_by_condition( const std::vector<T> &vec, F &condition ) {
 
 //------------------------------------------------------------------------------
 
+template <class T, size_t Align>
+T* Vec::AlignedAllocator<T,Align>::allocate(size_t n) {
+  /** Allocate memory for n elements with aligned start address.
+      The address returned by operator new is stored directly in front of the
+      aligned memory (needed for deallocation).
+      Throws std::bad_array_new_length if the size in bytes would overflow.
+  **/
+  static_assert( (Align & (Align - 1)) == 0, "Alignment must be power of 2!" );
+  static_assert( Align >= alignof(void*), "Alignment too small!" );
+  if ( n > this->max_size() ) { throw std::bad_array_new_length(); }
+  size_t n_bytes = n * sizeof(T) + Align + sizeof(void*);
+  char * raw = static_cast<char*>(::operator new(n_bytes));
+  std::uintptr_t address = 
+    reinterpret_cast<std::uintptr_t>(raw + sizeof(void*));
+  address = (address + Align - 1) & ~(std::uintptr_t(Align) - 1);
+  void ** aligned = reinterpret_cast<void**>(address);
+  aligned[-1] = raw;
+  return reinterpret_cast<T*>(aligned);
+}
+
+template <class T, size_t Align>
+void Vec::AlignedAllocator<T,Align>::deallocate(T* ptr, size_t /*n*/) {
+  ::operator delete( reinterpret_cast<void**>(ptr)[-1] );
+}
+
+template <class T, size_t Align>
+size_t Vec::AlignedAllocator<T,Align>::max_size() const {
+  /** Largest number of elements whose allocation (incl. the space for
+      alignment) doesn't overflow.
+  **/
+  return ( std::numeric_limits<size_t>::max() - Align - sizeof(void*) ) / 
+         sizeof(T);
+}
+
+//------------------------------------------------------------------------------
+
 }
 }
 
@@ -39,6 +39,8 @@ public:
   const std::string &get_coef_name() const;
   const DistrInfo &get_info() const;
   double get_coef(int bin) const;
+  const std::vector<double> &get_coefs() const;
+  bool is_global() const;
   
   // Operators
   bool operator==(const CoefDistr& other) const;
@@ -1,6 +1,8 @@
 #ifndef LIB_DISTRINFO_H
 #define LIB_DISTRINFO_H 1
 
+#include <CppUtils/Symbol.h>
+
 #include <string>
 #include <vector>
 
@@ -9,10 +11,12 @@ namespace Data {
 
   struct DistrInfo {
     /** Identifier holding all the info that uniquely identifies a distribution.
+        Names are interned (see CppUtils::Symbol) => comparisons are integer
+        compares, use str() for the strings.
     **/
-    std::string m_distr_name {};    // Name of distribution
-    std::string m_pol_config {};    // Name of polarisation setting
-    int         m_energy {};        // Center of mass energy
+    CppUtils::Symbol m_distr_name {};    // Name of distribution
+    CppUtils::Symbol m_pol_config {};    // Name of polarisation setting
+    int              m_energy {};        // Center of mass energy
     
     bool operator==(const DistrInfo& other) const;
   };
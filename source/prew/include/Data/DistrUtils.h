@@ -2,11 +2,13 @@
 #define LIB_DISTRUTILS_H 1
 
 // Includes from PrEW
+#include <CppUtils/Symbol.h>
 #include <CppUtils/Vec.h>
 #include <Data/DiffDistr.h>
 #include <Data/PredDistr.h>
 
 #include <string>
+#include <unordered_map>
 #include <vector>
 
 namespace PrEW {
@@ -22,16 +24,29 @@ namespace DistrUtils {
   template<class T>
   std::vector<T> subvec_energy_and_name(const std::vector<T>& vec, 
                                         int energy, 
-                                        std::string distr_name);
+                                        CppUtils::Symbol distr_name);
   
   template<class T>
   std::vector<T> subvec_energy(const std::vector<T>& vec, int energy);
   template<class T>
   std::vector<T> subvec_pol(const std::vector<T>& vec, 
-                            const std::string& pol_config);
+                            CppUtils::Symbol pol_config);
   
   template<class T>
-  T element_pol(const std::vector<T>& vec, const std::string& pol_config);
+  T element_pol(const std::vector<T>& vec, CppUtils::Symbol pol_config);
+  
+  // Index of vector positions by energy and name for repeated lookups
+  using NameIdxMap = 
+    std::unordered_map<CppUtils::Symbol, std::vector<size_t>>;
+  using EnergyNameIdxMap = std::unordered_map<int, NameIdxMap>;
+  
+  template<class T>
+  EnergyNameIdxMap index_energy_and_name(const std::vector<T>& vec);
+  template<class T>
+  std::vector<T> subvec_energy_and_name(const std::vector<T>& vec,
+                                        const EnergyNameIdxMap& idx_map,
+                                        int energy, 
+                                        CppUtils::Symbol distr_name);
   
   // Functions to rebin distributions
   Data::BinCoord
@@ -37,7 +37,7 @@ template<class T>
 std::vector<T> DistrUtils::subvec_energy_and_name(
   const std::vector<T>& vec, 
   int energy, 
-  std::string distr_name
+  CppUtils::Symbol distr_name
 ) {
   /** Find sub-vector of vector vec in which only distributions are contained 
       whose info contain the given energy and distr_name.
@@ -78,7 +78,7 @@ std::vector<T> DistrUtils::subvec_energy(
 template<class T>
 std::vector<T> DistrUtils::subvec_pol( 
   const std::vector<T>& vec, 
-  const std::string& pol_config
+  CppUtils::Symbol pol_config
 ) {
   /** Find polarisation-specific sub-vector in distribution vector vec.
   **/
@@ -97,7 +97,7 @@ std::vector<T> DistrUtils::subvec_pol(
 template<class T>
 T DistrUtils::element_pol( 
   const std::vector<T>& vec, 
-  const std::string& pol_config
+  CppUtils::Symbol pol_config
 ) {
   /** Find polarisation-specific element in distribution vector vec.
       Includes check that exactly one such element exists.
@@ -109,7 +109,7 @@ T DistrUtils::element_pol(
   
   // Check for how many are found
   if ( all_pol_elements.size() == 0 ) {
-    spdlog::debug("Vector doesn't have element of pol. {}", pol_config);
+    spdlog::debug("Vector doesn't have element of pol. {}", pol_config.str());
   } else {
     output_element = all_pol_elements.at(0);
   }
@@ -117,7 +117,7 @@ T DistrUtils::element_pol(
   if ( all_pol_elements.size() > 1 ) {
     spdlog::debug(
       "Vector has more than one element of pol. {} , returning first", 
-      pol_config
+      pol_config.str()
     );
   }
   
@@ -126,6 +126,46 @@ T DistrUtils::element_pol(
 
 //------------------------------------------------------------------------------
 
+template<class T>
+DistrUtils::EnergyNameIdxMap DistrUtils::index_energy_and_name(
+  const std::vector<T>& vec
+) {
+  /** Index the positions of the distributions in vec by energy and 
+      distribution name (positions in increasing order).
+  **/
+  EnergyNameIdxMap idx_map {};
+  for (size_t i=0; i<vec.size(); i++) {
+    const auto & info = vec[i].get_info();
+    idx_map[info.m_energy][info.m_distr_name].push_back(i);
+  }
+  return idx_map;
+}
+
+//------------------------------------------------------------------------------
+
+template<class T>
+std::vector<T> DistrUtils::subvec_energy_and_name(
+  const std::vector<T>& vec, 
+  const EnergyNameIdxMap& idx_map,
+  int energy, 
+  CppUtils::Symbol distr_name
+) {
+  /** Same as subvec_energy_and_name without index, but only looks at the
+      positions given by the index (which must have been created from vec).
+  **/
+  std::vector<T> subvec {};
+  auto energy_it = idx_map.find(energy);
+  if (energy_it == idx_map.end()) { return subvec; }
+  auto name_it = energy_it->second.find(distr_name);
+  if (name_it == energy_it->second.end()) { return subvec; }
+  
+  subvec.reserve(name_it->second.size());
+  for (const auto & i: name_it->second) { subvec.push_back(vec.at(i)); }
+  return subvec;
+}
+
+//------------------------------------------------------------------------------
+
 }
 }
 
@@ -1,6 +1,8 @@
 #ifndef LIB_POLLINK_H
 #define LIB_POLLINK_H 1
 
+#include <CppUtils/Symbol.h>
+
 #include <string>
 #include <vector>
 
@@ -13,7 +15,7 @@ namespace Data {
     **/
     
     int m_energy {}; // Depends on the energy
-    std::string m_pol_config {}; // Name of polarisation configuration
+    CppUtils::Symbol m_pol_config {}; // Name of polarisation configuration
     
     // Name of single beam polarisation variables
     std::string m_eM_pol {}; 
@@ -28,13 +30,13 @@ namespace Data {
       PolLink() = default;
       PolLink(
         int energy, 
-        std::string pol_config, 
+        CppUtils::Symbol pol_config, 
         std::string eM_pol,     std::string eP_pol, 
         std::string eM_sgn="+", std::string eP_sgn="+"
       );
       
       int get_energy() const;
-      std::string get_pol_config() const;
+      CppUtils::Symbol get_pol_config() const;
       std::string get_eM_pol() const;
       std::string get_eP_pol() const;
       
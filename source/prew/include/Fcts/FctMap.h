@@ -1,6 +1,7 @@
 #ifndef LIB_FNCTMAP_H
 #define LIB_FNCTMAP_H 1
 
+#include <Fcts/FctRegistry.h>
 #include <Fcts/ParametrisationFct.h>
 #include <Fcts/Physics.h>
 #include <Fcts/Polynomial.h>
@@ -12,43 +13,114 @@
 
 namespace PrEW {
 namespace Fcts {
-  // Kind of map pointing from a string (function-ID) to a function 
-  // which has three input parameter vectors: coordinate,parameters,coefficients
-  using FctMap = std::map<std::string, ParametrisationFct>;
+  // Registry pointing from a string (function-ID) to a function which has 
+  // three inputs: coordinate, coefficients, parameters.
+  // Each function is registered with its number of coefficients and 
+  // parameters: make_entry<N_coefs, N_pars, Function>(Function<>, Derivatives)
+  // Functions without parameters don't need derivatives.
+  // Functions with bin-constant quantities can be registered with their
+  // preparation: make_prepared_entry<N_coefs, N_pars, N_prepared, 
+  // Preparation, PreparedFunction>(Function<>, Derivatives)
+  // Functions that don't use the bin coordinates are marked with 
+  // without_coords (same value in all bins if coefficients are global).
         
   // This fixes the association of a funtion-ID string to an actual function.
   // All parameterisation functions must have their own unique ID!
-  static const FctMap prew_fct_map = {
+  static const FctRegistry prew_fct_registry = {
     // Polynomials
-    {"Constant", Polynomial::constant_par},
-    {"ConstantCoef", Polynomial::constant_coef},
-    {"Linear3DPolynomial_Coeff", Polynomial::linear_3D_coeff},
-    {"Quadratic1DPolynomial", Polynomial::quadratic_1D},
-    {"Quadratic3DPolynomial_Coeff", Polynomial::quadratic_3D_coeff},
+    {"Constant", 
+     Registry::without_coords(
+       Registry::make_entry<0, 1, Polynomial::constant_par>(
+         Polynomial::constant_par<>, Polynomial::constant_par_grad))},
+    {"ConstantCoef", 
+     Registry::without_coords(
+       Registry::make_entry<1, 0, Polynomial::constant_coef>(
+         Polynomial::constant_coef<>))},
+    {"Linear3DPolynomial_Coeff", 
+     Registry::without_coords(
+       Registry::make_entry<4, 3, Polynomial::linear_3D_coeff>(
+         Polynomial::linear_3D_coeff<>, Polynomial::linear_3D_coeff_grad))},
+    {"Quadratic1DPolynomial", 
+     Registry::make_entry<0, 3, Polynomial::quadratic_1D>(
+       Polynomial::quadratic_1D<>, Polynomial::quadratic_1D_grad)},
+    {"Quadratic3DPolynomial_Coeff", 
+     Registry::without_coords(
+       Registry::make_entry<10, 3, Polynomial::quadratic_3D_coeff>(
+         Polynomial::quadratic_3D_coeff<>, 
+         Polynomial::quadratic_3D_coeff_grad))},
     // Statisticals
-    {"Gaussian1D", Statistic::gaussian_1D},
+    {"Gaussian1D", 
+     Registry::make_entry<0, 3, Statistic::gaussian_1D>(
+       Statistic::gaussian_1D<>, Statistic::gaussian_1D_grad)},
     // Physis motivated
-    {"AsymmFactor0_2allowed", Physics::asymm_2chixs_a0},
-    {"AsymmFactor1_2allowed", Physics::asymm_2chixs_a1},
-    {"AsymmFactor0_3allowed", Physics::asymm_3chixs_a0},
-    {"AsymmFactor1_3allowed", Physics::asymm_3chixs_a1},
-    {"AsymmFactor2_3allowed", Physics::asymm_3chixs_a2},
-    {"General2fParam_LR", Physics::general_2f_param_LR},
-    {"General2fParam_RL", Physics::general_2f_param_RL},
-    {"Unpol2fParam", Physics::unpol_2f_param},
+    {"AsymmFactor0_2allowed", 
+     Registry::without_coords(
+       Registry::make_entry<2, 1, Physics::asymm_2chixs_a0>(
+         Physics::asymm_2chixs_a0<>, Physics::asymm_2chixs_a0_grad))},
+    {"AsymmFactor1_2allowed", 
+     Registry::without_coords(
+       Registry::make_entry<2, 1, Physics::asymm_2chixs_a1>(
+         Physics::asymm_2chixs_a1<>, Physics::asymm_2chixs_a1_grad))},
+    {"AsymmFactor0_3allowed", 
+     Registry::without_coords(
+       Registry::make_entry<3, 2, Physics::asymm_3chixs_a0>(
+         Physics::asymm_3chixs_a0<>, Physics::asymm_3chixs_a0_grad))},
+    {"AsymmFactor1_3allowed", 
+     Registry::without_coords(
+       Registry::make_entry<3, 2, Physics::asymm_3chixs_a1>(
+         Physics::asymm_3chixs_a1<>, Physics::asymm_3chixs_a1_grad))},
+    {"AsymmFactor2_3allowed", 
+     Registry::without_coords(
+       Registry::make_entry<3, 2, Physics::asymm_3chixs_a2>(
+         Physics::asymm_3chixs_a2<>, Physics::asymm_3chixs_a2_grad))},
+    {"General2fParam_LR", 
+     Registry::make_prepared_entry<4, 6, 4, Physics::prepare_2f_param, 
+                                   Physics::general_2f_param_LR_prepared>(
+       Physics::general_2f_param_LR<>, Physics::general_2f_param_LR_grad)},
+    {"General2fParam_RL", 
+     Registry::make_prepared_entry<4, 6, 4, Physics::prepare_2f_param, 
+                                   Physics::general_2f_param_RL_prepared>(
+       Physics::general_2f_param_RL<>, Physics::general_2f_param_RL_grad)},
+    {"Unpol2fParam", 
+     Registry::make_prepared_entry<4, 3, 4, Physics::prepare_2f_param, 
+                                   Physics::unpol_2f_param_prepared>(
+       Physics::unpol_2f_param<>, Physics::unpol_2f_param_grad)},
       /** // DEPRECATED 
       {"AsymmFactorLR_Af_2f", Physics::asymm_Af_2f_LR},
       {"AsymmFactorRL_Af_2f", Physics::asymm_Af_2f_RL}, 
       **/
     // Systematic effects
-    {"PolarisationFactor", Systematics::polarisation_factor},
-    {"LuminosityFraction", Systematics::luminosity_fraction},
-    {"AcceptanceBox", Systematics::acceptance_box},
-    {"AcceptanceBoxPolynomial", Systematics::acceptance_box_polynomial}
+    {"PolarisationFactor", 
+     Registry::without_coords(
+       Registry::make_entry<4, 2, Systematics::polarisation_factor>(
+         Systematics::polarisation_factor<>, 
+         Systematics::polarisation_factor_grad))},
+    {"LuminosityFraction", 
+     Registry::without_coords(
+       Registry::make_entry<1, 1, Systematics::luminosity_fraction>(
+         Systematics::luminosity_fraction<>, 
+         Systematics::luminosity_fraction_grad))},
+    {"AcceptanceBox", 
+     Registry::make_entry<2, 2, Systematics::acceptance_box>(
+       Systematics::acceptance_box<>, Systematics::acceptance_box_grad)},
+    {"AcceptanceBoxPolynomial", 
+     Registry::without_coords(
+       Registry::make_entry<6, 2, Systematics::acceptance_box_polynomial>(
+         Systematics::acceptance_box_polynomial<>, 
+         Systematics::acceptance_box_polynomial_grad))}
   };
-
+  
+  // Map pointing from function-ID to the function
+  static const FctMap prew_fct_map = 
+    Registry::get_fct_map(prew_fct_registry);
+  
+  // Map pointing from function-ID to the partial derivatives of the function
+  // w.r.t. its parameters (needed for analytic gradients).
+  // Only functions with known derivatives have an entry.
+  static const GradMap prew_grad_map = 
+    Registry::get_grad_map(prew_fct_registry);
   
 }
 }
 
-#endif
\ No newline at end of file
+#endif
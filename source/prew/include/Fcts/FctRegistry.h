@@ -0,0 +1,160 @@
+#ifndef LIB_FCTREGISTRY_H
+#define LIB_FCTREGISTRY_H 1
+
+#include <Data/BinCoord.h>
+#include <Fcts/ParametrisationFct.h>
+
+// Standard library
+#include <cstddef>
+#include <functional>
+#include <map>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace PrEW {
+namespace Fcts {
+
+// Function bound at a bin of a (shared) coordinate vector, coefficient values
+// and parameter indices are stored in a fixed-size record
+using BindFct = BoundFct (*)(
+  const std::shared_ptr<const Data::CoordVec> & coords, 
+  size_t bin,
+  const std::vector<double> & coefs, 
+  const std::vector<size_t> & par_idxs
+);
+
+// Function evaluated for n_rows consecutive bins with coordinates coords[row]
+// and coefficient i at coef_cols[i][row * coef_strides[i]]
+using RowsFct = void (*)(
+  const Data::BinCoord * coords, 
+  size_t n_rows,
+  const double * const * coef_cols, 
+  const size_t * coef_strides,
+  double * const * pars, 
+  double * out
+);
+
+// Preparation of the bin-constant quantities q from coordinates and 
+// coefficients c of a bin
+using PrepFct = void (*)(
+  const Data::BinCoord & x,
+  const double * c,
+  double * q
+);
+
+// Function evaluated for n_rows consecutive bins with contiguous coefficient
+// columns (coefficient i at coef_cols[i][row], as in CoefDistr)
+using BatchFct = void (*)(
+  const Data::BinCoord * coords, 
+  size_t n_rows,
+  const double * const * coef_cols, 
+  double * const * pars, 
+  double * out
+);
+
+struct FctEntry {
+  /** Parametrisation function whose number of coefficients and parameters 
+      (arity) is fixed at compile time.
+      Besides the general function (vector arguments) and its derivatives the
+      entry holds versions instantiated with fixed-size arguments: 
+      Binding at a bin only stores a small fixed-size record (no vectors) and
+      evaluating rows of bins inlines the function in the loop.
+      The batch version (contiguous columns) only reads columns and writes
+      the output in its loop, so it can be vectorised by the compiler.
+      Functions with a preparation hook calculate their bin-constant 
+      quantities (e.g. integrals over the bin) once when they are bound, the
+      bound function only does the parameter-dependent arithmetic.
+      For those the rows and batch functions expect the m_n_prep prepared 
+      columns in place of the coefficient columns (see m_prep).
+      Functions that don't use the bin coordinates are marked, with global 
+      coefficients their value is the same for all bins of a distribution.
+  **/
+  size_t m_n_coefs {};
+  size_t m_n_pars {};
+  ParametrisationFct m_fct {};
+  ParametrisationGrad m_grad {}; // Empty if derivatives unknown
+  BindFct m_bind {};
+  RowsFct m_rows {};
+  BatchFct m_batch {};
+  size_t m_n_prep {};  // Number of prepared quantities
+  PrepFct m_prep {};   // Null if function has no preparation
+  bool m_uses_coords {true};
+};
+
+// Registry of functions, functions are identified by their unique ID
+using FctRegistry = std::map<std::string, FctEntry>;
+
+// Maps from function-ID to function or derivatives only
+using FctMap = std::map<std::string, ParametrisationFct>;
+using GradMap = std::map<std::string, ParametrisationGrad>;
+
+namespace Registry {
+  template<size_t NC, size_t NP, TypedFct<NC, NP> F>
+  FctEntry make_entry( const ParametrisationFct & fct, 
+                       const ParametrisationGrad & grad = {} );
+
+  template<size_t NC, size_t NP, size_t NQ, 
+           TypedPrep<NC, NQ> Q, TypedFct<NQ, NP> F>
+  FctEntry make_prepared_entry( const ParametrisationFct & fct, 
+                                const ParametrisationGrad & grad = {} );
+
+  FctEntry without_coords(FctEntry entry);
+
+  template<size_t NC, size_t NP, TypedFct<NC, NP> F>
+  BoundFct bind_typed( 
+    const std::shared_ptr<const Data::CoordVec> & coords, 
+    size_t bin,
+    const std::vector<double> & coefs, 
+    const std::vector<size_t> & par_idxs );
+  
+  template<size_t NC, size_t NP, size_t NQ, 
+           TypedPrep<NC, NQ> Q, TypedFct<NQ, NP> F>
+  BoundFct bind_prepared( 
+    const std::shared_ptr<const Data::CoordVec> & coords, 
+    size_t bin,
+    const std::vector<double> & coefs, 
+    const std::vector<size_t> & par_idxs );
+  
+  template<size_t NC, size_t NQ, TypedPrep<NC, NQ> Q>
+  void prepare_typed( const Data::BinCoord & x, const double * c, double * q );
+  
+  template<size_t NC, size_t NP, TypedFct<NC, NP> F>
+  void eval_rows_typed( const Data::BinCoord * coords, 
+                        size_t n_rows,
+                        const double * const * coef_cols, 
+                        const size_t * coef_strides,
+                        double * const * pars, 
+                        double * out );
+  
+  template<size_t NC, size_t NP, TypedFct<NC, NP> F>
+  void eval_batch_typed( const Data::BinCoord * coords, 
+                         size_t n_rows,
+                         const double * const * coef_cols, 
+                         double * const * pars, 
+                         double * out );
+  
+  void eval_batch( const std::string & fct_name,
+                   const FctEntry & entry,
+                   const Data::CoordVec & coords,
+                   const std::vector<const double *> & coef_cols,
+                   const std::vector<double *> & pars,
+                   double * out );
+  
+  const FctEntry & find_entry( const FctRegistry & registry, 
+                               const std::string & fct_name );
+  void check_arity( const std::string & fct_name, 
+                    const FctEntry & entry,
+                    size_t n_coefs, 
+                    size_t n_pars );
+  
+  FctMap get_fct_map(const FctRegistry & registry);
+  GradMap get_grad_map(const FctRegistry & registry);
+} // namespace Registry
+
+} // namespace Fcts
+} // namespace PrEW
+
+#include <Fcts/FctRegistry.tpp>
+
+#endif
@@ -0,0 +1,194 @@
+#ifndef LIB_FCTREGISTRY_TPP
+#define LIB_FCTREGISTRY_TPP 1
+
+#include <Fcts/FctRegistry.h>
+
+// Standard library
+#include <algorithm>
+#include <array>
+
+namespace PrEW {
+namespace Fcts {
+
+//------------------------------------------------------------------------------
+
+template<size_t NC, size_t NP, TypedFct<NC, NP> F>
+FctEntry Registry::make_entry( 
+  const ParametrisationFct & fct, 
+  const ParametrisationGrad & grad
+) {
+  /** Registry entry of function F with NC coefficients and NP parameters.
+      fct must be the same function with vector arguments, grad its
+      derivatives (if known).
+  **/
+  FctEntry entry {};
+  entry.m_n_coefs = NC;
+  entry.m_n_pars = NP;
+  entry.m_fct = fct;
+  entry.m_grad = grad;
+  entry.m_bind = &bind_typed<NC, NP, F>;
+  entry.m_rows = &eval_rows_typed<NC, NP, F>;
+  entry.m_batch = &eval_batch_typed<NC, NP, F>;
+  return entry;
+}
+
+template<size_t NC, size_t NP, size_t NQ, 
+         TypedPrep<NC, NQ> Q, TypedFct<NQ, NP> F>
+FctEntry Registry::make_prepared_entry( 
+  const ParametrisationFct & fct, 
+  const ParametrisationGrad & grad
+) {
+  /** Registry entry of a function with NC coefficients and NP parameters 
+      whose NQ bin-constant quantities are prepared by Q and then used by F.
+      fct must be the full function with vector arguments (F after Q), grad
+      its derivatives (if known).
+  **/
+  FctEntry entry {};
+  entry.m_n_coefs = NC;
+  entry.m_n_pars = NP;
+  entry.m_fct = fct;
+  entry.m_grad = grad;
+  entry.m_bind = &bind_prepared<NC, NP, NQ, Q, F>;
+  entry.m_rows = &eval_rows_typed<NQ, NP, F>;
+  entry.m_batch = &eval_batch_typed<NQ, NP, F>;
+  entry.m_n_prep = NQ;
+  entry.m_prep = &prepare_typed<NC, NQ, Q>;
+  return entry;
+}
+
+//------------------------------------------------------------------------------
+
+template<size_t NC, size_t NP, TypedFct<NC, NP> F>
+BoundFct Registry::bind_typed( 
+  const std::shared_ptr<const Data::CoordVec> & coords, 
+  size_t bin,
+  const std::vector<double> & coefs, 
+  const std::vector<size_t> & par_idxs
+) {
+  /** Bind F at the bin, coefficients and parameter indices are copied into
+      fixed-size arrays (arity must have been checked).
+      The coordinates are shared, not copied.
+  **/
+  CoefArray<NC> c {};
+  std::array<size_t, NP> idxs {};
+  std::copy_n(coefs.begin(), NC, c.begin());
+  std::copy_n(par_idxs.begin(), NP, idxs.begin());
+  return [coords, bin, c, idxs](const double * par_vals) { 
+    std::array<double, NP> vals {};
+    ParArray<NP> p {};
+    for (size_t i=0; i<NP; i++) { 
+      vals[i] = par_vals[idxs[i]];
+      p[i] = &(vals[i]);
+    }
+    return F((*coords)[bin], c, p); 
+  };
+}
+
+template<size_t NC, size_t NP, size_t NQ, 
+         TypedPrep<NC, NQ> Q, TypedFct<NQ, NP> F>
+BoundFct Registry::bind_prepared( 
+  const std::shared_ptr<const Data::CoordVec> & coords, 
+  size_t bin,
+  const std::vector<double> & coefs, 
+  const std::vector<size_t> & par_idxs
+) {
+  /** Bind F at the bin with the quantities prepared by Q from the bin 
+      coordinates and coefficients (arity must have been checked).
+      Preparation is only done once here, not in each call.
+  **/
+  CoefArray<NC> c {};
+  std::array<size_t, NP> idxs {};
+  std::copy_n(coefs.begin(), NC, c.begin());
+  std::copy_n(par_idxs.begin(), NP, idxs.begin());
+  CoefArray<NQ> q = Q((*coords)[bin], c);
+  return [coords, bin, q, idxs](const double * par_vals) { 
+    std::array<double, NP> vals {};
+    ParArray<NP> p {};
+    for (size_t i=0; i<NP; i++) { 
+      vals[i] = par_vals[idxs[i]];
+      p[i] = &(vals[i]);
+    }
+    return F((*coords)[bin], q, p); 
+  };
+}
+
+template<size_t NC, size_t NQ, TypedPrep<NC, NQ> Q>
+void Registry::prepare_typed( 
+  const Data::BinCoord & x, 
+  const double * c, 
+  double * q
+) {
+  /** Prepare the quantities q of a single bin (see PrepFct).
+  **/
+  CoefArray<NC> c_arr {};
+  std::copy_n(c, NC, c_arr.begin());
+  CoefArray<NQ> q_arr = Q(x, c_arr);
+  std::copy_n(q_arr.begin(), NQ, q);
+}
+
+//------------------------------------------------------------------------------
+
+template<size_t NC, size_t NP, TypedFct<NC, NP> F>
+void Registry::eval_rows_typed( 
+  const Data::BinCoord * coords, 
+  size_t n_rows,
+  const double * const * coef_cols, 
+  const size_t * coef_strides,
+  double * const * pars, 
+  double * out
+) {
+  /** Evaluate F for consecutive rows of bins (see RowsFct).
+      Uses the batch version if all coefficient columns are contiguous.
+  **/
+  if ( std::all_of( coef_strides, coef_strides + NC, 
+                    [](size_t stride) { return stride == 1; } ) ) {
+    eval_batch_typed<NC, NP, F>(coords, n_rows, coef_cols, pars, out);
+    return;
+  }
+  
+  CoefArray<NC> c {};
+  ParArray<NP> p {};
+  std::copy_n(pars, NP, p.begin());
+  for (size_t row=0; row<n_rows; row++) {
+    for (size_t i=0; i<c.size(); i++) { 
+      c[i] = coef_cols[i][row * coef_strides[i]]; 
+    }
+    out[row] = F(coords[row], c, p);
+  }
+}
+
+template<size_t NC, size_t NP, TypedFct<NC, NP> F>
+void Registry::eval_batch_typed( 
+  const Data::BinCoord * coords, 
+  size_t n_rows,
+  const double * const * coef_cols, 
+  double * const * pars, 
+  double * out
+) {
+  /** Evaluate F for consecutive rows of bins with contiguous coefficient 
+      columns (see BatchFct).
+      Column pointers and parameter values are copied to local arrays first,
+      writing the output can then not change anything F reads and the loop 
+      can be vectorised (if F does not need the coordinates).
+  **/
+  std::array<const double *, NC> cols {};
+  std::array<double, NP> p_vals {};
+  ParArray<NP> p {};
+  std::copy_n(coef_cols, NC, cols.begin());
+  for (size_t i=0; i<NP; i++) { 
+    p_vals[i] = *(pars[i]); 
+    p[i] = &(p_vals[i]);
+  }
+  for (size_t row=0; row<n_rows; row++) {
+    CoefArray<NC> c {};
+    for (size_t i=0; i<NC; i++) { c[i] = cols[i][row]; }
+    out[row] = F(coords[row], c, p);
+  }
+}
+
+//------------------------------------------------------------------------------
+
+}
+}
+
+#endif
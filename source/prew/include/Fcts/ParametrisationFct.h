@@ -4,6 +4,8 @@
 #include <Data/BinCoord.h>
 
 // Standard library
+#include <array>
+#include <cstddef>
 #include <functional>
 #include <vector>
 
@@ -14,6 +16,35 @@ namespace Fcts {
 using ParametrisationFct = std::function<double(const Data::BinCoord &,
                                                 const std::vector<double> &,
                                                 const std::vector<double *> &)>;
+
+// Partial derivatives of a parametrisation function with respect to its 
+// parameters, same input as the function plus the output vector:
+// grad[i] = df/dp[i] (grad has same size as the parameter vector)
+using ParametrisationGrad = std::function<void(const Data::BinCoord &,
+                                               const std::vector<double> &,
+                                               const std::vector<double *> &,
+                                               std::vector<double> *)>;
+
+// Function bound to a bin (coordinates and coefficients fixed) whose 
+// parameters are referred to by their index in the parameter-value array 
+// given at evaluation
+using BoundFct = std::function<double(const double * par_vals)>;
+
+// Fixed-size arguments for functions whose number of coefficients (NC) and
+// parameters (NP) is known at compile time
+template<size_t NC> using CoefArray = std::array<double, NC>;
+template<size_t NP> using ParArray = std::array<double *, NP>;
+template<size_t NC, size_t NP>
+using TypedFct = double (*)(const Data::BinCoord &, 
+                            const CoefArray<NC> &,
+                            const ParArray<NP> &);
+
+// Preparation of NQ bin-constant quantities from the bin coordinates and the
+// NC coefficients, used by prepared functions (TypedFct<NQ, NP>) in place of
+// the coefficients
+template<size_t NC, size_t NQ>
+using TypedPrep = CoefArray<NQ> (*)(const Data::BinCoord &, 
+                                    const CoefArray<NC> &);
 } // namespace Fcts
 } // namespace PrEW
 
@@ -4,6 +4,7 @@
 #include <Data/BinCoord.h>
 
 // Standard library
+#include <array>
 #include <vector>
 
 namespace PrEW {
@@ -12,63 +13,160 @@ namespace Fcts {
 namespace Physics {
   /** Namespace for parametrisation functions from statistics.
       Must all follow structure:
+        template<class C=std::vector<double>, class P=std::vector<double*>>
         double fct_name (const Data::BinCoord   &x,
-                          const std::vector<double>   &c,
-                          const std::vector<double*>  &p);
+                          const C                     &c,
+                          const P                     &p);
+      Coefficient values c and parameter pointers p can be any indexable
+      containers, std::vector in general and std::array in the typed 
+      function registry (see FctRegistry.h).
   **/
 
   //----------------------------------------------------------------------------
   
+  template<class C=std::vector<double>, class P=std::vector<double*>>
   double asymm_2chixs_a0 (const Data::BinCoord        &x,
-                          const std::vector<double>   &c,
-                          const std::vector<double*>  &p);
+                          const C                     &c,
+                          const P                     &p);
                           
+  template<class C=std::vector<double>, class P=std::vector<double*>>
   double asymm_2chixs_a1 (const Data::BinCoord        &x,
-                          const std::vector<double>   &c,
-                          const std::vector<double*>  &p);
+                          const C                     &c,
+                          const P                     &p);
                           
   //----------------------------------------------------------------------------
   
+  template<class C=std::vector<double>, class P=std::vector<double*>>
   double asymm_3chixs_a0 (const Data::BinCoord        &x,
-                          const std::vector<double>   &c,
-                          const std::vector<double*>  &p);
+                          const C                     &c,
+                          const P                     &p);
   
+  template<class C=std::vector<double>, class P=std::vector<double*>>
   double asymm_3chixs_a1 (const Data::BinCoord        &x,
-                          const std::vector<double>   &c,
-                          const std::vector<double*>  &p);
+                          const C                     &c,
+                          const P                     &p);
   
+  template<class C=std::vector<double>, class P=std::vector<double*>>
   double asymm_3chixs_a2 (const Data::BinCoord        &x,
-                          const std::vector<double>   &c,
-                          const std::vector<double*>  &p);
+                          const C                     &c,
+                          const P                     &p);
   
   //----------------------------------------------------------------------------
   
+  template<class C=std::vector<double>, class P=std::vector<double*>>
   double asymm_Af_2f_LR (const Data::BinCoord         &x,
-                         const std::vector<double>   &c,
-                         const std::vector<double*>  &p);
+                         const C                     &c,
+                         const P                     &p);
   
+  template<class C=std::vector<double>, class P=std::vector<double*>>
   double asymm_Af_2f_RL (const Data::BinCoord         &x,
-                         const std::vector<double>   &c,
-                         const std::vector<double*>  &p);
+                         const C                     &c,
+                         const P                     &p);
   
   //----------------------------------------------------------------------------
   
+  template<class C=std::vector<double>, class P=std::vector<double*>>
   double general_2f_param_LR (const Data::BinCoord         &x,
-                              const std::vector<double>   &c,
-                              const std::vector<double*>  &p);
+                              const C                     &c,
+                              const P                     &p);
   
+  template<class C=std::vector<double>, class P=std::vector<double*>>
   double general_2f_param_RL (const Data::BinCoord         &x,
-                              const std::vector<double>   &c,
-                              const std::vector<double*>  &p);
+                              const C                     &c,
+                              const P                     &p);
                               
+  template<class C=std::vector<double>, class P=std::vector<double*>>
   double unpol_2f_param (const Data::BinCoord         &x,
-                         const std::vector<double>   &c,
-                         const std::vector<double*>  &p);
+                         const C                     &c,
+                         const P                     &p);
   
   //----------------------------------------------------------------------------
+  
+  /** Preparation of the bin-constant quantities q of the difermion 
+      parametrisations (done once per bin) and the functions using them.
+      Prepared functions follow the structure of the parametrisation 
+      functions with c replaced by q.
+  **/
+  
+  template<class C=std::vector<double>>
+  std::array<double, 4> prepare_2f_param (const Data::BinCoord    &x,
+                                          const C                 &c);
+  
+  template<class Q=std::array<double, 4>, class P=std::vector<double*>>
+  double general_2f_param_LR_prepared (const Data::BinCoord    &x,
+                                       const Q                 &q,
+                                       const P                 &p);
+  
+  template<class Q=std::array<double, 4>, class P=std::vector<double*>>
+  double general_2f_param_RL_prepared (const Data::BinCoord    &x,
+                                       const Q                 &q,
+                                       const P                 &p);
+  
+  template<class Q=std::array<double, 4>, class P=std::vector<double*>>
+  double unpol_2f_param_prepared (const Data::BinCoord    &x,
+                                  const Q                 &q,
+                                  const P                 &p);
+  
+  //----------------------------------------------------------------------------
+  
+  /** Partial derivatives w.r.t. the parameters.
+      Must all follow structure:
+        void fct_name_grad (const Data::BinCoord   &x,
+                            const std::vector<double>   &c,
+                            const std::vector<double*>  &p,
+                            std::vector<double>  *grad);
+  **/
+  
+  void asymm_2chixs_a0_grad (const Data::BinCoord         &x,
+                            const std::vector<double>   &c,
+                            const std::vector<double*>  &p,
+                            std::vector<double>  *grad);
+
+  void asymm_2chixs_a1_grad (const Data::BinCoord         &x,
+                            const std::vector<double>   &c,
+                            const std::vector<double*>  &p,
+                            std::vector<double>  *grad);
+
+  //----------------------------------------------------------------------------
+  
+  void asymm_3chixs_a0_grad (const Data::BinCoord         &x,
+                            const std::vector<double>   &c,
+                            const std::vector<double*>  &p,
+                            std::vector<double>  *grad);
+
+  void asymm_3chixs_a1_grad (const Data::BinCoord         &x,
+                            const std::vector<double>   &c,
+                            const std::vector<double*>  &p,
+                            std::vector<double>  *grad);
+
+  void asymm_3chixs_a2_grad (const Data::BinCoord         &x,
+                            const std::vector<double>   &c,
+                            const std::vector<double*>  &p,
+                            std::vector<double>  *grad);
+
+  //----------------------------------------------------------------------------
+  
+  void general_2f_param_LR_grad (const Data::BinCoord         &x,
+                                const std::vector<double>   &c,
+                                const std::vector<double*>  &p,
+                                std::vector<double>  *grad);
+
+  void general_2f_param_RL_grad (const Data::BinCoord         &x,
+                                const std::vector<double>   &c,
+                                const std::vector<double*>  &p,
+                                std::vector<double>  *grad);
+
+  void unpol_2f_param_grad (const Data::BinCoord         &x,
+                           const std::vector<double>   &c,
+                           const std::vector<double*>  &p,
+                           std::vector<double>  *grad);
+
+  //----------------------------------------------------------------------------
 }
   
 }
 }
 
+#include <Fcts/Physics.tpp>
+
 #endif
\ No newline at end of file
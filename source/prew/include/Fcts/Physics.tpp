@@ -0,0 +1,333 @@
+#ifndef LIB_PHYSICS_TPP
+#define LIB_PHYSICS_TPP 1
+
+#include <Fcts/Physics.h>
+
+#include <math.h>
+
+namespace PrEW {
+namespace Fcts {
+
+//------------------------------------------------------------------------------
+/** Chiral cross section scaling factors accounting for an the chiral asymmetry
+    in the case that only two chiral cross sections are allowed.
+    The two factors are chosen such that the sum of the chiral cross sections
+    is not modified, while the asymmetry is modified like:
+      A = (xs0 - xs1)/(xs0 + xs1) -> A' = A + DeltaA
+**/
+
+template<class C, class P>
+double Physics::asymm_2chixs_a0 (
+  const Data::BinCoord   &/*x*/,
+  const C   &c,
+  const P  &p
+) {
+  /** (See general description above.)
+      Factor for chiral cross section xs0.
+      Coefficients: c[0] - chiral cross section xs0 (sum over all bins)
+                    c[1] - chiral cross section xs1 (sum over all bins)
+      Parameters: p[0] - Change in asymmetry DeltaA
+  **/
+  return 1 + 0.5 * ( 1 + c[1]/c[0]) * (*(p[0]));
+}
+                        
+template<class C, class P>
+double Physics::asymm_2chixs_a1 (
+  const Data::BinCoord &/*x*/,
+  const C   &c,
+  const P  &p
+) {
+  /** (See general description above.)
+      Factor for chiral cross section xs1.
+      Coefficients: c[0] - chiral cross section xs0 (sum over all bins)
+                    c[1] - chiral cross section xs1 (sum over all bins)
+      Parameters: p[0] - Change in asymmetry DeltaA
+  **/
+  return 1 - 0.5 * ( 1 + c[0]/c[1]) * (*(p[0]));
+}
+                        
+//------------------------------------------------------------------------------
+/** Chiral cross section scaling factors accounting for the chiral asymmetries
+    in the case that three chiral cross sections are allowed.
+    The asymmtries are choosen such that they reduce to the 2-cross section 
+    case in case the third cross section goes to 0.
+      A_I   = ((xs0+xs2) - xs1) / (xs0+xs1+xs2)
+      A_II  = (xs0 - (xs1+xs2)) / (xs0+xs1+xs2)
+    The factors represent a shift in the asymmetry.
+      A_x -> A'_x = A_x + DeltaA_x
+**/
+
+template<class C, class P>
+double Physics::asymm_3chixs_a0 (
+  const Data::BinCoord &/*x*/,
+  const C   &c,
+  const P  &p
+) {
+  /** (See general description above.)
+      Factor for chiral cross section xs0.
+      Coefficients: c[0] - inital (SM) value for chiral cross section xs0
+                    c[1] - inital (SM) value for chiral cross section xs1
+                    c[2] - inital (SM) value for chiral cross section xs2
+      Parameters: p[0] - Change in asymmetry I DeltaA_I  
+                  p[1] - Change in asymmetry II DeltaA_II
+  **/
+  return 1.0 + (c[0]+c[1]+c[2])/c[0] * (*(p[1]));
+}
+
+template<class C, class P>
+double Physics::asymm_3chixs_a1 (
+  const Data::BinCoord &/*x*/,
+  const C   &c,
+  const P  &p
+) {
+  /** (See general description above.)
+      Factor for chiral cross section xs1.
+      Coefficients: c[0] - inital (SM) value for chiral cross section xs0
+                    c[1] - inital (SM) value for chiral cross section xs1
+                    c[2] - inital (SM) value for chiral cross section xs2
+      Parameters: p[0] - Change in asymmetry I DeltaA_I  
+                  p[1] - Change in asymmetry II DeltaA_II
+  **/
+  return 1.0 - (c[0]+c[1]+c[2])/c[1] * (*(p[0]));
+}
+
+template<class C, class P>
+double Physics::asymm_3chixs_a2 (
+  const Data::BinCoord &/*x*/,
+  const C   &c,
+  const P  &p
+) {
+  /** (See general description above.)
+      Factor for chiral cross section xs2.
+      Coefficients: c[0] - inital (SM) value for chiral cross section xs0
+                    c[1] - inital (SM) value for chiral cross section xs1
+                    c[2] - inital (SM) value for chiral cross section xs2
+      Parameters: p[0] - Change in asymmetry I DeltaA_I
+                  p[1] - Change in asymmetry II DeltaA_II
+  **/
+  return 1.0 + (c[0]+c[1]+c[2])/c[2] * ( (*(p[0])) - (*(p[1])) );
+}
+
+//------------------------------------------------------------------------------
+/** Final state asymmetry factors in di-fermion production.
+    Underlying assumption:
+      The distribution has the shape predicted by the Standard Model at tree 
+      level. Only the chiral coefficients (c_L/R^f/e) are allowed to vary.
+    Final state asymmetry is defined as:
+      Af = [(c_L^f)^2 - (c_R^f)^2] / [(c_L^f)^2 - (c_R^f)^2]
+    A change in this asymmetry changes the shape of the distribution but keeps
+    it's integral constant.
+    The shape-change depends on the chirality of the incoming particles and the
+    polar angle.
+**/
+
+template<class C, class P>
+double Physics::asymm_Af_2f_LR (
+  const Data::BinCoord &x,
+  const C   &c,
+  const P  &p
+) {
+  /** (See general description above.)
+      Polar angle-dependent scaling of the LR distribution due to a change in
+      the final state asymmetry.
+      Coefficients: c[0] - total LR cross section @ SM (or: initial prediction)
+                    c[1] - differential LR cross section in this bin @ SM
+                    c[2] - index of cos(theta) coordinate in coordinate vector
+      Coordinates: x[c[2]] - cosine of the polar angle of the fermion 
+      Parameters: p[0] - change in asymmetry DeltaA_f
+  **/
+  return 1.0 + 0.75 * c[0] / c[1] * x.get_center()[int(c[2])] * (*(p[0]));
+}
+
+template<class C, class P>
+double Physics::asymm_Af_2f_RL (
+  const Data::BinCoord &x,
+  const C   &c,
+  const P  &p
+) {
+  /** (See general description above.)
+      Polar angle-dependent scaling of the RL distribution due to a change in
+      the final state asymmetry.
+      Coefficients: c[0] - total RL cross section @ SM (or: initial prediction)
+                    c[1] - differential RL cross section in this bin @ SM
+                    c[2] - index of cos(theta) coordinate in coordinate vector
+      Coordinates: x[c[2]] - cosine of the polar angle of the fermion 
+      Parameters: p[0] - change in asymmetry DeltaA_f
+  **/
+  return 1.0 - 0.75 * c[0] / c[1] * x.get_center()[int(c[2])] * (*(p[0]));
+}
+
+//------------------------------------------------------------------------------
+
+/** Generalised differential parametrisation in di-fermion production.
+    Derived from the helicity amplitude approach, with additional correction 
+    term to take higher order effects into account.
+    Integrates over the bin to be in agreement with the datapoint.
+    
+    Coordinates: x[c[1]] - cosine of polar angle in ffbar system
+    Coefficients:
+      c[0] - cross section in bin (completely replaced)
+      c[1] - integrated LR cross section
+      c[2] - integrated RL cross section
+      c[3] - index of cos(theta) coordinate in coordinate vector
+    Parameters:
+      p[0] - xs0
+      p[1] - Ae
+      p[2] - Af
+      p[3] - epsilon_f
+      p[4] - k0
+      p[5] - Delta k
+    
+    The bin integrals of the polynomials in cos(theta) and the cross section
+    fraction only depend on the bin and the coefficients, they can be 
+    calculated once (prepare_2f_param) and used in each evaluation of the 
+    prepared functions.
+**/
+
+template<class C>
+std::array<double, 4> Physics::prepare_2f_param(const Data::BinCoord &x,
+                                                const C &c) {
+  /** Bin-constant quantities of the difermion parametrisations (see above).
+      Returns: q[0] - integral of 1 over bin
+               q[1] - integral of cos(theta) over bin
+               q[2] - integral of cos^2(theta) over bin
+               q[3] - cross section fraction c[0] / (c[1] + c[2])
+   **/
+  double x_up = x.get_edge_up()[int(c[3])];
+  double x_low = x.get_edge_low()[int(c[3])];
+  double integral_const = x_up - x_low;
+  double integral_lin = 0.5 * (std::pow(x_up, 2) - std::pow(x_low, 2));
+  double integral_quad = 1.0 / 3.0 * (std::pow(x_up, 3) - std::pow(x_low, 3));
+  
+  double xs_fraction = c[0] / (c[1] + c[2]);
+  
+  return {integral_const, integral_lin, integral_quad, xs_fraction};
+}
+
+template<class C, class P>
+double Physics::general_2f_param_LR(const Data::BinCoord &x,
+                                    const C &c,
+                                    const P &p) {
+  /** LR factor of generalised difermion parametrisation (see above).
+   **/
+  return general_2f_param_LR_prepared(x, prepare_2f_param(x, c), p);
+}
+
+template<class Q, class P>
+double Physics::general_2f_param_LR_prepared(const Data::BinCoord &/*x*/,
+                                             const Q &q,
+                                             const P &p) {
+  /** LR factor of generalised difermion parametrisation (see above) using 
+      the prepared bin-constant quantities q.
+   **/
+  const double integral_const = q[0];
+  const double integral_lin = q[1];
+  const double integral_quad = q[2];
+  const double xs_fraction = q[3];
+  
+  double kL = (*(p[4]) + *(p[5])) / 2.0;
+
+  double factor = 3.0 / 8.0 * (*(p[0])) / xs_fraction * 
+                  (1.0 + (*(p[1]))) / 2.0 * ((1.0 + kL) * integral_const +
+                   ((*(p[3])) + 2.0 * (*(p[2]))) * integral_lin +
+                   (1.0 - 3.0 * kL) * integral_quad);
+  if (factor < 0.0) {
+    factor = 0.0;
+  }
+  return factor;
+}
+
+template<class C, class P>
+double Physics::general_2f_param_RL(const Data::BinCoord &x,
+                                    const C &c,
+                                    const P &p) {
+  /** RL factor of generalised difermion parametrisation (see above).
+   **/
+  return general_2f_param_RL_prepared(x, prepare_2f_param(x, c), p);
+}
+
+template<class Q, class P>
+double Physics::general_2f_param_RL_prepared(const Data::BinCoord &/*x*/,
+                                             const Q &q,
+                                             const P &p) {
+  /** RL factor of generalised difermion parametrisation (see above) using 
+      the prepared bin-constant quantities q.
+   **/
+  const double integral_const = q[0];
+  const double integral_lin = q[1];
+  const double integral_quad = q[2];
+  const double xs_fraction = q[3];
+  
+  double kR = (*(p[4]) - *(p[5])) / 2.0;
+
+  double factor = 3.0 / 8.0 * (*(p[0])) / xs_fraction * 
+                  (1.0 - (*(p[1]))) / 2.0 * ((1.0 + kR) * integral_const +
+                   ((*(p[3])) - 2.0 * (*(p[2]))) * integral_lin +
+                   (1.0 - 3.0 * kR) * integral_quad);
+  if (factor < 0.0) {
+    factor = 0.0;
+  }
+  return factor;
+}
+
+//------------------------------------------------------------------------------
+
+/** Differential parametrisation in unpolarised di-fermion production.
+    Originates from general formula above.
+    It assumes that polarised quantities (e.g. Ae*epsilon_f in constant term) 
+    can be neglected and that Delta-k * Ae can be neglected as well (<=1e-4).
+    It uses the transformation: A_FB = 3/8 * (ef + 2 Ae Af)
+    Integrates over the bin to be in agreement with the datapoint.
+    
+    Coordinates: x[c[1]] - cosine of polar angle in ffbar system
+    Coefficients:
+      c[0] - cross section in bin (completely replaced)
+      c[1] - integrated LR cross section
+      c[2] - integrated RL cross section
+      c[3] - index of cos(theta) coordinate in coordinate vector
+    Parameters:
+      p[0] - xs0
+      p[1] - A_FB
+      p[4] - k0
+    Bin-constant quantities are the same as in the general parametrisation
+    (see prepare_2f_param).
+**/
+
+template<class C, class P>
+double Physics::unpol_2f_param(const Data::BinCoord &x,
+                               const C &c,
+                               const P &p) {
+  /** Factor of unpolarised difermion parametrisation (see above).
+      Factor function is same for LR and RL (coefficient values differ).
+   **/
+  return unpol_2f_param_prepared(x, prepare_2f_param(x, c), p);
+}
+
+template<class Q, class P>
+double Physics::unpol_2f_param_prepared(const Data::BinCoord &/*x*/,
+                                        const Q &q,
+                                        const P &p) {
+  /** Factor of unpolarised difermion parametrisation (see above) using the
+      prepared bin-constant quantities q.
+   **/
+  const double integral_const = q[0];
+  const double integral_lin = q[1];
+  const double integral_quad = q[2];
+  const double xs_fraction = q[3];
+  
+  double factor = 3.0 / 8.0 * (*(p[0])) / xs_fraction * 0.5 *
+                  ((1.0 + (*(p[2]))/2.0) * integral_const +
+                   8.0 / 3.0 * (*(p[1])) * integral_lin +
+                   (1.0 - 3.0 * (*(p[2]))/2.0) * integral_quad);
+  if (factor < 0.0) {
+    factor = 0.0;
+  }
+  return factor;
+}
+
+//------------------------------------------------------------------------------
+
+}
+}
+
+#endif
@@ -12,34 +12,73 @@ namespace Fcts {
 namespace Polynomial {
   /** Namespace for polynomial parametrisation functions.
       Must all follow structure:
+      template<class C=std::vector<double>, class P=std::vector<double*>>
       double fct_name (const Data::BinCoord   &x,
-                        const std::vector<double>   &c,
-                        const std::vector<double*>  &p);
+                        const C                     &c,
+                        const P                     &p);
+      Coefficient values c and parameter pointers p can be any indexable
+      containers, std::vector in general and std::array in the typed 
+      function registry (see FctRegistry.h).
   **/
   
+  template<class C=std::vector<double>, class P=std::vector<double*>>
   double constant_coef ( const Data::BinCoord        &x,
-                         const std::vector<double>   &c,
-                         const std::vector<double*>  &p);
+                         const C                     &c,
+                         const P                     &p);
   
+  template<class C=std::vector<double>, class P=std::vector<double*>>
   double constant_par ( const Data::BinCoord        &x,
-                        const std::vector<double>   &c,
-                        const std::vector<double*>  &p);
+                        const C                     &c,
+                        const P                     &p);
                         
+  template<class C=std::vector<double>, class P=std::vector<double*>>
   double linear_3D_coeff ( const Data::BinCoord        &x,
-                        const std::vector<double>   &c,
-                        const std::vector<double*>  &p);
+                        const C                     &c,
+                        const P                     &p);
                         
+  template<class C=std::vector<double>, class P=std::vector<double*>>
   double quadratic_1D ( const Data::BinCoord        &x,
-                        const std::vector<double>   &c,
-                        const std::vector<double*>  &p);
+                        const C                     &c,
+                        const P                     &p);
                         
+  template<class C=std::vector<double>, class P=std::vector<double*>>
   double quadratic_3D_coeff ( const Data::BinCoord        &x,
+                              const C                     &c,
+                              const P                     &p);
+  
+  /** Partial derivatives w.r.t. the parameters.
+      Must all follow structure:
+      void fct_name_grad (const Data::BinCoord   &x,
+                          const std::vector<double>   &c,
+                          const std::vector<double*>  &p,
+                          std::vector<double>  *grad);
+  **/
+  
+  void constant_par_grad ( const Data::BinCoord        &x,
+                           const std::vector<double>   &c,
+                           const std::vector<double*>  &p,
+                           std::vector<double>  *grad);
+                        
+  void linear_3D_coeff_grad ( const Data::BinCoord        &x,
                               const std::vector<double>   &c,
-                              const std::vector<double*>  &p);
+                              const std::vector<double*>  &p,
+                              std::vector<double>  *grad);
+                        
+  void quadratic_1D_grad ( const Data::BinCoord        &x,
+                           const std::vector<double>   &c,
+                           const std::vector<double*>  &p,
+                           std::vector<double>  *grad);
+                        
+  void quadratic_3D_coeff_grad ( const Data::BinCoord        &x,
+                                 const std::vector<double>   &c,
+                                 const std::vector<double*>  &p,
+                                 std::vector<double>  *grad);
                         
 }
   
 }
 }
 
+#include <Fcts/Polynomial.tpp>
+
 #endif
\ No newline at end of file
@@ -12,17 +12,37 @@ namespace Fcts {
 namespace Statistic {
   /** Namespace for parametrisation functions from statistics.
       Must all follow structure:
+      template<class C=std::vector<double>, class P=std::vector<double*>>
       double fct_name (const Data::BinCoord   &x,
-                        const std::vector<double>   &c,
-                        const std::vector<double*>  &p);
+                        const C                     &c,
+                        const P                     &p);
+      Coefficient values c and parameter pointers p can be any indexable
+      containers, std::vector in general and std::array in the typed 
+      function registry (see FctRegistry.h).
   **/
   
+  template<class C=std::vector<double>, class P=std::vector<double*>>
   double gaussian_1D (const Data::BinCoord        &x,
-                      const std::vector<double>   &c,
-                      const std::vector<double*>  &p);
+                      const C                     &c,
+                      const P                     &p);
+  
+  /** Partial derivatives w.r.t. the parameters.
+      Must all follow structure:
+      void fct_name_grad (const Data::BinCoord   &x,
+                          const std::vector<double>   &c,
+                          const std::vector<double*>  &p,
+                          std::vector<double>  *grad);
+  **/
+  
+  void gaussian_1D_grad (const Data::BinCoord        &x,
+                         const std::vector<double>   &c,
+                         const std::vector<double*>  &p,
+                         std::vector<double>  *grad);
 }
   
 }
 }
 
+#include <Fcts/Statistic.tpp>
+
 #endif
\ No newline at end of file
@@ -0,0 +1,36 @@
+#ifndef LIB_STATISTIC_TPP
+#define LIB_STATISTIC_TPP 1
+
+#include <Fcts/Statistic.h>
+
+#include <exception>
+#include <math.h>
+
+namespace PrEW {
+namespace Fcts {
+
+//------------------------------------------------------------------------------
+
+template<class C, class P>
+double Statistic::gaussian_1D ( 
+  const Data::BinCoord &x,
+  const C &/*c*/,
+  const P &p
+) {
+  /** Gaussian function in 1D.
+      Parameters: p[0] - amplitude
+                  p[1] - mean
+                  p[2] - width
+      No coefficients required.
+  **/
+  
+  return (*(p[0])) / (  (*(p[2])) * std::sqrt(2.0*M_PI) ) 
+         * std::exp( -0.5 * std::pow( ( x.get_center()[0] - (*(p[1])) ) / (*(p[2])) ,2) );
+}
+
+//------------------------------------------------------------------------------
+
+}
+}
+
+#endif
@@ -12,30 +12,67 @@ namespace Fcts {
 namespace Systematics {
   /** Namespace for parametrisation functions from systematic effects.
       Must all follow structure:
+      template<class C=std::vector<double>, class P=std::vector<double*>>
       double fct_name (const Data::BinCoord   &x,
-                        const std::vector<double>   &c,
-                        const std::vector<double*>  &p);
+                        const C                     &c,
+                        const P                     &p);
+      Coefficient values c and parameter pointers p can be any indexable
+      containers, std::vector in general and std::array in the typed 
+      function registry (see FctRegistry.h).
   **/
   
   //----------------------------------------------------------------------------
   
+  template<class C=std::vector<double>, class P=std::vector<double*>>
   double polarisation_factor (const Data::BinCoord        &x,
-                              const std::vector<double>   &c,
-                              const std::vector<double*>  &p);
+                              const C                     &c,
+                              const P                     &p);
   
+  template<class C=std::vector<double>, class P=std::vector<double*>>
   double luminosity_fraction (const Data::BinCoord        &x,
-                              const std::vector<double>   &c,
-                              const std::vector<double*>  &p);
+                              const C                     &c,
+                              const P                     &p);
                               
   //----------------------------------------------------------------------------
   
+  template<class C=std::vector<double>, class P=std::vector<double*>>
   double acceptance_box (const Data::BinCoord        &x,
-                         const std::vector<double>   &c,
-                         const std::vector<double*>  &p);
+                         const C                     &c,
+                         const P                     &p);
     
+  template<class C=std::vector<double>, class P=std::vector<double*>>
   double acceptance_box_polynomial (const Data::BinCoord       &x,
-                                    const std::vector<double>  &c,
-                                    const std::vector<double*> &p);
+                                    const C                    &c,
+                                    const P                    &p);
+    
+  //----------------------------------------------------------------------------
+  /** Partial derivatives w.r.t. the parameters.
+      Must all follow structure:
+      void fct_name_grad (const Data::BinCoord   &x,
+                          const std::vector<double>   &c,
+                          const std::vector<double*>  &p,
+                          std::vector<double>  *grad);
+  **/
+  
+  void polarisation_factor_grad (const Data::BinCoord        &x,
+                                 const std::vector<double>   &c,
+                                 const std::vector<double*>  &p,
+                                 std::vector<double>  *grad);
+  
+  void luminosity_fraction_grad (const Data::BinCoord        &x,
+                                 const std::vector<double>   &c,
+                                 const std::vector<double*>  &p,
+                                 std::vector<double>  *grad);
+  
+  void acceptance_box_grad (const Data::BinCoord        &x,
+                            const std::vector<double>   &c,
+                            const std::vector<double*>  &p,
+                            std::vector<double>  *grad);
+    
+  void acceptance_box_polynomial_grad (const Data::BinCoord       &x,
+                                       const std::vector<double>  &c,
+                                       const std::vector<double*> &p,
+                                       std::vector<double>  *grad);
     
   //----------------------------------------------------------------------------
   
@@ -44,4 +81,6 @@ namespace Systematics {
 } // Namespace Fcts
 } // Namespace PrEW
 
+#include <Fcts/Systematics.tpp>
+
 #endif
\ No newline at end of file
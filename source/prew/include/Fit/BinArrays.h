@@ -0,0 +1,41 @@
+#ifndef LIB_BINARRAYS_H
+#define LIB_BINARRAYS_H 1
+
+#include <CppUtils/Vec.h>
+#include <Fit/FitBin.h>
+
+#include <vector>
+
+namespace PrEW {
+namespace Fit {
+  
+  struct BinArrays {
+    /** Structure-of-arrays form of the bin values used by the minimizers.
+        Values of all bins are contiguous and aligned so that loops over the
+        bins can be vectorised. The inverse variance is precomputed to avoid 
+        a division per bin and evaluation.
+        Measured values are copied from the bins (=> need to be refilled if 
+        the bins change), predictions are written by the prediction evaluator.
+    **/
+    
+    CppUtils::Vec::AlignedVec<double> m_vals_mst {}; // Measured values
+    CppUtils::Vec::AlignedVec<double> m_inv_vars {}; // 1 / uncertainty^2
+    CppUtils::Vec::AlignedVec<double> m_prds {};     // Predictions
+    
+    // Constructors
+    BinArrays() = default;
+    BinArrays(const BinVec & bins);
+    
+    void set_measurements(const BinVec & bins);
+    size_t size() const;
+    
+    // Chi-squared contribution and its derivatives w.r.t. the predictions
+    double calc_chisq(size_t bin_begin, size_t bin_end) const;
+    void calc_chisq_derivs( size_t bin_begin, size_t bin_end, 
+                            double * derivs ) const;
+  };
+  
+}
+}
+
+#endif
@@ -4,8 +4,10 @@
 #include <Fit/FitContainer.h>
 #include <Fit/MinuitFactory.h>
 #include <Fit/FitResult.h>
+#include <Fit/PrdEvaluator.h>
 
 #include <memory>
+#include <vector>
 
 #include "Minuit2/Minuit2Minimizer.h"
 
@@ -17,30 +19,52 @@ namespace Fit {
         Takes the fit parameters and the bins (whose prediction is connected
         to the fit parameters).
         Bins cannot (!) be correlated except through common fit parameters.
+        If the predictions are compiled with derivatives of all functions the
+        analytic gradient is given to the minimizer.
+        Measured values and uncertainties of the bins are taken from the 
+        container when the minimizer is created (or reset).
+        Minimizations can be started from a previous result including its
+        covariance matrix (see set_start).
     **/
   
   // Input
   FitContainer * m_container {}; // Container with bins and parameters
   std::unique_ptr<ROOT::Minuit2::Minuit2Minimizer> m_minimizer; // Minimizer created by factory
+  FitResult m_start {}; // Previous result to start from (optional)
   
   // Output
   double m_chisq {};
+  std::vector<double> m_chisq_grad {}; // Gradient w.r.t. all parameters
+  std::vector<double> m_grad_pars {}; // Point of the last gradient
   FitResult m_result {};
   
+  // Evaluation of bin predictions (in chunks, possibly in parallel)
+  PrdEvaluator m_evaluator;
+  std::vector<double> m_chunk_sums {};
+  
   // Internal functions
-  void update_chisq();
+  void update_chisq(const double * par_vals=nullptr);
+  void update_chisq_grad(const double * par_vals=nullptr);
+  void sum_up_chisq();
   
   void collect_par_names();
   void update_result();
   
   public:
     // Constructors
-    ChiSqMinimizer(FitContainer * container, const MinuitFactory &factory);
+    ChiSqMinimizer(
+      FitContainer * container, 
+      const MinuitFactory &factory,
+      size_t n_threads=1
+    );
     
+    void set_start(const FitResult & start);
     void minimize();
+    void reset();
     
     // Get function
     double get_chisq() const;
+    const std::vector<double> & get_chisq_grad() const;
     const FitResult& get_result() const;
   };
   
@@ -2,38 +2,47 @@
 #define LIB_FITBIN_H 1
 
 #include <functional>
+#include <memory>
 #include <vector>
 
 namespace PrEW {
 namespace Fit {
   
+  // Prediction function of a bin, parameters are referred to by their index in
+  // the parameter-value array given at evaluation (followed by the shared 
+  // prediction terms of the fit container if it has any, see PrdTerms)
+  using PrdFct = std::function<double(const double * par_vals)>;
+  
   class FitBin {
     /** Class describing the prediction for a bin depending on a set of fit 
         parameters.
+        The prediction function doesn't point to the parameters and doesn't
+        store anything, so bins can be copied freely (copies share the 
+        prediction function, which can be evaluated in several threads).
     **/
     
     double m_val_mst {}; // measured value
     double m_val_unc {}; // measurement uncertainty
     
-    // Prediction function (includes dependece on fit parameters as pointers!!!)
-    std::function<double()> m_prd_fct {};  
+    // Prediction function (shared between copies, never modified)
+    std::shared_ptr<const PrdFct> m_prd_fct {};  
     
     public:
       // Constructors
       FitBin(
         double val_mst=0, 
         double val_unc=0, 
-        std::function<double()> prd_fct=NULL
+        PrdFct prd_fct=NULL
       );
       
       void set_val_mst(double val_mst);
       void set_val_unc(double val_unc);
-      void set_prd_fct(std::function<double()> prd_fct); // Set prediction fct.
+      void set_prd_fct(PrdFct prd_fct); // Set prediction fct.
       
       double get_val_mst() const; // Get measured value
       double get_val_unc() const; // Get measurement uncertainty
       
-      double get_val_prd() const;
+      double get_val_prd(const double * par_vals) const;
   };
 
   typedef std::vector<FitBin> BinVec;
@@ -1,8 +1,14 @@
 #ifndef LIB_FITCONTAINER_H
 #define LIB_FITCONTAINER_H 1
 
+#include <Data/BinCoord.h>
+#include <Data/DiffDistr.h>
+#include <Data/DistrInfo.h>
 #include <Fit/FitBin.h>
 #include <Fit/FitPar.h>
+#include <Fit/ParBinIndex.h>
+#include <Fit/PrdProgram.h>
+#include <Fit/PrdTerms.h>
 
 #include <vector>
 
@@ -13,11 +19,37 @@ namespace Fit {
     /** Class to hold complete set of bins and corresponding fit parameters that
         are to be used in the chi-squared minimization.
     **/
+    
+    // Binning of a distribution the bins were filled from
+    struct DistrBinning {
+      Data::DistrInfo m_info {};
+      Data::CoordVec m_coords {};
+      size_t m_n_bins {};
+    };
   
     // Fit parameters 
     ParVec m_fit_pars {}; 
     // Bins (whose prediction is connected to the parameters and coefficients)
     BinVec m_fit_bins {}; 
+    // Compiled predictions of all bins (optional, if used bins don't need a
+    // prediction function)
+    PrdProgram m_prd_program {};
+    // Terms shared by the bound predictions of several bins (optional, if
+    // used the bound predictions take them behind the parameter values)
+    PrdTerms m_prd_terms {};
+    // Which bins depend on which parameters (optional, if empty all bins are
+    // assumed to depend on all parameters)
+    ParBinIndex m_par_bin_index {};
+    // Distributions the bins were filled from, in order of the bins
+    // (optional, if empty only the total number of bins can be checked)
+    std::vector<DistrBinning> m_distr_binnings {};
+    
+    // Modifying functions (keep the connections between bins and parameters)
+    void update_measurements(const Data::DiffDistrVec & diff_distrs);
+    void update_pars(const ParVec & pars);
+    
+    // Evaluating the predictions (checked, for single evaluations)
+    std::vector<double> get_val_prd(const std::vector<double> & par_vals) const;
   };
 
 }
@@ -56,6 +56,7 @@ namespace Fit {
       double get_constr_val() const;
       double get_constr_unc() const;
       double calc_constr_chisq() const; // Chi-squared produced by constraint
+      double calc_constr_chisq_deriv() const; // Derivative w.r.t. value
       
       void fix();     // fix the parameter
       void release(); // release the parameter
@@ -69,6 +70,10 @@ namespace Fit {
   
   typedef std::vector<FitPar> ParVec;
   
+  // Current (modified) values of the parameters, in the order of the vector
+  // (as needed for evaluating bound predictions)
+  std::vector<double> get_par_vals(const ParVec & pars);
+  
 }
 }
 
@@ -0,0 +1,29 @@
+#ifndef LIB_MINUITHELP_H
+#define LIB_MINUITHELP_H 1
+
+#include <Fit/FitPar.h>
+#include <Fit/FitResult.h>
+
+#include "Minuit2/Minuit2Minimizer.h"
+
+namespace PrEW {
+namespace Fit {
+
+namespace MinuitHelp {
+  /** Functions that help setting up the Minuit2 minimizer of the different
+      minimizers the same way.
+  **/
+
+  void check_start( const FitResult & start, const ParVec & pars );
+
+  void set_variables(
+    const ParVec & pars,
+    const FitResult & start,
+    ROOT::Minuit2::Minuit2Minimizer * minimizer
+  );
+}
+
+}
+}
+
+#endif
@@ -0,0 +1,49 @@
+#ifndef LIB_PARARRAYS_H
+#define LIB_PARARRAYS_H 1
+
+#include <Fit/FitPar.h>
+
+#include <vector>
+
+namespace PrEW {
+namespace Fit {
+
+  struct ParArrays {
+    /** Structure-of-arrays form of the fit parameters used by the minimizers.
+        Current values of all parameters are contiguous (in the order of the
+        parameter vector) so that they can be taken from the minimizer as
+        they are and be read by the bin predictions.
+        Constraints are only stored for the parameters on which they are
+        active (constrained and not fixed) => constraint terms are evaluated
+        without checking every parameter.
+        Everything is copied from the parameters (=> needs to be refilled if
+        parameters are fixed, released or constrained).
+    **/
+
+    std::vector<double> m_vals {}; // Current values of all parameters
+
+    // Active constraints
+    std::vector<size_t> m_constr_idxs {}; // Index of constrained parameter
+    std::vector<double> m_constr_vals {};
+    std::vector<double> m_constr_uncs {};
+
+    // Constructors
+    ParArrays() = default;
+    ParArrays(const ParVec & pars);
+
+    void set_pars(const ParVec & pars);
+    void set_vals(const double * vals);
+    void write_vals(ParVec * pars) const;
+    size_t size() const;
+    size_t get_n_constrs() const;
+
+    // Chi-squared contribution of a constraint and its derivative w.r.t. the
+    // parameter value
+    double calc_constr_chisq(size_t i_constr) const;
+    double calc_constr_chisq_deriv(size_t i_constr) const;
+  };
+
+}
+}
+
+#endif
@@ -0,0 +1,47 @@
+#ifndef LIB_PARBININDEX_H
+#define LIB_PARBININDEX_H 1
+
+#include <cstddef>
+#include <vector>
+
+namespace PrEW {
+namespace Fit {
+  
+  struct BinRange {
+    // Bins [m_begin, m_end) of a bin vector
+    size_t m_begin {};
+    size_t m_end {};
+  };
+  
+  class ParBinIndex {
+    /** Index which bins depend on which parameter (by index in parameter and 
+        bin vector).
+        Bins are recorded as ranges (typically one per distribution), the 
+        ranges of each parameter are kept sorted and merged.
+        An empty index contains no information, in that case all bins have
+        to be assumed to depend on all parameters.
+    **/
+    
+    std::vector<std::vector<BinRange>> m_par_ranges {};
+    
+    // Internal functions
+    static void add_range(const BinRange & range, std::vector<BinRange> *ranges);
+    
+    public:
+      // Modifying functions
+      void add_bins( const std::vector<size_t> & par_idxs, 
+                     size_t bin_begin, size_t bin_end );
+      void clear();
+      
+      // Access functions
+      bool is_empty() const;
+      size_t get_n_pars() const;
+      const std::vector<BinRange> & get_bin_ranges(size_t par_idx) const;
+      std::vector<BinRange> get_bin_ranges(
+        const std::vector<size_t> & par_idxs) const;
+  };
+  
+}
+}
+
+#endif
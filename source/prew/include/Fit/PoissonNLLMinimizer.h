@@ -4,8 +4,10 @@
 #include <Fit/FitContainer.h>
 #include <Fit/MinuitFactory.h>
 #include <Fit/FitResult.h>
+#include <Fit/PrdEvaluator.h>
 
 #include <memory>
+#include <vector>
 
 #include "Minuit2/Minuit2Minimizer.h"
 
@@ -21,32 +23,57 @@ namespace Fit {
         to the fit parameters).
         The uncertainty of the measurement bins is not explicitely used 
         because the Likelihood assumes a Poissonian fluctuation.
+        If the predictions are compiled with derivatives of all functions the
+        analytic gradient is given to the minimizer.
+        Measured values of the bins are taken from the container when the 
+        minimizer is created (or reset).
+        Minimizations can be started from a previous result including its
+        covariance matrix (see set_start).
     **/
   
     // Input
     FitContainer * m_container {}; // Container with bins and parameters
     std::unique_ptr<ROOT::Minuit2::Minuit2Minimizer> m_minimizer; // Minimizer created by factory
+    FitResult m_start {}; // Previous result to start from (optional)
     
     // Output
     double m_nll {}; // Current value of the negative log-likelihood
+    std::vector<double> m_nll_grad {}; // Gradient w.r.t. all parameters
+    std::vector<double> m_grad_pars {}; // Point of the last gradient
     FitResult m_result {};
     
+    // Evaluation of bin predictions (in chunks, possibly in parallel)
+    PrdEvaluator m_evaluator;
+    std::vector<double> m_chunk_sums {};
+    std::vector<double> m_chunk_comps {}; // Kahan compensations of chunks
+    
     // Internal functions
     double nll_poisson(int n, double mu) const;
     double nll_gaussian(double x, double mu, double sigma) const;
-    void update_nll();
+    double nll_bin(double x, double mu) const;
+    double nll_bin_deriv(double x, double mu) const;
+    void update_nll(const double * par_vals=nullptr);
+    void update_nll_grad(const double * par_vals=nullptr);
+    void sum_up_nll();
     
     void collect_par_names();
     void update_result();
     
     public:
       // Constructors
-      PoissonNLLMinimizer(FitContainer * container, const MinuitFactory &factory);
+      PoissonNLLMinimizer(
+        FitContainer * container, 
+        const MinuitFactory &factory,
+        size_t n_threads=1
+      );
       
+      void set_start(const FitResult & start);
       void minimize();
+      void reset();
       
       // Get function
       double get_nll() const;
+      const std::vector<double> & get_nll_grad() const;
       const FitResult& get_result() const;
   };
   
@@ -0,0 +1,109 @@
+#ifndef LIB_PRDEVALUATOR_H
+#define LIB_PRDEVALUATOR_H 1
+
+#include <CppUtils/ThreadPool.h>
+#include <CppUtils/Vec.h>
+#include <Fit/BinArrays.h>
+#include <Fit/FitContainer.h>
+#include <Fit/ParArrays.h>
+#include <Fit/PrdProgram.h>
+
+#include <functional>
+#include <memory>
+#include <vector>
+
+namespace PrEW {
+namespace Fit {
+
+  class PrdEvaluator {
+    /** Evaluates the bin predictions of a fit container.
+        Bins are split into chunks of fixed size which can be evaluated in
+        parallel. Chunking does not depend on the number of threads, so
+        anything calculated per chunk (and combined in chunk order) gives
+        identical results for any number of threads.
+        Uses the compiled prediction program of the container if there is
+        one, otherwise the prediction functions of the bins. Shared terms of 
+        the bound predictions (see PrdTerms) are calculated once per 
+        evaluation into memory of the evaluator, evaluators of copied
+        containers share nothing.
+        With a compiled program that has all derivatives the gradient of a
+        weighted sum of the predictions can be calculated as well.
+        Predictions are stored together with the measured values of the bins
+        in contiguous arrays (see BinArrays), the measured values are taken 
+        from the container at construction (see update_measurements).
+        Using the parameter-bin index of the container, only chunks with bins
+        that depend on changed parameters can be re-evaluated (see 
+        evaluate_changed).
+        Parameter values and constraints are kept in contiguous arrays as well
+        (see ParArrays). Evaluations can take the parameter values directly 
+        from a contiguous array (e.g. from the minimizer), the parameters of
+        the container are then not touched.
+    **/
+
+    public:
+      using ChunkFct = std::function<void(size_t chunk, size_t bin_begin,
+                                          size_t bin_end)>;
+      using GradChunkFct = std::function<void(size_t chunk, size_t bin_begin,
+                                              size_t bin_end, double * weights)>;
+
+    private:
+      FitContainer * m_container {};
+      size_t m_bins_per_chunk {};
+      std::unique_ptr<CppUtils::ThreadPool> m_pool;
+
+      // Memory for evaluating the bin predictions
+      ParArrays m_par_arrays {};
+      BinArrays m_bin_arrays {};
+      std::vector<double> m_prd_vals {};
+      std::vector<double> m_bound_vals {}; // Parameters + shared terms
+      std::vector<PrdProgram::Scratch> m_scratches {}; // One per thread
+
+      // Parameter values at which all predictions are up to date
+      bool m_prds_valid {false};
+      std::vector<double> m_last_par_vals {};
+      std::vector<size_t> m_changed_chunks {}; // Chunks to (re-)evaluate
+      std::vector<size_t> m_changed_groups {}; // Term groups to (re-)evaluate
+
+      // Memory for the gradient (per chunk => independent of number of threads)
+      std::vector<double> m_weights {};
+      std::vector<double> m_adjs {};
+      std::vector<std::vector<double>> m_chunk_grads {};
+      std::vector<std::vector<double>> m_chunk_scalar_adjs {};
+
+      // Internal functions
+      void update_chunk_prds(size_t bin_begin, size_t bin_end, size_t thread);
+      void update_scalars(const double * par_vals);
+      void update_terms(bool all);
+      void find_changed_chunks();
+      void run_chunks(const ChunkFct & chunk_fct);
+
+    public:
+      // Constructors
+      PrdEvaluator( FitContainer * container,
+                    size_t n_threads=1,
+                    size_t bins_per_chunk=1024 );
+
+      // Access functions
+      size_t get_n_threads() const;
+      size_t get_n_chunks() const;
+      const CppUtils::Vec::AlignedVec<double> & get_prds() const;
+      const BinArrays & get_bin_arrays() const;
+      const ParArrays & get_par_arrays() const;
+      bool has_gradient() const;
+
+      // Core functionality
+      void update_measurements();
+      void update_pars();
+      void evaluate( const ChunkFct & chunk_fct, 
+                     const double * par_vals=nullptr );
+      void evaluate_changed( const ChunkFct & chunk_fct,
+                             const double * par_vals=nullptr );
+      void evaluate_gradient( const GradChunkFct & chunk_fct,
+                              std::vector<double> * grad,
+                              const double * par_vals=nullptr );
+  };
+
+}
+}
+
+#endif
@@ -0,0 +1,245 @@
+#ifndef LIB_PRDPROGRAM_H
+#define LIB_PRDPROGRAM_H 1
+
+#include <Data/BinCoord.h>
+#include <Fcts/FctRegistry.h>
+#include <Fcts/ParametrisationFct.h>
+
+#include <string>
+#include <vector>
+
+namespace PrEW {
+namespace Fit {
+
+  class PrdProgram {
+    /** Compiled (flat) form of the bin predictions.
+        Instead of one nested closure per bin the program holds a table of
+        operations, each operation acting on a whole column of values
+        (one row per bin of a distribution):
+          Call : f(x,c,p) with f a parametrisation function, x the bin
+                 coordinate, c the coefficients and p the parameters
+          Prod : (optional constant column) * product of the input columns
+          Sum  : sum of the input columns
+        Columns with the same number of rows are grouped in segments.
+        Segment 0 is always present and holds single-row columns that are the
+        same for all bins (e.g. polarisation factors), those can be used as
+        input in any other segment and are evaluated first.
+        Shared segments hold columns that several segments with the same 
+        number of rows use (e.g. modified chiral cross sections of all
+        polarisation configurations of a distribution). Like the scalars they
+        are evaluated once before the bins (all rows), their columns can be 
+        used as input in any later segment with the same number of rows, but
+        they have no bins themselves.
+        Parameters are referenced by their index in the parameter vector, their
+        values are only supplied when the program is evaluated.
+        Calls in the scalar segment that are identical to an existing call
+        (same function, coefficient values and parameters) are not added 
+        again, the existing call is used instead.
+        Functions from the function registry are evaluated with their typed
+        version for a whole block of rows at once (bin-constant quantities of
+        functions with a preparation are calculated when the call is added),
+        others row by row with vector arguments.
+        If all called functions have analytic derivatives the gradient of a
+        weighted sum of the bin predictions can be calculated by going through
+        the operations backwards (see backprop_bins and backprop_scalars).
+        Adjoints of scalars and shared columns are collected separately from
+        the adjoint storage (scalar adjoints, see get_n_scalar_adjs).
+    **/
+
+    public:
+      enum class OpCode { Call, Prod, Sum };
+
+      struct Ref {
+        /** Reference to a column in the value or constant storage.
+            Stride 0 means the single value is used for every row.
+        **/
+        size_t m_offset {};
+        size_t m_stride {};
+      };
+
+      struct Op {
+        OpCode m_code {};
+        size_t m_out {};     // Offset of output column in value storage
+        size_t m_fct {};     // Index of function in function table (Call)
+        bool   m_has_const {}; // Prod: start from constant column
+        Ref    m_const {};     // Prod: constant column
+        size_t m_in_begin {};  // First input reference in m_refs
+        size_t m_n_in {};      // Number of inputs (coefficients for Call)
+        size_t m_par_begin {}; // First parameter index in m_par_idxs (Call)
+        size_t m_n_pars {};    // Number of parameters (Call)
+        Fcts::RowsFct m_rows {}; // Typed version of function (Call, optional)
+        size_t m_prep_begin {};  // First prepared column in m_refs (Call)
+        size_t m_n_prep {};      // Number of prepared columns (Call)
+      };
+
+      struct Segment {
+        size_t m_n_rows {};       // Number of rows of all columns in segment
+        size_t m_coord_begin {};  // First coordinate of segment in m_coords
+        size_t m_val_begin {};    // First value of segment in value storage
+        bool m_is_shared {};      // Columns can be used in later segments
+        std::vector<Op> m_ops {}; // Operations in order of evaluation
+      };
+
+      struct Scratch {
+        /** Memory needed for the function calls, one per evaluating thread.
+        **/
+        std::vector<double> m_c {};       // Coefficients of current call
+        std::vector<double> m_p_vals {};  // Parameter values of current call
+        std::vector<double*> m_p {};      // Pointers to m_p_vals
+        std::vector<double> m_grad {};    // Derivatives of current call
+        std::vector<double*> m_in_adjs {}; // Adjoints of op inputs
+        std::vector<const double*> m_c_cols {}; // Coefficient columns (typed)
+        std::vector<size_t> m_c_strides {};     // Coefficient strides (typed)
+      };
+
+      struct Workspace {
+        /** Memory needed while evaluating a program.
+            Kept outside the program so the program itself is never modified
+            during evaluation.
+        **/
+        std::vector<double> m_vals {};    // Value storage
+        std::vector<double> m_adjs {};    // Adjoint storage (gradient only)
+        std::vector<double> m_scalar_adjs {}; // Adjoints of scalars+shared
+        Scratch m_scratch {};
+      };
+
+    private:
+      // Function table, functions are identified by their name
+      std::vector<std::string> m_fct_names {};
+      std::vector<Fcts::ParametrisationFct> m_fcts {};
+      std::vector<Fcts::ParametrisationGrad> m_grads {}; // Empty if unknown
+
+      Data::CoordVec m_coords {};          // Bin coordinates of all segments
+      std::vector<double> m_consts {};     // Constant storage
+      std::vector<Ref> m_refs {};          // Input references of all ops
+      std::vector<size_t> m_par_idxs {};   // Parameter indices of all calls
+      std::vector<Segment> m_segments {};
+      size_t m_n_vals {};                  // Size of value storage
+      size_t m_last_seg_vals {};           // First value of newest segment
+
+      struct BinBlock {
+        // Bins whose predictions are the rows of a column of one segment
+        size_t m_segment {};
+        size_t m_first_bin {};
+        Ref m_col {};
+      };
+      std::vector<BinBlock> m_bin_blocks {};
+      size_t m_n_bins {};
+
+      struct SharedCol {
+        // Column of a shared segment, its adjoints are behind the scalars
+        size_t m_offset {};   // Offset in value storage
+        size_t m_n_rows {};
+        size_t m_adj_begin {}; // First adjoint (counted from first shared)
+      };
+      std::vector<SharedCol> m_shared_cols {};
+      size_t m_n_shared_vals {};
+
+      // Internal functions
+      size_t add_fct( const std::string & fct_name,
+                      const Fcts::ParametrisationFct & fct,
+                      const Fcts::ParametrisationGrad & grad );
+      void check_call( size_t segment, const std::vector<Ref> & coefs ) const;
+      bool find_scalar_call( size_t segment,
+                             const std::string & fct_name,
+                             const std::vector<Ref> & coefs,
+                             const std::vector<size_t> & par_idxs,
+                             Ref * ref ) const;
+      Op call_op( const std::string & fct_name,
+                  const Fcts::ParametrisationFct & fct,
+                  const std::vector<size_t> & par_idxs,
+                  const Fcts::ParametrisationGrad & grad );
+      void add_prepared( size_t segment,
+                         const Fcts::FctEntry & entry,
+                         const std::vector<Ref> & coefs,
+                         Op * op );
+      Ref add_op(size_t segment, Op op, const std::vector<Ref> & inputs);
+      void check_input(size_t segment, const Ref & input) const;
+      void check_const(size_t segment, const Ref & constant) const;
+      void eval_op( const Op & op, const Segment & segment,
+                    size_t row_begin, size_t row_end,
+                    const double * par_vals, double * vals,
+                    Scratch * scratch ) const;
+      size_t scalar_index(size_t offset) const;
+      const SharedCol * find_shared_col(size_t offset) const;
+      double * get_adjs( const Segment & segment, const Ref & ref,
+                         double * adjs, double * scalar_adjs ) const;
+      void backprop_op( const Op & op, const Segment & segment,
+                        size_t row_begin, size_t row_end,
+                        const double * par_vals, const double * vals,
+                        double * adjs, double * scalar_adjs,
+                        Scratch * scratch, double * par_grad ) const;
+
+    public:
+      // Constructors
+      PrdProgram();
+
+      // Building the program
+      size_t add_segment(const Data::CoordVec & coords);
+      size_t add_shared_segment(const Data::CoordVec & coords);
+      Ref add_const(double val);
+      Ref add_const(const std::vector<double> & col);
+      Ref add_call( size_t segment,
+                    const std::string & fct_name,
+                    const Fcts::ParametrisationFct & fct,
+                    const std::vector<Ref> & coefs,
+                    const std::vector<size_t> & par_idxs,
+                    const Fcts::ParametrisationGrad & grad = {} );
+      Ref add_call( size_t segment,
+                    const std::string & fct_name,
+                    const Fcts::FctEntry & entry,
+                    const std::vector<Ref> & coefs,
+                    const std::vector<size_t> & par_idxs );
+      Ref add_prod(size_t segment, const std::vector<Ref> & inputs);
+      Ref add_prod( size_t segment,
+                    const std::vector<Ref> & inputs,
+                    const Ref & constant );
+      Ref add_sum(size_t segment, const std::vector<Ref> & inputs);
+      void add_bins(size_t segment, const Ref & col);
+
+      // Access functions
+      size_t get_n_bins() const;
+      size_t get_n_segments() const;
+      size_t get_n_ops() const;
+      size_t get_n_vals() const;
+      size_t get_n_scalars() const;
+      size_t get_n_scalar_adjs() const;
+      bool has_gradient() const;
+
+      // Evaluation
+      void evaluate_scalars( const double * par_vals,
+                             double * vals,
+                             Scratch * scratch ) const;
+      void evaluate_bins( size_t bin_begin, size_t bin_end,
+                          const double * par_vals,
+                          double * vals,
+                          Scratch * scratch,
+                          double * prds ) const;
+      void evaluate( const double * par_vals,
+                     Workspace * ws,
+                     std::vector<double> * prds ) const;
+
+      // Gradient (reverse mode)
+      void backprop_bins( size_t bin_begin, size_t bin_end,
+                          const double * par_vals,
+                          const double * vals,
+                          const double * weights,
+                          double * adjs,
+                          double * scalar_adjs,
+                          Scratch * scratch,
+                          double * par_grad ) const;
+      void backprop_scalars( const double * par_vals,
+                             const double * vals,
+                             double * scalar_adjs,
+                             Scratch * scratch,
+                             double * par_grad ) const;
+      void gradient( const double * par_vals,
+                     const std::vector<double> & weights,
+                     Workspace * ws,
+                     std::vector<double> * par_grad ) const;
+  };
+
+}
+}
+
+#endif
@@ -0,0 +1,65 @@
+#ifndef LIB_PRDTERMS_H
+#define LIB_PRDTERMS_H 1
+
+#include <functional>
+#include <memory>
+#include <vector>
+
+namespace PrEW {
+namespace Fit {
+
+  class PrdTerms {
+    /** Terms that the bound predictions of several bins have in common (e.g.
+        the modified chiral cross sections of a bin that all polarisation
+        configurations use).
+        The terms are calculated once per evaluation by whoever evaluates the
+        predictions (see PrdEvaluator) and placed behind the parameter values
+        in the value array given to the predictions.
+        => Predictions refer to a term by its index in that array, just like
+           to a parameter.
+        Terms are calculated in groups, each by one function that only depends
+        on the given parameters. The functions don't store anything, so copies
+        of the terms (e.g. in a copied fit container) share no mutable state.
+    **/
+
+    public:
+      using ParIdxs = std::shared_ptr<const std::vector<size_t>>;
+      using TermFct =
+        std::function<void(const double * par_vals, double * terms)>;
+
+    private:
+      struct Group {
+        size_t m_begin {}; // Index of the first term in the value array
+        size_t m_n_terms {};
+        ParIdxs m_par_idxs {}; // Parameters the terms depend on
+        std::shared_ptr<const TermFct> m_fct {};
+      };
+
+      size_t m_n_pars {};
+      size_t m_n_vals {};
+      std::vector<Group> m_groups {};
+
+    public:
+      // Constructors
+      PrdTerms(size_t n_pars=0);
+
+      // Modifying functions
+      size_t add_group( size_t n_terms, const ParIdxs & par_idxs,
+                        TermFct fct );
+
+      // Access functions
+      bool is_empty() const;
+      size_t get_n_pars() const;
+      size_t get_n_vals() const;
+      size_t get_n_groups() const;
+      const std::vector<size_t> & get_par_idxs(size_t group) const;
+
+      // Core functionality
+      void evaluate_group(size_t group, double * vals) const;
+      std::vector<double> get_vals(const double * par_vals) const;
+  };
+
+}
+}
+
+#endif
@@ -0,0 +1,96 @@
+#ifndef LIB_PROFILESCAN_H
+#define LIB_PROFILESCAN_H 1
+
+#include <CppUtils/ThreadPool.h>
+#include <Fit/FitContainer.h>
+#include <Fit/FitResult.h>
+#include <Fit/MinuitFactory.h>
+
+#include <functional>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace PrEW {
+namespace Fit {
+
+  struct ScanPoint {
+    std::vector<double> m_scan_vals {}; // Values of the scanned parameters
+    FitResult m_result {}; // Profiled fit (chi^2/NLL in m_chisq_fin)
+  };
+
+  using ScanPointVec = std::vector<ScanPoint>;
+
+  class ProfileScan {
+    /** Class that performs 1D and 2D profile scans of fit parameters:
+        At each grid point the scanned parameters are fixed to the grid values
+        and all other parameters are minimized.
+        Each thread fits in its own copy of the given fit container.
+        Copies of bound and compiled containers share no mutable state
+        (shared prediction terms are evaluated by each minimizer) => any
+        filled container can be scanned with multiple threads.
+        Fits are started from the converged fit of a neighbouring grid point:
+        Starting at the grid point closest to the start values, the scan
+        spreads out along the last scanned parameter from each point of the
+        other one. Points with the same distance to the first point are
+        fitted in parallel, which neighbour a point starts from is fixed
+        => results don't depend on the number of threads.
+    **/
+
+    public:
+      using MinimizationFct =
+        std::function<FitResult( FitContainer * container,
+                                 const FitResult & start )>;
+
+    private:
+      // Provided as input
+      FitContainer m_container {}; // Copied for each thread
+      MinimizationFct m_minimization_fct {};
+      FitResult m_start {}; // Start of the first point (optional)
+
+      // Running the fits
+      std::unique_ptr<CppUtils::ThreadPool> m_pool;
+      std::vector<std::unique_ptr<FitContainer>> m_containers {}; // Per thread
+
+      // Internal functions
+      size_t find_par(const std::string & par_name) const;
+      FitResult fit_point( const std::vector<size_t> & par_idxs,
+                           const std::vector<double> & scan_vals,
+                           const FitResult & start,
+                           size_t thread );
+      ScanPointVec run( const std::vector<size_t> & par_idxs,
+                        const std::vector<std::vector<double>> & grids );
+
+    public:
+      // Constructors
+      ProfileScan(
+        const FitContainer & container,
+        const MinimizationFct & minimization_fct,
+        size_t n_threads=1
+      );
+
+      // Settings
+      void set_start(const FitResult & start);
+
+      // Access functions
+      size_t get_n_threads() const;
+
+      // Core functionality
+      ScanPointVec scan( const std::string & par_name,
+                         const std::vector<double> & grid );
+      ScanPointVec scan( const std::string & par_name_x,
+                         const std::vector<double> & grid_x,
+                         const std::string & par_name_y,
+                         const std::vector<double> & grid_y );
+
+      // Standard minimizations
+      static MinimizationFct chisq_minimization(
+        const MinuitFactory & factory );
+      static MinimizationFct nll_minimization(
+        const MinuitFactory & factory );
+  };
+
+}
+}
+
+#endif
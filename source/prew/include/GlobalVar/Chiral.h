@@ -1,8 +1,12 @@
 #ifndef LIBRARY_CHIRAL_H
 #define LIBRARY_CHIRAL_H 1
 
+// Includes from PrEW
+#include <CppUtils/Symbol.h>
+
 // Standard library
 #include <string>
+#include <vector>
 
 namespace PrEW {
 namespace GlobalVar {
@@ -10,15 +14,18 @@ namespace GlobalVar {
  **/
 
 namespace Chiral {
-/** Common strings to mark generator level chiral distributions.
+/** Common (interned) strings to mark generator level chiral distributions.
  **/
 
-static const std::string eLpR = "PrEW-internal-GenLevel-ElectronL-PositronR";
-static const std::string eRpL = "PrEW-internal-GenLevel-ElectronR-PositronL";
-static const std::string eLpL = "PrEW-internal-GenLevel-ElectronL-PositronL";
-static const std::string eRpR = "PrEW-internal-GenLevel-ElectronR-PositronR";
+static const CppUtils::Symbol eLpR = "PrEW-internal-GenLevel-ElectronL-PositronR";
+static const CppUtils::Symbol eRpL = "PrEW-internal-GenLevel-ElectronR-PositronL";
+static const CppUtils::Symbol eLpL = "PrEW-internal-GenLevel-ElectronL-PositronL";
+static const CppUtils::Symbol eRpR = "PrEW-internal-GenLevel-ElectronR-PositronR";
+
+// All chiralities in the order in which they are used for predictions
+static const std::vector<CppUtils::Symbol> all {eLpR, eRpL, eLpL, eRpR};
 
-std::string transform(int eM_chirality, int eP_chirality);
+CppUtils::Symbol transform(int eM_chirality, int eP_chirality);
 
 } // namespace Chiral
 
@@ -0,0 +1,112 @@
+#ifndef LIBRARY_BINARYCACHE_H
+#define LIBRARY_BINARYCACHE_H 1
+
+#include <CppUtils/Symbol.h>
+#include <Data/CoefDistr.h>
+#include <Data/DistrInfo.h>
+#include <Data/PredDistr.h>
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace PrEW {
+namespace Input {
+
+  class BinaryCache {
+    /** PrEW-native binary file of predicted distributions and coefficients
+        which is memory-mapped for reading.
+        The file is only mapped (not read), the arrays of the file are
+        accessed directly through the views (no copies), pages are only loaded
+        when they are accessed.
+        Views and their pointers are valid as long as the cache exists.
+
+        File layout (native byte order, all arrays 8-byte aligned):
+          Header (magic, version, byte order check, table sizes and offsets)
+          String table entries (offset and length of each name)
+          Prediction records (identifiers, bins, offsets of arrays)
+          Coefficient records (identifiers, number of values, array offset)
+          Characters of all names
+          Arrays: for each prediction the bin centers, lower edges, upper
+                  edges (each n_bins*dim, bin-major) and the signal and
+                  background distributions (each n_bins), for each
+                  coefficient its values (1 if global, n_bins otherwise)
+        Files are written to a temporary file first and then renamed, so
+        readers never see partially written files.
+    **/
+
+    public:
+      static const std::uint32_t version = 1;
+
+      struct PredView {
+        /** Prediction in the cache (see Data::PredDistr).
+            Coordinates of bin i are [i*m_dim, (i+1)*m_dim).
+        **/
+        Data::DistrInfo m_info {};
+        size_t m_n_bins {};
+        size_t m_dim {};
+        const double * m_centers {};
+        const double * m_edges_low {};
+        const double * m_edges_up {};
+        const double * m_sig_distr {};
+        const double * m_bkg_distr {};
+      };
+
+      struct CoefView {
+        /** Coefficient in the cache (see Data::CoefDistr).
+            Global coefficients have a single value.
+        **/
+        CppUtils::Symbol m_coef_name {};
+        Data::DistrInfo m_info {};
+        bool m_is_global {};
+        size_t m_n_vals {};
+        const double * m_vals {};
+      };
+
+    private:
+      std::string m_file_path {};
+      const char * m_data {};
+      size_t m_size {};
+
+      std::vector<CppUtils::Symbol> m_strings {}; // Names, interned once
+      std::vector<PredView> m_preds {};
+      std::vector<CoefView> m_coefs {};
+
+      // Internal functions
+      void map_file();
+      void unmap_file();
+      void read_tables();
+      const double * get_array(std::uint64_t offset, std::uint64_t n) const;
+      const CppUtils::Symbol & get_string(std::uint32_t idx) const;
+
+    public:
+      // Constructors
+      BinaryCache(const std::string & file_path);
+      ~BinaryCache();
+      BinaryCache(const BinaryCache &) = delete;
+      BinaryCache & operator=(const BinaryCache &) = delete;
+
+      // Access functions
+      const std::string & get_file_path() const;
+      size_t get_n_preds() const;
+      size_t get_n_coefs() const;
+      const PredView & get_pred(size_t i) const;
+      const CoefView & get_coef(size_t i) const;
+
+      // Conversion to PrEW data objects (copies)
+      Data::PredDistr get_pred_distr(size_t i) const;
+      Data::CoefDistr get_coef_distr(size_t i) const;
+      Data::PredDistrVec get_pred_distrs() const;
+      Data::CoefDistrVec get_coef_distrs() const;
+
+      // Writing
+      static void write( const std::string & file_path,
+                         const Data::PredDistrVec & pred_distrs,
+                         const Data::CoefDistrVec & coef_distrs );
+  };
+
+}
+}
+
+#endif
@@ -7,11 +7,10 @@
 #include <Input/CSVMetadata.h>
 
 // Standard library
+#include <istream>
 #include <string>
 #include <vector>
 
-#include "csv.hpp"
-
 namespace PrEW {
 namespace Input {
 
@@ -29,6 +28,7 @@ class CSVInterpreter {
   static const std::string BinLowMarker;
   static const std::string BinUpMarker;
   static const std::string CoefficientMarker;
+  static const std::string CrossSectionName;
 
   class CSVCoord {
     /** Small helper class that ensures the conventions for the coordinate data
@@ -54,7 +54,15 @@ public:
 
 protected:
   void read_metadata(const CSVMetadata &metadata);
-  void read_csv(csv::CSVReader &csv_reader);
+  void read_csv(std::istream &stream, const std::string &file_path);
+
+  std::vector<std::string> split_header(const std::string &line) const;
+  size_t find_col(const std::vector<std::string> &col_names,
+                  const std::string &col_name,
+                  const std::string &file_path) const;
+  void read_row(const std::string &line, const std::vector<int> &col_buffers,
+                std::vector<std::vector<double>> *buffers,
+                const std::string &file_path) const;
 
   std::vector<CSVCoord> find_coords(const std::vector<std::string> &col_names);
   std::vector<std::string>
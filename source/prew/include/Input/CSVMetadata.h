@@ -2,8 +2,10 @@
 #define LIB_CSVMETADATA_H 1
 
 // Standard library
+#include <istream>
 #include <map>
 #include <string>
+#include <vector>
 
 #include "csv.hpp"
 
@@ -34,6 +36,7 @@ public:
 
   // Core functionality
   csv::CSVReader strip_metadata(const std::string &file_path);
+  void read_metadata(std::istream &stream, const std::string &file_path);
 
   // Access functions
   template <class OutClass> OutClass get(const std::string &name) const;
@@ -44,6 +47,8 @@ protected:
   void interpret(const std::vector<std::string> &metadata_lines);
   std::vector<std::string>
   get_metadata_lines(const std::string &file_path) const;
+  std::vector<std::string>
+  get_metadata_lines(std::istream &stream, const std::string &file_path) const;
 };
 
 } // namespace Input
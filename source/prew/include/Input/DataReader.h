@@ -6,6 +6,8 @@
 #include <Input/InputInfo.h>
 #include <Input/Reading.h>
 
+#include <string>
+
 
 namespace PrEW {
 namespace Input {
@@ -30,6 +32,7 @@ namespace Input {
       DataReader(InputInfo *input_info);
       
       void read_file();
+      void write_binary_cache(const std::string & file_path) const;
       const Data::DiffDistrVec& get_meas_distrs() const;
       const Data::PredDistrVec& get_pred_distrs() const;
       const Data::CoefDistrVec& get_coef_distrs() const;
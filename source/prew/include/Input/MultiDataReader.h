@@ -0,0 +1,55 @@
+#ifndef LIBRARY_MULTIDATAREADER_H
+#define LIBRARY_MULTIDATAREADER_H 1
+
+#include <Data/CoefDistr.h>
+#include <Data/PredDistr.h>
+#include <Input/InputInfo.h>
+
+#include <string>
+#include <vector>
+
+namespace PrEW {
+namespace Input {
+
+  class MultiDataReader {
+    /** Reader for many input files which are parsed in parallel (each file
+        with its own DataReader).
+        The results are merged in the order of the input infos, so they do
+        not depend on the number of threads and are the same as reading the
+        files one after another.
+        Files that need ROOT (RK style) are read one at a time, all other
+        styles are read concurrently.
+    **/
+
+    std::vector<InputInfo*> m_input_infos {};
+    std::vector<InputInfo> m_own_infos {}; // Infos of directory input
+    size_t m_n_threads {};
+
+    Data::PredDistrVec m_pred_distrs {};
+    Data::CoefDistrVec m_coef_distrs {};
+
+    public:
+      // Constructors
+      MultiDataReader( const std::vector<InputInfo*> & input_infos,
+                       size_t n_threads=1 );
+      MultiDataReader( const std::string & dir_path,
+                       const std::string & input_style,
+                       const std::string & extension,
+                       size_t n_threads=1 );
+      MultiDataReader(const MultiDataReader&) = delete;
+      MultiDataReader& operator=(const MultiDataReader&) = delete;
+
+      // Access functions
+      size_t get_n_files() const;
+      size_t get_n_threads() const;
+      const Data::PredDistrVec& get_pred_distrs() const;
+      const Data::CoefDistrVec& get_coef_distrs() const;
+
+      // Core functionality
+      void read_files();
+  };
+
+}
+}
+
+#endif
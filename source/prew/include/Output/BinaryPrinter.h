@@ -0,0 +1,78 @@
+#ifndef LIB_BINARYPRINTER_H
+#define LIB_BINARYPRINTER_H 1
+
+#include <Connect/DataConnector.h>
+#include <Fit/FitResult.h>
+
+#include <cstdint>
+#include <fstream>
+#include <string>
+#include <vector>
+
+namespace PrEW {
+namespace Output {
+
+  class BinaryPrinter {
+    /** Class to write the information and results from fits to a framed
+        binary file (read by PrOut.BinaryReader).
+        Each fit result is appended to the file when it is added, memory use
+        does not grow with the number of fits and no number formatting is
+        needed.
+
+        File layout (native byte order):
+          File header: magic "PrEWOUT\0", version (u32), byte order (u32)
+          Frames: type (u32), reserved (u32), payload size (u64), payload
+            Setup:  energy (i32), setup info text (u64 length + chars, same
+                    text as in the Printer output)
+            Pars:   number of parameters (u32), names (each u64 length +
+                    chars), written before the first fit of a setup
+            Fit:    n_pars (u32), n_cov (u32), n_cor (u32),
+                    n_bins, n_free_pars, n_fct_calls, n_iters, min_status,
+                    cov_status (each i32), chi-squared, EDM (each f64),
+                    final values and uncertainties (each n_pars f64),
+                    covariance and correlation matrix (row-major,
+                    n_cov*n_cov and n_cor*n_cor f64)
+        Readers skip frames of unknown type using the payload size.
+    **/
+
+    public:
+      static const std::uint32_t version = 1;
+
+    private:
+      enum class FrameType : std::uint32_t { Setup = 1, Pars = 2, Fit = 3 };
+
+      // Input arguments
+      std::string m_file_path {}; // Path of the output file
+      std::ofstream m_file {};
+
+      // Tracking number of fit results in current setup
+      int m_n_fits {};
+
+      // Reused buffer for the payload of a frame
+      std::vector<char> m_buffer {};
+
+      // Internal functions
+      template<class T> void put(const T & val);
+      void put_str(const std::string & str);
+      void write_frame(FrameType type);
+
+    public:
+      // Constructors
+      BinaryPrinter( const std::string & file_path,
+                     const std::string & mode="overwrite" );
+
+      // Writing functions
+      void new_setup( int energy, const Connect::DataConnector & connector );
+      void add_fit( const Fit::FitResult & result );
+      void add_fits( const Fit::ResultVec & results );
+      void flush();
+
+      // Access functions
+      const std::string & get_file_path() const;
+      int get_n_fits() const;
+  };
+
+}
+}
+
+#endif
@@ -4,13 +4,24 @@
 #include <Connect/DataConnector.h>
 #include <Fit/FitResult.h>
 
+#include <condition_variable>
+#include <deque>
+#include <fstream>
+#include <mutex>
 #include <string>
+#include <thread>
 
 namespace PrEW {
 namespace Output {
   
   class Printer {
     /** Class to print the information and results from fits to a file.
+        By default the output is collected in memory and written by write().
+        In streaming mode (see stream) the file is opened once and the output
+        is handed to a writer thread whenever a block of the given size is
+        complete, so memory use is bounded and the file can be monitored
+        while long runs progress.
+        Adding setups and fits is thread safe.
     **/
     
     // Input arguments
@@ -25,29 +36,68 @@ namespace Output {
     // Tracking number of fit results
     int m_n_fits {};
     
+    // Guards the output strings (fits may be added from multiple threads)
+    mutable std::mutex m_mutex {};
+    
+    // Streaming mode: blocks of output are queued for a single writer thread
+    bool m_streaming {};
+    bool m_setup_open {}; // Setup beginning written, end not yet
+    size_t m_buffer_size {};
+    std::ofstream m_file {};
+    std::deque<std::string> m_queue {};
+    bool m_writing {};
+    bool m_stop {};
+    bool m_write_failed {}; // Writer couldn't write to the file
+    std::mutex m_queue_mutex {};
+    std::condition_variable m_cv_queue {};
+    std::condition_variable m_cv_written {};
+    std::thread m_writer {};
+    
     // Internal functions defining actual output
     void add_meta_info(int energy, const Connect::DataConnector & connector);
     void add_par_info(const Fit::FitResult & result);
     void add_fit_res(const Fit::FitResult & result);
     std::string assemble_setup_output() const;
+    std::string setup_begin() const;
+    std::string setup_end() const;
     
     // Internal functions to handle output
     bool has_setup_to_save() const;
     void save_setup_output();
     void reset_setup();
+    
+    // Internal functions for streaming mode
+    void enqueue(std::string && block);
+    void end_open_setup();
+    void check_written();
+    void writer_loop();
+    static std::ios::openmode open_mode(const std::string & mode);
 
     public:
       // Constructors
       Printer( std::string file_path );
+      Printer(const Printer&) = delete;
+      Printer& operator=(const Printer&) = delete;
+      ~Printer();
 
       // Writing functions
       void new_setup( int energy, const Connect::DataConnector & connector );
       void add_fit( const Fit::FitResult & result );
       void add_fits( const Fit::ResultVec & results );
-      void write( const std::string & mode="overwrite" ) const;
+      void write( const std::string & mode="overwrite" );
+      
+      // Streaming mode
+      void stream( const std::string & mode="overwrite", 
+                   size_t buffer_size=1<<16 );
+      void flush();
+      void close();
 
       // Functions to check current status
       std::string get_current_output() const;
+
+      // Setup description (shared with other output formats)
+      static std::string setup_info( int energy, 
+                                     const Connect::DataConnector & connector );
   };
   
 }
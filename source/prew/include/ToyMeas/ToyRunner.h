@@ -0,0 +1,99 @@
+#ifndef LIB_TOYRUNNER_H
+#define LIB_TOYRUNNER_H 1
+
+#include <Connect/DataConnector.h>
+#include <CppUtils/ThreadPool.h>
+#include <Fit/FitContainer.h>
+#include <Fit/FitPar.h>
+#include <Fit/FitResult.h>
+#include <Fit/MinuitFactory.h>
+#include <Output/Printer.h>
+#include <ToyMeas/ToyGen.h>
+
+#include <functional>
+#include <memory>
+#include <vector>
+
+namespace PrEW {
+namespace ToyMeas {
+
+  class ToyRunner {
+    /** Class that performs batches of toy fits in parallel.
+        For each toy the distributions of the toy generator are fluctuated,
+        the constraints of the fit parameters are fluctuated (optional), the
+        fit container of the thread is updated and the minimization is 
+        performed.
+        Each thread fills its own fit container using the data connector once
+        and afterwards only updates measurements and parameters.
+        Each toy uses its own random number stream (given by the seed and the
+        toy index), so the results do not depend on the number of threads.
+        Results are handed on in the order of the toys.
+        Toy generator and data connector are only read and have to stay
+        unchanged while toys are running.
+    **/
+
+    public:
+      using MinimizationFct =
+        std::function<Fit::FitResult(Fit::FitContainer * container)>;
+      using ResultFct =
+        std::function<void(size_t toy, const Fit::FitResult & result)>;
+
+    private:
+      // Provided as input
+      const ToyGen & m_toy_gen;
+      const Connect::DataConnector & m_connector;
+      Fit::ParVec m_pars {};
+      int m_energy {};
+      MinimizationFct m_minimization_fct {};
+      unsigned m_seed {};
+
+      // Toy settings
+      bool m_fluctuate_constrs {true};
+      bool m_compile_prds {false};
+
+      // Running the toys
+      std::unique_ptr<CppUtils::ThreadPool> m_pool;
+      std::vector<std::unique_ptr<Fit::FitContainer>> m_containers {}; // Per thread
+      size_t m_n_toys_done {}; // Toy index continues over batches
+
+      // Internal functions
+      Fit::FitResult run_toy(size_t toy, size_t thread);
+
+    public:
+      // Constructors
+      ToyRunner(
+        const ToyGen & toy_gen,
+        const Connect::DataConnector & connector,
+        const Fit::ParVec & pars,
+        int energy,
+        const MinimizationFct & minimization_fct,
+        size_t n_threads=1,
+        unsigned seed=0
+      );
+
+      // Settings
+      void set_fluctuate_constrs(bool fluctuate_constrs);
+      void set_compile_prds(bool compile_prds);
+
+      // Access functions
+      size_t get_n_threads() const;
+      size_t get_n_toys_done() const;
+
+      // Core functionality
+      void run( size_t n_toys, const ResultFct & result_fct );
+      void run( size_t n_toys, Output::Printer * printer );
+      Fit::ResultVec run( size_t n_toys );
+
+      // Standard minimizations
+      static MinimizationFct chisq_minimization(
+        const Fit::MinuitFactory & factory,
+        const Fit::FitResult & start = Fit::FitResult() );
+      static MinimizationFct nll_minimization(
+        const Fit::MinuitFactory & factory,
+        const Fit::FitResult & start = Fit::FitResult() );
+  };
+
+}
+}
+
+#endif
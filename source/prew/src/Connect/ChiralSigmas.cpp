@@ -0,0 +1,117 @@
+#include <Connect/ChiralSigmas.h>
+
+#include <stdexcept>
+
+namespace PrEW {
+namespace Connect {
+
+//------------------------------------------------------------------------------
+// Constructors
+
+ChiralSigmas::ChiralSigmas(
+  const std::vector<double> & sigmas,
+  const CppUtils::Vec::Matrix2D<Fcts::BoundFct> & alphas
+) :
+  m_sigmas(sigmas),
+  m_alphas(alphas)
+{
+  if ( (m_alphas.size() != m_sigmas.size()) || (m_sigmas.size() % 2 != 0) ) {
+    throw std::invalid_argument(
+      "ChiralSigmas needs signal and background cross sections with one set "
+      "of factor functions each!");
+  }
+}
+
+//------------------------------------------------------------------------------
+// Internal functions
+
+double ChiralSigmas::calc_modified_at(
+  size_t i,
+  const double * par_vals
+) const {
+  /** Modified cross section i: sigma_i * alpha_i,1 * ... * alpha_i,n
+  **/
+  return apply_alphas(m_sigmas[i], par_vals, m_alphas[i]);
+}
+
+double ChiralSigmas::apply_alphas(
+  double pred,
+  const double * par_vals,
+  const std::vector<Fcts::BoundFct> & alphas
+) {
+  for (const auto & alpha: alphas) { pred *= alpha(par_vals); }
+  return pred;
+}
+
+//------------------------------------------------------------------------------
+// Access functions
+
+size_t ChiralSigmas::get_n_sigmas() const { return m_sigmas.size(); }
+
+//------------------------------------------------------------------------------
+// Core functionality
+
+void ChiralSigmas::calc_modified(
+  const double * par_vals,
+  double * sigmas_mod
+) const {
+  /** Calculate all modified cross sections (get_n_sigmas() values, in the
+      order of the unmodified ones).
+  **/
+  for (size_t i=0; i<m_sigmas.size(); i++) {
+    sigmas_mod[i] = this->calc_modified_at(i, par_vals);
+  }
+}
+
+double ChiralSigmas::get_polarised(
+  const double * par_vals,
+  const std::vector<Fcts::BoundFct> & pol_factors,
+  const std::vector<Fcts::BoundFct> & alphas_sig,
+  const std::vector<Fcts::BoundFct> & alphas_bkg
+) const {
+  /** Get the polarised prediction like polarise, but calculate the modified
+      cross sections on the way.
+  **/
+  size_t n_chiral = pol_factors.size();
+  if ( (n_chiral == 0) || (2 * n_chiral != m_sigmas.size()) ) {
+    throw std::invalid_argument("Need one polarisation factor per chirality!");
+  }
+
+  double pred_sig = 0, pred_bkg = 0;
+  for (size_t c=0; c<n_chiral; c++) {
+    double pol_factor = pol_factors[c](par_vals);
+    pred_sig += pol_factor * this->calc_modified_at(c, par_vals);
+    pred_bkg += pol_factor * this->calc_modified_at(n_chiral + c, par_vals);
+  }
+  return apply_alphas(pred_sig, par_vals, alphas_sig) +
+         apply_alphas(pred_bkg, par_vals, alphas_bkg);
+}
+
+double ChiralSigmas::polarise(
+  const double * par_vals,
+  const double * sigmas_mod,
+  const std::vector<Fcts::BoundFct> & pol_factors,
+  const std::vector<Fcts::BoundFct> & alphas_sig,
+  const std::vector<Fcts::BoundFct> & alphas_bkg
+) {
+  /** Get the polarised prediction (signal + background) from the modified
+      chiral cross sections (see calc_modified), the polarisation factors
+      (one per chirality) and the polarised factor functions of signal and
+      background:
+        (pol_1 * sigma_1 + ... + pol_n * sigma_n) * alpha_1 * ... * alpha_m
+  **/
+  size_t n_chiral = pol_factors.size();
+  double pred_sig = 0, pred_bkg = 0;
+  for (size_t c=0; c<n_chiral; c++) {
+    double pol_factor = pol_factors[c](par_vals);
+    pred_sig += pol_factor * sigmas_mod[c];
+    pred_bkg += pol_factor * sigmas_mod[n_chiral + c];
+  }
+  return apply_alphas(pred_sig, par_vals, alphas_sig) +
+         apply_alphas(pred_bkg, par_vals, alphas_bkg);
+}
+
+//------------------------------------------------------------------------------
+
+}
+}
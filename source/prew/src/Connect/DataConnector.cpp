@@ -1,14 +1,21 @@
 #include <Connect/DataConnector.h>
 #include <Connect/Linker.h>
 #include <Connect/LinkHelp.h>
+#include <CppUtils/Vec.h>
 #include <Data/DistrUtils.h>
 #include <Data/PredDistr.h>
 #include <GlobalVar/Chiral.h>
 
 #include "spdlog/spdlog.h"
 
+#include <algorithm>
 #include <exception>
+#include <functional>
+#include <map>
+#include <memory>
 #include <string>
+#include <utility>
+#include <vector>
 
 namespace PrEW {
 namespace Connect {
@@ -35,6 +42,17 @@ DataConnector::DataConnector (
     throw std::invalid_argument("DataConnector needs polarisation links!");
   }
   
+  // Index everything once => finding the inputs of a distribution doesn't
+  // depend on the total number of inputs
+  m_pred_distrs_idx = Data::DistrUtils::index_energy_and_name(m_pred_distrs);
+  m_coef_distrs_idx = Data::DistrUtils::index_energy_and_name(m_coef_distrs);
+  m_pred_links_idx = Data::DistrUtils::index_energy_and_name(m_pred_links);
+  for (size_t i=0; i<m_pol_links.size(); i++) {
+    const auto & pol_link = m_pol_links[i];
+    m_pol_links_idx[pol_link.get_energy()][pol_link.get_pol_config()]
+      .push_back(i);
+  }
+  
   spdlog::debug("{} predicted distributions supplied to DataConnector.", pred_distrs.size());
   spdlog::debug("{} coefficients supplied to DataConnector.", coef_distrs.size());
   spdlog::debug("{} prediction links supplied to DataConnector.", pred_links.size());
@@ -57,16 +75,135 @@ const Data::PolLinkVec&   DataConnector::get_pol_links()   const {
   return m_pol_links; 
 }
 
+//------------------------------------------------------------------------------
+// Internal functions
+
+DataConnector::DistrSetup DataConnector::get_distr_setup(
+  const Data::DiffDistr & diff_distr
+) const {
+  /** Find everything that is needed to connect the bins of the given
+      distribution: the polarisation link, the chiral predictions and the
+      linkers for the chiral and polarised alpha functions.
+  **/
+  
+  // Information of the given distribution
+  CppUtils::Symbol distr_name = diff_distr.m_info.m_distr_name;
+  CppUtils::Symbol pol_config = diff_distr.m_info.m_pol_config;
+  int energy                  = diff_distr.m_info.m_energy;
+  
+  const auto & coords = diff_distr.m_coords;
+  
+  DistrSetup setup {};
+  
+  // Find polarisation link for this energy
+  spdlog::debug("Finding polarisation links at energy {}.", energy);
+  auto pol_links = Data::DistrUtils::subvec_energy_and_name(
+    m_pol_links, m_pol_links_idx, energy, pol_config);
+  if (pol_links.size() == 0) {
+    throw std::invalid_argument(
+      "No polarisation link for " + pol_config.str() + " at " + 
+      std::to_string(energy));
+  }
+  setup.m_pol_link = pol_links[0];
+
+  // Find corresponding predicted distributions, links and coefficients
+  spdlog::debug("Looking for subvectors for distr {} @ energy {}.", 
+                distr_name.str(), energy);
+  Data::PredDistrVec predictions  = Data::DistrUtils::subvec_energy_and_name(
+    m_pred_distrs, m_pred_distrs_idx, energy, distr_name);
+  Data::CoefDistrVec coefficients = Data::DistrUtils::subvec_energy_and_name(
+    m_coef_distrs, m_coef_distrs_idx, energy, distr_name);
+  Data::PredLinkVec links         = Data::DistrUtils::subvec_energy_and_name(
+    m_pred_links, m_pred_links_idx, energy, distr_name);
+
+  // --- Get chiral predictions and linkers for chiral alpha functions ---------
+  // Not every chiral distribution has to be provided.
+  // Those that aren't will be assumed as 0.
+  std::vector<double> zero_distr (coords.size(), 0.0);
+  int n_not_found = 0;
+  for (const auto & chirality: GlobalVar::Chiral::all) {
+    spdlog::debug("Looking for predicted distribution.");
+    auto pred = Data::DistrUtils::element_pol(predictions, chirality);
+    if (pred == Data::PredDistr()) {
+      spdlog::debug("No {} prediction available for {}, assume zero.", 
+                    chirality.str(), distr_name.str());
+      pred.m_sig_distr = zero_distr;
+      pred.m_bkg_distr = zero_distr;
+      n_not_found++;
+    }
+    setup.m_chiral_preds.push_back(pred);
+    
+    spdlog::debug("Setting up linkers.");
+    auto chiral_links = Data::DistrUtils::element_pol(links, chirality);
+    auto chiral_coefs = Data::DistrUtils::subvec_pol(coefficients, chirality);
+    setup.m_chiral_linkers_sig.push_back(
+      Connect::Linker(chiral_links.m_fcts_links_sig, coords, chiral_coefs));
+    setup.m_chiral_linkers_bkg.push_back(
+      Connect::Linker(chiral_links.m_fcts_links_bkg, coords, chiral_coefs));
+  }
+  
+  if (n_not_found == 4) {
+    throw std::invalid_argument("No chiral distr's found for " + distr_name.str());
+  }
+  // ---------------------------------------------------------------------------
+
+  // --- Get linkers for polarised alpha functions -----------------------------
+  auto links_pol = Data::DistrUtils::element_pol(links, pol_config);
+  auto coefs_pol = Data::DistrUtils::subvec_pol(coefficients, pol_config);
+
+  setup.m_pol_linkers.push_back(
+    Connect::Linker(links_pol.m_fcts_links_sig, coords, coefs_pol));
+  setup.m_pol_linkers.push_back(
+    Connect::Linker(links_pol.m_fcts_links_bkg, coords, coefs_pol));
+  // ---------------------------------------------------------------------------
+  
+  return setup;
+}
+
+//------------------------------------------------------------------------------
+
+std::vector<size_t> DataConnector::get_par_idxs(
+  const DistrSetup & setup,
+  const Fit::ParVec & pars
+) const {
+  /** Get the (sorted, unique) indices of all parameters that the predictions
+      of the distribution with the given setup depend on.
+  **/
+  std::vector<Linker> linkers {};
+  for (const auto & chirality: GlobalVar::Chiral::all) {
+    linkers.push_back(
+      LinkHelp::get_polfactor_linker(chirality, setup.m_pol_link));
+  }
+  linkers.insert( linkers.end(), setup.m_chiral_linkers_sig.begin(),
+                  setup.m_chiral_linkers_sig.end() );
+  linkers.insert( linkers.end(), setup.m_chiral_linkers_bkg.begin(),
+                  setup.m_chiral_linkers_bkg.end() );
+  linkers.insert( linkers.end(), setup.m_pol_linkers.begin(),
+                  setup.m_pol_linkers.end() );
+  
+  std::vector<size_t> par_idxs {};
+  for (const auto & linker: linkers) {
+    auto linker_par_idxs = linker.get_all_par_idxs(pars);
+    par_idxs.insert( par_idxs.end(), linker_par_idxs.begin(), 
+                     linker_par_idxs.end() );
+  }
+  std::sort(par_idxs.begin(), par_idxs.end());
+  par_idxs.erase(std::unique(par_idxs.begin(), par_idxs.end()), par_idxs.end());
+  return par_idxs;
+}
+
 //------------------------------------------------------------------------------
 // Core functionality
 
 void DataConnector::fill_bins(
   const Data::DiffDistr & diff_distr,
-  Fit::ParVec *pars,
+  const Fit::ParVec & pars,
   Fit::BinVec *bins
 ) const {
   /** Set bin prediction functions for all bins of the distribution.
-      Predictions will be correctly connected to the given input parameters.
+      Predictions will be correctly connected to the given input parameters,
+      they refer to them by their index in the parameter vector (values are
+      given when the prediction is evaluated, see FitBin::get_val_prd).
       
       A full prediction for a single bin is calculated as:
         f_pol,1 * ... * f_pol,n *
@@ -82,238 +219,148 @@ void DataConnector::fill_bins(
                         incoming particle helicity 
         Pe- : electron polarisation
         Pe+ : positron polarisation
+      The modified chiral cross sections (f_LR,1 * ... * f_LR,n * pred_LR etc.)
+      are calculated by each prediction (see ChiralSigmas), 
+      fill_fit_container shares them between polarisation configurations.
   **/
   
-  // Information of the given distribution
-  std::string distr_name = diff_distr.m_info.m_distr_name;
-  std::string pol_config = diff_distr.m_info.m_pol_config;
-  int energy             = diff_distr.m_info.m_energy;
-  
-  auto coords = diff_distr.m_coords;
-  
-  // Find polarisation link for this energy
-  spdlog::debug("Finding polarisation links at energy {}.", energy);
-  auto energy_pol_condition = 
-    [energy,pol_config](const Data::PolLink& link) {
-      return (link.get_energy()==energy) && (link.get_pol_config()==pol_config);
-    };
-  Data::PolLink pol_link = 
-    CppUtils::Vec::element_by_condition(m_pol_links, energy_pol_condition);
-
-  // Find corresponding predicted distributions, links and coefficients
-  spdlog::debug("Looking for subvectors for distr {} @ energy {}.", distr_name, 
-                energy);
-  Data::PredDistrVec predictions  = 
-    Data::DistrUtils::subvec_energy_and_name(m_pred_distrs, energy, distr_name);
-  Data::CoefDistrVec coefficients = 
-    Data::DistrUtils::subvec_energy_and_name(m_coef_distrs, energy, distr_name);
-  Data::PredLinkVec links         = 
-    Data::DistrUtils::subvec_energy_and_name(m_pred_links, energy, distr_name);
-
-  // --- Get chiral predictions, links and coefficients ------------------------
-  spdlog::debug("Looking for predicted distributions.");
-  auto pred_LR = Data::DistrUtils::element_pol( predictions, 
-                                                GlobalVar::Chiral::eLpR);
-  auto pred_RL = Data::DistrUtils::element_pol( predictions, 
-                                                GlobalVar::Chiral::eRpL);
-  auto pred_LL = Data::DistrUtils::element_pol( predictions, 
-                                                GlobalVar::Chiral::eLpL);
-  auto pred_RR = Data::DistrUtils::element_pol( predictions, 
-                                                GlobalVar::Chiral::eRpR);
-
-  spdlog::debug("Looking for function links.");
-  auto links_LR = Data::DistrUtils::element_pol(links, GlobalVar::Chiral::eLpR);
-  auto links_RL = Data::DistrUtils::element_pol(links, GlobalVar::Chiral::eRpL);
-  auto links_LL = Data::DistrUtils::element_pol(links, GlobalVar::Chiral::eLpL);
-  auto links_RR = Data::DistrUtils::element_pol(links, GlobalVar::Chiral::eRpR);
-
-  spdlog::debug("Looking for coefficients.");
-  auto coefs_LR = Data::DistrUtils::subvec_pol( coefficients, 
-                                                GlobalVar::Chiral::eLpR);
-  auto coefs_RL = Data::DistrUtils::subvec_pol( coefficients, 
-                                                GlobalVar::Chiral::eRpL);
-  auto coefs_LL = Data::DistrUtils::subvec_pol( coefficients, 
-                                                GlobalVar::Chiral::eLpL);
-  auto coefs_RR = Data::DistrUtils::subvec_pol( coefficients, 
-                                                GlobalVar::Chiral::eRpR);
-  // ---------------------------------------------------------------------------
-  
-  // --- Check if any chiral distributions are missing -------------------------
-  // Not every chiral distribution has to be provided.
-  // Those that aren't will be assumed as 0.
-  
-  std::vector<double> zero_distr (coords.size(), 0.0);
-  int n_not_found = 0;
-  if (pred_LR == Data::PredDistr()) {
-    spdlog::debug("No LR prediction available for {}, assume zero.", distr_name);
-    pred_LR.m_sig_distr = zero_distr;
-    pred_LR.m_bkg_distr = zero_distr;
-    n_not_found++;
-  }
-  if (pred_RL == Data::PredDistr()) {
-    spdlog::debug("No RL prediction available for {}, assume zero.", distr_name);
-    pred_RL.m_sig_distr = zero_distr;
-    pred_RL.m_bkg_distr = zero_distr;
-    n_not_found++;
-  }
-  if (pred_LL == Data::PredDistr()) {
-    spdlog::debug("No LL prediction available for {}, assume zero.", distr_name);
-    pred_LL.m_sig_distr = zero_distr;
-    pred_LL.m_bkg_distr = zero_distr;
-    n_not_found++;
-  }
-  if (pred_RR == Data::PredDistr()) {
-    spdlog::debug("No RR prediction available for {}, assume zero.", distr_name);
-    pred_RR.m_sig_distr = zero_distr;
-    pred_RR.m_bkg_distr = zero_distr;
-    n_not_found++;
-  }
-  
-  if (n_not_found == 4) {
-    throw std::invalid_argument("No chiral distr's found for " + distr_name);
-  }
-  
-  // ---------------------------------------------------------------------------
-
-  // --- Get linkers for chiral alpha functions ------- ------------------------
-  spdlog::debug("Setting up linkers.");
+  auto setup = this->get_distr_setup(diff_distr);
+  this->bind_bins( setup, diff_distr,
+                   this->get_chiral_sigmas(setup, diff_distr, pars), {},
+                   pars, bins );
+}
 
-  Connect::Linker linker_sig_LR = 
-    Connect::Linker(links_LR.m_fcts_links_sig, coords, coefs_LR);
-  Connect::Linker linker_bkg_LR = 
-    Connect::Linker(links_LR.m_fcts_links_bkg, coords, coefs_LR);
+//------------------------------------------------------------------------------
 
-  Connect::Linker linker_sig_RL = 
-    Connect::Linker(links_RL.m_fcts_links_sig, coords, coefs_RL);
-  Connect::Linker linker_bkg_RL = 
-    Connect::Linker(links_RL.m_fcts_links_bkg, coords, coefs_RL);
+std::vector<size_t> DataConnector::get_chiral_par_idxs(
+  const DistrSetup & setup,
+  const Fit::ParVec & pars
+) const {
+  /** Get the (sorted, unique) indices of all parameters that the modified
+      chiral cross sections of the distribution with the given setup depend 
+      on.
+  **/
+  std::vector<size_t> par_idxs {};
+  for (const auto * linkers: { &setup.m_chiral_linkers_sig, 
+                               &setup.m_chiral_linkers_bkg }) {
+    for (const auto & linker: *linkers) {
+      auto linker_par_idxs = linker.get_all_par_idxs(pars);
+      par_idxs.insert( par_idxs.end(), linker_par_idxs.begin(), 
+                       linker_par_idxs.end() );
+    }
+  }
+  std::sort(par_idxs.begin(), par_idxs.end());
+  par_idxs.erase(std::unique(par_idxs.begin(), par_idxs.end()), par_idxs.end());
+  return par_idxs;
+}
 
-  Connect::Linker linker_sig_LL = 
-    Connect::Linker(links_LL.m_fcts_links_sig, coords, coefs_LL);
-  Connect::Linker linker_bkg_LL = 
-    Connect::Linker(links_LL.m_fcts_links_bkg, coords, coefs_LL);
+//------------------------------------------------------------------------------
 
-  Connect::Linker linker_sig_RR = 
-    Connect::Linker(links_RR.m_fcts_links_sig, coords, coefs_RR);
-  Connect::Linker linker_bkg_RR = 
-    Connect::Linker(links_RR.m_fcts_links_bkg, coords, coefs_RR);
+ChiralSigmasVec DataConnector::get_chiral_sigmas(
+  const DistrSetup & setup,
+  const Data::DiffDistr & diff_distr,
+  const Fit::ParVec & pars
+) const {
+  /** Bind the modified chiral cross sections (signal and background of all
+      chiralities) of each bin of the distribution.
+      They don't depend on the polarisation configuration, distributions that
+      only differ in the polarisation configuration can use the same ones.
+  **/
+  const auto & coords = diff_distr.m_coords;
+  size_t n_chiral = GlobalVar::Chiral::all.size();
+  
+  // --- Bind the alpha functions of all bins (links only resolved once) -------
+  std::vector<CppUtils::Vec::Matrix2D<Fcts::BoundFct>> 
+    chiral_alphas_sig {}, chiral_alphas_bkg {};
+  for (size_t c=0; c<n_chiral; c++) {
+    chiral_alphas_sig.push_back(
+      setup.m_chiral_linkers_sig[c].get_all_bonded_fcts(pars));
+    chiral_alphas_bkg.push_back(
+      setup.m_chiral_linkers_bkg[c].get_all_bonded_fcts(pars));
+  }
   // ---------------------------------------------------------------------------
+  
+  ChiralSigmasVec chiral_sigmas {};
+  for ( size_t bin=0; bin<coords.size(); bin++ ) {
+    // Signal of all chiralities, then background of all chiralities
+    std::vector<double> sigmas {};
+    CppUtils::Vec::Matrix2D<Fcts::BoundFct> alphas {};
+    for (size_t c=0; c<n_chiral; c++) {
+      sigmas.push_back(setup.m_chiral_preds[c].m_sig_distr[bin]);
+      alphas.push_back(chiral_alphas_sig[c][bin]);
+    }
+    for (size_t c=0; c<n_chiral; c++) {
+      sigmas.push_back(setup.m_chiral_preds[c].m_bkg_distr[bin]);
+      alphas.push_back(chiral_alphas_bkg[c][bin]);
+    }
+    chiral_sigmas.push_back(std::make_shared<const ChiralSigmas>(sigmas, alphas));
+  }
+  return chiral_sigmas;
+}
 
-  // --- Get linkers for polarised alpha functions -----------------------------
-  auto links_pol = Data::DistrUtils::element_pol(links, pol_config);
-  auto coefs_pol = Data::DistrUtils::subvec_pol(coefficients, pol_config);
+//------------------------------------------------------------------------------
 
-  Connect::Linker linker_sig_pol = 
-    Connect::Linker(links_pol.m_fcts_links_sig, coords, coefs_pol);
-  Connect::Linker linker_bkg_pol = 
-    Connect::Linker(links_pol.m_fcts_links_bkg, coords, coefs_pol);
-  // ---------------------------------------------------------------------------
+void DataConnector::bind_bins(
+  const DistrSetup & setup,
+  const Data::DiffDistr & diff_distr,
+  const ChiralSigmasVec & chiral_sigmas,
+  const std::vector<size_t> & sigma_idxs,
+  const Fit::ParVec & pars,
+  Fit::BinVec *bins
+) const {
+  /** Set the bin prediction functions of the distribution using the given
+      modified chiral cross sections (one per bin, see get_chiral_sigmas).
+      If the indices of the modified cross sections of each bin in the value
+      array are given (shared prediction terms, see Fit::PrdTerms), the 
+      predictions take them from there, otherwise each prediction calculates
+      them itself.
+  **/
+  const auto & coords = diff_distr.m_coords;
+  if ( (chiral_sigmas.size() != coords.size()) ||
+       ( (!sigma_idxs.empty()) && (sigma_idxs.size() != coords.size()) ) ) {
+    throw std::invalid_argument(
+      "Chiral cross sections for " + diff_distr.m_info.m_distr_name.str() + 
+      " don't match number of bins!");
+  }
 
   // --- Get polarisation factor alpha functions -------------------------------
-  auto pol_factor_LR = 
-    LinkHelp::get_polfactor_lambda(GlobalVar::Chiral::eLpR, pol_link, pars);
-  auto pol_factor_RL = 
-    LinkHelp::get_polfactor_lambda(GlobalVar::Chiral::eRpL, pol_link, pars);
-  auto pol_factor_LL = 
-    LinkHelp::get_polfactor_lambda(GlobalVar::Chiral::eLpL, pol_link, pars);
-  auto pol_factor_RR = 
-    LinkHelp::get_polfactor_lambda(GlobalVar::Chiral::eRpR, pol_link, pars);
+  std::vector<Fcts::BoundFct> pol_factors {};
+  for (const auto & chirality: GlobalVar::Chiral::all) {
+    pol_factors.push_back(
+      LinkHelp::get_polfactor_lambda(chirality, setup.m_pol_link, pars));
+  }
   // ---------------------------------------------------------------------------
-
+  
+  // --- Bind the polarised alpha functions of all bins ------------------------
+  auto pol_alphas_sig = setup.m_pol_linkers[0].get_all_bonded_fcts(pars);
+  auto pol_alphas_bkg = setup.m_pol_linkers[1].get_all_bonded_fcts(pars);
+  // ---------------------------------------------------------------------------
+  
   // Set the prediction of each distribution
   for ( size_t bin=0; bin<coords.size(); bin++ ) {
     spdlog::debug("Binding functions for bin {}.", bin);
     
-    // -------------------- Get chiral signal prediction -----------------------
-    spdlog::debug("Getting chiral signal predictions.");
-    double sigma_sig_LR = pred_LR.m_sig_distr[bin];
-    double sigma_sig_RL = pred_RL.m_sig_distr[bin];
-    double sigma_sig_LL = pred_LL.m_sig_distr[bin];
-    double sigma_sig_RR = pred_RR.m_sig_distr[bin];
-
-    auto alphas_sig_LR = linker_sig_LR.get_all_bonded_fcts_at_bin(bin, pars);
-    auto alphas_sig_RL = linker_sig_RL.get_all_bonded_fcts_at_bin(bin, pars);
-    auto alphas_sig_LL = linker_sig_LL.get_all_bonded_fcts_at_bin(bin, pars);
-    auto alphas_sig_RR = linker_sig_RR.get_all_bonded_fcts_at_bin(bin, pars);
-
-    auto sigma_sig_LR_mod =
-        LinkHelp::get_modified_sigma(sigma_sig_LR, alphas_sig_LR);
-    auto sigma_sig_RL_mod =
-        LinkHelp::get_modified_sigma(sigma_sig_RL, alphas_sig_RL);
-    auto sigma_sig_LL_mod =
-        LinkHelp::get_modified_sigma(sigma_sig_LL, alphas_sig_LL);
-    auto sigma_sig_RR_mod =
-        LinkHelp::get_modified_sigma(sigma_sig_RR, alphas_sig_RR);
-    // -------------------------------------------------------------------------
-
-    // -------------------- Get chiral background prediction -------------------
-    spdlog::debug("Getting chiral background predictions.");
-    double sigma_bkg_LR = pred_LR.m_bkg_distr[bin];
-    double sigma_bkg_RL = pred_RL.m_bkg_distr[bin];
-    double sigma_bkg_LL = pred_LL.m_bkg_distr[bin];
-    double sigma_bkg_RR = pred_RR.m_bkg_distr[bin];
-
-    auto alphas_bkg_LR = linker_bkg_LR.get_all_bonded_fcts_at_bin(bin, pars);
-    auto alphas_bkg_RL = linker_bkg_RL.get_all_bonded_fcts_at_bin(bin, pars);
-    auto alphas_bkg_LL = linker_bkg_LL.get_all_bonded_fcts_at_bin(bin, pars);
-    auto alphas_bkg_RR = linker_bkg_RR.get_all_bonded_fcts_at_bin(bin, pars);
-
-    auto sigma_bkg_LR_mod =
-        LinkHelp::get_modified_sigma(sigma_bkg_LR, alphas_bkg_LR);
-    auto sigma_bkg_RL_mod =
-        LinkHelp::get_modified_sigma(sigma_bkg_RL, alphas_bkg_RL);
-    auto sigma_bkg_LL_mod =
-        LinkHelp::get_modified_sigma(sigma_bkg_LL, alphas_bkg_LL);
-    auto sigma_bkg_RR_mod =
-        LinkHelp::get_modified_sigma(sigma_bkg_RR, alphas_bkg_RR);
-    // -------------------------------------------------------------------------
-
-    // -------------------- Get polarised signal prediction --------------------
-    spdlog::debug("Getting polarised signal predictions.");
-    auto alphas_sig_pol = linker_sig_pol.get_all_bonded_fcts_at_bin(bin, pars);
-
-    // No longer sigma because includes lumi => #Events
-    auto pred_sig_pol =
-      [ sigma_sig_LR_mod, pol_factor_LR,
-        sigma_sig_RL_mod, pol_factor_RL,
-        sigma_sig_LL_mod, pol_factor_LL,
-        sigma_sig_RR_mod, pol_factor_RR,
-        alphas_sig_pol
-      ] () {
-        double sigma_mod =  pol_factor_LR() * sigma_sig_LR_mod() +
-                            pol_factor_RL() * sigma_sig_RL_mod() +
-                            pol_factor_LL() * sigma_sig_LL_mod() +
-                            pol_factor_RR() * sigma_sig_RR_mod();
-        for (const auto & alpha: alphas_sig_pol) {sigma_mod *= alpha();}
-        return sigma_mod;
-      };
-    // -------------------------------------------------------------------------
-
-    // -------------------- Get polarised background prediction ----------------
-    spdlog::debug("Getting polarised background predictions.");
-    auto alphas_bkg_pol = linker_bkg_pol.get_all_bonded_fcts_at_bin(bin, pars);
-
-    // No longer sigma because includes lumi => #Events
-    auto pred_bkg_pol =
-      [ sigma_bkg_LR_mod,pol_factor_LR,
-        sigma_bkg_RL_mod,pol_factor_RL,
-        sigma_bkg_LL_mod,pol_factor_LL,
-        sigma_bkg_RR_mod,pol_factor_RR,
-        alphas_bkg_pol
-      ] () {
-        double sigma_mod =  pol_factor_LR() * sigma_bkg_LR_mod() +
-                            pol_factor_RL() * sigma_bkg_RL_mod() +
-                            pol_factor_LL() * sigma_bkg_LL_mod() +
-                            pol_factor_RR() * sigma_bkg_RR_mod();
-        for (const auto & alpha: alphas_bkg_pol) {sigma_mod *= alpha();}
-        return sigma_mod;
-      };
-    // -------------------------------------------------------------------------
-
     // -------------------- Get total polarised prediction ---------------------
+    // No longer sigma because includes lumi => #Events
     spdlog::debug("Getting total polarised predictions.");
-    std::function<double()> pred_pol  =
-      [pred_sig_pol,pred_bkg_pol]() { return pred_sig_pol() + pred_bkg_pol(); };
+    auto alphas_sig = pol_alphas_sig[bin];
+    auto alphas_bkg = pol_alphas_bkg[bin];
+    Fit::PrdFct pred_pol {};
+    if (sigma_idxs.empty()) {
+      auto sigmas = chiral_sigmas[bin];
+      pred_pol = 
+        [sigmas, pol_factors, alphas_sig, alphas_bkg](const double * vals) { 
+          return sigmas->get_polarised( vals, pol_factors, 
+                                        alphas_sig, alphas_bkg ); 
+        };
+    } else {
+      size_t sigma_idx = sigma_idxs[bin];
+      pred_pol = 
+        [sigma_idx, pol_factors, alphas_sig, alphas_bkg](const double * vals) {
+          return ChiralSigmas::polarise( vals, vals + sigma_idx, pol_factors,
+                                         alphas_sig, alphas_bkg );
+        };
+    }
     // -------------------------------------------------------------------------
 
     // -------------------- Set bin prediction function ------------------------
@@ -325,17 +372,195 @@ void DataConnector::fill_bins(
   }
 }
 
+//------------------------------------------------------------------------------
+
+std::vector<bool> DataConnector::get_shared_distrs(
+  const Data::DiffDistrVec & diff_distrs
+) const {
+  /** Find the distributions whose modified chiral cross sections are also
+      used by a distribution with another polarisation configuration (same 
+      energy, name and binning) => only those are worth sharing.
+  **/
+  std::map<std::pair<int, CppUtils::Symbol>, std::vector<size_t>> 
+    distr_idxs {};
+  for ( size_t i=0; i<diff_distrs.size(); i++ ) {
+    const auto & info = diff_distrs[i].m_info;
+    distr_idxs[std::make_pair(info.m_energy, info.m_distr_name)].push_back(i);
+  }
+  
+  std::vector<bool> is_shared (diff_distrs.size(), false);
+  for ( const auto & key_idxs: distr_idxs ) {
+    const auto & idxs = key_idxs.second;
+    for ( auto i: idxs ) {
+      for ( auto j: idxs ) {
+        const auto & distr_i = diff_distrs[i];
+        const auto & distr_j = diff_distrs[j];
+        if ( (distr_i.m_info.m_pol_config != distr_j.m_info.m_pol_config) &&
+             (distr_i.m_coords == distr_j.m_coords) ) {
+          is_shared[i] = true;
+          break;
+        }
+      }
+    }
+  }
+  return is_shared;
+}
+
+//------------------------------------------------------------------------------
+
+void DataConnector::compile_bins(
+  const Data::DiffDistr & diff_distr,
+  const Fit::ParVec & pars,
+  Fit::PrdProgram *program
+) const {
+  /** Add the predictions for all bins of the distribution to the prediction
+      program (as new segment). 
+      Calculation is the same as in fill_bins, but instead of binding
+      functions for each bin the operations are compiled for all bins at once.
+      Parameters are referred to by their index in the given parameter vector.
+  **/
+  this->compile_distr( this->get_distr_setup(diff_distr), diff_distr, pars,
+                       {}, program );
+}
+
+//------------------------------------------------------------------------------
+
+std::vector<Fit::PrdProgram::Ref> DataConnector::compile_chiral_sigmas(
+  const DistrSetup & setup,
+  const Data::DiffDistr & diff_distr,
+  const Fit::ParVec & pars,
+  size_t segment,
+  Fit::PrdProgram *program
+) const {
+  /** Compile the modified chiral cross sections of the distribution with the
+      given setup into the given segment of the program (one column each, 
+      signal of all chiralities, then background of all chiralities, like in
+      get_chiral_sigmas).
+  **/
+  std::vector<Fit::PrdProgram::Ref> sigma_cols {};
+  for (int is_bkg=0; is_bkg<2; is_bkg++) {
+    for (size_t c=0; c<GlobalVar::Chiral::all.size(); c++) {
+      const auto & pred = setup.m_chiral_preds[c];
+      const auto & sigmas = is_bkg ? pred.m_bkg_distr : pred.m_sig_distr;
+      if (sigmas.size() != diff_distr.m_coords.size()) {
+        throw std::invalid_argument(
+          "Chiral prediction for " + diff_distr.m_info.m_distr_name.str() +
+          " doesn't match number of bins!");
+      }
+      const auto & linker = 
+        is_bkg ? setup.m_chiral_linkers_bkg[c] : setup.m_chiral_linkers_sig[c];
+      
+      auto alphas = linker.compile_all_fcts(pars, segment, program);
+      sigma_cols.push_back(
+        program->add_prod(segment, alphas, program->add_const(sigmas)) );
+    }
+  }
+  return sigma_cols;
+}
+
+//------------------------------------------------------------------------------
+
+void DataConnector::compile_distr(
+  const DistrSetup & setup,
+  const Data::DiffDistr & diff_distr,
+  const Fit::ParVec & pars,
+  const std::vector<Fit::PrdProgram::Ref> & sigma_cols,
+  Fit::PrdProgram *program
+) const {
+  /** Compile the predictions of the distribution with the given setup (see 
+      compile_bins).
+      If the columns of the modified chiral cross sections are given (from a
+      shared segment, see compile_chiral_sigmas) they are used, otherwise 
+      they are compiled into the segment of the distribution.
+  **/
+  const auto & coords = diff_distr.m_coords;
+  if (diff_distr.m_distribution.size() != coords.size()) {
+    throw std::invalid_argument(
+      "Bins and coordinates of " + diff_distr.m_info.m_distr_name.str() + 
+      " don't match!");
+  }
+  
+  size_t n_chiral = GlobalVar::Chiral::all.size();
+  
+  size_t segment = program->add_segment(coords);
+  auto sigma_mods = sigma_cols.empty() ?
+    this->compile_chiral_sigmas(setup, diff_distr, pars, segment, program) :
+    sigma_cols;
+  if (sigma_mods.size() != 2 * n_chiral) {
+    throw std::invalid_argument(
+      "Chiral cross sections for " + diff_distr.m_info.m_distr_name.str() + 
+      " don't match number of chiralities!");
+  }
+  
+  // Polarisation factors are the same for all bins
+  std::vector<Fit::PrdProgram::Ref> pol_factors {};
+  for (const auto & chirality: GlobalVar::Chiral::all) {
+    pol_factors.push_back(
+      LinkHelp::get_polfactor_linker(chirality, setup.m_pol_link)
+      .compile_all_fcts(pars, 0, program).at(0)
+    );
+  }
+  
+  // Polarised signal and background predictions
+  std::vector<Fit::PrdProgram::Ref> preds_pol {};
+  for (int is_bkg=0; is_bkg<2; is_bkg++) {
+    std::vector<Fit::PrdProgram::Ref> terms {};
+    for (size_t c=0; c<n_chiral; c++) {
+      terms.push_back( program->add_prod( 
+        segment, {pol_factors[c], sigma_mods[is_bkg * n_chiral + c]} ) );
+    }
+    
+    std::vector<Fit::PrdProgram::Ref> factors { 
+      program->add_sum(segment, terms) 
+    };
+    for ( const auto & alpha: 
+          setup.m_pol_linkers[is_bkg].compile_all_fcts(pars, segment, program) 
+    ) {
+      factors.push_back(alpha);
+    }
+    preds_pol.push_back(program->add_prod(segment, factors));
+  }
+  
+  program->add_bins(segment, program->add_sum(segment, preds_pol));
+}
 
 //------------------------------------------------------------------------------
 
 void DataConnector::fill_fit_container(
   const Data::DiffDistrVec & diff_distrs,
   const Fit::ParVec        & pars,
-  Fit::FitContainer *fit_container 
+  Fit::FitContainer *fit_container,
+  bool compile_prds
 ) const {
+  /** Fill the fit container with the given parameters and the bins of the
+      given distributions.
+      If compile_prds is set the bin predictions are compiled into the 
+      prediction program of the container instead of being bound to the bins.
+
+      Which bins depend on which parameters is recorded in the parameter-bin
+      index of the container, the binning of the distributions is recorded
+      to check later measurement updates (see 
+      FitContainer::update_measurements).
+      Bound predictions of distributions that only differ in the polarisation
+      configuration (same energy, name and binning) share their modified 
+      chiral cross sections: They are shared prediction terms of the 
+      container (see Fit::PrdTerms), so they are calculated once per 
+      evaluation for all polarisation configurations.
+      Distributions without such partners calculate them in their 
+      predictions, if no distribution has one the bound predictions only 
+      take the parameter values (=> container has no shared terms).
+      Compiled predictions share them the same way: They are compiled once 
+      into a shared segment of the prediction program (see 
+      Fit::PrdProgram::add_shared_segment) whose columns the segments of all
+      polarisation configurations use.
+  **/
   
   if (  (fit_container->m_fit_pars.size() != 0) ||
-        (fit_container->m_fit_bins.size() != 0)
+        (fit_container->m_fit_bins.size() != 0) ||
+        (fit_container->m_prd_program.get_n_bins() != 0) ||
+        (! fit_container->m_prd_terms.is_empty()) ||
+        (! fit_container->m_par_bin_index.is_empty()) ||
+        (fit_container->m_distr_binnings.size() != 0)
   ) {
     throw std::invalid_argument("Can't fill non-empty fit container!");
   }
@@ -343,16 +568,105 @@ void DataConnector::fill_fit_container(
   // Parameters are just to be copied, are created from diff. distrs. with 
   // proper linking to the parameters in the fit container
   fit_container->m_fit_pars = pars;
-  for ( const auto & distr : diff_distrs ) {
-    this->fill_bins(  
-      distr,
-      &(fit_container->m_fit_pars),
-      &(fit_container->m_fit_bins)
+  fit_container->m_prd_terms = Fit::PrdTerms(pars.size());
+  
+  // Modified chiral cross sections already added for energy and 
+  // distribution: as prediction terms (index of first term of each bin) or 
+  // as columns of a shared segment of the prediction program
+  struct SharedSigmas {
+    Data::CoordVec m_coords {};
+    ChiralSigmasVec m_chiral_sigmas {};
+    std::vector<size_t> m_sigma_idxs {};
+    std::vector<Fit::PrdProgram::Ref> m_sigma_cols {};
+  };
+  std::map<std::pair<int, CppUtils::Symbol>, SharedSigmas> shared_sigmas {};
+  auto is_shared = this->get_shared_distrs(diff_distrs);
+  auto & program = fit_container->m_prd_program;
+  
+  for ( size_t i_distr=0; i_distr<diff_distrs.size(); i_distr++ ) {
+    const auto & distr = diff_distrs[i_distr];
+    size_t bin_begin = fit_container->m_fit_bins.size();
+    auto setup = this->get_distr_setup(distr);
+    
+    // --- Add shared modified chiral cross sections (if not yet there) --------
+    SharedSigmas * shared = nullptr;
+    if ( is_shared[i_distr] ) {
+      auto key = 
+        std::make_pair(distr.m_info.m_energy, distr.m_info.m_distr_name);
+      bool is_new = ( shared_sigmas.count(key) == 0 );
+      shared = &(shared_sigmas[key]);
+      if ( is_new || (shared->m_coords != distr.m_coords) ) {
+        *shared = SharedSigmas {};
+        shared->m_coords = distr.m_coords;
+        if (compile_prds) {
+          shared->m_sigma_cols = this->compile_chiral_sigmas(
+            setup, distr, fit_container->m_fit_pars, 
+            program.add_shared_segment(distr.m_coords), &program );
+        } else {
+          shared->m_chiral_sigmas = 
+            this->get_chiral_sigmas(setup, distr, fit_container->m_fit_pars);
+          auto par_idxs = std::make_shared<const std::vector<size_t>>(
+            this->get_chiral_par_idxs(setup, fit_container->m_fit_pars));
+          for ( const auto & sigmas: shared->m_chiral_sigmas ) {
+            shared->m_sigma_idxs.push_back(
+              fit_container->m_prd_terms.add_group(
+                sigmas->get_n_sigmas(), par_idxs,
+                [sigmas](const double * par_vals, double * terms) {
+                  sigmas->calc_modified(par_vals, terms);
+                }
+              )
+            );
+          }
+        }
+      }
+    }
+    // -------------------------------------------------------------------------
+    
+    if (compile_prds) {
+      this->compile_distr(
+        setup,
+        distr,
+        fit_container->m_fit_pars,
+        shared ? shared->m_sigma_cols : std::vector<Fit::PrdProgram::Ref>{},
+        &program
+      );
+      fit_container->m_fit_bins.insert(
+        fit_container->m_fit_bins.end(),
+        distr.m_distribution.begin(),
+        distr.m_distribution.end()
+      );
+    } else if (shared) {
+      this->bind_bins(  
+        setup,
+        distr,
+        shared->m_chiral_sigmas,
+        shared->m_sigma_idxs,
+        fit_container->m_fit_pars,
+        &(fit_container->m_fit_bins)
+      );
+    } else {
+      this->bind_bins(
+        setup,
+        distr,
+        this->get_chiral_sigmas(setup, distr, fit_container->m_fit_pars),
+        {},
+        fit_container->m_fit_pars,
+        &(fit_container->m_fit_bins)
+      );
+    }
+    fit_container->m_par_bin_index.add_bins(
+      this->get_par_idxs(setup, fit_container->m_fit_pars),
+      bin_begin,
+      fit_container->m_fit_bins.size()
     );
+    fit_container->m_distr_binnings.push_back( { 
+      distr.m_info, distr.m_coords, 
+      fit_container->m_fit_bins.size() - bin_begin 
+    } );
   }
 }
 
 //------------------------------------------------------------------------------
 
 }
-}
\ No newline at end of file
+}
@@ -4,19 +4,20 @@
 #include <Data/FctLink.h>
 #include <GlobalVar/Chiral.h>
 
+#include <stdexcept>
+
 namespace PrEW {
 namespace Connect {
 
 //------------------------------------------------------------------------------
 
-std::function<double()> LinkHelp::get_polfactor_lambda(
-  const std::string   & chirality, 
-  const Data::PolLink & pol_link, 
-  Fit::ParVec *pars
+Linker LinkHelp::get_polfactor_linker(
+  CppUtils::Symbol      chirality, 
+  const Data::PolLink & pol_link
 ) {
-  /** Get lambda function for the polarisation factor associated with a chiral
-      cross section. Lambda function output will be dependent on polarisation
-      fit parameters (given in the pol_link).
+  /** Get linker for the polarisation factor associated with a chiral cross
+      section. The linker has a single (dummy) bin, its function depends on
+      the polarisation fit parameters (given in the pol_link).
       Underlying equation:
           (1 + e-_chirality * sgn(P_e-) * |P_e-|) / 2
         * (1 + e+_chirality * sgn(P_e+) * |P_e+|) / 2
@@ -46,7 +47,7 @@ std::function<double()> LinkHelp::get_polfactor_lambda(
     eM_chirality = "R";
     eP_chirality = "R";
   } else {
-    throw std::invalid_argument("Unknown chirality" + chirality);
+    throw std::invalid_argument("Unknown chirality" + chirality.str());
   }
   
   // Instruction class for how to build lambda function
@@ -57,9 +58,25 @@ std::function<double()> LinkHelp::get_polfactor_lambda(
     } 
   };
     
-  // Use Linker class to get function (Need one dummy 0 bin)
+  // Linker class can bind the function (Need one dummy 0 bin)
+  return Connect::Linker(pol_fct_link, {{}}, pol_coefs);
+}
+
+//------------------------------------------------------------------------------
+
+Fcts::BoundFct LinkHelp::get_polfactor_lambda(
+  CppUtils::Symbol      chirality, 
+  const Data::PolLink & pol_link, 
+  const Fit::ParVec & pars
+) {
+  /** Get lambda function for the polarisation factor associated with a chiral
+      cross section. Lambda function output will be dependent on polarisation
+      fit parameters (given in the pol_link, values taken from the 
+      parameter-value array given to the lambda function).
+      (More details in get_polfactor_linker)
+  **/
   auto pol_factor = 
-    Connect::Linker(pol_fct_link, {{}}, pol_coefs)
+    get_polfactor_linker(chirality, pol_link)
     .get_all_bonded_fcts_at_bin(0,pars).at(0);
 
   return pol_factor;
@@ -67,17 +84,17 @@ std::function<double()> LinkHelp::get_polfactor_lambda(
 
 //------------------------------------------------------------------------------
 
-std::function<double()> LinkHelp::get_modified_sigma(
+Fcts::BoundFct LinkHelp::get_modified_sigma(
   double sigma,
-  const std::vector<std::function<double()>>& alphas
+  const std::vector<Fcts::BoundFct>& alphas
 ) {
   /** Take a cross section (sigma) and alpha factor functions and return a 
       function that gives the modified cross section value.
   **/
   auto sigma_mod_fct = 
-    [sigma,alphas](){
+    [sigma,alphas](const double * par_vals){
       double sigma_mod = sigma;
-      for (const auto & alpha: alphas) {sigma_mod *= alpha();}
+      for (const auto & alpha: alphas) {sigma_mod *= alpha(par_vals);}
       return sigma_mod;
     };
   return sigma_mod_fct;
@@ -4,8 +4,10 @@
 
 #include "spdlog/spdlog.h"
 
+#include <algorithm>
+#include <cstring>
 #include <functional>
-#include <exception>
+#include <stdexcept>
 #include <vector>
 
 namespace PrEW {
@@ -18,103 +20,290 @@ Linker::Linker( Data::FctLinkVec fcts_links,
                 Data::CoordVec coords,
                 Data::CoefDistrVec coefs 
 ) : m_fcts_links(fcts_links),
-    m_coords(coords),
+    m_coords(std::make_shared<const Data::CoordVec>(coords)),
     m_coefs(coefs) 
-{}
+{
+  /** Index the coefficients by name (first one wins for duplicate names).
+  **/
+  for (size_t i=0; i<m_coefs.size(); i++) {
+    m_coef_idxs.emplace(m_coefs[i].get_coef_name(), i);
+  }
+}
 
 //------------------------------------------------------------------------------
+// Internal functions
 
-std::function<double()> Linker::get_bonded_fct_at_bin (
-  const Data::FctLink &fct_link,
-  size_t bin,
-  Fit::ParVec *pars
-) const {
-  /** Return the requested parameterisation function in which the values of
-      bin centers and coefficients are fixed (to their values at the bin),
-      and for which the parameters are connected to the given pointers.
-      This means that if parameters are changed the output of the bounded 
-      function will change.
+Linker::NameIdxMap Linker::index_pars(const Fit::ParVec &pars) {
+  /** Map from parameter name to index in the parameter vector (first one 
+      wins for duplicate names).
   **/
-  
-  if (bin > m_coords.size()) {
-    throw std::out_of_range("Asking for function for non-existing bin!");
+  NameIdxMap par_idxs {};
+  par_idxs.reserve(pars.size());
+  for (size_t i=0; i<pars.size(); i++) {
+    par_idxs.emplace(pars[i].get_name(), i);
+  }
+  return par_idxs;
+}
+
+bool Linker::same_in_all_bins(const std::vector<double> &col) {
+  /** Check if all values of the column are (bitwise) the same.
+  **/
+  for (size_t bin=1; bin<col.size(); bin++) {
+    if ( std::memcmp(&(col[bin]), &(col[0]), sizeof(double)) != 0 ) {
+      return false;
+    }
   }
-  auto coord = m_coords[bin];
+  return true;
+}
 
-  // Find needed coefficient values
+Linker::ResolvedLink Linker::resolve_link(
+  const Data::FctLink &fct_link,
+  const NameIdxMap &par_idxs
+) const {
+  /** Find function, coefficient distributions and parameter indices of the 
+      function link.
+  **/
+  ResolvedLink link {};
+  link.m_fct_link = &fct_link;
+  link.m_entry = &(this->find_entry(fct_link.m_fct_name));
+  Fcts::Registry::check_arity( fct_link.m_fct_name, *(link.m_entry), 
+                               fct_link.m_coefs.size(), 
+                               fct_link.m_pars.size() );
   spdlog::debug("Looking for {} coefficients.", fct_link.m_coefs.size());
-  std::vector<double> bin_coefs {};
   for ( const auto & coef_name: fct_link.m_coefs ) {
-    spdlog::debug("Looking for coefficient: {}", coef_name);
-    // Find coefficient distribution with given name
-    auto name_condition = [coef_name](const Data::CoefDistr& coef_distr) 
-                            {return coef_distr.get_coef_name()==coef_name;};
-    auto coefs = CppUtils::Vec::element_by_condition(m_coefs, name_condition);
-    // Choose coeffient value at bin
-    bin_coefs.push_back(coefs.get_coef(bin));
+    link.m_coefs.push_back(&(this->find_coef(coef_name)));
+  }
+  link.m_par_idxs = this->find_par_idxs(fct_link, par_idxs);
+  return link;
+}
+
+Fcts::BoundFct Linker::bind_at_bin(
+  const ResolvedLink &link,
+  size_t bin
+) const {
+  /** Bind the resolved function link at the given bin (see 
+      get_bonded_fct_at_bin).
+  **/
+  if (bin >= m_coords->size()) {
+    throw std::out_of_range("Asking for function for non-existing bin!");
   }
-  if ( fct_link.m_coefs.size() != bin_coefs.size() ) {
-    throw std::invalid_argument(
-        "Was looking for " + std::to_string(fct_link.m_coefs.size()) +
-        " coefficients and found " + std::to_string(bin_coefs.size()) + ".");
+  
+  // Choose coeffient values at bin
+  std::vector<double> bin_coefs {};
+  for ( const auto & coef_distr: link.m_coefs ) {
+    bin_coefs.push_back(coef_distr->get_coef(int(bin)));
   }
   
-  // Find pointers to needed parameters
+  // Fix the arguments of the requested function:
+  // Bin coordinates and coefficient values are fixed, parameter indices are 
+  // fixed (stored in the fixed-size record of the typed function).
+  return link.m_entry->m_bind(m_coords, bin, bin_coefs, link.m_par_idxs);
+}
+
+//------------------------------------------------------------------------------
+
+const Data::CoefDistr & Linker::find_coef(
+  const std::string &coef_name
+) const {
+  /** Find the coefficient distribution with the given name.
+  **/
+  spdlog::debug("Looking for coefficient: {}", coef_name);
+  auto coef_it = m_coef_idxs.find(coef_name);
+  if (coef_it == m_coef_idxs.end()) {
+    throw std::invalid_argument("Coefficient not found: " + coef_name);
+  }
+  return m_coefs[coef_it->second];
+}
+
+//------------------------------------------------------------------------------
+
+std::vector<size_t> Linker::find_par_idxs(
+  const Data::FctLink &fct_link,
+  const NameIdxMap &par_idxs_by_name
+) const {
+  /** Find the indices of the parameters needed by the function link.
+  **/
   spdlog::debug("Looking for {} parameters.", fct_link.m_pars.size());
-  std::vector<double*> bin_pars {};
-  for ( auto & par_name: fct_link.m_pars ) {
-    // Find the index of the correct parameter and connect the modifiable 
-    // parameter value in with the function
-    for (size_t i_par=0; i_par<pars->size(); i_par++) {
-      if ( (*pars)[i_par].get_name() == par_name ) {
-        // Found correct parameter, use pointer to its modifiable value
-        bin_pars.push_back( & ((*pars)[i_par].m_val_mod) );
-        continue;
-      }
+  std::vector<size_t> par_idxs {};
+  for ( const auto & par_name: fct_link.m_pars ) {
+    auto par_it = par_idxs_by_name.find(par_name);
+    if ( par_it == par_idxs_by_name.end() ) {
+      throw std::invalid_argument("Parameter not found: " + par_name);
     }
+    par_idxs.push_back(par_it->second);
   }
-  spdlog::debug("Found {} parameters.", bin_pars.size());
+  spdlog::debug("Found {} parameters.", par_idxs.size());
+  return par_idxs;
+}
+
+//------------------------------------------------------------------------------
+
+const Fcts::FctEntry & Linker::find_entry(const std::string &fct_name) const {
+  /** Find the registry entry of the requested parametrisation function.
+  **/
+  return Fcts::Registry::find_entry(Fcts::prew_fct_registry, fct_name);
+}
+
+const Fcts::ParametrisationFct & Linker::find_fct(
+  const std::string &fct_name
+) const {
+  /** Find the requested parametrisation function.
+  **/
+  return this->find_entry(fct_name).m_fct;
+}
+
+Fcts::ParametrisationGrad Linker::find_grad(
+  const std::string &fct_name
+) const {
+  /** Find the derivatives of the requested parametrisation function.
+      Returns an empty function if the derivatives are not known.
+  **/
+  return this->find_entry(fct_name).m_grad;
+}
+
+//------------------------------------------------------------------------------
+
+Fcts::BoundFct Linker::get_bonded_fct_at_bin (
+  const Data::FctLink &fct_link,
+  size_t bin,
+  const Fit::ParVec &pars
+) const {
+  /** Return the requested parameterisation function in which the values of
+      bin centers and coefficients are fixed (to their values at the bin),
+      and for which the parameters are referred to by their index in the 
+      given parameter vector.
+      The bound function takes the parameter values (in the order of the 
+      parameter vector) when it is evaluated, so it doesn't depend on where
+      the parameters are stored.
+  **/
   
-  // Check if requested function exists
-  auto fct_name = fct_link.m_fct_name;
-  if ( Fcts::prew_fct_map.find(fct_name) == Fcts::prew_fct_map.end() ) {
-    throw std::invalid_argument("Function not known: " + fct_name);
+  if (bin >= m_coords->size()) {
+    throw std::out_of_range("Asking for function for non-existing bin!");
   }
-  
-  // Fix the arguments of the requested function:
-  // Bin center and coefficient values are fixed, parameter pointers are fixed.
-  std::function<double()> bound_fct = 
-   std::bind( 
-     Fcts::prew_fct_map.at(fct_name),
-     coord,
-     bin_coefs,
-     bin_pars
-   );
-
-  return bound_fct;
+  return this->bind_at_bin( this->resolve_link(fct_link, index_pars(pars)), 
+                            bin );
 }
 
 //------------------------------------------------------------------------------
 
-std::vector<std::function<double()>> Linker::get_all_bonded_fcts_at_bin(
+std::vector<Fcts::BoundFct> Linker::get_all_bonded_fcts_at_bin(
   size_t bin,
-  Fit::ParVec *pars
+  const Fit::ParVec &pars
 ) const {
   /** Get all bonded parametrisation functions for the given bin.
       (More details in get_bonded_fct_at_bin)
   **/
   
-  std::vector<std::function<double()>> bonded_fcts_at_bin {};
+  auto par_idxs = index_pars(pars);
+  std::vector<Fcts::BoundFct> bonded_fcts_at_bin {};
   for (const auto & fct_link: m_fcts_links) {
     bonded_fcts_at_bin.push_back(
-      get_bonded_fct_at_bin(fct_link, bin, pars)
+      this->bind_at_bin(this->resolve_link(fct_link, par_idxs), bin)
     );
   }
   
   return bonded_fcts_at_bin;
 }
 
+CppUtils::Vec::Matrix2D<Fcts::BoundFct> Linker::get_all_bonded_fcts(
+  const Fit::ParVec &pars
+) const {
+  /** Get all bonded parametrisation functions for all bins 
+      ([bin][function link], details in get_bonded_fct_at_bin).
+      Every function link is only resolved once.
+  **/
+  auto par_idxs = index_pars(pars);
+  std::vector<ResolvedLink> links {};
+  for (const auto & fct_link: m_fcts_links) {
+    links.push_back(this->resolve_link(fct_link, par_idxs));
+  }
+  
+  CppUtils::Vec::Matrix2D<Fcts::BoundFct> bonded_fcts (m_coords->size());
+  for (size_t bin=0; bin<m_coords->size(); bin++) {
+    for (const auto & link: links) {
+      bonded_fcts[bin].push_back(this->bind_at_bin(link, bin));
+    }
+  }
+  
+  return bonded_fcts;
+}
+
 //------------------------------------------------------------------------------
 
+std::vector<Fit::PrdProgram::Ref> Linker::compile_all_fcts(
+  const Fit::ParVec &pars,
+  size_t segment,
+  Fit::PrdProgram *program
+) const {
+  /** Add the calls of all parametrisation functions to the given segment of
+      the prediction program (one row per bin of the linker).
+      Parameters are referred to by their index in the given parameter vector.
+      Known analytic derivatives of the functions are added as well.
+      Functions that are the same in all bins (no dependence on the bin 
+      coordinates, coefficients same in all bins) are added to the scalar 
+      segment instead, so they are only evaluated once per evaluation of the
+      program (identical scalar calls are shared, see PrdProgram::add_call).
+      Returns the references to the output columns of the calls.
+  **/
+  
+  auto par_idxs = index_pars(pars);
+  std::vector<Fit::PrdProgram::Ref> fct_cols {};
+  for (const auto & fct_link: m_fcts_links) {
+    const auto & entry = this->find_entry(fct_link.m_fct_name);
+    
+    // Coefficient values in all bins
+    CppUtils::Vec::Matrix2D<double> coef_vals {};
+    bool bin_indep = (!entry.m_uses_coords) && (!m_coords->empty());
+    for ( const auto & coef_name: fct_link.m_coefs ) {
+      const auto & coef_distr = this->find_coef(coef_name);
+      std::vector<double> coef_col (m_coords->size());
+      for (size_t bin=0; bin<m_coords->size(); bin++) {
+        coef_col[bin] = coef_distr.get_coef(int(bin));
+      }
+      bin_indep = bin_indep && ( coef_distr.is_global() || 
+                                 same_in_all_bins(coef_col) );
+      coef_vals.push_back(coef_col);
+    }
+    
+    // Coefficients are stored in the program as constants
+    std::vector<Fit::PrdProgram::Ref> coef_cols {};
+    for (const auto & coef_col: coef_vals) {
+      coef_cols.push_back( bin_indep ? program->add_const(coef_col.at(0)) 
+                                     : program->add_const(coef_col) );
+    }
+    
+    fct_cols.push_back(
+      program->add_call(
+        bin_indep ? 0 : segment,
+        fct_link.m_fct_name,
+        entry,
+        coef_cols,
+        this->find_par_idxs(fct_link, par_idxs)
+      )
+    );
+  }
+  
+  return fct_cols;
+}
+
+//------------------------------------------------------------------------------
+
+std::vector<size_t> Linker::get_all_par_idxs(const Fit::ParVec &pars) const {
+  /** Get the (sorted, unique) indices of all parameters in the given 
+      parameter vector that are used by any of the linked functions.
+  **/
+  auto par_idxs_by_name = index_pars(pars);
+  std::vector<size_t> par_idxs {};
+  for (const auto & fct_link: m_fcts_links) {
+    auto fct_par_idxs = this->find_par_idxs(fct_link, par_idxs_by_name);
+    par_idxs.insert(par_idxs.end(), fct_par_idxs.begin(), fct_par_idxs.end());
+  }
+  std::sort(par_idxs.begin(), par_idxs.end());
+  par_idxs.erase(std::unique(par_idxs.begin(), par_idxs.end()), par_idxs.end());
+  return par_idxs;
+}
+
+//------------------------------------------------------------------------------
+
+}
 }
-}
\ No newline at end of file
@@ -7,6 +7,18 @@ namespace CppUtils {
   
 //------------------------------------------------------------------------------
 
+void Rnd::set_seed(unsigned seed, unsigned stream) {
+  /** Reseed the random number generator of the current thread.
+      Different streams with the same seed give independent sequences, e.g.
+      one stream per toy measurement makes toys reproducible independent of
+      which thread generates them.
+  **/
+  std::seed_seq seed_seq {seed, stream};
+  Rnd::rnd_gen.seed(seed_seq);
+}
+
+//------------------------------------------------------------------------------
+
 int Rnd::poisson_fluctuate(double mean) {
   /** Produce a random number from poisson distribution with given mean.
   **/
@@ -0,0 +1,95 @@
+#include <CppUtils/Symbol.h>
+
+#include <deque>
+#include <limits>
+#include <mutex>
+#include <stdexcept>
+#include <unordered_map>
+
+namespace PrEW {
+namespace CppUtils {
+
+//------------------------------------------------------------------------------
+// Global symbol table
+
+namespace {
+  struct SymbolTable {
+    /** Strings stored in a deque so references to them stay valid when new
+        strings are added.
+    **/
+    std::mutex m_mutex {};
+    std::deque<std::string> m_strs {""};
+    std::unordered_map<std::string, Symbol::Id> m_ids {{"", 0}};
+  };
+  
+  SymbolTable & get_table() {
+    /** Constructed on first use => safe to use in static initialisation of
+        other translation units (e.g. static const symbols in headers).
+    **/
+    static SymbolTable table {};
+    return table;
+  }
+}
+
+//------------------------------------------------------------------------------
+// Constructors
+
+Symbol::Symbol(const std::string & str) : m_id(Symbol::intern(str)) {}
+Symbol::Symbol(const char * str) : m_id(Symbol::intern(str)) {}
+
+//------------------------------------------------------------------------------
+// Internal functions
+
+Symbol::Id Symbol::intern(const std::string & str) {
+  /** Find the ID of the string in the symbol table, add it if it isn't there
+      yet.
+  **/
+  if ( str.empty() ) { return 0; }
+  auto & table = get_table();
+  std::lock_guard<std::mutex> lock (table.m_mutex);
+  auto it = table.m_ids.find(str);
+  if ( it != table.m_ids.end() ) { return it->second; }
+  
+  if ( table.m_strs.size() > std::numeric_limits<Id>::max() ) {
+    throw std::out_of_range("Symbol table full!");
+  }
+  Id id = Id(table.m_strs.size());
+  table.m_strs.push_back(str);
+  table.m_ids.emplace(str, id);
+  return id;
+}
+
+//------------------------------------------------------------------------------
+// Access functions
+
+Symbol::Id Symbol::get_id() const { return m_id; }
+bool Symbol::empty() const { return m_id == 0; }
+
+size_t Symbol::get_n_symbols() {
+  auto & table = get_table();
+  std::lock_guard<std::mutex> lock (table.m_mutex);
+  return table.m_strs.size();
+}
+
+//------------------------------------------------------------------------------
+// String round-trip
+
+const std::string & Symbol::str() const {
+  /** String of the symbol, reference stays valid for the whole program.
+  **/
+  auto & table = get_table();
+  std::lock_guard<std::mutex> lock (table.m_mutex);
+  return table.m_strs[m_id];
+}
+
+const char * Symbol::c_str() const { return this->str().c_str(); }
+Symbol::operator const std::string & () const { return this->str(); }
+
+std::ostream & operator<<(std::ostream & os, const Symbol & symbol) {
+  return os << symbol.str();
+}
+
+//------------------------------------------------------------------------------
+
+}
+}
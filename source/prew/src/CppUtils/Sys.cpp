@@ -1,9 +1,12 @@
 #include <CppUtils/Str.h>
 #include <CppUtils/Sys.h>
 
+#include <algorithm>
 #include <fstream>
 #include <stdexcept>
 #include <string>
+#include <vector>
+#include <dirent.h>
 #include <sys/stat.h>
 #include <unistd.h>
 
@@ -55,6 +58,41 @@ bool Sys::file_writable(const std::string& file_path) {
   return writable;
 }
 
+//------------------------------------------------------------------------------
+
+std::vector<std::string> Sys::list_files(
+  const std::string& dir_path,
+  const std::string& extension
+) {
+  /** Paths of all regular files in the directory (not recursive) whose name
+      ends with the given extension (e.g. ".csv", empty => all files).
+      Paths are sorted so that the order does not depend on the file system.
+  **/
+  DIR *dir = opendir(dir_path.c_str());
+  if (dir == nullptr) {
+    throw std::invalid_argument("Can't open directory: " + dir_path);
+  }
+
+  std::vector<std::string> file_paths {};
+  while (struct dirent *entry = readdir(dir)) {
+    std::string name = entry->d_name;
+    if ( (name.size() < extension.size()) || 
+         (name.compare(name.size() - extension.size(), extension.size(),
+                       extension) != 0) ) {
+      continue;
+    }
+    std::string file_path = dir_path + "/" + name;
+    struct stat buffer;
+    if ( (stat(file_path.c_str(), &buffer) == 0) && S_ISREG(buffer.st_mode) ) {
+      file_paths.push_back(file_path);
+    }
+  }
+  closedir(dir);
+
+  std::sort(file_paths.begin(), file_paths.end());
+  return file_paths;
+}
+
 //------------------------------------------------------------------------------
   
 }
@@ -0,0 +1,107 @@
+#include <CppUtils/ThreadPool.h>
+
+#include <stdexcept>
+
+namespace PrEW {
+namespace CppUtils {
+
+//------------------------------------------------------------------------------
+// Constructors
+
+ThreadPool::ThreadPool(size_t n_threads) {
+  /** Create pool with the given total number of threads (including the
+      calling thread).
+  **/
+  if (n_threads == 0) {
+    throw std::invalid_argument("ThreadPool needs at least one thread!");
+  }
+  for (size_t thread=1; thread<n_threads; thread++) {
+    m_workers.emplace_back(&ThreadPool::worker_loop, this, thread);
+  }
+}
+
+ThreadPool::~ThreadPool() {
+  {
+    std::lock_guard<std::mutex> lock (m_mutex);
+    m_stop = true;
+  }
+  m_cv_start.notify_all();
+  for (auto & worker: m_workers) { worker.join(); }
+}
+
+//------------------------------------------------------------------------------
+// Access functions
+
+size_t ThreadPool::get_n_threads() const { return m_workers.size() + 1; }
+
+//------------------------------------------------------------------------------
+// Internal functions
+
+void ThreadPool::work(size_t thread) {
+  /** Take tasks of the current job until none are left.
+      First exception is stored to be rethrown by the calling thread.
+  **/
+  size_t task = m_next_task++;
+  while (task < m_n_tasks) {
+    try {
+      (*m_task_fct)(task, thread);
+    } catch (...) {
+      std::lock_guard<std::mutex> lock (m_mutex);
+      if (!m_exception) { m_exception = std::current_exception(); }
+    }
+    task = m_next_task++;
+  }
+}
+
+void ThreadPool::worker_loop(size_t thread) {
+  size_t last_job = 0;
+  while (true) {
+    {
+      std::unique_lock<std::mutex> lock (m_mutex);
+      m_cv_start.wait(lock, [&]() { return m_stop || (m_job_id != last_job); });
+      if (m_stop) { return; }
+      last_job = m_job_id;
+    }
+
+    this->work(thread);
+
+    {
+      std::lock_guard<std::mutex> lock (m_mutex);
+      m_n_busy--;
+    }
+    m_cv_done.notify_one();
+  }
+}
+
+//------------------------------------------------------------------------------
+// Core functionality
+
+void ThreadPool::run(size_t n_tasks, const TaskFct & task_fct) {
+  /** Run task_fct(task, thread) for all tasks in [0, n_tasks) and return once
+      all tasks are done.
+      Thread indices are in [0, get_n_threads()), index 0 is the calling
+      thread.
+  **/
+  {
+    std::lock_guard<std::mutex> lock (m_mutex);
+    m_task_fct = &task_fct;
+    m_n_tasks = n_tasks;
+    m_next_task = 0;
+    m_n_busy = m_workers.size();
+    m_exception = nullptr;
+    m_job_id++;
+  }
+  m_cv_start.notify_all();
+
+  this->work(0);
+
+  std::unique_lock<std::mutex> lock (m_mutex);
+  m_cv_done.wait(lock, [this]() { return m_n_busy == 0; });
+  m_task_fct = nullptr;
+  if (m_exception) { std::rethrow_exception(m_exception); }
+}
+
+//------------------------------------------------------------------------------
+
+}
+}
@@ -49,6 +49,14 @@ double CoefDistr::get_coef(int bin) const {
   return m_is_global ? m_coefficient : m_coefficients[bin];
 }
 
+const std::vector<double> &CoefDistr::get_coefs() const {
+  /** Returns the coefficients of all bins (contiguous, empty in global case).
+   **/
+  return m_coefficients;
+}
+
+bool CoefDistr::is_global() const { return m_is_global; }
+
 //------------------------------------------------------------------------------
 // Operators
 
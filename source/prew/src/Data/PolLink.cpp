@@ -11,7 +11,7 @@ namespace Data {
 
 PolLink::PolLink(
   int energy, 
-  std::string pol_config, 
+  CppUtils::Symbol pol_config, 
   std::string eM_pol, std::string eP_pol, 
   std::string eM_sgn, std::string eP_sgn
 ) : 
@@ -39,7 +39,7 @@ PolLink::PolLink(
 // Get functions
 
 int PolLink::get_energy() const { return m_energy; }
-std::string PolLink::get_pol_config() const { return m_pol_config; }
+CppUtils::Symbol PolLink::get_pol_config() const { return m_pol_config; }
 std::string PolLink::get_eM_pol() const { return m_eM_pol; }
 std::string PolLink::get_eP_pol() const { return m_eP_pol; }
 
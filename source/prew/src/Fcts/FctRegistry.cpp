@@ -0,0 +1,119 @@
+#include <Fcts/FctRegistry.h>
+
+// Standard library
+#include <stdexcept>
+
+namespace PrEW {
+namespace Fcts {
+
+//------------------------------------------------------------------------------
+
+FctEntry Registry::without_coords(FctEntry entry) {
+  /** Mark the function of the entry as independent of the bin coordinates.
+  **/
+  entry.m_uses_coords = false;
+  return entry;
+}
+
+//------------------------------------------------------------------------------
+
+const FctEntry & Registry::find_entry( 
+  const FctRegistry & registry, 
+  const std::string & fct_name 
+) {
+  /** Find the function with the given ID in the registry.
+  **/
+  auto entry_it = registry.find(fct_name);
+  if ( entry_it == registry.end() ) {
+    throw std::invalid_argument("Function not known: " + fct_name);
+  }
+  return entry_it->second;
+}
+
+void Registry::check_arity(
+  const std::string & fct_name,
+  const FctEntry & entry,
+  size_t n_coefs,
+  size_t n_pars
+) {
+  /** Check that the function is used with the number of coefficients and 
+      parameters it expects.
+  **/
+  if ( (n_coefs != entry.m_n_coefs) || (n_pars != entry.m_n_pars) ) {
+    throw std::invalid_argument(
+      "Function " + fct_name + " needs " + std::to_string(entry.m_n_coefs) + 
+      " coefficients and " + std::to_string(entry.m_n_pars) + 
+      " parameters, got " + std::to_string(n_coefs) + " and " + 
+      std::to_string(n_pars) + "!"
+    );
+  }
+}
+
+//------------------------------------------------------------------------------
+
+void Registry::eval_batch(
+  const std::string & fct_name,
+  const FctEntry & entry,
+  const Data::CoordVec & coords,
+  const std::vector<const double *> & coef_cols,
+  const std::vector<double *> & pars,
+  double * out
+) {
+  /** Evaluate the function for all bins with the given coordinates, 
+      coefficient i of bin j is coef_cols[i][j].
+      out must have space for one value per bin.
+      Bin-constant quantities of functions with a preparation are calculated
+      first (see FctEntry).
+  **/
+  check_arity(fct_name, entry, coef_cols.size(), pars.size());
+  if (coords.empty()) { return; }
+  if (!entry.m_prep) {
+    entry.m_batch( coords.data(), coords.size(), coef_cols.data(), 
+                   pars.data(), out );
+    return;
+  }
+  
+  std::vector<std::vector<double>> q_cols (
+    entry.m_n_prep, std::vector<double>(coords.size()) );
+  std::vector<double> c (entry.m_n_coefs);
+  std::vector<double> q (entry.m_n_prep);
+  for (size_t bin=0; bin<coords.size(); bin++) {
+    for (size_t i=0; i<c.size(); i++) { c[i] = coef_cols[i][bin]; }
+    entry.m_prep(coords[bin], c.data(), q.data());
+    for (size_t i=0; i<q.size(); i++) { q_cols[i][bin] = q[i]; }
+  }
+  std::vector<const double *> q_ptrs {};
+  for (const auto & q_col: q_cols) { q_ptrs.push_back(q_col.data()); }
+  entry.m_batch( coords.data(), coords.size(), q_ptrs.data(), pars.data(), 
+                 out );
+}
+
+//------------------------------------------------------------------------------
+
+FctMap Registry::get_fct_map(const FctRegistry & registry) {
+  /** Map from function-ID to the (general) function.
+  **/
+  FctMap fct_map {};
+  for (const auto & entry: registry) {
+    fct_map.emplace(entry.first, entry.second.m_fct);
+  }
+  return fct_map;
+}
+
+GradMap Registry::get_grad_map(const FctRegistry & registry) {
+  /** Map from function-ID to the derivatives, only for functions whose
+      derivatives are known.
+  **/
+  GradMap grad_map {};
+  for (const auto & entry: registry) {
+    if (entry.second.m_grad) {
+      grad_map.emplace(entry.first, entry.second.m_grad);
+    }
+  }
+  return grad_map;
+}
+
+//------------------------------------------------------------------------------
+
+}
+}
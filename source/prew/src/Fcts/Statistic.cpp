@@ -8,21 +8,28 @@ namespace Fcts {
 
 //------------------------------------------------------------------------------
 
-double Statistic::gaussian_1D ( 
+void Statistic::gaussian_1D_grad ( 
   const Data::BinCoord &x,
   const std::vector<double> &/*c*/,
-  const std::vector<double*> &p
+  const std::vector<double*> &p,
+  std::vector<double>  *grad
 ) {
-  /** Gaussian function in 1D.
-      Parameters: p[0] - amplitude
-                  p[1] - mean
-                  p[2] - width
-      No coefficients required.
+  /** Derivatives of the gaussian w.r.t. amplitude, mean and width.
   **/
+  double amplitude = *(p[0]);
+  double width = *(p[2]);
+  double dist = x.get_center()[0] - (*(p[1]));
   
-  return (*(p[0])) / (  (*(p[2])) * std::sqrt(2.0*M_PI) ) 
-         * std::exp( -0.5 * std::pow( ( x.get_center()[0] - (*(p[1])) ) / (*(p[2])) ,2) );
+  double shape = 1.0 / ( width * std::sqrt(2.0*M_PI) ) 
+                 * std::exp( -0.5 * std::pow( dist / width ,2) );
+  
+  (*grad)[0] = shape;
+  (*grad)[1] = amplitude * shape * dist / std::pow(width, 2);
+  (*grad)[2] = amplitude * shape * 
+               ( std::pow(dist, 2) / std::pow(width, 3) - 1.0 / width );
 }
 
+//------------------------------------------------------------------------------
+
+}
 }
-}
\ No newline at end of file
@@ -6,58 +6,42 @@
 namespace PrEW {
 namespace Fcts {
 
+//------------------------------------------------------------------------------
+// Partial derivatives w.r.t. the parameters
 //------------------------------------------------------------------------------
 
-double Systematics::polarisation_factor ( 
+void Systematics::polarisation_factor_grad ( 
   const Data::BinCoord &/*x*/,
   const std::vector<double> &c,
-  const std::vector<double*> &p
+  const std::vector<double*> &p,
+  std::vector<double>  *grad
 ) {
-  /** Calculate polarisation factor for given chirality (handled by 
-      coeffficients) and polarisations (amplitude handled by parameters, 
-      sign handled by coefficients).
-      Coefficients: c[0] - electron chirality (-1 = L , +1 = R)
-                    c[1] - positron chirality (-1 = L , +1 = R)
-                    c[2] - electron beam polarisation sign
-                    c[3] - positron beam polarisation sign
-      Parameters: p[0] - electron beam polarisation amplitude
-                  p[1] - positron beam polarisation amplitude
-  **/
-  
-  return 0.25 * 
-        ( 1 + c[0] * c[2] * (*(p[0])) ) * 
-        ( 1 + c[1] * c[3] * (*(p[1])) );
+  (*grad)[0] = 0.25 * c[0] * c[2] * ( 1 + c[1] * c[3] * (*(p[1])) );
+  (*grad)[1] = 0.25 * ( 1 + c[0] * c[2] * (*(p[0])) ) * c[1] * c[3];
 }
 
 //------------------------------------------------------------------------------
 
-double Systematics::luminosity_fraction ( 
+void Systematics::luminosity_fraction_grad ( 
   const Data::BinCoord &/*x*/,
   const std::vector<double> &c,
-  const std::vector<double*> &p
+  const std::vector<double*> &/*p*/,
+  std::vector<double>  *grad
 ) {
-  /** Calculate the fraction of the luminosity.
-      Coefficients: c[0] - luminosity fraction
-      Parameters: p[0] - total luminosity
-  **/
-  
-  return c[0] * (*(p[0]));
+  (*grad)[0] = c[0];
 }
 
 //------------------------------------------------------------------------------
 
-double Systematics::acceptance_box (
+void Systematics::acceptance_box_grad (
   const Data::BinCoord &x,
   const std::vector<double>   &c,
-  const std::vector<double*>  &p
+  const std::vector<double*>  &p,
+  std::vector<double>  *grad
 ) {
-  /** Calculate factor from detector acceptance for box-like detector acceptance
-      assumining that the distribution is constant within the bin.
-      Coordinates: x[c[0]] - coordinate of the acceptance range
-      Coefficients: c[0] - index of the relevant coordinate (must be int!)
-                    c[1] - bin width
-      Parameters: p[0] - center of box
-                  p[1] - box width
+  /** Derivatives of the box acceptance w.r.t. box center and width.
+      Only non-zero if one of the box edges is within the bin.
+      (Same case distinction as acceptance_box)
   **/
   double box_center = *(p[0]);
   double box_width = *(p[1]);
@@ -69,44 +53,32 @@ double Systematics::acceptance_box (
   double bin_max = coord + bin_width/2.0;
   double bin_min = coord - bin_width/2.0;
   
-  double factor = 0.0; // Default assumes x outside acceptance
+  (*grad)[0] = 0.0;
+  (*grad)[1] = 0.0;
   
   if ( ( edge_low > bin_min ) && ( edge_low < bin_max ) ) {
     // Lower edge within bin
-    factor = ( bin_max - edge_low ) / bin_width;
+    (*grad)[0] = - 1.0 / bin_width;
+    (*grad)[1] = 0.5 / bin_width;
   } else if ( ( edge_low <= bin_min ) && ( edge_up >= bin_max ) ) {
-    // Bin in acceptance and edges not in bin
-    factor = 1.0;
+    // Bin in acceptance and edges not in bin => constant
   } else if ( ( edge_up > bin_min) && ( edge_up < bin_max) ) {
     // Upper edge within bin
-    factor = ( edge_up - bin_min ) / bin_width;
+    (*grad)[0] = 1.0 / bin_width;
+    (*grad)[1] = 0.5 / bin_width;
   }
-  
-  return factor;
 }
 
 //------------------------------------------------------------------------------
 
-double Systematics::acceptance_box_polynomial (
+void Systematics::acceptance_box_polynomial_grad (
   const Data::BinCoord &/*x*/,
   const std::vector<double>   &c,
-  const std::vector<double*>  &p
+  const std::vector<double*>  &p,
+  std::vector<double>  *grad
 ) {
-  /** Calculate factor from detector acceptance for box-like detector 
-      acceptance.
-      Small deviations of the edges on both sides of the box lead to deviations
-      which are described by a second order polynomial. The coefficients for 
-      that polynomial should be calculated from Monte Carlo events.
-      An additional restriction is applied so that the factor can only be 
-      between 0 and 1.
-      Coefficients: c[0] - constant polynomial term
-                    c[1] - linear polyn. term in center deviation
-                    c[2] - linear polyn. term in width deviation
-                    c[3] - quadratic polyn. term in center deviation
-                    c[4] - quadratic polyn. term in width deviation
-                    c[5] - mixed polynomial term in width and center deviations
-      Parameters: p[0] - deviation in the box center
-                  p[1] - deviation in the box width
+  /** Derivatives of the polynomial box acceptance w.r.t. the center and width
+      deviations. Vanish where the factor is restricted to 0 or 1.
   **/
   double dc = (*(p[0]));
   double dw = (*(p[1]));
@@ -115,17 +87,16 @@ double Systematics::acceptance_box_polynomial (
                   + c[3] * std::pow(dc,2) + c[4] * std::pow(dw,2)
                   + c[5] * dc * dw;
   
-  // Enforce that the factor can only be between 0 and 1
-  if (factor > 1) {
-    factor = 1.0;
-  } else if (factor < 0) {
-    factor = 0.0;
+  (*grad)[0] = 0.0;
+  (*grad)[1] = 0.0;
+  if ( (factor > 1) || (factor < 0) ) {
+    return;
   }
-  
-  return factor;
+  (*grad)[0] = c[1] + 2.0 * c[3] * dc + c[5] * dw;
+  (*grad)[1] = c[2] + 2.0 * c[4] * dw + c[5] * dc;
 }
 
 //------------------------------------------------------------------------------
 
 } // Namespace Fcts
-} // Namespace PrEW
\ No newline at end of file
+} // Namespace PrEW
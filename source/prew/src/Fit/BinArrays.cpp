@@ -0,0 +1,94 @@
+#include <Fit/BinArrays.h>
+
+#include <stdexcept>
+
+namespace PrEW {
+namespace Fit {
+
+//------------------------------------------------------------------------------
+// Constructors
+
+BinArrays::BinArrays(const BinVec & bins) { this->set_measurements(bins); }
+
+//------------------------------------------------------------------------------
+// Modifying functions
+
+void BinArrays::set_measurements(const BinVec & bins) {
+  /** Take measured values and uncertainties from the given bins.
+      Predictions are reset to zero if the number of bins changes.
+  **/
+  size_t n_bins = bins.size();
+  m_vals_mst.resize(n_bins);
+  m_inv_vars.resize(n_bins);
+  m_prds.resize(n_bins);
+  for ( size_t i=0; i<n_bins; i++ ) {
+    m_vals_mst[i] = bins[i].get_val_mst();
+    m_inv_vars[i] = 1.0 / ( bins[i].get_val_unc() * bins[i].get_val_unc() );
+  }
+}
+
+//------------------------------------------------------------------------------
+// Access functions
+
+size_t BinArrays::size() const { return m_vals_mst.size(); }
+
+//------------------------------------------------------------------------------
+// Core functionality
+
+double BinArrays::calc_chisq(size_t bin_begin, size_t bin_end) const {
+  /** Chi-squared sum of the bins in [bin_begin, bin_end).
+      Summed in a fixed number of interleaved partial sums which allows the 
+      compiler to vectorise the loop (a single running sum can't be reordered)
+      while the result only depends on the bin range.
+  **/
+  if ( (bin_begin > bin_end) || (bin_end > this->size()) ) {
+    throw std::out_of_range("BinArrays: Invalid bin range!");
+  }
+  
+  const double * mst = m_vals_mst.data();
+  const double * inv_var = m_inv_vars.data();
+  const double * prd = m_prds.data();
+  
+  constexpr size_t n_lanes = 4;
+  double lane_sums[n_lanes] {};
+  size_t i = bin_begin;
+  for ( ; i + n_lanes <= bin_end; i += n_lanes ) {
+    for ( size_t lane=0; lane<n_lanes; lane++ ) {
+      double diff = mst[i+lane] - prd[i+lane];
+      lane_sums[lane] += diff * diff * inv_var[i+lane];
+    }
+  }
+  for ( ; i<bin_end; i++ ) {
+    double diff = mst[i] - prd[i];
+    lane_sums[0] += diff * diff * inv_var[i];
+  }
+  
+  return (lane_sums[0] + lane_sums[1]) + (lane_sums[2] + lane_sums[3]);
+}
+
+void BinArrays::calc_chisq_derivs(
+  size_t bin_begin, 
+  size_t bin_end, 
+  double * derivs
+) const {
+  /** Derivatives of the chi-squared contributions of the bins in 
+      [bin_begin, bin_end) w.r.t. the predictions: 
+        -2 * (mst_i - prd_i) / unc_i^2
+      written to derivs[0, bin_end-bin_begin).
+  **/
+  if ( (bin_begin > bin_end) || (bin_end > this->size()) ) {
+    throw std::out_of_range("BinArrays: Invalid bin range!");
+  }
+  
+  const double * mst = m_vals_mst.data();
+  const double * inv_var = m_inv_vars.data();
+  const double * prd = m_prds.data();
+  for ( size_t i=bin_begin; i<bin_end; i++ ) {
+    derivs[i-bin_begin] = -2.0 * (mst[i] - prd[i]) * inv_var[i];
+  }
+}
+
+//------------------------------------------------------------------------------
+
+}
+}
@@ -1,6 +1,10 @@
 #include <Fit/ChiSqMinimizer.h>
+#include <Fit/MinuitHelp.h>
 
+#include <algorithm>
 #include <cmath>
+#include <limits>
+#include <stdexcept>
 
 // External 
 #include "Math/Functor.h"
@@ -13,9 +17,17 @@ namespace Fit {
 //------------------------------------------------------------------------------
 // Constructors
 
-ChiSqMinimizer::ChiSqMinimizer(FitContainer * container, const MinuitFactory &factory) : 
-  m_container(container) 
+ChiSqMinimizer::ChiSqMinimizer(
+  FitContainer * container, 
+  const MinuitFactory &factory,
+  size_t n_threads
+) : 
+  m_container(container),
+  m_evaluator(container, n_threads)
 {
+  /** Bin contributions can be evaluated with multiple threads.
+      Result does not depend on the number of threads.
+  **/
   this->update_chisq();
   m_minimizer = factory.create_minimizer();
 }
@@ -24,26 +36,84 @@ ChiSqMinimizer::ChiSqMinimizer(FitContainer * container, const MinuitFactory &fa
 // get functions
 
 double ChiSqMinimizer::get_chisq() const { return m_chisq; }
+const std::vector<double> & ChiSqMinimizer::get_chisq_grad() const { 
+  return m_chisq_grad; 
+}
 const FitResult& ChiSqMinimizer::get_result() const { return m_result; }
 
 //------------------------------------------------------------------------------
 // Core functionality
 
-void ChiSqMinimizer::update_chisq() {
+void ChiSqMinimizer::update_chisq(const double * par_vals) {
   /** Update the full chi-squared sum from the bins and parameter constraints
       given by the fit container.
+      Parameter values are taken from the given array (one per container
+      parameter) or, if none is given, from the container parameters.
+      Bins are summed up in chunks, the chunk sums are then added in order
+      (=> same result for any number of threads).
+      Only chunks with bins that depend on changed parameters are
+      re-evaluated, the sums of all other chunks are kept.
   **/
-  m_chisq = 0.0;
-  for ( const auto & bin : m_container->m_fit_bins ) {
-    m_chisq += std::pow( ( bin.get_val_mst() - bin.get_val_prd() ) /  bin.get_val_unc() , 2 );
+  const auto & bin_arrays = m_evaluator.get_bin_arrays();
+  m_chunk_sums.resize(m_evaluator.get_n_chunks());
+  m_evaluator.evaluate_changed(
+    [this, &bin_arrays](size_t chunk, size_t bin_begin, size_t bin_end) {
+      m_chunk_sums[chunk] = bin_arrays.calc_chisq(bin_begin, bin_end);
+    },
+    par_vals
+  );
+  this->sum_up_chisq();
+}
+
+void ChiSqMinimizer::update_chisq_grad(const double * par_vals) {
+  /** Update the chi-squared (same as update_chisq) and its analytic gradient 
+      w.r.t. all parameters:
+        d chisq / d prd_i = - 2 * (mst_i - prd_i) / unc_i^2
+      is propagated through the compiled predictions.
+  **/
+  const auto & bin_arrays = m_evaluator.get_bin_arrays();
+  m_chunk_sums.resize(m_evaluator.get_n_chunks());
+  m_evaluator.evaluate_gradient(
+    [this, &bin_arrays](size_t chunk, size_t bin_begin, size_t bin_end, 
+                        double * weights) {
+      m_chunk_sums[chunk] = bin_arrays.calc_chisq(bin_begin, bin_end);
+      bin_arrays.calc_chisq_derivs(bin_begin, bin_end, weights);
+    },
+    &m_chisq_grad,
+    par_vals
+  );
+  this->sum_up_chisq();
+  
+  const auto & par_arrays = m_evaluator.get_par_arrays();
+  for ( size_t c=0; c<par_arrays.get_n_constrs(); c++ ) {
+    m_chisq_grad[par_arrays.m_constr_idxs[c]] += 
+      par_arrays.calc_constr_chisq_deriv(c);
   }
-  for ( const auto & par : m_container->m_fit_pars ) {
-    if ( (! par.is_fixed()) && par.has_constraint()) { 
-      m_chisq += par.calc_constr_chisq();
-    }
+}
+
+void ChiSqMinimizer::sum_up_chisq() {
+  /** Sum up the chunk sums (in order) and the parameter constraints.
+  **/
+  m_chisq = 0.0;
+  for ( const auto & chunk_sum : m_chunk_sums ) { m_chisq += chunk_sum; }
+  const auto & par_arrays = m_evaluator.get_par_arrays();
+  for ( size_t c=0; c<par_arrays.get_n_constrs(); c++ ) {
+    m_chisq += par_arrays.calc_constr_chisq(c);
   }
 }
 
+void ChiSqMinimizer::set_start(const FitResult & start) {
+  /** Start the following minimizations from a previous result (e.g. of a
+      neighbouring scan point or of a fit to similar measurements) instead of
+      the current parameter values (see MinuitHelp::set_variables).
+      Fixed parameters keep their values in the container.
+      The result must have the parameters of the container (in the same
+      order), an empty result removes the start.
+  **/
+  MinuitHelp::check_start(start, m_container->m_fit_pars);
+  m_start = start;
+}
+
 void ChiSqMinimizer::minimize() {
   /** Perform the actual chi-squared minimization using Minuit2.
       Will modify the m_val_mod of all parameters in the container!
@@ -56,41 +126,49 @@ void ChiSqMinimizer::minimize() {
   // Tell minimizer to perform hessian error-calculation for accurate errors
   m_minimizer->SetValidError(true); 
   
-  // Create a vector holding the addresses of the parameter values
-  // => Minimizer will directly change parameter values by changing the 
-  //    values at the addresses
+  // Minimizer parameter array has the same order as the container parameters
+  // => Predictions and constraints are evaluated directly from it, the
+  //    container parameters only get the values of the last evaluation
+  //    at the end
   const unsigned int n_pars = m_container->m_fit_pars.size();
-  std::vector<double*> pars(n_pars);
-  for ( unsigned int i=0; i<n_pars; i++ ){
-    pars[i] = &(m_container->m_fit_pars[i].m_val_mod);
-  }
-    
+  m_evaluator.update_pars(); // Parameters may have been fixed or released
+  
   // Thing that minimizer performs chi-squared minimization on
   const ROOT::Math::Functor recalc_chisq (
     // Lambda function for the minimizer:
-    // Update the parameter set, then recalculate and return new chi-squared
-    [pars, n_pars, this](const double * _pars) { 
-      for ( unsigned int i=0; i<n_pars; i++ ) { *(pars[i]) = _pars[i]; }
-      this->update_chisq();
+    // Recalculate and return new chi-squared for the parameter set
+    [this](const double * _pars) {
+      this->update_chisq(_pars);
       return this->get_chisq();
     },
     // Needs to know the correct number of parameters
     n_pars
   );
   
+  // With analytic gradient: Minimizer asks for one derivative at a time
+  // => Calculate full gradient once per point and remember the point
+  // (Minuit2 keeps a copy of the function => lambdas may not refer to locals)
+  m_grad_pars.assign(n_pars, std::numeric_limits<double>::quiet_NaN());
+  const ROOT::Math::GradFunctor recalc_chisq_grad (
+    [recalc_chisq](const double * _pars) { return recalc_chisq(_pars); },
+    [n_pars, this](const double * _pars, unsigned int i_par) {
+      if ( !std::equal(_pars, _pars+n_pars, m_grad_pars.begin()) ) {
+        this->update_chisq_grad(_pars);
+        m_grad_pars.assign(_pars, _pars+n_pars);
+      }
+      return this->get_chisq_grad()[i_par];
+    },
+    n_pars
+  );
+  
   // Set up minimizer by telling about function and parameters
-  m_minimizer->SetFunction(recalc_chisq);
-  for ( unsigned int i_par=0; i_par<n_pars; i_par++ ){
-    FitPar par = m_container->m_fit_pars[i_par];
-    m_minimizer->SetVariable( i_par, par.get_name(), par.m_val_mod, par.get_unc_ini() );
-    // Check if parameter is fixed or limited
-    if (par.is_fixed()) {
-      m_minimizer->FixVariable(i_par); 
-    } else if (par.is_limited()) {
-      m_minimizer->SetVariableLimits( 
-        i_par, par.get_upper_lim(), par.get_lower_lim());
-    }
+  if ( m_evaluator.has_gradient() ) {
+    m_minimizer->SetFunction(recalc_chisq_grad);
+  } else {
+    m_minimizer->SetFunction(recalc_chisq);
   }
+  MinuitHelp::set_variables(
+    m_container->m_fit_pars, m_start, m_minimizer.get());
   
   // -------------------------------------------------------------------------//
   // --------------------------------ACTION!----------------------------------//
@@ -119,12 +197,27 @@ void ChiSqMinimizer::minimize() {
     spdlog::debug("Minimisation used parameter limits, recalculating error without limits for accuracy.");
     m_minimizer->Hesse(); 
   }
+  m_evaluator.get_par_arrays().write_vals(&(m_container->m_fit_pars));
   
   // Form a usable output collection
   this->collect_par_names();
   this->update_result();
 }
 
+void ChiSqMinimizer::reset() {
+  /** Prepare a new minimization after the bins or parameters of the container
+      were updated (see FitContainer::update_measurements and update_pars).
+      Measured values are taken from the container again, the Minuit2
+      instance is cleared and reused.
+  **/
+  m_minimizer->Clear();
+  m_result = FitResult();
+  m_chisq_grad.clear();
+  m_grad_pars.clear();
+  m_evaluator.update_measurements();
+  this->update_chisq();
+}
+
 //------------------------------------------------------------------------------
 // Result collecting
 
@@ -1,20 +1,34 @@
 #include <Fit/FitBin.h>
 
+#include <functional>
+#include <utility>
+
 namespace PrEW {
 namespace Fit {
 
 //------------------------------------------------------------------------------
 // Constructors
 
-FitBin::FitBin(double val_mst, double val_unc, std::function<double()> prd_fct) : 
-  m_val_mst(val_mst), m_val_unc(val_unc), m_prd_fct(prd_fct) {}
+FitBin::FitBin(double val_mst, double val_unc, PrdFct prd_fct) : 
+  m_val_mst(val_mst), m_val_unc(val_unc) 
+{
+  this->set_prd_fct(prd_fct);
+}
 
 //------------------------------------------------------------------------------
 // set functions
 
 void FitBin::set_val_mst(double val_mst) { m_val_mst = val_mst; }
 void FitBin::set_val_unc(double val_unc) { m_val_unc = val_unc; }
-void FitBin::set_prd_fct(std::function<double()> prd_fct) {m_prd_fct = prd_fct;}
+void FitBin::set_prd_fct(PrdFct prd_fct) {
+  /** Set the prediction function (empty function removes it).
+  **/
+  if (prd_fct) { 
+    m_prd_fct = std::make_shared<const PrdFct>(std::move(prd_fct)); 
+  } else {
+    m_prd_fct.reset();
+  }
+}
 
 //------------------------------------------------------------------------------
 // get functions
@@ -25,7 +39,16 @@ double FitBin::get_val_unc() const { return m_val_unc; }
 //------------------------------------------------------------------------------
 // Envoking the prediction function
 
-double FitBin::get_val_prd() const { return m_prd_fct(); }
+double FitBin::get_val_prd(const double * par_vals) const { 
+  /** Evaluate the prediction for the given parameter values (in the order of 
+      the parameter vector that the prediction was connected to).
+      Predictions that use shared prediction terms (see PrdTerms) need the
+      complete value array, i.e. the parameter values followed by the terms.
+      The array isn't checked, FitContainer::get_val_prd does that.
+  **/
+  if (!m_prd_fct) { throw std::bad_function_call(); }
+  return (*m_prd_fct)(par_vals); 
+}
 
 //------------------------------------------------------------------------------
 
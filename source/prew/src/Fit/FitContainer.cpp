@@ -0,0 +1,121 @@
+#include <Fit/FitContainer.h>
+
+#include <stdexcept>
+#include <vector>
+
+namespace PrEW {
+namespace Fit {
+
+//------------------------------------------------------------------------------
+// Modifying functions
+
+void FitContainer::update_measurements(
+  const Data::DiffDistrVec & diff_distrs
+) {
+  /** Take the measured values and uncertainties of the bins from the given
+      distributions, which have to be binned like the ones the container was
+      filled with (same order).
+      The distributions have to be given in the order the container was
+      filled with. If the container knows these distributions, the i-th given
+      distribution has to match the i-th of them (same info, coordinates and
+      number of bins), otherwise only the total number of bins is checked.
+      Predictions (bound or compiled) are not touched, so a filled container
+      can be reused for new measurements (e.g. toys) without reconnecting.
+  **/
+  if ( !m_distr_binnings.empty() ) {
+    if ( diff_distrs.size() != m_distr_binnings.size() ) {
+      throw std::invalid_argument(
+        "Number of distributions doesn't match fit container!");
+    }
+    for ( size_t i=0; i<diff_distrs.size(); i++ ) {
+      const auto & distr = diff_distrs[i];
+      const auto & binning = m_distr_binnings[i];
+      if ( !(distr.m_info == binning.m_info) || 
+           (distr.m_coords != binning.m_coords) ||
+           (distr.m_distribution.size() != binning.m_n_bins) ) {
+        throw std::invalid_argument(
+          "Distribution " + distr.m_info.m_distr_name.str() + 
+          " doesn't match binning of fit container!");
+      }
+    }
+  }
+  
+  size_t n_bins = 0;
+  for ( const auto & distr: diff_distrs ) { 
+    n_bins += distr.m_distribution.size(); 
+  }
+  if ( n_bins != m_fit_bins.size() ) {
+    throw std::invalid_argument(
+      "Distributions don't match bins of fit container!");
+  }
+  
+  size_t bin = 0;
+  for ( const auto & distr: diff_distrs ) {
+    for ( const auto & distr_bin: distr.m_distribution ) {
+      m_fit_bins[bin].set_val_mst(distr_bin.get_val_mst());
+      m_fit_bins[bin].set_val_unc(distr_bin.get_val_unc());
+      bin++;
+    }
+  }
+}
+
+void FitContainer::update_pars(const ParVec & pars) {
+  /** Take values, constraints (e.g. fluctuated constraint centres) and 
+      settings of the given parameters, which have to be the same parameters 
+      (same names in same order) the container was filled with.
+      Bin predictions refer to the parameters by their index, so they use the
+      new parameters without reconnecting.
+  **/
+  if ( pars.size() != m_fit_pars.size() ) {
+    throw std::invalid_argument(
+      "Parameters don't match parameters of fit container!");
+  }
+  for ( size_t i=0; i<pars.size(); i++ ) {
+    if ( pars[i].get_name() != m_fit_pars[i].get_name() ) {
+      throw std::invalid_argument(
+        "Parameter " + pars[i].get_name() + " doesn't match " + 
+        m_fit_pars[i].get_name() + " of fit container!");
+    }
+  }
+  for ( size_t i=0; i<pars.size(); i++ ) { m_fit_pars[i] = pars[i]; }
+}
+
+//------------------------------------------------------------------------------
+// Evaluating the predictions
+
+std::vector<double> FitContainer::get_val_prd(
+  const std::vector<double> & par_vals
+) const {
+  /** Get the predictions of all bins for the given parameter values (one per
+      parameter of the container, in the same order).
+      Uses the compiled prediction program if there is one, otherwise the
+      prediction functions of the bins, which get the parameter values
+      followed by the shared prediction terms (if there are any).
+      Meant for single evaluations (e.g. checks), repeated evaluations should
+      use a PrdEvaluator which keeps its memory.
+  **/
+  if ( (par_vals.size() != m_fit_pars.size()) ||
+       ( (!m_prd_terms.is_empty()) && 
+         (m_prd_terms.get_n_pars() != par_vals.size()) ) ) {
+    throw std::invalid_argument(
+      "Parameter values don't match parameters of fit container!");
+  }
+  
+  std::vector<double> prds {};
+  if ( m_prd_program.get_n_bins() > 0 ) {
+    PrdProgram::Workspace ws {};
+    m_prd_program.evaluate(par_vals.data(), &ws, &prds);
+  } else {
+    auto vals = m_prd_terms.is_empty() ? 
+      par_vals : m_prd_terms.get_vals(par_vals.data());
+    for ( const auto & bin: m_fit_bins ) { 
+      prds.push_back(bin.get_val_prd(vals.data())); 
+    }
+  }
+  return prds;
+}
+
+//------------------------------------------------------------------------------
+
+}
+}
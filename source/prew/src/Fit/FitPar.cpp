@@ -71,6 +71,17 @@ double FitPar::calc_constr_chisq() const {
   return chisq; 
 }
 
+double FitPar::calc_constr_chisq_deriv() const {
+  /** Return the derivative of the constraint Chi^2 w.r.t. the parameter value
+      (0 if no constraint available).
+  **/
+  double deriv=0;
+  if ( m_has_constraint ) {
+    deriv = 2.0 * (m_val_mod - m_constr_val) / std::pow(m_constr_unc, 2);
+  }
+  return deriv; 
+}
+
 //------------------------------------------------------------------------------
 // Modifying functions
 
@@ -97,6 +108,15 @@ bool FitPar::operator==(const FitPar& fit_par) const {
   return fit_par.get_name() == m_name;
 }
 
+//------------------------------------------------------------------------------
+// Helper functions
+
+std::vector<double> get_par_vals(const ParVec & pars) {
+  std::vector<double> par_vals (pars.size());
+  for (size_t i=0; i<pars.size(); i++) { par_vals[i] = pars[i].m_val_mod; }
+  return par_vals;
+}
+
 //------------------------------------------------------------------------------
 
 }
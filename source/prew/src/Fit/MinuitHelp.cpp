@@ -0,0 +1,106 @@
+#include <Fit/MinuitHelp.h>
+
+#include <stdexcept>
+#include <vector>
+
+// External
+#include "RVersion.h"
+#include "spdlog/spdlog.h"
+
+namespace PrEW {
+namespace Fit {
+
+//------------------------------------------------------------------------------
+
+void MinuitHelp::check_start( const FitResult & start, const ParVec & pars ) {
+  /** Check that a result can be used as start of a minimization with the
+      given parameters, i.e. it has the same parameters (in the same order)
+      with final values and uncertainties.
+      An empty result (=> no start) is always fine.
+  **/
+  if ( start.m_par_names.empty() ) { return; }
+
+  size_t n_pars = pars.size();
+  bool matches =
+    (start.m_par_names.size() == n_pars) &&
+    (start.m_pars_fin.size() == n_pars) &&
+    (start.m_uncs_fin.size() == n_pars);
+  for ( size_t i_par=0; matches && (i_par<n_pars); i_par++ ) {
+    matches = ( start.m_par_names[i_par] == pars[i_par].get_name() );
+  }
+  if ( !matches ) {
+    throw std::invalid_argument(
+      "Start result doesn't match parameters of container!");
+  }
+}
+
+//------------------------------------------------------------------------------
+
+void MinuitHelp::set_variables(
+  const ParVec & pars,
+  const FitResult & start,
+  ROOT::Minuit2::Minuit2Minimizer * minimizer
+) {
+  /** Tell the minimizer about the parameters (start values, step sizes,
+      fixed or limited) and, if there is a start result (see check_start),
+      about the initial error matrix:
+        - Free parameters start at the final values of the result, its
+          uncertainties are used as step sizes.
+        - The covariance matrix of the free parameters is given to Minuit2 as
+          initial error matrix (if all of them have a positive variance)
+          => Migrad doesn't need to estimate it first.
+      Older ROOT versions can't take an initial error matrix, there only the
+      values and step sizes of the start are used.
+  **/
+  const unsigned int n_pars = pars.size();
+  bool has_start = !start.m_par_names.empty();
+
+  std::vector<unsigned int> free_pars {};
+  for ( unsigned int i_par=0; i_par<n_pars; i_par++ ){
+    const FitPar & par = pars[i_par];
+    double val = par.m_val_mod;
+    double step = par.get_unc_ini();
+    if ( has_start && (! par.is_fixed()) ) {
+      val = start.m_pars_fin[i_par];
+      if ( start.m_uncs_fin[i_par] > 0 ) { step = start.m_uncs_fin[i_par]; }
+    }
+    minimizer->SetVariable( i_par, par.get_name(), val, step );
+    // Check if parameter is fixed or limited
+    if (par.is_fixed()) {
+      minimizer->FixVariable(i_par);
+    } else {
+      free_pars.push_back(i_par);
+      if (par.is_limited()) {
+        minimizer->SetVariableLimits(
+          i_par, par.get_upper_lim(), par.get_lower_lim());
+      }
+    }
+  }
+  if ( (! has_start) || free_pars.empty() ) { return; }
+
+#if ROOT_VERSION_CODE >= ROOT_VERSION(6,26,0)
+  // Covariance of the free parameters (lower triangle, row by row)
+  const auto & cov_matrix = start.m_cov_matrix;
+  std::vector<double> cov {};
+  bool is_valid = ( cov_matrix.size() == n_pars );
+  for ( size_t i=0; is_valid && (i<free_pars.size()); i++ ) {
+    const auto & row = cov_matrix[free_pars[i]];
+    is_valid = (row.size() == n_pars) && (row[free_pars[i]] > 0);
+    for ( size_t j=0; is_valid && (j<=i); j++ ) {
+      cov.push_back(row[free_pars[j]]);
+    }
+  }
+  if ( is_valid ) {
+    minimizer->SetCovariance(cov, free_pars.size());
+  } else {
+    spdlog::debug("Start result has no usable covariance matrix, Minuit2 will estimate the initial error matrix.");
+  }
+#else
+  spdlog::debug("ROOT version can't set an initial error matrix, Minuit2 will estimate it.");
+#endif
+}
+
+//------------------------------------------------------------------------------
+
+}
+}
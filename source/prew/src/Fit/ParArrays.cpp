@@ -0,0 +1,83 @@
+#include <Fit/ParArrays.h>
+
+#include <algorithm>
+#include <cmath>
+#include <stdexcept>
+
+namespace PrEW {
+namespace Fit {
+
+//------------------------------------------------------------------------------
+// Constructors
+
+ParArrays::ParArrays(const ParVec & pars) { this->set_pars(pars); }
+
+//------------------------------------------------------------------------------
+// Modifying functions
+
+void ParArrays::set_pars(const ParVec & pars) {
+  /** Take current values and active constraints from the given parameters.
+  **/
+  size_t n_pars = pars.size();
+  m_vals.resize(n_pars);
+  m_constr_idxs.clear();
+  m_constr_vals.clear();
+  m_constr_uncs.clear();
+  for ( size_t i=0; i<n_pars; i++ ) {
+    m_vals[i] = pars[i].m_val_mod;
+    if ( (! pars[i].is_fixed()) && pars[i].has_constraint() ) {
+      m_constr_idxs.push_back(i);
+      m_constr_vals.push_back(pars[i].get_constr_val());
+      m_constr_uncs.push_back(pars[i].get_constr_unc());
+    }
+  }
+}
+
+void ParArrays::set_vals(const double * vals) {
+  /** Take the current values of all parameters from a contiguous array (e.g.
+      from the minimizer), must have the same length as m_vals.
+  **/
+  std::copy(vals, vals + m_vals.size(), m_vals.begin());
+}
+
+void ParArrays::write_vals(ParVec * pars) const {
+  /** Write the current values back to the (modified values of the) given
+      parameters.
+  **/
+  if ( pars->size() != m_vals.size() ) {
+    throw std::invalid_argument("ParArrays: Number of parameters changed!");
+  }
+  for ( size_t i=0; i<m_vals.size(); i++ ) { (*pars)[i].m_val_mod = m_vals[i]; }
+}
+
+//------------------------------------------------------------------------------
+// Access functions
+
+size_t ParArrays::size() const { return m_vals.size(); }
+size_t ParArrays::get_n_constrs() const { return m_constr_idxs.size(); }
+
+//------------------------------------------------------------------------------
+// Core functionality
+
+double ParArrays::calc_constr_chisq(size_t i_constr) const {
+  /** Chi-squared resulting from a parameter constraint
+      (same as FitPar::calc_constr_chisq).
+  **/
+  double val = m_vals[m_constr_idxs[i_constr]];
+  return std::pow( (val - m_constr_vals[i_constr]) / m_constr_uncs[i_constr],
+                   2 );
+}
+
+double ParArrays::calc_constr_chisq_deriv(size_t i_constr) const {
+  /** Derivative of the constraint chi-squared w.r.t. the parameter value
+      (same as FitPar::calc_constr_chisq_deriv).
+  **/
+  double val = m_vals[m_constr_idxs[i_constr]];
+  return 2.0 * (val - m_constr_vals[i_constr]) /
+         std::pow(m_constr_uncs[i_constr], 2);
+}
+
+//------------------------------------------------------------------------------
+
+}
+}
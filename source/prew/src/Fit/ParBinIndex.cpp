@@ -0,0 +1,92 @@
+#include <Fit/ParBinIndex.h>
+
+#include <algorithm>
+#include <stdexcept>
+
+namespace PrEW {
+namespace Fit {
+
+//------------------------------------------------------------------------------
+// Internal functions
+
+void ParBinIndex::add_range(
+  const BinRange & range, 
+  std::vector<BinRange> *ranges
+) {
+  /** Add range to the sorted ranges and merge it with overlapping or 
+      adjacent ones.
+  **/
+  if (range.m_begin >= range.m_end) { return; } // Nothing to add
+  
+  auto it = std::lower_bound(
+    ranges->begin(), ranges->end(), range,
+    [](const BinRange & r1, const BinRange & r2) { 
+      return r1.m_end < r2.m_begin; 
+    }
+  );
+  BinRange merged = range;
+  auto it_end = it;
+  while ( (it_end != ranges->end()) && (it_end->m_begin <= merged.m_end) ) {
+    merged.m_begin = std::min(merged.m_begin, it_end->m_begin);
+    merged.m_end = std::max(merged.m_end, it_end->m_end);
+    ++it_end;
+  }
+  it = ranges->erase(it, it_end);
+  ranges->insert(it, merged);
+}
+
+//------------------------------------------------------------------------------
+// Modifying functions
+
+void ParBinIndex::add_bins(
+  const std::vector<size_t> & par_idxs,
+  size_t bin_begin,
+  size_t bin_end
+) {
+  /** Record that the bins [bin_begin, bin_end) depend on the given parameters.
+  **/
+  if (bin_begin > bin_end) {
+    throw std::invalid_argument("ParBinIndex: Invalid bin range!");
+  }
+  for (const auto & par_idx: par_idxs) {
+    if (par_idx >= m_par_ranges.size()) { m_par_ranges.resize(par_idx + 1); }
+    this->add_range({bin_begin, bin_end}, &(m_par_ranges[par_idx]));
+  }
+}
+
+void ParBinIndex::clear() { m_par_ranges.clear(); }
+
+//------------------------------------------------------------------------------
+// Access functions
+
+bool ParBinIndex::is_empty() const { return m_par_ranges.empty(); }
+size_t ParBinIndex::get_n_pars() const { return m_par_ranges.size(); }
+
+const std::vector<BinRange> & ParBinIndex::get_bin_ranges(
+  size_t par_idx
+) const {
+  /** Bin ranges that depend on the given parameter.
+  **/
+  static const std::vector<BinRange> no_ranges {};
+  if (par_idx >= m_par_ranges.size()) { return no_ranges; }
+  return m_par_ranges[par_idx];
+}
+
+std::vector<BinRange> ParBinIndex::get_bin_ranges(
+  const std::vector<size_t> & par_idxs
+) const {
+  /** Bin ranges that depend on any of the given parameters (merged).
+  **/
+  std::vector<BinRange> ranges {};
+  for (const auto & par_idx: par_idxs) {
+    for (const auto & range: this->get_bin_ranges(par_idx)) {
+      this->add_range(range, &ranges);
+    }
+  }
+  return ranges;
+}
+
+//------------------------------------------------------------------------------
+
+}
+}
@@ -1,9 +1,12 @@
 #include <Fit/PoissonNLLMinimizer.h>
+#include <Fit/MinuitHelp.h>
 #include <CppUtils/Num.h>
 
 #define _USE_MATH_DEFINES // To access mathematical constants such as pi
+#include <algorithm>
 #include <cmath>
 #include <limits> // For numerical limits (e.g. infinity)
+#include <stdexcept>
 
 // External 
 #include "Math/Functor.h"
@@ -16,9 +19,17 @@ namespace Fit {
 //------------------------------------------------------------------------------
 // Constructors
 
-PoissonNLLMinimizer::PoissonNLLMinimizer(FitContainer * container, const MinuitFactory &factory) : 
-  m_container(container) 
+PoissonNLLMinimizer::PoissonNLLMinimizer(
+  FitContainer * container, 
+  const MinuitFactory &factory,
+  size_t n_threads
+) : 
+  m_container(container),
+  m_evaluator(container, n_threads)
 {
+  /** Bin contributions can be evaluated with multiple threads.
+      Result does not depend on the number of threads.
+  **/
   this->update_nll();
   m_minimizer = factory.create_minimizer();
 }
@@ -27,6 +38,9 @@ PoissonNLLMinimizer::PoissonNLLMinimizer(FitContainer * container, const MinuitF
 // get functions
 
 double PoissonNLLMinimizer::get_nll() const { return m_nll; }
+const std::vector<double> & PoissonNLLMinimizer::get_nll_grad() const { 
+  return m_nll_grad; 
+}
 const FitResult& PoissonNLLMinimizer::get_result() const { return m_result; }
 
 //------------------------------------------------------------------------------
@@ -50,10 +64,74 @@ double PoissonNLLMinimizer::nll_gaussian(double x, double mu, double sigma) cons
   return log_2pi + 2.0 * std::log( sigma ) + std::pow( (x - mu) / sigma , 2);
 }
 
+double PoissonNLLMinimizer::nll_bin(double x, double mu) const {
+  /** Negative log likelihood (including factor -2) of a single bin.
+      x ... measured bin value
+      mu ... predicted bin value
+      (More details in update_nll)
+  **/
+  int n = int( x ); // Measurements have to be integer
+  
+  double num = 0;
+  
+  // Handle all possible cases of n and mu
+  if ( n == 0 ) {
+    if ( mu > 0 ) {
+      // Poisson NLL behaves well under these conditions
+      num = this->nll_poisson(n, mu);
+    } else {
+      // Poisson NLL goes to zero for mu->0 for n==0, continue at 0 for
+      // mu < 0 as well.
+      // => Negative pred. not punished, assume will be fixed by other bins
+      // num = 0; // redundant
+    }
+  } else if ( n <= 25 ) {
+    if ( mu > 0 ) {
+      // Poisson NLL behaves well under these conditions
+      num = this->nll_poisson(n, mu);
+    } else {
+      // Poisson NLL goes to infinity for mu->0 for n>0, continue at inf. for
+      // mu < 0 as well.
+      num = std::numeric_limits<double>::infinity();
+    }
+  } else {
+    // Measured value big enough that a gaussian can be assumed
+    if ( mu > 0 ) {
+      // Gaussian well behaved
+      num = this->nll_gaussian(double(n), mu, std::sqrt(mu));
+    } else {
+      // Gaussian assumption leads to infinity
+      num = std::numeric_limits<double>::infinity();
+    }
+  }
+  return num;
+}
+
+double PoissonNLLMinimizer::nll_bin_deriv(double x, double mu) const {
+  /** Derivative of the NLL of a single bin (see nll_bin) w.r.t. the predicted
+      bin value mu.
+      Where the NLL is continued constantly (mu <= 0) the derivative is 0.
+  **/
+  int n = int( x ); // Measurements have to be integer
+  
+  double deriv = 0;
+  if ( mu > 0 ) {
+    if ( n <= 25 ) {
+      // d/dmu of poissonian NLL
+      deriv = 2.0 - 2.0 * double(n) / mu;
+    } else {
+      // d/dmu of gaussian NLL with sigma^2 = mu
+      double diff = double(n) - mu;
+      deriv = 1.0 / mu - 2.0 * diff / mu - std::pow( diff / mu, 2 );
+    }
+  }
+  return deriv;
+}
+
 //------------------------------------------------------------------------------
 // Core functionality
 
-void PoissonNLLMinimizer::update_nll() {
+void PoissonNLLMinimizer::update_nll(const double * par_vals) {
   /** Update the poissonian negative log-likelihood.
       All measurement bins are assumed to have an positive integer value (>=0).
   
@@ -77,78 +155,151 @@ void PoissonNLLMinimizer::update_nll() {
         x ... measured parameter value
         mu ... current parameter value
         sigma ... uncertainty on measured parameter value
+        
+      Parameter values are taken from the given array (one per container
+      parameter) or, if none is given, from the container parameters.
   **/
   
-  m_nll = 0.0; // Reset NLL before summing it up again
-  
-  // For numerically safer Kahan sum
-  double num{0}, c{0}, y{0}, t{0};
+  const auto & vals_mst = m_evaluator.get_bin_arrays().m_vals_mst;
+  const auto & prds = m_evaluator.get_prds();
   
   // Find log-likelihood contributions from bin values
-  for ( const auto & bin : m_container->m_fit_bins ) {
-    int n = int( bin.get_val_mst() ); // Measurements have to be integer
-    double mu = bin.get_val_prd();    // Prediction
-    
-    num = 0; // Reset current number, to be determined below
-    
-    // Handle all possible cases of n and mu
-    if ( n == 0 ) {
-      if ( mu > 0 ) {
-        // Poisson NLL behaves well under these conditions
-        num = this->nll_poisson(n, mu);
-      } else {
-        // Poisson NLL goes to zero for mu->0 for n==0, continue at 0 for
-        // mu < 0 as well.
-        // => Negative pred. not punished, assume will be fixed by other bins
-        // num = 0; // redundant
-      }
-    } else if ( n <= 25 ) {
-      if ( mu > 0 ) {
-        // Poisson NLL behaves well under these conditions
-        num = this->nll_poisson(n, mu);
-      } else {
-        // Poisson NLL goes to infinity for mu->0 for n>0, continue at inf. for
-        // mu < 0 as well.
-        m_nll = std::numeric_limits<double>::infinity();
-        return; // No need to add any more
-      }
-    } else {
-      // Measured value big enough that a gaussian can be assumed
-      if ( mu > 0 ) {
-        // Gaussian well behaved
-        num = this->nll_gaussian(double(n), mu, std::sqrt(mu));
-      } else {
-        // Gaussian assumption leads to infinity
-        m_nll = std::numeric_limits<double>::infinity();
-        return; // No need to add any more
+  // Bins are Kahan-summed in chunks (sum and compensation of each chunk are 
+  // kept), chunks are then added in order 
+  // => same result for any number of threads
+  // Only chunks with bins that depend on changed parameters are re-evaluated
+  size_t n_chunks = m_evaluator.get_n_chunks();
+  m_chunk_sums.resize(n_chunks);
+  m_chunk_comps.resize(n_chunks);
+  m_evaluator.evaluate_changed(
+    [this, &vals_mst, &prds](size_t chunk, size_t bin_begin, size_t bin_end) {
+      // For numerically safer Kahan sum
+      double sum{0}, num{0}, c{0}, y{0}, t{0};
+      for ( size_t i=bin_begin; i<bin_end; i++ ) {
+        num = this->nll_bin(vals_mst[i], prds[i]);
+        if ( std::isinf(num) ) { // No need to add any more
+          sum = num;
+          c = 0;
+          break;
+        }
+        
+        // Perform the numerically safer Kahan sum
+        y = num - c;
+        t = sum + y;
+        c = (t - sum) - y;
+        sum = t;
       }
-    }    
-    
-    // Perform the numerically safer Kahan sum
-    y = num - c;
-    t = m_nll + y;
-    c = (t - m_nll) - y;
-    m_nll = t;
-  } // End bin loop
+      m_chunk_sums[chunk] = sum;
+      m_chunk_comps[chunk] = c;
+    },
+    par_vals
+  );
+  this->sum_up_nll();
+}
+
+void PoissonNLLMinimizer::update_nll_grad(const double * par_vals) {
+  /** Update the NLL (same as update_nll) and its analytic gradient w.r.t. all
+      parameters.
+      The derivatives of the bin NLLs w.r.t. the predictions are propagated 
+      through the compiled predictions, the gaussian parameter constraints
+      contribute 2 * (val - constr_val) / constr_unc^2.
+  **/
   
-  // Find log-likelihood contributions from parameter constraints
-  for ( const auto & par : m_container->m_fit_pars ) {
-    if ( (! par.is_fixed()) && par.has_constraint()) { 
-      // Parameter constraints are assumed to be gaussian
-      num = 
-        this->nll_gaussian( 
-          par.m_val_mod, 
-          par.get_constr_val(), 
-          par.get_constr_unc()
-        );
+  const auto & vals_mst = m_evaluator.get_bin_arrays().m_vals_mst;
+  const auto & prds = m_evaluator.get_prds();
+  
+  size_t n_chunks = m_evaluator.get_n_chunks();
+  m_chunk_sums.resize(n_chunks);
+  m_chunk_comps.resize(n_chunks);
+  m_evaluator.evaluate_gradient(
+    [this, &vals_mst, &prds](size_t chunk, size_t bin_begin, size_t bin_end,
+                         double * weights) {
+      // For numerically safer Kahan sum
+      double sum{0}, num{0}, c{0}, y{0}, t{0};
+      for ( size_t i=bin_begin; i<bin_end; i++ ) {
+        // Weights are needed for all bins, even if sum is already infinite
+        weights[i-bin_begin] = 
+          this->nll_bin_deriv(vals_mst[i], prds[i]);
+        if ( std::isinf(sum) ) { continue; }
+        
+        num = this->nll_bin(vals_mst[i], prds[i]);
+        if ( std::isinf(num) ) { // No need to add any more
+          sum = num;
+          c = 0;
+          continue;
+        }
         
-      // Perform the numerically safer Kahan sum
-      y = num - c;
+        // Perform the numerically safer Kahan sum
+        y = num - c;
+        t = sum + y;
+        c = (t - sum) - y;
+        sum = t;
+      }
+      m_chunk_sums[chunk] = sum;
+      m_chunk_comps[chunk] = c;
+    },
+    &m_nll_grad,
+    par_vals
+  );
+  this->sum_up_nll();
+  
+  // Same as derivative of gaussian NLL w.r.t. x
+  const auto & par_arrays = m_evaluator.get_par_arrays();
+  for ( size_t c=0; c<par_arrays.get_n_constrs(); c++ ) {
+    m_nll_grad[par_arrays.m_constr_idxs[c]] += 
+      par_arrays.calc_constr_chisq_deriv(c);
+  }
+}
+
+void PoissonNLLMinimizer::sum_up_nll() {
+  /** Kahan-sum the chunk sums (in order) and the parameter constraints.
+  **/
+  size_t n_chunks = m_chunk_sums.size();
+  m_nll = 0.0; // Reset NLL before summing it up again
+  double num{0}, c{0}, y{0}, t{0};
+  for ( size_t chunk=0; chunk<n_chunks; chunk++ ) {
+    if ( std::isinf(m_chunk_sums[chunk]) ) {
+      m_nll = std::numeric_limits<double>::infinity();
+      return; // No need to add any more
+    }
+    // Chunk sum and its compensation are added as separate numbers
+    for ( double chunk_num : {m_chunk_sums[chunk], - m_chunk_comps[chunk]} ) {
+      y = chunk_num - c;
       t = m_nll + y;
       c = (t - m_nll) - y;
       m_nll = t;
     }
   }
+  
+  // Find log-likelihood contributions from parameter constraints
+  const auto & par_arrays = m_evaluator.get_par_arrays();
+  for ( size_t i_constr=0; i_constr<par_arrays.get_n_constrs(); i_constr++ ) {
+    // Parameter constraints are assumed to be gaussian
+    num = 
+      this->nll_gaussian( 
+        par_arrays.m_vals[par_arrays.m_constr_idxs[i_constr]], 
+        par_arrays.m_constr_vals[i_constr], 
+        par_arrays.m_constr_uncs[i_constr]
+      );
+      
+    // Perform the numerically safer Kahan sum
+    y = num - c;
+    t = m_nll + y;
+    c = (t - m_nll) - y;
+    m_nll = t;
+  }
+}
+
+void PoissonNLLMinimizer::set_start(const FitResult & start) {
+  /** Start the following minimizations from a previous result (e.g. of a
+      neighbouring scan point or of a fit to similar measurements) instead of
+      the current parameter values (see MinuitHelp::set_variables).
+      Fixed parameters keep their values in the container.
+      The result must have the parameters of the container (in the same
+      order), an empty result removes the start.
+  **/
+  MinuitHelp::check_start(start, m_container->m_fit_pars);
+  m_start = start;
 }
 
 void PoissonNLLMinimizer::minimize() {
@@ -163,41 +314,49 @@ void PoissonNLLMinimizer::minimize() {
   // Tell minimizer to perform hessian error-calculation for accurate errors
   m_minimizer->SetValidError(true); 
   
-  // Create a vector holding the addresses of the parameter values
-  // => Minimizer will directly change parameter values by changing the 
-  //    values at the addresses
+  // Minimizer parameter array has the same order as the container parameters
+  // => Predictions and constraints are evaluated directly from it, the
+  //    container parameters only get the values of the last evaluation
+  //    at the end
   const unsigned int n_pars = m_container->m_fit_pars.size();
-  std::vector<double*> pars(n_pars);
-  for ( unsigned int i=0; i<n_pars; i++ ){
-    pars[i] = &(m_container->m_fit_pars[i].m_val_mod);
-  }
-    
+  m_evaluator.update_pars(); // Parameters may have been fixed or released
+  
   // Thing that minimizer performs NLL minimization on
   const ROOT::Math::Functor recalc_nll (
     // Lambda function for the minimizer:
-    // Update the parameter set, then recalculate and return new NLL
-    [pars, n_pars, this](const double * _pars) { 
-      for ( unsigned int i=0; i<n_pars; i++ ) { *(pars[i]) = _pars[i]; }
-      this->update_nll();
+    // Recalculate and return new NLL for the parameter set
+    [this](const double * _pars) {
+      this->update_nll(_pars);
       return this->get_nll();
     },
     // Needs to know the correct number of parameters
     n_pars
   );
   
+  // With analytic gradient: Minimizer asks for one derivative at a time
+  // => Calculate full gradient once per point and remember the point
+  // (Minuit2 keeps a copy of the function => lambdas may not refer to locals)
+  m_grad_pars.assign(n_pars, std::numeric_limits<double>::quiet_NaN());
+  const ROOT::Math::GradFunctor recalc_nll_grad (
+    [recalc_nll](const double * _pars) { return recalc_nll(_pars); },
+    [n_pars, this](const double * _pars, unsigned int i_par) {
+      if ( !std::equal(_pars, _pars+n_pars, m_grad_pars.begin()) ) {
+        this->update_nll_grad(_pars);
+        m_grad_pars.assign(_pars, _pars+n_pars);
+      }
+      return this->get_nll_grad()[i_par];
+    },
+    n_pars
+  );
+  
   // Set up minimizer by telling about function and parameters
-  m_minimizer->SetFunction(recalc_nll);
-  for ( unsigned int i_par=0; i_par<n_pars; i_par++ ){
-    FitPar par = m_container->m_fit_pars[i_par];
-    m_minimizer->SetVariable( i_par, par.get_name(), par.m_val_mod, par.get_unc_ini() );
-    // Check if parameter is fixed or limited
-    if (par.is_fixed()) {
-      m_minimizer->FixVariable(i_par); 
-    } else if (par.is_limited()) {
-      m_minimizer->SetVariableLimits( 
-        i_par, par.get_upper_lim(), par.get_lower_lim());
-    }
+  if ( m_evaluator.has_gradient() ) {
+    m_minimizer->SetFunction(recalc_nll_grad);
+  } else {
+    m_minimizer->SetFunction(recalc_nll);
   }
+  MinuitHelp::set_variables(
+    m_container->m_fit_pars, m_start, m_minimizer.get());
   
   // -------------------------------------------------------------------------//
   // --------------------------------ACTION!----------------------------------//
@@ -226,12 +385,27 @@ void PoissonNLLMinimizer::minimize() {
     spdlog::debug("Minimisation used parameter limits, recalculating error without limits for accuracy.");
     m_minimizer->Hesse(); 
   }
+  m_evaluator.get_par_arrays().write_vals(&(m_container->m_fit_pars));
   
   // Form a usable output collection
   this->collect_par_names();
   this->update_result();
 }
 
+void PoissonNLLMinimizer::reset() {
+  /** Prepare a new minimization after the bins or parameters of the container
+      were updated (see FitContainer::update_measurements and update_pars).
+      Measured values are taken from the container again, the Minuit2
+      instance is cleared and reused.
+  **/
+  m_minimizer->Clear();
+  m_result = FitResult();
+  m_nll_grad.clear();
+  m_grad_pars.clear();
+  m_evaluator.update_measurements();
+  this->update_nll();
+}
+
 //------------------------------------------------------------------------------
 // Result collecting
 
@@ -0,0 +1,358 @@
+#include <Fit/PrdEvaluator.h>
+
+#include <algorithm>
+#include <cstring>
+#include <stdexcept>
+
+namespace PrEW {
+namespace Fit {
+
+//------------------------------------------------------------------------------
+// Constructors
+
+PrdEvaluator::PrdEvaluator(
+  FitContainer * container,
+  size_t n_threads,
+  size_t bins_per_chunk
+) :
+  m_container(container),
+  m_bins_per_chunk(bins_per_chunk),
+  m_pool(new CppUtils::ThreadPool(n_threads)),
+  m_par_arrays(container->m_fit_pars),
+  m_bin_arrays(container->m_fit_bins),
+  m_scratches(n_threads)
+{
+  if (m_bins_per_chunk == 0) {
+    throw std::invalid_argument("PrdEvaluator needs at least 1 bin per chunk!");
+  }
+  auto n_prd_bins = m_container->m_prd_program.get_n_bins();
+  if ( (n_prd_bins > 0) && (n_prd_bins != m_container->m_fit_bins.size()) ) {
+    throw std::invalid_argument(
+      "Prediction program and bins of fit container don't match!");
+  }
+  const auto & terms = m_container->m_prd_terms;
+  if ( (!terms.is_empty()) && 
+       (terms.get_n_pars() != m_container->m_fit_pars.size()) ) {
+    throw std::invalid_argument(
+      "Prediction terms and parameters of fit container don't match!");
+  }
+}
+
+//------------------------------------------------------------------------------
+// Access functions
+
+size_t PrdEvaluator::get_n_threads() const { return m_pool->get_n_threads(); }
+
+size_t PrdEvaluator::get_n_chunks() const {
+  return
+    (m_container->m_fit_bins.size() + m_bins_per_chunk - 1) / m_bins_per_chunk;
+}
+
+const CppUtils::Vec::AlignedVec<double> & PrdEvaluator::get_prds() const { 
+  return m_bin_arrays.m_prds; 
+}
+const BinArrays & PrdEvaluator::get_bin_arrays() const { return m_bin_arrays; }
+const ParArrays & PrdEvaluator::get_par_arrays() const { return m_par_arrays; }
+
+bool PrdEvaluator::has_gradient() const {
+  /** Analytic gradient only available with a compiled prediction program.
+  **/
+  const auto & program = m_container->m_prd_program;
+  return (program.get_n_bins() > 0) && program.has_gradient();
+}
+
+//------------------------------------------------------------------------------
+// Internal functions
+
+void PrdEvaluator::update_chunk_prds(
+  size_t bin_begin,
+  size_t bin_end,
+  size_t thread
+) {
+  /** Update the predictions of the bins in [bin_begin, bin_end).
+  **/
+  const auto & program = m_container->m_prd_program;
+  if ( program.get_n_bins() > 0 ) {
+    program.evaluate_bins( bin_begin, bin_end, m_par_arrays.m_vals.data(),
+                           m_prd_vals.data(), &(m_scratches[thread]),
+                           m_bin_arrays.m_prds.data() + bin_begin );
+  } else {
+    const auto & bins = m_container->m_fit_bins;
+    const double * vals = m_container->m_prd_terms.is_empty() ? 
+      m_par_arrays.m_vals.data() : m_bound_vals.data();
+    for ( size_t i=bin_begin; i<bin_end; i++ ) {
+      m_bin_arrays.m_prds[i] = bins[i].get_val_prd(vals);
+    }
+  }
+}
+
+void PrdEvaluator::update_scalars(const double * par_vals) {
+  /** Take the given parameter values (or the current values of the container
+      parameters if none are given) and evaluate the scalars of the 
+      prediction program (if there is one).
+  **/
+  const auto & program = m_container->m_prd_program;
+  if ( (par_vals == nullptr) || 
+       (m_par_arrays.size() != m_container->m_fit_pars.size()) ) {
+    this->update_pars();
+  }
+  if ( par_vals != nullptr ) { m_par_arrays.set_vals(par_vals); }
+  if ( program.get_n_bins() > 0 ) {
+    m_prd_vals.resize(program.get_n_vals());
+    program.evaluate_scalars( m_par_arrays.m_vals.data(), m_prd_vals.data(),
+                              &(m_scratches[0]) );
+  }
+}
+
+void PrdEvaluator::update_terms(bool all) {
+  /** Put the current parameter values and the shared terms of the bound
+      predictions (if there are any and no compiled program is used) into the
+      value array of the bound predictions.
+      Unless all are requested, only the term groups that depend on 
+      parameters which changed since the last evaluation are recalculated 
+      (parameter values compared bitwise).
+  **/
+  const auto & terms = m_container->m_prd_terms;
+  if ( terms.is_empty() || (m_container->m_prd_program.get_n_bins() > 0) ) {
+    return;
+  }
+  const auto & par_vals = m_par_arrays.m_vals;
+  all = all || (!m_prds_valid) || (m_bound_vals.size() != terms.get_n_vals()) ||
+        (m_last_par_vals.size() != par_vals.size());
+  m_bound_vals.resize(terms.get_n_vals());
+  std::copy(par_vals.begin(), par_vals.end(), m_bound_vals.begin());
+  
+  m_changed_groups.clear();
+  std::vector<char> par_changed (par_vals.size(), 1);
+  if ( !all ) {
+    for ( size_t i=0; i<par_vals.size(); i++ ) {
+      par_changed[i] = std::memcmp( &(par_vals[i]), &(m_last_par_vals[i]),
+                                    sizeof(double) ) != 0;
+    }
+  }
+  for ( size_t group=0; group<terms.get_n_groups(); group++ ) {
+    const auto & par_idxs = terms.get_par_idxs(group);
+    if ( all || std::any_of( par_idxs.begin(), par_idxs.end(),
+                             [&par_changed](size_t i) { 
+                               return par_changed[i] != 0; 
+                             } ) ) {
+      m_changed_groups.push_back(group);
+    }
+  }
+  
+  // Groups write to separate parts of the array => can run in parallel
+  size_t n_changed = m_changed_groups.size();
+  size_t n_tasks = (n_changed + m_bins_per_chunk - 1) / m_bins_per_chunk;
+  m_pool->run(
+    n_tasks,
+    [this, n_changed, &terms](size_t task, size_t) {
+      size_t begin = task * m_bins_per_chunk;
+      size_t end = std::min(begin + m_bins_per_chunk, n_changed);
+      for ( size_t i=begin; i<end; i++ ) {
+        terms.evaluate_group(m_changed_groups[i], m_bound_vals.data());
+      }
+    }
+  );
+}
+
+void PrdEvaluator::find_changed_chunks() {
+  /** Find the chunks whose bins depend on parameters that changed since the
+      last evaluation.
+      All chunks if there was no previous evaluation or the container has no
+      parameter-bin index.
+      Parameter values are compared bitwise.
+  **/
+  const auto & index = m_container->m_par_bin_index;
+  size_t n_chunks = this->get_n_chunks();
+  m_changed_chunks.clear();
+  
+  if ( (!m_prds_valid) || index.is_empty() ||
+       (m_last_par_vals.size() != m_par_arrays.m_vals.size()) ) {
+    for ( size_t chunk=0; chunk<n_chunks; chunk++ ) {
+      m_changed_chunks.push_back(chunk);
+    }
+    return;
+  }
+  
+  std::vector<size_t> changed_pars {};
+  for ( size_t i=0; i<m_par_arrays.m_vals.size(); i++ ) {
+    if ( std::memcmp( &(m_par_arrays.m_vals[i]), &(m_last_par_vals[i]), 
+                      sizeof(double) ) != 0 ) {
+      changed_pars.push_back(i);
+    }
+  }
+  
+  // Ranges are sorted => chunks are found in increasing order
+  for ( const auto & range: index.get_bin_ranges(changed_pars) ) {
+    size_t chunk_begin = range.m_begin / m_bins_per_chunk;
+    size_t chunk_end = 
+      std::min( (range.m_end + m_bins_per_chunk - 1) / m_bins_per_chunk, 
+                n_chunks );
+    for ( size_t chunk=chunk_begin; chunk<chunk_end; chunk++ ) {
+      if ( m_changed_chunks.empty() || (m_changed_chunks.back() < chunk) ) {
+        m_changed_chunks.push_back(chunk);
+      }
+    }
+  }
+}
+
+void PrdEvaluator::run_chunks(const ChunkFct & chunk_fct) {
+  /** Update predictions of all chunks in m_changed_chunks and call chunk_fct 
+      for each of them.
+      Afterwards all predictions are up to date for the current parameters.
+  **/
+  size_t n_bins = m_container->m_fit_bins.size();
+  m_pool->run(
+    m_changed_chunks.size(),
+    [this, n_bins, &chunk_fct](size_t task, size_t thread) {
+      size_t chunk = m_changed_chunks[task];
+      size_t bin_begin = chunk * m_bins_per_chunk;
+      size_t bin_end = std::min(bin_begin + m_bins_per_chunk, n_bins);
+      this->update_chunk_prds(bin_begin, bin_end, thread);
+      chunk_fct(chunk, bin_begin, bin_end);
+    }
+  );
+  m_last_par_vals = m_par_arrays.m_vals;
+  m_prds_valid = true;
+}
+
+//------------------------------------------------------------------------------
+// Core functionality
+
+void PrdEvaluator::update_measurements() {
+  /** Take the measured values of the bins from the container again (needed
+      whenever the measurements of the bins were changed).
+  **/
+  m_bin_arrays.set_measurements(m_container->m_fit_bins);
+  m_prds_valid = false;
+}
+
+void PrdEvaluator::update_pars() {
+  /** Take the values and constraints of the parameters from the container 
+      again (needed before evaluating with values given as array whenever
+      parameters were fixed, released or constrained).
+  **/
+  m_par_arrays.set_pars(m_container->m_fit_pars);
+}
+
+void PrdEvaluator::evaluate(
+  const ChunkFct & chunk_fct, 
+  const double * par_vals
+) {
+  /** Update the predictions of all bins using the given parameter values
+      (one per container parameter) or, if none are given, the current values
+      of the container parameters.
+      After the predictions of a chunk are updated chunk_fct is called for the
+      chunk (in the same thread), it may only access the predictions of the
+      bins of that chunk.
+  **/
+  size_t n_bins = m_container->m_fit_bins.size();
+
+  if ( m_bin_arrays.size() != n_bins ) { this->update_measurements(); }
+  this->update_scalars(par_vals);
+  this->update_terms(true);
+
+  m_changed_chunks.clear();
+  for ( size_t chunk=0; chunk<this->get_n_chunks(); chunk++ ) {
+    m_changed_chunks.push_back(chunk);
+  }
+  this->run_chunks(chunk_fct);
+}
+
+void PrdEvaluator::evaluate_changed(
+  const ChunkFct & chunk_fct,
+  const double * par_vals
+) {
+  /** Update the predictions like evaluate, but only for the chunks whose bins
+      depend on parameters that changed since the last evaluation (according
+      to the parameter-bin index of the container).
+      chunk_fct is only called for these chunks, anything calculated for the
+      other chunks in previous evaluations is still valid.
+  **/
+  size_t n_bins = m_container->m_fit_bins.size();
+
+  if ( m_bin_arrays.size() != n_bins ) { this->update_measurements(); }
+  this->update_scalars(par_vals);
+  this->update_terms(false);
+  
+  this->find_changed_chunks();
+  this->run_chunks(chunk_fct);
+}
+
+//------------------------------------------------------------------------------
+
+void PrdEvaluator::evaluate_gradient(
+  const GradChunkFct & chunk_fct,
+  std::vector<double> * grad,
+  const double * par_vals
+) {
+  /** Update the predictions like evaluate and calculate the gradient of
+      sum_i w_i * prd_i w.r.t. all parameters of the container.
+      chunk_fct is called after the predictions of a chunk are updated and 
+      has to set the weights w_i of the bins of the chunk 
+      (weights[0, bin_end-bin_begin)), typically the derivative of the
+      minimized quantity w.r.t. the bin prediction.
+      Gradient contributions are collected per chunk and added in chunk order
+      (=> same result for any number of threads).
+  **/
+  if ( !this->has_gradient() ) {
+    throw std::invalid_argument(
+      "PrdEvaluator: No analytic gradient without derivatives of all functions"
+      " in compiled prediction program!");
+  }
+  const auto & program = m_container->m_prd_program;
+  size_t n_bins = m_container->m_fit_bins.size();
+  size_t n_pars = m_container->m_fit_pars.size();
+  size_t n_chunks = this->get_n_chunks();
+  size_t n_scalars = program.get_n_scalar_adjs();
+
+  if ( m_bin_arrays.size() != n_bins ) { this->update_measurements(); }
+  m_weights.resize(n_bins);
+  m_adjs.resize(program.get_n_vals());
+  m_chunk_grads.resize(n_chunks);
+  m_chunk_scalar_adjs.resize(n_chunks);
+  this->update_scalars(par_vals);
+
+  m_pool->run(
+    n_chunks,
+    [this, n_bins, n_pars, n_scalars, &program, &chunk_fct](
+      size_t chunk, size_t thread
+    ) {
+      size_t bin_begin = chunk * m_bins_per_chunk;
+      size_t bin_end = std::min(bin_begin + m_bins_per_chunk, n_bins);
+      this->update_chunk_prds(bin_begin, bin_end, thread);
+      chunk_fct(chunk, bin_begin, bin_end, m_weights.data() + bin_begin);
+      
+      auto & chunk_grad = m_chunk_grads[chunk];
+      auto & chunk_scalar_adjs = m_chunk_scalar_adjs[chunk];
+      chunk_grad.assign(n_pars, 0.0);
+      chunk_scalar_adjs.assign(n_scalars, 0.0);
+      program.backprop_bins( bin_begin, bin_end, m_par_arrays.m_vals.data(),
+                             m_prd_vals.data(), m_weights.data() + bin_begin,
+                             m_adjs.data(), chunk_scalar_adjs.data(),
+                             &(m_scratches[thread]), chunk_grad.data() );
+    }
+  );
+  m_last_par_vals = m_par_arrays.m_vals;
+  m_prds_valid = true;
+
+  // Combine chunks in order, then propagate through scalars
+  grad->assign(n_pars, 0.0);
+  std::vector<double> scalar_adjs (n_scalars, 0.0);
+  for ( size_t chunk=0; chunk<n_chunks; chunk++ ) {
+    for ( size_t p=0; p<n_pars; p++ ) {
+      (*grad)[p] += m_chunk_grads[chunk][p];
+    }
+    for ( size_t s=0; s<n_scalars; s++ ) {
+      scalar_adjs[s] += m_chunk_scalar_adjs[chunk][s];
+    }
+  }
+  program.backprop_scalars( m_par_arrays.m_vals.data(), m_prd_vals.data(), 
+                            scalar_adjs.data(), &(m_scratches[0]),
+                            grad->data() );
+}
+
+//------------------------------------------------------------------------------
+
+}
+}
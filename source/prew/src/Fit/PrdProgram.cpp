@@ -0,0 +1,860 @@
+#include <Fit/PrdProgram.h>
+
+#include <algorithm>
+#include <cstring>
+#include <stdexcept>
+#include <string>
+
+namespace PrEW {
+namespace Fit {
+
+//------------------------------------------------------------------------------
+// Constructors
+
+PrdProgram::PrdProgram() {
+  /** Program always starts with the scalar segment (single row, no coordinate).
+  **/
+  this->add_segment({{}});
+}
+
+//------------------------------------------------------------------------------
+// Internal functions
+
+size_t PrdProgram::add_fct(
+  const std::string & fct_name,
+  const Fcts::ParametrisationFct & fct,
+  const Fcts::ParametrisationGrad & grad
+) {
+  /** Add function to function table (if not already there) and return its
+      index in the table.
+      A derivative given later for a known function is added to the table.
+  **/
+  for (size_t f=0; f<m_fct_names.size(); f++) {
+    if (m_fct_names[f] == fct_name) { 
+      if ( (!m_grads[f]) && grad ) { m_grads[f] = grad; }
+      return f; 
+    }
+  }
+  m_fct_names.push_back(fct_name);
+  m_fcts.push_back(fct);
+  m_grads.push_back(grad);
+  return m_fcts.size() - 1;
+}
+
+//------------------------------------------------------------------------------
+
+void PrdProgram::check_input(size_t segment, const Ref & input) const {
+  /** Check that the input column can be used in the given segment.
+      Column inputs must be from the same segment or from a shared segment 
+      with the same number of rows, scalar inputs from the scalar segment 
+      (both are evaluated before all other segments).
+  **/
+  if (input.m_stride == 0) {
+    if (input.m_offset >= m_n_vals) {
+      throw std::out_of_range("PrdProgram: Input value does not exist!");
+    }
+  } else if ( (segment == 0) || (input.m_offset < m_last_seg_vals) ||
+              (input.m_offset + m_segments[segment].m_n_rows > m_n_vals) ) {
+    const SharedCol * shared = this->find_shared_col(input.m_offset);
+    if ( (segment == 0) || (shared == nullptr) || 
+         (shared->m_n_rows != m_segments[segment].m_n_rows) ) {
+      throw std::invalid_argument("PrdProgram: Input column not in segment!");
+    }
+  }
+}
+
+void PrdProgram::check_const(size_t segment, const Ref & constant) const {
+  /** Check that the constant column has enough rows for the given segment.
+  **/
+  size_t n_used = constant.m_stride * (m_segments[segment].m_n_rows - 1) + 1;
+  if (constant.m_offset + n_used > m_consts.size()) {
+    throw std::out_of_range("PrdProgram: Constant column too short!");
+  }
+}
+
+//------------------------------------------------------------------------------
+
+PrdProgram::Ref PrdProgram::add_op(
+  size_t segment,
+  Op op,
+  const std::vector<Ref> & inputs
+) {
+  /** Add an operation to the given segment and reserve its output column.
+      Only the scalar segment and the newest segment can be extended.
+  **/
+  if ( (segment != 0) && (segment != m_segments.size() - 1) ) {
+    throw std::invalid_argument(
+      "PrdProgram: Can only add operations to scalar or newest segment!");
+  }
+
+  op.m_in_begin = m_refs.size();
+  op.m_n_in = inputs.size();
+  m_refs.insert(m_refs.end(), inputs.begin(), inputs.end());
+
+  op.m_out = m_n_vals;
+  size_t n_rows = m_segments[segment].m_n_rows;
+  m_n_vals += n_rows;
+  m_segments[segment].m_ops.push_back(op);
+  
+  if (m_segments[segment].m_is_shared) {
+    m_shared_cols.push_back({op.m_out, n_rows, m_n_shared_vals});
+    m_n_shared_vals += n_rows;
+  }
+
+  return Ref{op.m_out, segment == 0 ? 0 : size_t(1)};
+}
+
+void PrdProgram::check_call(
+  size_t segment, 
+  const std::vector<Ref> & coefs
+) const {
+  /** Check that a call with the given coefficients can be added to the 
+      segment.
+  **/
+  if (segment >= m_segments.size()) {
+    throw std::out_of_range("PrdProgram: Segment does not exist!");
+  }
+  for (const auto & coef: coefs) { this->check_const(segment, coef); }
+}
+
+bool PrdProgram::find_scalar_call(
+  size_t segment,
+  const std::string & fct_name,
+  const std::vector<Ref> & coefs,
+  const std::vector<size_t> & par_idxs,
+  Ref * ref
+) const {
+  /** Find a call in the scalar segment with the same function, coefficient 
+      values (compared bitwise) and parameters.
+      Sets the reference to its output and returns true if there is one.
+  **/
+  if (segment != 0) { return false; }
+  for (const auto & op: m_segments[0].m_ops) {
+    if ( (op.m_code != OpCode::Call) || (m_fct_names[op.m_fct] != fct_name) ||
+         (op.m_n_in != coefs.size()) || (op.m_n_pars != par_idxs.size()) ) {
+      continue;
+    }
+    bool same = std::equal( par_idxs.begin(), par_idxs.end(), 
+                            m_par_idxs.begin() + long(op.m_par_begin) );
+    for (size_t c=0; same && (c<coefs.size()); c++) {
+      const double & op_coef = m_consts[m_refs[op.m_in_begin + c].m_offset];
+      same = 
+        std::memcmp( &op_coef, &(m_consts[coefs[c].m_offset]), 
+                     sizeof(double) ) == 0;
+    }
+    if (same) {
+      *ref = Ref{op.m_out, 0};
+      return true;
+    }
+  }
+  return false;
+}
+
+PrdProgram::Op PrdProgram::call_op(
+  const std::string & fct_name,
+  const Fcts::ParametrisationFct & fct,
+  const std::vector<size_t> & par_idxs,
+  const Fcts::ParametrisationGrad & grad
+) {
+  /** Create the (general) call operation of a function and store its 
+      parameter indices.
+  **/
+  Op op {};
+  op.m_code = OpCode::Call;
+  op.m_fct = this->add_fct(fct_name, fct, grad);
+  op.m_par_begin = m_par_idxs.size();
+  op.m_n_pars = par_idxs.size();
+  m_par_idxs.insert(m_par_idxs.end(), par_idxs.begin(), par_idxs.end());
+  return op;
+}
+
+void PrdProgram::add_prepared(
+  size_t segment,
+  const Fcts::FctEntry & entry,
+  const std::vector<Ref> & coefs,
+  Op * op
+) {
+  /** Calculate the prepared bin-constant quantities of the function for all
+      rows of the segment and store them as constant columns used by the 
+      call operation.
+  **/
+  const auto & seg = m_segments[segment];
+  std::vector<double> c (coefs.size());
+  std::vector<double> q (entry.m_n_prep);
+  std::vector<std::vector<double>> q_cols (
+    entry.m_n_prep, std::vector<double>(seg.m_n_rows) );
+  for (size_t row=0; row<seg.m_n_rows; row++) {
+    for (size_t i=0; i<coefs.size(); i++) {
+      c[i] = m_consts[coefs[i].m_offset + row * coefs[i].m_stride];
+    }
+    entry.m_prep(m_coords[seg.m_coord_begin + row], c.data(), q.data());
+    for (size_t i=0; i<q.size(); i++) { q_cols[i][row] = q[i]; }
+  }
+  
+  op->m_prep_begin = m_refs.size();
+  op->m_n_prep = entry.m_n_prep;
+  for (const auto & q_col: q_cols) { 
+    m_refs.push_back(this->add_const(q_col)); 
+  }
+}
+
+//------------------------------------------------------------------------------
+// Building the program
+
+size_t PrdProgram::add_segment(const Data::CoordVec & coords) {
+  /** Add a new segment with one row per given coordinate, returns the index of
+      the segment.
+  **/
+  if (coords.size() == 0) {
+    throw std::invalid_argument("PrdProgram: Segment needs at least one row!");
+  }
+  Segment segment {};
+  segment.m_n_rows = coords.size();
+  segment.m_coord_begin = m_coords.size();
+  segment.m_val_begin = m_n_vals;
+  m_coords.insert(m_coords.end(), coords.begin(), coords.end());
+  m_segments.push_back(segment);
+  m_last_seg_vals = m_n_vals;
+  return m_segments.size() - 1;
+}
+
+size_t PrdProgram::add_shared_segment(const Data::CoordVec & coords) {
+  /** Add a new shared segment with one row per given coordinate, returns the
+      index of the segment.
+      Its columns can be used in any later segment with the same number of
+      rows (rows are matched by index, coordinates aren't compared).
+  **/
+  size_t segment = this->add_segment(coords);
+  m_segments[segment].m_is_shared = true;
+  return segment;
+}
+
+//------------------------------------------------------------------------------
+
+PrdProgram::Ref PrdProgram::add_const(double val) {
+  /** Add a constant that is the same for all rows.
+  **/
+  m_consts.push_back(val);
+  return Ref{m_consts.size() - 1, 0};
+}
+
+PrdProgram::Ref PrdProgram::add_const(const std::vector<double> & col) {
+  /** Add a constant column (one value per row).
+  **/
+  Ref ref {m_consts.size(), 1};
+  m_consts.insert(m_consts.end(), col.begin(), col.end());
+  return ref;
+}
+
+//------------------------------------------------------------------------------
+
+PrdProgram::Ref PrdProgram::add_call(
+  size_t segment,
+  const std::string & fct_name,
+  const Fcts::ParametrisationFct & fct,
+  const std::vector<Ref> & coefs,
+  const std::vector<size_t> & par_idxs,
+  const Fcts::ParametrisationGrad & grad
+) {
+  /** Add the call of a parametrisation function to the given segment.
+      Coefficients refer to the constant storage, parameters are indices in
+      the parameter array given at evaluation.
+      The derivatives of the function w.r.t. its parameters are optional, but
+      needed for the analytic gradient.
+  **/
+  this->check_call(segment, coefs);
+  Ref ref {};
+  if ( this->find_scalar_call(segment, fct_name, coefs, par_idxs, &ref) ) {
+    this->add_fct(fct_name, fct, grad); // Derivative may be new
+    return ref;
+  }
+  Op op = this->call_op(fct_name, fct, par_idxs, grad);
+  return this->add_op(segment, op, coefs);
+}
+
+PrdProgram::Ref PrdProgram::add_call(
+  size_t segment,
+  const std::string & fct_name,
+  const Fcts::FctEntry & entry,
+  const std::vector<Ref> & coefs,
+  const std::vector<size_t> & par_idxs
+) {
+  /** Add the call of a function from the function registry to the given 
+      segment (see above).
+      The typed version of the function evaluates all rows at once, 
+      bin-constant quantities of functions with a preparation are calculated
+      here once for all rows.
+  **/
+  Fcts::Registry::check_arity(fct_name, entry, coefs.size(), par_idxs.size());
+  this->check_call(segment, coefs);
+  Ref ref {};
+  if ( this->find_scalar_call(segment, fct_name, coefs, par_idxs, &ref) ) {
+    this->add_fct(fct_name, entry.m_fct, entry.m_grad);
+    return ref;
+  }
+  Op op = this->call_op(fct_name, entry.m_fct, par_idxs, entry.m_grad);
+  op.m_rows = entry.m_rows;
+  if (entry.m_prep) { this->add_prepared(segment, entry, coefs, &op); }
+  return this->add_op(segment, op, coefs);
+}
+
+//------------------------------------------------------------------------------
+
+PrdProgram::Ref PrdProgram::add_prod(
+  size_t segment,
+  const std::vector<Ref> & inputs
+) {
+  /** Add the product of the input columns to the given segment.
+  **/
+  if (segment >= m_segments.size()) {
+    throw std::out_of_range("PrdProgram: Segment does not exist!");
+  }
+  if (inputs.size() == 0) {
+    throw std::invalid_argument("PrdProgram: Empty product!");
+  }
+  for (const auto & input: inputs) { this->check_input(segment, input); }
+
+  Op op {};
+  op.m_code = OpCode::Prod;
+
+  return this->add_op(segment, op, inputs);
+}
+
+PrdProgram::Ref PrdProgram::add_prod(
+  size_t segment,
+  const std::vector<Ref> & inputs,
+  const Ref & constant
+) {
+  /** Add the product of the constant column and the input columns to the
+      given segment.
+  **/
+  if (segment >= m_segments.size()) {
+    throw std::out_of_range("PrdProgram: Segment does not exist!");
+  }
+  this->check_const(segment, constant);
+  for (const auto & input: inputs) { this->check_input(segment, input); }
+
+  Op op {};
+  op.m_code = OpCode::Prod;
+  op.m_has_const = true;
+  op.m_const = constant;
+
+  return this->add_op(segment, op, inputs);
+}
+
+//------------------------------------------------------------------------------
+
+PrdProgram::Ref PrdProgram::add_sum(
+  size_t segment,
+  const std::vector<Ref> & inputs
+) {
+  /** Add the sum of the input columns to the given segment.
+  **/
+  if (segment >= m_segments.size()) {
+    throw std::out_of_range("PrdProgram: Segment does not exist!");
+  }
+  if (inputs.size() == 0) {
+    throw std::invalid_argument("PrdProgram: Empty sum!");
+  }
+  for (const auto & input: inputs) { this->check_input(segment, input); }
+
+  Op op {};
+  op.m_code = OpCode::Sum;
+
+  return this->add_op(segment, op, inputs);
+}
+
+//------------------------------------------------------------------------------
+
+void PrdProgram::add_bins(size_t segment, const Ref & col) {
+  /** Use the rows of the given column as predictions of the next bins.
+      Each (non-scalar) segment can provide the predictions for one set of
+      bins.
+  **/
+  if (segment >= m_segments.size()) {
+    throw std::out_of_range("PrdProgram: Segment does not exist!");
+  }
+  if (segment == 0) {
+    throw std::invalid_argument("PrdProgram: Scalar segment can't have bins!");
+  }
+  if (m_segments[segment].m_is_shared) {
+    throw std::invalid_argument("PrdProgram: Shared segment can't have bins!");
+  }
+  for (const auto & block: m_bin_blocks) {
+    if (block.m_segment == segment) {
+      throw std::invalid_argument("PrdProgram: Segment already has bins!");
+    }
+  }
+  this->check_input(segment, col);
+  m_bin_blocks.push_back({segment, m_n_bins, col});
+  m_n_bins += m_segments[segment].m_n_rows;
+}
+
+//------------------------------------------------------------------------------
+// Access functions
+
+size_t PrdProgram::get_n_bins() const { return m_n_bins; }
+size_t PrdProgram::get_n_segments() const { return m_segments.size(); }
+
+size_t PrdProgram::get_n_ops() const {
+  size_t n_ops = 0;
+  for (const auto & segment: m_segments) { n_ops += segment.m_ops.size(); }
+  return n_ops;
+}
+
+size_t PrdProgram::get_n_vals() const { return m_n_vals; }
+size_t PrdProgram::get_n_scalars() const { return m_segments[0].m_ops.size(); }
+
+size_t PrdProgram::get_n_scalar_adjs() const { 
+  /** Number of scalar adjoints: one per scalar and per row of each shared 
+      column.
+  **/
+  return this->get_n_scalars() + m_n_shared_vals; 
+}
+
+bool PrdProgram::has_gradient() const {
+  /** Check if the analytic gradient is available, which requires derivatives
+      for all called functions that have parameters.
+  **/
+  for (const auto & segment: m_segments) {
+    for (const auto & op: segment.m_ops) {
+      if ( (op.m_code == OpCode::Call) && (op.m_n_pars > 0) && 
+           (!m_grads[op.m_fct]) ) {
+        return false;
+      }
+    }
+  }
+  return true;
+}
+
+//------------------------------------------------------------------------------
+// Evaluation
+
+void PrdProgram::eval_op(
+  const Op & op,
+  const Segment & segment,
+  size_t row_begin,
+  size_t row_end,
+  const double * par_vals,
+  double * vals,
+  Scratch * scratch
+) const {
+  /** Evaluate a single operation for the given rows of its segment.
+      All operations only use values of the same row (or scalars), so
+      different rows can be evaluated independently.
+  **/
+  double * out = vals + op.m_out;
+  const Ref * inputs = m_refs.data() + op.m_in_begin;
+
+  switch (op.m_code) {
+    case OpCode::Call: {
+      // Parameters are given to the functions as pointers, use the scratch
+      scratch->m_p_vals.resize(op.m_n_pars);
+      scratch->m_p.resize(op.m_n_pars);
+      for (size_t p=0; p<op.m_n_pars; p++) {
+        scratch->m_p_vals[p] = par_vals[m_par_idxs[op.m_par_begin + p]];
+        scratch->m_p[p] = &(scratch->m_p_vals[p]);
+      }
+      
+      // Typed function evaluates all rows directly from the columns 
+      // (prepared columns in place of coefficients if there are any)
+      if (op.m_rows) {
+        const Ref * cols = inputs;
+        size_t n_cols = op.m_n_in;
+        if (op.m_n_prep > 0) {
+          cols = m_refs.data() + op.m_prep_begin;
+          n_cols = op.m_n_prep;
+        }
+        scratch->m_c_cols.resize(n_cols);
+        scratch->m_c_strides.resize(n_cols);
+        for (size_t c=0; c<n_cols; c++) {
+          scratch->m_c_cols[c] = 
+            m_consts.data() + cols[c].m_offset + row_begin * cols[c].m_stride;
+          scratch->m_c_strides[c] = cols[c].m_stride;
+        }
+        op.m_rows( m_coords.data() + segment.m_coord_begin + row_begin,
+                   row_end - row_begin, scratch->m_c_cols.data(), 
+                   scratch->m_c_strides.data(), scratch->m_p.data(), 
+                   out + row_begin );
+        break;
+      }
+      
+      // Otherwise function expects vectors, use the scratch for them
+      scratch->m_c.resize(op.m_n_in);
+      const auto & fct = m_fcts[op.m_fct];
+      for (size_t row=row_begin; row<row_end; row++) {
+        for (size_t c=0; c<op.m_n_in; c++) {
+          scratch->m_c[c] =
+            m_consts[inputs[c].m_offset + row * inputs[c].m_stride];
+        }
+        out[row] = fct( m_coords[segment.m_coord_begin + row], 
+                        scratch->m_c, scratch->m_p );
+      }
+      break;
+    }
+    case OpCode::Prod: {
+      for (size_t row=row_begin; row<row_end; row++) {
+        size_t first = 0;
+        double val {};
+        if (op.m_has_const) {
+          val = m_consts[op.m_const.m_offset + row * op.m_const.m_stride];
+        } else {
+          val = vals[inputs[0].m_offset + row * inputs[0].m_stride];
+          first = 1;
+        }
+        for (size_t i=first; i<op.m_n_in; i++) {
+          val *= vals[inputs[i].m_offset + row * inputs[i].m_stride];
+        }
+        out[row] = val;
+      }
+      break;
+    }
+    case OpCode::Sum: {
+      for (size_t row=row_begin; row<row_end; row++) {
+        double val = vals[inputs[0].m_offset + row * inputs[0].m_stride];
+        for (size_t i=1; i<op.m_n_in; i++) {
+          val += vals[inputs[i].m_offset + row * inputs[i].m_stride];
+        }
+        out[row] = val;
+      }
+      break;
+    }
+  }
+}
+
+//------------------------------------------------------------------------------
+
+void PrdProgram::evaluate_scalars(
+  const double * par_vals,
+  double * vals,
+  Scratch * scratch
+) const {
+  /** Evaluate the scalar segment and the shared segments (all rows), needs 
+      to be done before evaluating bins.
+      Value storage must have (at least) the size given by get_n_vals.
+  **/
+  for (const auto & segment: m_segments) {
+    if ( (&segment != m_segments.data()) && (!segment.m_is_shared) ) {
+      continue;
+    }
+    for (const auto & op: segment.m_ops) {
+      this->eval_op(op, segment, 0, segment.m_n_rows, par_vals, vals, scratch);
+    }
+  }
+}
+
+//------------------------------------------------------------------------------
+
+void PrdProgram::evaluate_bins(
+  size_t bin_begin,
+  size_t bin_end,
+  const double * par_vals,
+  double * vals,
+  Scratch * scratch,
+  double * prds
+) const {
+  /** Evaluate the predictions of the bins in the range [bin_begin, bin_end)
+      and write them to prds[0, bin_end-bin_begin).
+      Scalars must have been evaluated before (see evaluate_scalars).
+      Only the rows needed by the bins are written in the value storage, 
+      evaluations of disjoint bin ranges can therefore run in parallel on the
+      same value storage (if they use different scratches).
+  **/
+  if ( (bin_begin > bin_end) || (bin_end > m_n_bins) ) {
+    throw std::out_of_range("PrdProgram: Invalid bin range!");
+  }
+  for (const auto & block: m_bin_blocks) {
+    const auto & segment = m_segments[block.m_segment];
+    size_t block_end = block.m_first_bin + segment.m_n_rows;
+    if ( (block_end <= bin_begin) || (block.m_first_bin >= bin_end) ) {
+      continue;
+    }
+    size_t row_begin = 
+      std::max(bin_begin, block.m_first_bin) - block.m_first_bin;
+    size_t row_end = std::min(bin_end, block_end) - block.m_first_bin;
+    
+    for (const auto & op: segment.m_ops) {
+      this->eval_op(op, segment, row_begin, row_end, par_vals, vals, scratch);
+    }
+    
+    double * block_prds = prds + (block.m_first_bin + row_begin - bin_begin);
+    for (size_t row=row_begin; row<row_end; row++) {
+      block_prds[row - row_begin] = 
+        vals[block.m_col.m_offset + row * block.m_col.m_stride];
+    }
+  }
+}
+
+//------------------------------------------------------------------------------
+
+void PrdProgram::evaluate(
+  const double * par_vals,
+  Workspace * ws,
+  std::vector<double> * prds
+) const {
+  /** Evaluate the program for the given parameter values and write the
+      prediction of each bin into the prediction vector.
+      Parameter values are given in the order of the parameter vector the
+      program was compiled with.
+  **/
+  ws->m_vals.resize(m_n_vals);
+  prds->resize(m_n_bins);
+  this->evaluate_scalars(par_vals, ws->m_vals.data(), &(ws->m_scratch));
+  this->evaluate_bins( 0, m_n_bins, par_vals, ws->m_vals.data(), 
+                       &(ws->m_scratch), prds->data() );
+}
+
+//------------------------------------------------------------------------------
+// Gradient (reverse mode)
+
+size_t PrdProgram::scalar_index(size_t offset) const {
+  /** Index of the scalar value at the given offset of the value storage.
+      Every operation of the scalar segment has exactly one value and offsets
+      increase with the operations.
+  **/
+  const auto & ops = m_segments[0].m_ops;
+  auto it = std::lower_bound( 
+    ops.begin(), ops.end(), offset,
+    [](const Op & op, size_t val) { return op.m_out < val; }
+  );
+  return size_t(it - ops.begin());
+}
+
+const PrdProgram::SharedCol * PrdProgram::find_shared_col(
+  size_t offset
+) const {
+  /** Shared column at the given offset of the value storage (nullptr if 
+      there is none).
+      Shared columns are added with increasing offsets.
+  **/
+  auto it = std::lower_bound( 
+    m_shared_cols.begin(), m_shared_cols.end(), offset,
+    [](const SharedCol & col, size_t val) { return col.m_offset < val; }
+  );
+  if ( (it == m_shared_cols.end()) || (it->m_offset != offset) ) {
+    return nullptr;
+  }
+  return &(*it);
+}
+
+double * PrdProgram::get_adjs(
+  const Segment & segment,
+  const Ref & ref,
+  double * adjs,
+  double * scalar_adjs
+) const {
+  /** Adjoints of a column (or scalar) used in the given segment, rows at the
+      stride of the reference.
+      Adjoints of scalars and shared columns are in the scalar adjoints (a 
+      shared column is either in a shared segment or before the segment that 
+      uses it), those of other columns in adjs (same layout as value 
+      storage).
+  **/
+  if (ref.m_stride == 0) {
+    return scalar_adjs + this->scalar_index(ref.m_offset);
+  }
+  if ( segment.m_is_shared || (ref.m_offset < segment.m_val_begin) ) {
+    return scalar_adjs + this->get_n_scalars() + 
+           this->find_shared_col(ref.m_offset)->m_adj_begin;
+  }
+  return adjs + ref.m_offset;
+}
+
+//------------------------------------------------------------------------------
+
+void PrdProgram::backprop_op(
+  const Op & op,
+  const Segment & segment,
+  size_t row_begin,
+  size_t row_end,
+  const double * par_vals,
+  const double * vals,
+  double * adjs,
+  double * scalar_adjs,
+  Scratch * scratch,
+  double * par_grad
+) const {
+  /** Propagate the adjoints of the output rows of an operation to its inputs
+      (or to the parameters for function calls).
+      Adjoints of column values are in adjs (same layout as value storage),
+      adjoints of scalars and shared columns in scalar_adjs (see get_adjs).
+  **/
+  const Ref * inputs = m_refs.data() + op.m_in_begin;
+  bool is_scalar = (&segment == m_segments.data());
+  Ref out {op.m_out, is_scalar ? 0 : size_t(1)};
+  const double * out_adjs = this->get_adjs(segment, out, adjs, scalar_adjs);
+
+  switch (op.m_code) {
+    case OpCode::Call: {
+      if (op.m_n_pars == 0) { break; }
+      const auto & grad = m_grads[op.m_fct];
+      if (!grad) {
+        throw std::invalid_argument(
+          "PrdProgram: No derivative for function " + m_fct_names[op.m_fct]);
+      }
+      scratch->m_c.resize(op.m_n_in);
+      scratch->m_p_vals.resize(op.m_n_pars);
+      scratch->m_p.resize(op.m_n_pars);
+      scratch->m_grad.resize(op.m_n_pars);
+      for (size_t p=0; p<op.m_n_pars; p++) {
+        scratch->m_p_vals[p] = par_vals[m_par_idxs[op.m_par_begin + p]];
+        scratch->m_p[p] = &(scratch->m_p_vals[p]);
+      }
+      for (size_t row=row_begin; row<row_end; row++) {
+        double adj = out_adjs[row * out.m_stride];
+        for (size_t c=0; c<op.m_n_in; c++) {
+          scratch->m_c[c] =
+            m_consts[inputs[c].m_offset + row * inputs[c].m_stride];
+        }
+        grad( m_coords[segment.m_coord_begin + row], 
+              scratch->m_c, scratch->m_p, &(scratch->m_grad) );
+        for (size_t p=0; p<op.m_n_pars; p++) {
+          par_grad[m_par_idxs[op.m_par_begin + p]] += adj * scratch->m_grad[p];
+        }
+      }
+      break;
+    }
+    case OpCode::Prod: 
+    case OpCode::Sum: {
+      // Scalar inputs collect adjoints of all rows
+      scratch->m_in_adjs.resize(op.m_n_in);
+      for (size_t i=0; i<op.m_n_in; i++) {
+        scratch->m_in_adjs[i] = 
+          this->get_adjs(segment, inputs[i], adjs, scalar_adjs);
+      }
+      for (size_t row=row_begin; row<row_end; row++) {
+        double adj = out_adjs[row * out.m_stride];
+        for (size_t i=0; i<op.m_n_in; i++) {
+          double d_in = adj;
+          if (op.m_code == OpCode::Prod) {
+            // Derivative w.r.t. input i is product of all other factors
+            if (op.m_has_const) {
+              d_in *= m_consts[op.m_const.m_offset + row * op.m_const.m_stride];
+            }
+            for (size_t j=0; j<op.m_n_in; j++) {
+              if (j == i) { continue; }
+              d_in *= vals[inputs[j].m_offset + row * inputs[j].m_stride];
+            }
+          }
+          scratch->m_in_adjs[i][row * inputs[i].m_stride] += d_in;
+        }
+      }
+      break;
+    }
+  }
+}
+
+//------------------------------------------------------------------------------
+
+void PrdProgram::backprop_bins(
+  size_t bin_begin,
+  size_t bin_end,
+  const double * par_vals,
+  const double * vals,
+  const double * weights,
+  double * adjs,
+  double * scalar_adjs,
+  Scratch * scratch,
+  double * par_grad
+) const {
+  /** Add the gradient of sum_i weights[i-bin_begin] * prd_i for the bins in 
+      [bin_begin, bin_end) to par_grad (indices of parameter vector).
+      Contributions through scalars and shared columns are only collected in
+      scalar_adjs (size get_n_scalar_adjs), they are added to par_grad by 
+      backprop_scalars.
+      Values of the bins must be evaluated (see evaluate_bins).
+      Like in evaluate_bins only the rows of the bins are used in the adjoint 
+      storage (same size as value storage), so disjoint bin ranges can run in
+      parallel if they use different scalar adjoints and gradients.
+  **/
+  if ( (bin_begin > bin_end) || (bin_end > m_n_bins) ) {
+    throw std::out_of_range("PrdProgram: Invalid bin range!");
+  }
+  for (const auto & block: m_bin_blocks) {
+    const auto & segment = m_segments[block.m_segment];
+    size_t block_end = block.m_first_bin + segment.m_n_rows;
+    if ( (block_end <= bin_begin) || (block.m_first_bin >= bin_end) ) {
+      continue;
+    }
+    size_t row_begin = 
+      std::max(bin_begin, block.m_first_bin) - block.m_first_bin;
+    size_t row_end = std::min(bin_end, block_end) - block.m_first_bin;
+    
+    for (const auto & op: segment.m_ops) {
+      std::fill(adjs + op.m_out + row_begin, adjs + op.m_out + row_end, 0.0);
+    }
+    
+    const double * block_weights = 
+      weights + (block.m_first_bin + row_begin - bin_begin);
+    double * col_adjs = 
+      this->get_adjs(segment, block.m_col, adjs, scalar_adjs);
+    for (size_t row=row_begin; row<row_end; row++) {
+      col_adjs[row * block.m_col.m_stride] += block_weights[row - row_begin];
+    }
+    
+    for (auto op=segment.m_ops.rbegin(); op!=segment.m_ops.rend(); ++op) {
+      this->backprop_op( *op, segment, row_begin, row_end, par_vals, vals, 
+                         adjs, scalar_adjs, scratch, par_grad );
+    }
+  }
+}
+
+//------------------------------------------------------------------------------
+
+void PrdProgram::backprop_scalars(
+  const double * par_vals,
+  const double * vals,
+  double * scalar_adjs,
+  Scratch * scratch,
+  double * par_grad
+) const {
+  /** Add the contributions of the scalar adjoints (collected by 
+      backprop_bins) to the gradient, going backwards through the shared
+      segments (all rows) and then the scalar segment.
+      Scalar adjoints are modified in the process.
+  **/
+  for ( auto segment=m_segments.rbegin(); segment!=m_segments.rend(); 
+        ++segment ) {
+    if ( (!segment->m_is_shared) && (&(*segment) != m_segments.data()) ) {
+      continue;
+    }
+    for (auto op=segment->m_ops.rbegin(); op!=segment->m_ops.rend(); ++op) {
+      this->backprop_op( *op, *segment, 0, segment->m_n_rows, par_vals, vals, 
+                         nullptr, scalar_adjs, scratch, par_grad );
+    }
+  }
+}
+
+//------------------------------------------------------------------------------
+
+void PrdProgram::gradient(
+  const double * par_vals,
+  const std::vector<double> & weights,
+  Workspace * ws,
+  std::vector<double> * par_grad
+) const {
+  /** Calculate the gradient of sum_i weights[i] * prd_i w.r.t. the parameters
+      for the given parameter values.
+      Gradient vector must already have the size of the parameter vector, the
+      gradient is added to it.
+  **/
+  if (weights.size() != m_n_bins) {
+    throw std::invalid_argument("PrdProgram: Need one weight per bin!");
+  }
+  std::vector<double> prds {};
+  this->evaluate(par_vals, ws, &prds);
+  ws->m_adjs.resize(m_n_vals);
+  ws->m_scalar_adjs.assign(this->get_n_scalar_adjs(), 0.0);
+  this->backprop_bins( 0, m_n_bins, par_vals, ws->m_vals.data(), 
+                       weights.data(), ws->m_adjs.data(), 
+                       ws->m_scalar_adjs.data(), &(ws->m_scratch), 
+                       par_grad->data() );
+  this->backprop_scalars( par_vals, ws->m_vals.data(), 
+                          ws->m_scalar_adjs.data(), &(ws->m_scratch), 
+                          par_grad->data() );
+}
+
+//------------------------------------------------------------------------------
+
+}
+}
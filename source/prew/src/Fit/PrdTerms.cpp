@@ -0,0 +1,84 @@
+#include <Fit/PrdTerms.h>
+
+#include <algorithm>
+#include <stdexcept>
+
+namespace PrEW {
+namespace Fit {
+
+//------------------------------------------------------------------------------
+// Constructors
+
+PrdTerms::PrdTerms(size_t n_pars) : m_n_pars(n_pars), m_n_vals(n_pars) {}
+
+//------------------------------------------------------------------------------
+// Modifying functions
+
+size_t PrdTerms::add_group(
+  size_t n_terms,
+  const ParIdxs & par_idxs,
+  TermFct fct
+) {
+  /** Add a group of n_terms terms that the given function calculates from
+      the given parameters.
+      Returns the index of the first term of the group in the value array.
+  **/
+  if ( (!fct) || (!par_idxs) ) {
+    throw std::invalid_argument(
+      "Group of prediction terms needs function and parameter indices!");
+  }
+  for ( auto par_idx: *par_idxs ) {
+    if ( par_idx >= m_n_pars ) {
+      throw std::out_of_range("Prediction term depends on unknown parameter!");
+    }
+  }
+  Group group {};
+  group.m_begin = m_n_vals;
+  group.m_n_terms = n_terms;
+  group.m_par_idxs = par_idxs;
+  group.m_fct = std::make_shared<const TermFct>(std::move(fct));
+  m_groups.push_back(group);
+  m_n_vals += n_terms;
+  return group.m_begin;
+}
+
+//------------------------------------------------------------------------------
+// Access functions
+
+bool PrdTerms::is_empty() const { return m_groups.empty(); }
+size_t PrdTerms::get_n_pars() const { return m_n_pars; }
+size_t PrdTerms::get_n_vals() const { return m_n_vals; }
+size_t PrdTerms::get_n_groups() const { return m_groups.size(); }
+
+const std::vector<size_t> & PrdTerms::get_par_idxs(size_t group) const {
+  return *(m_groups.at(group).m_par_idxs);
+}
+
+//------------------------------------------------------------------------------
+// Core functionality
+
+void PrdTerms::evaluate_group(size_t group, double * vals) const {
+  /** Calculate the terms of the group from the parameter values at the front
+      of the value array (get_n_vals() long) and write them to their place in
+      it.
+  **/
+  const auto & g = m_groups[group];
+  (*g.m_fct)(vals, vals + g.m_begin);
+}
+
+std::vector<double> PrdTerms::get_vals(const double * par_vals) const {
+  /** Get the complete value array (parameter values followed by all terms)
+      for the given parameter values (e.g. to evaluate single bins).
+  **/
+  std::vector<double> vals (m_n_vals);
+  std::copy(par_vals, par_vals + m_n_pars, vals.begin());
+  for ( size_t group=0; group<m_groups.size(); group++ ) {
+    this->evaluate_group(group, vals.data());
+  }
+  return vals;
+}
+
+//------------------------------------------------------------------------------
+
+}
+}
@@ -0,0 +1,254 @@
+#include <Fit/ChiSqMinimizer.h>
+#include <Fit/PoissonNLLMinimizer.h>
+#include <Fit/ProfileScan.h>
+
+#include "spdlog/spdlog.h"
+
+#include <cmath>
+#include <stdexcept>
+
+namespace PrEW {
+namespace Fit {
+
+//------------------------------------------------------------------------------
+// Constructors
+
+ProfileScan::ProfileScan(
+  const FitContainer & container,
+  const MinimizationFct & minimization_fct,
+  size_t n_threads
+) :
+  m_container(container),
+  m_minimization_fct(minimization_fct),
+  m_pool(new CppUtils::ThreadPool(n_threads)),
+  m_containers(n_threads)
+{
+  if (!m_minimization_fct) {
+    throw std::invalid_argument("ProfileScan needs a minimization function!");
+  }
+}
+
+//------------------------------------------------------------------------------
+// Settings
+
+void ProfileScan::set_start(const FitResult & start) {
+  /** Start the fit of the first grid point from the given result (e.g. the
+      fit with all parameters free), otherwise it starts from the parameters
+      of the container.
+      The first grid point is the one closest to the start values.
+      An empty result removes the start.
+  **/
+  const auto & pars = m_container.m_fit_pars;
+  bool matches = start.m_par_names.empty() ||
+    ( (start.m_par_names.size() == pars.size()) &&
+      (start.m_pars_fin.size() == pars.size()) );
+  for ( size_t i=0; matches && (i<start.m_par_names.size()); i++ ) {
+    matches = ( start.m_par_names[i] == pars[i].get_name() );
+  }
+  if ( !matches ) {
+    throw std::invalid_argument(
+      "ProfileScan: Start result doesn't match parameters of container!");
+  }
+  m_start = start;
+}
+
+//------------------------------------------------------------------------------
+// Access functions
+
+size_t ProfileScan::get_n_threads() const { return m_pool->get_n_threads(); }
+
+//------------------------------------------------------------------------------
+// Internal functions
+
+size_t ProfileScan::find_par(const std::string & par_name) const {
+  const auto & pars = m_container.m_fit_pars;
+  for ( size_t i=0; i<pars.size(); i++ ) {
+    if ( pars[i].get_name() == par_name ) { return i; }
+  }
+  throw std::invalid_argument("Unknown parameter: " + par_name);
+}
+
+FitResult ProfileScan::fit_point(
+  const std::vector<size_t> & par_idxs,
+  const std::vector<double> & scan_vals,
+  const FitResult & start,
+  size_t thread
+) {
+  /** Fit with the scanned parameters fixed to the given values in the fit
+      container of the thread.
+      The container is only copied for the first point of the thread, later
+      points only reset its parameters.
+  **/
+  auto & container = m_containers[thread];
+  if (!container) {
+    container.reset(new FitContainer(m_container));
+  } else {
+    container->update_pars(m_container.m_fit_pars);
+  }
+  for ( size_t d=0; d<par_idxs.size(); d++ ) {
+    auto & par = container->m_fit_pars[par_idxs[d]];
+    par.m_val_mod = scan_vals[d];
+    par.fix();
+  }
+  return m_minimization_fct(container.get(), start);
+}
+
+ScanPointVec ProfileScan::run(
+  const std::vector<size_t> & par_idxs,
+  const std::vector<std::vector<double>> & grids
+) {
+  /** Scan the given parameters over the grid spanned by the given grids.
+      Points are ordered like the grid values with the last parameter
+      running fastest.
+      Each point (except the first) starts from its neighbour one step closer
+      to the first point, first along the last parameter, then along the
+      others. Its distance to the first point (number of steps) gives the
+      round in which it is fitted.
+  **/
+  size_t n_dims = grids.size();
+  size_t n_points = 1;
+  std::vector<size_t> first_idxs (n_dims);
+  for ( size_t d=0; d<n_dims; d++ ) {
+    const auto & grid = grids[d];
+    if ( grid.empty() ) {
+      throw std::invalid_argument("ProfileScan: Empty scan grid!");
+    }
+    n_points *= grid.size();
+
+    // First point is the grid point closest to the start
+    size_t i_par = par_idxs[d];
+    double start_val = m_start.m_pars_fin.empty() ?
+      m_container.m_fit_pars[i_par].m_val_mod : m_start.m_pars_fin[i_par];
+    for ( size_t i=1; i<grid.size(); i++ ) {
+      if ( std::abs(grid[i] - start_val) <
+           std::abs(grid[first_idxs[d]] - start_val) ) {
+        first_idxs[d] = i;
+      }
+    }
+  }
+
+  // Find neighbour to start from and fitting round of each point
+  ScanPointVec points (n_points);
+  std::vector<size_t> start_points (n_points, n_points); // n_points => none
+  std::vector<std::vector<size_t>> rounds {};
+  for ( size_t point=0; point<n_points; point++ ) {
+    std::vector<size_t> idxs (n_dims);
+    auto & scan_vals = points[point].m_scan_vals;
+    scan_vals.resize(n_dims);
+    size_t rest = point;
+    for ( size_t d=n_dims; d-- > 0; ) {
+      idxs[d] = rest % grids[d].size();
+      rest /= grids[d].size();
+      scan_vals[d] = grids[d][idxs[d]];
+    }
+
+    size_t round = 0;
+    size_t step_dim = n_dims;
+    for ( size_t d=0; d<n_dims; d++ ) {
+      if ( idxs[d] != first_idxs[d] ) {
+        round += (idxs[d] > first_idxs[d]) ? idxs[d] - first_idxs[d]
+                                           : first_idxs[d] - idxs[d];
+        step_dim = d;
+      }
+    }
+    if ( step_dim < n_dims ) {
+      if ( idxs[step_dim] > first_idxs[step_dim] ) {
+        idxs[step_dim]--;
+      } else {
+        idxs[step_dim]++;
+      }
+      size_t start_point = 0;
+      for ( size_t d=0; d<n_dims; d++ ) {
+        start_point = start_point * grids[d].size() + idxs[d];
+      }
+      start_points[point] = start_point;
+    }
+    if ( rounds.size() <= round ) { rounds.resize(round + 1); }
+    rounds[round].push_back(point);
+  }
+
+  // Points of a round only start from points of the previous round
+  for ( const auto & round_points: rounds ) {
+    m_pool->run(
+      round_points.size(),
+      [&](size_t task, size_t thread) {
+        size_t point = round_points[task];
+        size_t start_point = start_points[point];
+        const FitResult * start = &m_start;
+        if ( (start_point < n_points) &&
+             (points[start_point].m_result.m_min_status == 0) ) {
+          start = &(points[start_point].m_result);
+        }
+        spdlog::debug("Fitting scan point {}.", point);
+        points[point].m_result =
+          this->fit_point(par_idxs, points[point].m_scan_vals, *start, thread);
+      }
+    );
+  }
+  return points;
+}
+
+//------------------------------------------------------------------------------
+// Core functionality
+
+ScanPointVec ProfileScan::scan(
+  const std::string & par_name,
+  const std::vector<double> & grid
+) {
+  /** Profile scan of one parameter over the given values.
+  **/
+  return this->run( {this->find_par(par_name)}, {grid} );
+}
+
+ScanPointVec ProfileScan::scan(
+  const std::string & par_name_x,
+  const std::vector<double> & grid_x,
+  const std::string & par_name_y,
+  const std::vector<double> & grid_y
+) {
+  /** Profile scan of two parameters over all combinations of the given
+      values (grid_x.size() * grid_y.size() points, y running fastest).
+  **/
+  size_t par_x = this->find_par(par_name_x);
+  size_t par_y = this->find_par(par_name_y);
+  if ( par_x == par_y ) {
+    throw std::invalid_argument("ProfileScan: Can't scan parameter twice!");
+  }
+  return this->run( {par_x, par_y}, {grid_x, grid_y} );
+}
+
+//------------------------------------------------------------------------------
+// Standard minimizations
+
+ProfileScan::MinimizationFct ProfileScan::chisq_minimization(
+  const MinuitFactory & factory
+) {
+  /** Chi-squared minimization (single threaded, parallelisation is over
+      grid points).
+  **/
+  return [factory](FitContainer * container, const FitResult & start) {
+    ChiSqMinimizer minimizer (container, factory);
+    minimizer.set_start(start);
+    minimizer.minimize();
+    return minimizer.get_result();
+  };
+}
+
+ProfileScan::MinimizationFct ProfileScan::nll_minimization(
+  const MinuitFactory & factory
+) {
+  /** Poisson negative log-likelihood minimization (single threaded,
+      parallelisation is over grid points).
+  **/
+  return [factory](FitContainer * container, const FitResult & start) {
+    PoissonNLLMinimizer minimizer (container, factory);
+    minimizer.set_start(start);
+    minimizer.minimize();
+    return minimizer.get_result();
+  };
+}
+
+//------------------------------------------------------------------------------
+
+}
+}
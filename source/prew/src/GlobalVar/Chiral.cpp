@@ -8,10 +8,11 @@ namespace GlobalVar {
 
 //------------------------------------------------------------------------------
 
-std::string Chiral::transform(int eM_chirality, int eP_chirality) {
-  /** Transform a given e-e+ chirality combination into he corresponding string.
+CppUtils::Symbol Chiral::transform(int eM_chirality, int eP_chirality) {
+  /** Transform a given e-e+ chirality combination into he corresponding 
+      (interned) string.
    **/
-  std::string output{};
+  CppUtils::Symbol output{};
   if ((eM_chirality == -1) && (eP_chirality == -1)) {
     output = eLpL;
   } else if ((eM_chirality == -1) && (eP_chirality == +1)) {
@@ -0,0 +1,499 @@
+#include <CppUtils/Sys.h>
+#include <Input/BinaryCache.h>
+
+#include "spdlog/spdlog.h"
+
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <stdexcept>
+#include <string>
+#include <unordered_map>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace PrEW {
+namespace Input {
+
+//------------------------------------------------------------------------------
+// Layout of the file
+
+namespace {
+  const char magic[8] = {'P', 'r', 'E', 'W', 'B', 'I', 'N', '\0'};
+  const std::uint32_t byte_order = 0x01020304;
+
+  struct Header {
+    char          m_magic[8];
+    std::uint32_t m_version;
+    std::uint32_t m_byte_order;  // Written as byte_order => same endianness
+    std::uint64_t m_n_strings;
+    std::uint64_t m_strings_offset;
+    std::uint64_t m_n_preds;
+    std::uint64_t m_preds_offset;
+    std::uint64_t m_n_coefs;
+    std::uint64_t m_coefs_offset;
+    std::uint64_t m_file_size;
+  };
+
+  struct StringEntry {
+    std::uint64_t m_offset;
+    std::uint64_t m_length;
+  };
+
+  struct PredRecord {
+    std::uint32_t m_distr_name;  // Index in string table
+    std::uint32_t m_pol_config;  // Index in string table
+    std::int32_t  m_energy;
+    std::uint32_t m_dim;
+    std::uint64_t m_n_bins;
+    std::uint64_t m_coords_offset; // Centers, lower edges, upper edges
+    std::uint64_t m_sig_offset;
+    std::uint64_t m_bkg_offset;
+  };
+
+  struct CoefRecord {
+    std::uint32_t m_coef_name;   // Index in string table
+    std::uint32_t m_distr_name;  // Index in string table
+    std::uint32_t m_pol_config;  // Index in string table
+    std::int32_t  m_energy;
+    std::uint32_t m_is_global;
+    std::uint32_t m_padding;
+    std::uint64_t m_n_vals;
+    std::uint64_t m_vals_offset;
+  };
+
+  static_assert(sizeof(Header) == 72, "Unexpected binary cache header size");
+  static_assert(sizeof(StringEntry) == 16, "Unexpected string entry size");
+  static_assert(sizeof(PredRecord) == 48, "Unexpected prediction record size");
+  static_assert(sizeof(CoefRecord) == 40, "Unexpected coefficient record size");
+
+  std::uint64_t aligned(std::uint64_t offset) { return (offset + 7) / 8 * 8; }
+
+  template<class T>
+  T read_struct(const char * data, std::uint64_t offset) {
+    // Copy instead of cast => no alignment or aliasing assumptions
+    T t {};
+    std::memcpy(&t, data + offset, sizeof(T));
+    return t;
+  }
+
+  template<class T>
+  void write_data(std::ofstream & file, const T * data, std::uint64_t n) {
+    file.write( reinterpret_cast<const char*>(data),
+                std::streamsize(n * sizeof(T)) );
+  }
+
+  void write_padding(std::ofstream & file, std::uint64_t n_written) {
+    const char zeros[8] = {};
+    file.write(zeros, std::streamsize(aligned(n_written) - n_written));
+  }
+}
+
+//------------------------------------------------------------------------------
+// Constructors
+
+BinaryCache::BinaryCache(const std::string & file_path) :
+  m_file_path(file_path)
+{
+  this->map_file();
+  try {
+    this->read_tables();
+  } catch (...) {
+    this->unmap_file();
+    throw;
+  }
+}
+
+BinaryCache::~BinaryCache() { this->unmap_file(); }
+
+//------------------------------------------------------------------------------
+// Internal functions
+
+void BinaryCache::map_file() {
+  /** Map the whole file read-only into memory.
+      The file descriptor is not needed once the mapping exists.
+  **/
+  int fd = open(m_file_path.c_str(), O_RDONLY);
+  if (fd < 0) {
+    throw std::invalid_argument("File not found: " + m_file_path);
+  }
+  struct stat file_stat;
+  if (fstat(fd, &file_stat) != 0) {
+    close(fd);
+    throw std::invalid_argument("Can't access file: " + m_file_path);
+  }
+  m_size = size_t(file_stat.st_size);
+  if (m_size < sizeof(Header)) {
+    close(fd);
+    throw std::invalid_argument("Not a PrEW binary cache: " + m_file_path);
+  }
+
+  void * data = mmap(nullptr, m_size, PROT_READ, MAP_SHARED, fd, 0);
+  close(fd);
+  if (data == MAP_FAILED) {
+    throw std::invalid_argument("Can't map file: " + m_file_path);
+  }
+  m_data = static_cast<const char*>(data);
+}
+
+void BinaryCache::unmap_file() {
+  if (m_data) {
+    munmap(const_cast<char*>(m_data), m_size);
+    m_data = nullptr;
+  }
+}
+
+//------------------------------------------------------------------------------
+
+const double * BinaryCache::get_array(
+  std::uint64_t offset,
+  std::uint64_t n
+) const {
+  /** Pointer to an array of n doubles at the given offset of the file.
+  **/
+  if ( (offset % 8 != 0) || (offset > m_size) ||
+       (n > (m_size - offset) / sizeof(double)) ) {
+    throw std::invalid_argument("Corrupt PrEW binary cache: " + m_file_path);
+  }
+  return reinterpret_cast<const double*>(m_data + offset);
+}
+
+const CppUtils::Symbol & BinaryCache::get_string(std::uint32_t idx) const {
+  if (idx >= m_strings.size()) {
+    throw std::invalid_argument("Corrupt PrEW binary cache: " + m_file_path);
+  }
+  return m_strings[idx];
+}
+
+void BinaryCache::read_tables() {
+  /** Check the header and read the tables of the file.
+      Names are interned, the views point to the arrays in the mapped file.
+  **/
+  auto header = read_struct<Header>(m_data, 0);
+  if (std::memcmp(header.m_magic, magic, sizeof(magic)) != 0) {
+    throw std::invalid_argument("Not a PrEW binary cache: " + m_file_path);
+  }
+  if (header.m_version != version) {
+    throw std::invalid_argument(
+      "PrEW binary cache " + m_file_path + " has version " +
+      std::to_string(header.m_version) + ", expected " +
+      std::to_string(version) + "!");
+  }
+  if (header.m_byte_order != byte_order) {
+    throw std::invalid_argument(
+      "PrEW binary cache " + m_file_path + " has different byte order!");
+  }
+  if (header.m_file_size != m_size) {
+    throw std::invalid_argument(
+      "PrEW binary cache " + m_file_path + " is incomplete!");
+  }
+
+  // Tables must be inside the file
+  auto check_table = [this](std::uint64_t offset, std::uint64_t n,
+                            std::uint64_t record_size) {
+    if ( (offset > m_size) || (n > (m_size - offset) / record_size) ) {
+      throw std::invalid_argument(
+        "Corrupt PrEW binary cache: " + m_file_path);
+    }
+  };
+  check_table(header.m_strings_offset, header.m_n_strings, sizeof(StringEntry));
+  check_table(header.m_preds_offset, header.m_n_preds, sizeof(PredRecord));
+  check_table(header.m_coefs_offset, header.m_n_coefs, sizeof(CoefRecord));
+
+  m_strings.reserve(header.m_n_strings);
+  for (std::uint64_t i=0; i<header.m_n_strings; i++) {
+    auto entry = read_struct<StringEntry>(
+      m_data, header.m_strings_offset + i * sizeof(StringEntry) );
+    check_table(entry.m_offset, entry.m_length, 1);
+    m_strings.emplace_back(
+      std::string(m_data + entry.m_offset, entry.m_length) );
+  }
+
+  m_preds.reserve(header.m_n_preds);
+  for (std::uint64_t i=0; i<header.m_n_preds; i++) {
+    auto record = read_struct<PredRecord>(
+      m_data, header.m_preds_offset + i * sizeof(PredRecord) );
+    PredView pred {};
+    pred.m_info = { this->get_string(record.m_distr_name),
+                    this->get_string(record.m_pol_config),
+                    record.m_energy };
+    // Arrays can't be larger than the file (=> sizes can't overflow)
+    std::uint64_t max_vals = m_size / sizeof(double);
+    if ( (record.m_n_bins > max_vals) || ( (record.m_dim != 0) &&
+         (record.m_n_bins > max_vals / 3 / record.m_dim) ) ) {
+      throw std::invalid_argument("Corrupt PrEW binary cache: " + m_file_path);
+    }
+    pred.m_n_bins = record.m_n_bins;
+    pred.m_dim = record.m_dim;
+    std::uint64_t n_coords = record.m_n_bins * record.m_dim;
+    pred.m_centers = this->get_array(record.m_coords_offset, 3 * n_coords);
+    pred.m_edges_low = pred.m_centers + n_coords;
+    pred.m_edges_up = pred.m_edges_low + n_coords;
+    pred.m_sig_distr = this->get_array(record.m_sig_offset, record.m_n_bins);
+    pred.m_bkg_distr = this->get_array(record.m_bkg_offset, record.m_n_bins);
+    m_preds.push_back(pred);
+  }
+
+  m_coefs.reserve(header.m_n_coefs);
+  for (std::uint64_t i=0; i<header.m_n_coefs; i++) {
+    auto record = read_struct<CoefRecord>(
+      m_data, header.m_coefs_offset + i * sizeof(CoefRecord) );
+    CoefView coef {};
+    coef.m_coef_name = this->get_string(record.m_coef_name);
+    coef.m_info = { this->get_string(record.m_distr_name),
+                    this->get_string(record.m_pol_config),
+                    record.m_energy };
+    coef.m_is_global = (record.m_is_global != 0);
+    coef.m_n_vals = record.m_n_vals;
+    if ( coef.m_is_global && (coef.m_n_vals != 1) ) {
+      throw std::invalid_argument("Corrupt PrEW binary cache: " + m_file_path);
+    }
+    coef.m_vals = this->get_array(record.m_vals_offset, record.m_n_vals);
+    m_coefs.push_back(coef);
+  }
+
+  spdlog::debug( "Mapped PrEW binary cache {} with {} predictions and {} "
+                 "coefficients.", m_file_path, m_preds.size(), m_coefs.size() );
+}
+
+//------------------------------------------------------------------------------
+// Access functions
+
+const std::string & BinaryCache::get_file_path() const { return m_file_path; }
+size_t BinaryCache::get_n_preds() const { return m_preds.size(); }
+size_t BinaryCache::get_n_coefs() const { return m_coefs.size(); }
+
+const BinaryCache::PredView & BinaryCache::get_pred(size_t i) const {
+  if (i >= m_preds.size()) {
+    throw std::out_of_range("BinaryCache: Prediction does not exist!");
+  }
+  return m_preds[i];
+}
+
+const BinaryCache::CoefView & BinaryCache::get_coef(size_t i) const {
+  if (i >= m_coefs.size()) {
+    throw std::out_of_range("BinaryCache: Coefficient does not exist!");
+  }
+  return m_coefs[i];
+}
+
+//------------------------------------------------------------------------------
+// Conversion to PrEW data objects
+
+Data::PredDistr BinaryCache::get_pred_distr(size_t i) const {
+  /** Copy the prediction into a PrEW prediction object.
+  **/
+  const auto & pred = this->get_pred(i);
+  Data::PredDistr pred_distr {};
+  pred_distr.m_info = pred.m_info;
+  pred_distr.m_coords.reserve(pred.m_n_bins);
+  for (size_t bin=0; bin<pred.m_n_bins; bin++) {
+    size_t begin = bin * pred.m_dim, end = (bin + 1) * pred.m_dim;
+    pred_distr.m_coords.emplace_back(
+      std::vector<double>(pred.m_centers + begin, pred.m_centers + end),
+      std::vector<double>(pred.m_edges_low + begin, pred.m_edges_low + end),
+      std::vector<double>(pred.m_edges_up + begin, pred.m_edges_up + end)
+    );
+  }
+  pred_distr.m_sig_distr.assign( pred.m_sig_distr,
+                                 pred.m_sig_distr + pred.m_n_bins );
+  pred_distr.m_bkg_distr.assign( pred.m_bkg_distr,
+                                 pred.m_bkg_distr + pred.m_n_bins );
+  return pred_distr;
+}
+
+Data::CoefDistr BinaryCache::get_coef_distr(size_t i) const {
+  /** Copy the coefficient into a PrEW coefficient object.
+  **/
+  const auto & coef = this->get_coef(i);
+  if (coef.m_is_global) {
+    return Data::CoefDistr(coef.m_coef_name.str(), coef.m_info, coef.m_vals[0]);
+  }
+  return Data::CoefDistr( coef.m_coef_name.str(), coef.m_info,
+                          std::vector<double>( coef.m_vals,
+                                               coef.m_vals + coef.m_n_vals ) );
+}
+
+Data::PredDistrVec BinaryCache::get_pred_distrs() const {
+  Data::PredDistrVec pred_distrs {};
+  pred_distrs.reserve(m_preds.size());
+  for (size_t i=0; i<m_preds.size(); i++) {
+    pred_distrs.push_back(this->get_pred_distr(i));
+  }
+  return pred_distrs;
+}
+
+Data::CoefDistrVec BinaryCache::get_coef_distrs() const {
+  Data::CoefDistrVec coef_distrs {};
+  coef_distrs.reserve(m_coefs.size());
+  for (size_t i=0; i<m_coefs.size(); i++) {
+    coef_distrs.push_back(this->get_coef_distr(i));
+  }
+  return coef_distrs;
+}
+
+//------------------------------------------------------------------------------
+// Writing
+
+void BinaryCache::write(
+  const std::string & file_path,
+  const Data::PredDistrVec & pred_distrs,
+  const Data::CoefDistrVec & coef_distrs
+) {
+  /** Write the predictions and coefficients to a binary cache file (layout
+      see class description).
+      All bins of a prediction must have coordinates of the same dimension.
+  **/
+  if (! CppUtils::Sys::file_writable(file_path)) {
+    throw std::invalid_argument("No write access to " + file_path);
+  }
+
+  // --- String table ----------------------------------------------------------
+  std::vector<std::string> strings {};
+  std::unordered_map<std::string, std::uint32_t> string_idxs {};
+  auto add_string = [&strings, &string_idxs](const std::string & str) {
+    auto it = string_idxs.find(str);
+    if (it != string_idxs.end()) { return it->second; }
+    auto idx = std::uint32_t(strings.size());
+    strings.push_back(str);
+    string_idxs.emplace(str, idx);
+    return idx;
+  };
+
+  // --- Records (offsets are set below) ---------------------------------------
+  std::vector<PredRecord> pred_records {};
+  for (const auto & pred_distr: pred_distrs) {
+    const auto & coords = pred_distr.m_coords;
+    PredRecord record {};
+    record.m_distr_name = add_string(pred_distr.m_info.m_distr_name.str());
+    record.m_pol_config = add_string(pred_distr.m_info.m_pol_config.str());
+    record.m_energy = pred_distr.m_info.m_energy;
+    record.m_n_bins = coords.size();
+    record.m_dim = coords.empty() ? 0 : std::uint32_t(coords[0].get_dim());
+    for (const auto & coord: coords) {
+      if ( (coord.get_center().size() != record.m_dim) ||
+           (coord.get_edge_low().size() != record.m_dim) ||
+           (coord.get_edge_up().size() != record.m_dim) ) {
+        throw std::invalid_argument(
+          "Bin coordinates of " + pred_distr.m_info.m_distr_name.str() +
+          " have different dimensions!");
+      }
+    }
+    if ( (pred_distr.m_sig_distr.size() != coords.size()) ||
+         (pred_distr.m_bkg_distr.size() != coords.size()) ) {
+      throw std::invalid_argument(
+        "Prediction " + pred_distr.m_info.m_distr_name.str() +
+        " doesn't match number of bins!");
+    }
+    pred_records.push_back(record);
+  }
+
+  std::vector<CoefRecord> coef_records {};
+  for (const auto & coef_distr: coef_distrs) {
+    CoefRecord record {};
+    record.m_coef_name = add_string(coef_distr.get_coef_name());
+    record.m_distr_name = add_string(coef_distr.get_info().m_distr_name.str());
+    record.m_pol_config = add_string(coef_distr.get_info().m_pol_config.str());
+    record.m_energy = coef_distr.get_info().m_energy;
+    record.m_is_global = coef_distr.is_global() ? 1 : 0;
+    record.m_n_vals =
+      coef_distr.is_global() ? 1 : coef_distr.get_coefs().size();
+    coef_records.push_back(record);
+  }
+
+  // --- Layout ----------------------------------------------------------------
+  Header header {};
+  std::memcpy(header.m_magic, magic, sizeof(magic));
+  header.m_version = version;
+  header.m_byte_order = byte_order;
+  header.m_n_strings = strings.size();
+  header.m_n_preds = pred_records.size();
+  header.m_n_coefs = coef_records.size();
+
+  std::uint64_t offset = sizeof(Header);
+  header.m_strings_offset = offset;
+  offset += strings.size() * sizeof(StringEntry);
+  header.m_preds_offset = offset;
+  offset += pred_records.size() * sizeof(PredRecord);
+  header.m_coefs_offset = offset;
+  offset += coef_records.size() * sizeof(CoefRecord);
+
+  std::vector<StringEntry> string_entries {};
+  std::uint64_t chars_begin = offset;
+  for (const auto & str: strings) {
+    string_entries.push_back({offset, str.size()});
+    offset += str.size();
+  }
+  std::uint64_t n_chars = offset - chars_begin;
+  offset = aligned(offset);
+
+  for (auto & record: pred_records) {
+    std::uint64_t n_coords = record.m_n_bins * record.m_dim;
+    record.m_coords_offset = offset;
+    offset += 3 * n_coords * sizeof(double);
+    record.m_sig_offset = offset;
+    offset += record.m_n_bins * sizeof(double);
+    record.m_bkg_offset = offset;
+    offset += record.m_n_bins * sizeof(double);
+  }
+  for (auto & record: coef_records) {
+    record.m_vals_offset = offset;
+    offset += record.m_n_vals * sizeof(double);
+  }
+  header.m_file_size = offset;
+
+  // --- Writing (to temporary file, moved in place when complete) -------------
+  std::string tmp_path = file_path + ".tmp";
+  std::ofstream file (tmp_path, std::ios::binary | std::ios::trunc);
+  write_data(file, &header, 1);
+  write_data(file, string_entries.data(), string_entries.size());
+  write_data(file, pred_records.data(), pred_records.size());
+  write_data(file, coef_records.data(), coef_records.size());
+  for (const auto & str: strings) { write_data(file, str.data(), str.size()); }
+  write_padding(file, n_chars);
+
+  std::vector<double> coord_vals {};
+  for (const auto & pred_distr: pred_distrs) {
+    coord_vals.clear();
+    for (const auto & coord: pred_distr.m_coords) {
+      const auto & center = coord.get_center();
+      coord_vals.insert(coord_vals.end(), center.begin(), center.end());
+    }
+    for (const auto & coord: pred_distr.m_coords) {
+      const auto & low = coord.get_edge_low();
+      coord_vals.insert(coord_vals.end(), low.begin(), low.end());
+    }
+    for (const auto & coord: pred_distr.m_coords) {
+      const auto & up = coord.get_edge_up();
+      coord_vals.insert(coord_vals.end(), up.begin(), up.end());
+    }
+    write_data(file, coord_vals.data(), coord_vals.size());
+    write_data( file, pred_distr.m_sig_distr.data(),
+                pred_distr.m_sig_distr.size() );
+    write_data( file, pred_distr.m_bkg_distr.data(),
+                pred_distr.m_bkg_distr.size() );
+  }
+  for (const auto & coef_distr: coef_distrs) {
+    if (coef_distr.is_global()) {
+      double val = coef_distr.get_coef(0);
+      write_data(file, &val, 1);
+    } else {
+      write_data( file, coef_distr.get_coefs().data(),
+                  coef_distr.get_coefs().size() );
+    }
+  }
+
+  file.close();
+  if ( (!file) || (std::rename(tmp_path.c_str(), file_path.c_str()) != 0) ) {
+    std::remove(tmp_path.c_str());
+    throw std::invalid_argument("Writing binary cache failed: " + file_path);
+  }
+}
+
+//------------------------------------------------------------------------------
+
+}
+}
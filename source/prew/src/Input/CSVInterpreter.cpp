@@ -1,10 +1,14 @@
 #include <CppUtils/Str.h>
+#include <CppUtils/Sys.h>
 #include <CppUtils/Vec.h>
 #include <GlobalVar/Chiral.h>
 #include <Input/CSVInterpreter.h>
 
 // Standard library
+#include <cstdlib>
+#include <cstring>
 #include <fstream>
+#include <stdexcept>
 
 namespace PrEW {
 namespace Input {
@@ -16,18 +20,25 @@ const std::string CSVInterpreter::BinCenterMarker = "BinCenters";
 const std::string CSVInterpreter::BinLowMarker = "BinLow";
 const std::string CSVInterpreter::BinUpMarker = "BinUp";
 const std::string CSVInterpreter::CoefficientMarker = "Coef";
+const std::string CSVInterpreter::CrossSectionName = "Cross sections";
 
 //------------------------------------------------------------------------------
 
 CSVInterpreter::CSVInterpreter(const std::string &file_path) {
   /** Constructor interprets the given CSV file (metadata and distribution).
+   *The file is read once from start to end (metadata first, then the CSV
+   *part).
    **/
+  if (!CppUtils::Sys::path_exists(file_path)) {
+    throw std::invalid_argument("CSV file does not exist: " + file_path);
+  }
+  std::ifstream file(file_path.c_str());
 
   CSVMetadata metadata{};
-  auto csv_reader = metadata.strip_metadata(file_path);
+  metadata.read_metadata(file, file_path);
 
   this->read_metadata(metadata);
-  this->read_csv(csv_reader);
+  this->read_csv(file, file_path);
 }
 
 //------------------------------------------------------------------------------
@@ -64,53 +75,183 @@ void CSVInterpreter::read_metadata(const CSVMetadata &metadata) {
 
 //------------------------------------------------------------------------------
 
-void CSVInterpreter::read_csv(csv::CSVReader &csv_reader) {
-  /** Read the differential distribution and coefficients from the given
-   *CSVReader.
+void CSVInterpreter::read_csv(std::istream &stream,
+                              const std::string &file_path) {
+  /** Read the differential distribution and coefficients from the CSV part of
+   *the given stream (starting at the column header line).
+   *Column indices are resolved once from the header, the values of each used
+   *column are parsed directly into a column buffer.
    **/
-
-  auto col_names = csv_reader.get_col_names();
+  std::string line{};
+  if (!getline(stream, line)) {
+    throw std::invalid_argument("CSV file has no column header: " + file_path);
+  }
+  auto col_names = this->split_header(line);
   auto csv_coords = this->find_coords(col_names);
   auto coef_cols = this->find_coefs(col_names);
 
-  Data::CoordVec coords{};
-  std::vector<double> bin_values{};
-  std::map<std::string, std::vector<double>> coef_values{};
-
-  // Initialize coefficients vectors
+  // Buffers: cross sections, (center, low, up) of each coordinate, coefficients
+  std::vector<size_t> buffer_cols{
+      this->find_col(col_names, CrossSectionName, file_path)};
+  for (const auto &csv_coord : csv_coords) {
+    buffer_cols.push_back(
+        this->find_col(col_names, csv_coord.bin_center(), file_path));
+    buffer_cols.push_back(
+        this->find_col(col_names, csv_coord.edge_low(), file_path));
+    buffer_cols.push_back(
+        this->find_col(col_names, csv_coord.edge_up(), file_path));
+  }
   for (const auto &coef_col : coef_cols) {
-    coef_values[coef_col] = {};
+    buffer_cols.push_back(this->find_col(col_names, coef_col, file_path));
+  }
+  std::vector<int> col_buffers(col_names.size(), -1); // Buffer of each column
+  for (size_t b = 0; b < buffer_cols.size(); b++) {
+    col_buffers[buffer_cols[b]] = int(b);
+  }
+  std::vector<std::vector<double>> buffers(buffer_cols.size());
+
+  // Remaining file size is used to estimate the number of rows
+  auto begin_pos = stream.tellg();
+  auto end_pos = begin_pos;
+  if (begin_pos >= 0) {
+    stream.seekg(0, std::ios::end);
+    end_pos = stream.tellg();
+    stream.seekg(begin_pos);
   }
 
   // Collect all the values for the predicted distributions and coefficients
-  for (auto &row : csv_reader) {
-    // Collect bin centers for this bin
-    std::vector<double> bin_centers{}, edges_low{}, edges_up{};
-    for (const auto &csv_coord : csv_coords) {
-      bin_centers.push_back(row[csv_coord.bin_center()].get<double>());
-      edges_low.push_back(row[csv_coord.edge_low()].get<double>());
-      edges_up.push_back(row[csv_coord.edge_up()].get<double>());
+  bool reserved = false;
+  while (getline(stream, line)) {
+    if (!line.empty() && (line.back() == '\r')) {
+      line.pop_back();
     }
-    coords.push_back(Data::BinCoord(bin_centers, edges_low, edges_up));
-
-    // Collect bin values
-    bin_values.push_back(row["Cross sections"].get<double>());
+    if (line.empty()) {
+      continue;
+    }
+    if (!reserved) {
+      // Assume similar length of all rows (buffers still grow if needed)
+      auto pos = stream.tellg();
+      if ((pos >= 0) && (end_pos >= pos)) {
+        auto n_rows = size_t(end_pos - pos) / (line.size() + 1) + 1;
+        for (auto &buffer : buffers) {
+          buffer.reserve(n_rows);
+        }
+      }
+      reserved = true;
+    }
+    this->read_row(line, col_buffers, &buffers, file_path);
+  }
 
-    // Find coefficient vectors
-    for (const auto &coef_col : coef_cols) {
-      coef_values[coef_col].push_back(row[coef_col].get<double>());
+  // Construct the bin coordinates
+  size_t n_bins = buffers[0].size();
+  size_t dim = csv_coords.size();
+  Data::CoordVec coords{};
+  coords.reserve(n_bins);
+  for (size_t bin = 0; bin < n_bins; bin++) {
+    std::vector<double> bin_centers(dim), edges_low(dim), edges_up(dim);
+    for (size_t d = 0; d < dim; d++) {
+      bin_centers[d] = buffers[1 + 3 * d][bin];
+      edges_low[d] = buffers[2 + 3 * d][bin];
+      edges_up[d] = buffers[3 + 3 * d][bin];
     }
+    coords.push_back(Data::BinCoord(bin_centers, edges_low, edges_up));
   }
 
   // Construct the predicted distribution (no backgrounds contained in CSV file)
-  m_pred_distr = Data::PredDistr{m_info, coords, bin_values,
-                                 std::vector<double>(bin_values.size(), 0.0)};
+  m_pred_distr = Data::PredDistr{m_info, coords, buffers[0],
+                                 std::vector<double>(n_bins, 0.0)};
 
   // Construct coefficient distributions
-  for (const auto &coef_col : coef_cols) {
-    auto name = CppUtils::Str::string_to_vec(coef_col, ":").at(1);
+  for (size_t c = 0; c < coef_cols.size(); c++) {
+    auto name = CppUtils::Str::string_to_vec(coef_cols[c], ":").at(1);
     m_coef_distrs.push_back(
-        Data::CoefDistr(name, m_info, coef_values.at(coef_col)));
+        Data::CoefDistr(name, m_info, buffers[1 + 3 * dim + c]));
+  }
+}
+
+//------------------------------------------------------------------------------
+
+std::vector<std::string>
+CSVInterpreter::split_header(const std::string &line) const {
+  /** Split the column header line into the column names (empty names are kept
+   *so that the names match the column positions).
+   *Quoted fields are not supported.
+   **/
+  std::vector<std::string> col_names{};
+  size_t last = 0, next = 0;
+  while ((next = line.find(',', last)) != std::string::npos) {
+    col_names.push_back(line.substr(last, next - last));
+    last = next + 1;
+  }
+  auto last_name = line.substr(last);
+  if (!last_name.empty() && (last_name.back() == '\r')) {
+    last_name.pop_back();
+  }
+  col_names.push_back(last_name);
+  return col_names;
+}
+
+//------------------------------------------------------------------------------
+
+size_t CSVInterpreter::find_col(const std::vector<std::string> &col_names,
+                                const std::string &col_name,
+                                const std::string &file_path) const {
+  /** Find the index of the column with the given name.
+   **/
+  for (size_t col = 0; col < col_names.size(); col++) {
+    if (col_names[col] == col_name) {
+      return col;
+    }
+  }
+  throw std::invalid_argument("Missing column " + col_name + " in CSV file " +
+                              file_path);
+}
+
+//------------------------------------------------------------------------------
+
+void CSVInterpreter::read_row(const std::string &line,
+                              const std::vector<int> &col_buffers,
+                              std::vector<std::vector<double>> *buffers,
+                              const std::string &file_path) const {
+  /** Parse the values of the used columns of the row and append them to the
+   *corresponding buffers, unused columns are skipped without parsing.
+   **/
+  const char *field = line.c_str();
+  const char *line_end = field + line.size();
+  size_t col = 0;
+  while (true) {
+    const char *field_end = static_cast<const char *>(
+        std::memchr(field, ',', size_t(line_end - field)));
+    if (field_end == nullptr) {
+      field_end = line_end;
+    }
+
+    if ((col < col_buffers.size()) && (col_buffers[col] >= 0)) {
+      char *num_end{};
+      double val = std::strtod(field, &num_end);
+      while ((num_end < field_end) && (*num_end == ' ')) {
+        num_end++;
+      }
+      if ((num_end == field) || (num_end != field_end)) {
+        throw std::invalid_argument(
+            "Invalid number '" + std::string(field, field_end) +
+            "' in CSV file " + file_path);
+      }
+      (*buffers)[size_t(col_buffers[col])].push_back(val);
+    }
+
+    col++;
+    if (field_end == line_end) {
+      break;
+    }
+    field = field_end + 1;
+  }
+
+  if (col != col_buffers.size()) {
+    throw std::invalid_argument("Row with " + std::to_string(col) +
+                                " instead of " +
+                                std::to_string(col_buffers.size()) +
+                                " columns in CSV file " + file_path);
   }
 }
 
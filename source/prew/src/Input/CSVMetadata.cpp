@@ -35,6 +35,17 @@ csv::CSVReader CSVMetadata::strip_metadata(const std::string &file_path) {
 
 //------------------------------------------------------------------------------
 
+void CSVMetadata::read_metadata(std::istream &stream,
+                                const std::string &file_path) {
+  /** Read and interpret the metadata header from the stream of the given file.
+   *Afterwards the stream is positioned at the CSV column header line, so the
+   *file only needs to be read once.
+   **/
+  this->interpret(this->get_metadata_lines(stream, file_path));
+}
+
+//------------------------------------------------------------------------------
+
 std::vector<std::string> CSVMetadata::keys(const std::string &which) const {
   /** Return the keys of the available metadata from the header.
       A string can be given to state which keys should be given.
@@ -110,11 +121,25 @@ CSVMetadata::get_metadata_lines(const std::string &file_path) const {
   /** Find the lines describing the metadata other an otherwise csv-compatible
    *file.
    **/
+  std::ifstream file(file_path.c_str());
+  auto metadata_lines = this->get_metadata_lines(file, file_path);
+  file.close();
+
+  return metadata_lines;
+}
+
+//------------------------------------------------------------------------------
+
+std::vector<std::string>
+CSVMetadata::get_metadata_lines(std::istream &stream,
+                                const std::string &file_path) const {
+  /** Read the metadata lines from the stream, stops after the end ID of the
+   *metadata header.
+   **/
   std::string current_line{};
   std::vector<std::string> metadata_lines{};
-  std::ifstream file(file_path.c_str());
   bool in_metadata = false;
-  while (getline(file, current_line)) {
+  while (getline(stream, current_line)) {
     if (current_line == CSVMetadata::end_ID) {
       break; // Found end, time to return
     } else if (in_metadata) {
@@ -128,7 +153,6 @@ CSVMetadata::get_metadata_lines(const std::string &file_path) const {
           file_path);
     }
   }
-  file.close();
 
   return metadata_lines;
 }
@@ -1,4 +1,5 @@
 #include <CppUtils/Sys.h>
+#include <Input/BinaryCache.h>
 #include <Input/DataReader.h>
 
 #include <exception>
@@ -33,12 +34,28 @@ void DataReader::read_file() {
   } else if ( m_input_info->m_input_style == "CSV" ) {
     spdlog::debug("Reading CSV file containing info for one chiral distribution.");
     Reading::read_csv_file(m_input_info, &m_pred_distrs, &m_coef_distrs);
+  } else if ( m_input_info->m_input_style == "Binary" ) {
+    spdlog::debug("Reading PrEW binary cache with predictions and coefficients.");
+    BinaryCache cache (m_input_info->m_file_path);
+    auto pred_distrs = cache.get_pred_distrs();
+    auto coef_distrs = cache.get_coef_distrs();
+    m_pred_distrs.insert(m_pred_distrs.end(), pred_distrs.begin(), 
+                         pred_distrs.end());
+    m_coef_distrs.insert(m_coef_distrs.end(), coef_distrs.begin(), 
+                         coef_distrs.end());
   } else {
     throw std::invalid_argument(
       ("Invalid file style " + m_input_info->m_input_style).c_str() );
   }
 }
 
+void DataReader::write_binary_cache(const std::string & file_path) const {
+  /** Write the predictions and coefficients that were read to a PrEW binary
+      cache (see BinaryCache), later fits can read it with input style 
+      "Binary" instead of parsing the original file again.
+  **/
+  BinaryCache::write(file_path, m_pred_distrs, m_coef_distrs);
+}
 
 //------------------------------------------------------------------------------
 
@@ -0,0 +1,113 @@
+#include <CppUtils/Sys.h>
+#include <CppUtils/ThreadPool.h>
+#include <Input/DataReader.h>
+#include <Input/MultiDataReader.h>
+
+#include "spdlog/spdlog.h"
+
+#include <algorithm>
+#include <mutex>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+namespace PrEW {
+namespace Input {
+
+//------------------------------------------------------------------------------
+// Constructors
+
+MultiDataReader::MultiDataReader(
+  const std::vector<InputInfo*> & input_infos,
+  size_t n_threads
+) :
+  m_input_infos(input_infos),
+  m_n_threads(n_threads)
+{
+  for (const auto & input_info: m_input_infos) {
+    if ( ! CppUtils::Sys::path_exists(input_info->m_file_path) ) {
+      throw std::invalid_argument("File not found: " + input_info->m_file_path);
+    }
+  }
+}
+
+MultiDataReader::MultiDataReader(
+  const std::string & dir_path,
+  const std::string & input_style,
+  const std::string & extension,
+  size_t n_threads
+) :
+  m_n_threads(n_threads)
+{
+  /** Read all files in the directory that have the given extension (sorted by
+      name) assuming the given input style.
+      Only for input styles that need no information besides the file path
+      (e.g. CSV).
+  **/
+  for (const auto & file_path: CppUtils::Sys::list_files(dir_path, extension)) {
+    m_own_infos.push_back({file_path, input_style});
+  }
+  for (auto & input_info: m_own_infos) { m_input_infos.push_back(&input_info); }
+}
+
+//------------------------------------------------------------------------------
+// Access functions
+
+size_t MultiDataReader::get_n_files() const { return m_input_infos.size(); }
+size_t MultiDataReader::get_n_threads() const { return m_n_threads; }
+
+const Data::PredDistrVec& MultiDataReader::get_pred_distrs() const {
+  return m_pred_distrs;
+}
+
+const Data::CoefDistrVec& MultiDataReader::get_coef_distrs() const {
+  return m_coef_distrs;
+}
+
+//------------------------------------------------------------------------------
+// Core functionality
+
+void MultiDataReader::read_files() {
+  /** Read all files in parallel and collect their predictions and
+      coefficients in the order of the files (results of a previous call are
+      replaced).
+      An exception while reading any file is rethrown (no results are kept).
+  **/
+  m_pred_distrs.clear();
+  m_coef_distrs.clear();
+  size_t n_files = m_input_infos.size();
+  std::vector<Data::PredDistrVec> pred_distrs (n_files);
+  std::vector<Data::CoefDistrVec> coef_distrs (n_files);
+  std::mutex root_mutex {}; // ROOT file access is not thread safe
+
+  size_t n_threads = std::max<size_t>(std::min(m_n_threads, n_files), 1);
+  CppUtils::ThreadPool pool (n_threads);
+  pool.run(
+    n_files,
+    [&](size_t file, size_t) {
+      InputInfo *input_info = m_input_infos[file];
+      spdlog::debug("Reading file {}.", input_info->m_file_path);
+      DataReader reader (input_info);
+      if (input_info->m_input_style == "RK") {
+        std::lock_guard<std::mutex> lock (root_mutex);
+        reader.read_file();
+      } else {
+        reader.read_file();
+      }
+      pred_distrs[file] = reader.get_pred_distrs();
+      coef_distrs[file] = reader.get_coef_distrs();
+    }
+  );
+
+  for (size_t file=0; file<n_files; file++) {
+    m_pred_distrs.insert( m_pred_distrs.end(),
+                          pred_distrs[file].begin(), pred_distrs[file].end() );
+    m_coef_distrs.insert( m_coef_distrs.end(),
+                          coef_distrs[file].begin(), coef_distrs[file].end() );
+  }
+}
+
+//------------------------------------------------------------------------------
+
+}
+}
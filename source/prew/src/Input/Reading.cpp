@@ -1,4 +1,3 @@
-#include <CppUtils/Root.h>
 #include <CppUtils/Str.h>
 #include <CppUtils/Vec.h>
 #include <Data/PredDistr.h>
@@ -10,13 +9,51 @@
 
 // Includes from ROOT
 #include "TFile.h"
+#include "TLeaf.h"
 #include "TMatrixT.h"
 #include "TTree.h"
 
 #include "spdlog/spdlog.h"
 
+#include <algorithm>
+#include <cstddef>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
 namespace PrEW {
 namespace Input {
+
+//------------------------------------------------------------------------------
+
+namespace {
+  struct RKBranchObjects {
+    /** Objects that ROOT creates for the branches of an RK style tree.
+        They belong to the reader and are deleted (after detaching them from
+        the tree) when leaving the reading function, also on exceptions.
+    **/
+    TTree *m_tree {};
+    std::string *m_process {};
+    std::string *m_coef_label {};
+    TMatrixT<double> *m_bin_centers {};
+    TMatrixT<double> *m_bin_widths {};
+    std::vector<TMatrixT<double>*> m_coefs {};
+    
+    RKBranchObjects(TTree *tree, size_t n_chiral) : 
+      m_tree(tree), m_coefs(n_chiral, nullptr) {}
+    RKBranchObjects(const RKBranchObjects&) = delete;
+    RKBranchObjects& operator=(const RKBranchObjects&) = delete;
+    ~RKBranchObjects() {
+      m_tree->ResetBranchAddresses();
+      delete m_process;
+      delete m_coef_label;
+      delete m_bin_centers;
+      delete m_bin_widths;
+      for (auto & coef_mtx: m_coefs) { delete coef_mtx; }
+    }
+  };
+}
   
 //------------------------------------------------------------------------------
 
@@ -41,6 +78,9 @@ void Reading::read_RK_file(
 {
   /** Read input file that is in style of Robert Karls root files.
       Extracts predicted cross sections and coefficiencts for TGCs.
+      Buffers are sized from the file (no limit on the number of bins) and
+      reused for all processes, values are written directly into the columns
+      of the distributions.
   **/
   
   // Get all the information needed to read the file
@@ -51,150 +91,158 @@ void Reading::read_RK_file(
   std::string file_path = info->m_file_path;
   int energy = info->m_energy;
   
-  // Parameters to read out of tree
-  std::string *process {};
-  int n_bins {};
-  TMatrixT < double > *bin_centers = 0;
-  TMatrixT < double > *bin_widths = 0;
-  
-  const unsigned int number_init = 10000;
-  double diff_sigma_signal_LR[number_init] {};
-  double diff_sigma_signal_RL[number_init] {};
-  double diff_sigma_signal_RR[number_init] {};
-  double diff_sigma_signal_LL[number_init] {};
-  
-  std::string * diff_TGC_coeff_label {};
-  TMatrixT<double> *diff_TGC_coeff_LR = 0;
-  TMatrixT<double> *diff_TGC_coeff_RL = 0;
-  TMatrixT<double> *diff_TGC_coeff_RR = 0;
-  TMatrixT<double> *diff_TGC_coeff_LL = 0;
-  
-  // Open tree
+  // Open tree (file is closed when leaving the function, also on exceptions)
   spdlog::debug("Opening file: {}", file_path);
-  TFile *file = new TFile( file_path.c_str(), "Read" );	
+  std::unique_ptr<TFile> file ( TFile::Open( file_path.c_str(), "READ" ) );
+  if ( (file == nullptr) || file->IsZombie() ) {
+    throw std::invalid_argument("Can't open ROOT file " + file_path);
+  }
   std::string tree_name = "MinimizationProcesses" + std::to_string(energy) + "GeV";
-  TTree *tree = static_cast<TTree*>( file->Get( tree_name.c_str() ) );
+  TTree *tree {};
+  file->GetObject( tree_name.c_str(), tree );
   if( tree == nullptr ){
     throw std::invalid_argument( ("No tree for energy " + std::to_string(energy) 
                                   + " in file " + file_path + " !").c_str());
   }
   
-  // Couple parameters to tree addresses
-  tree->SetBranchAddress("describtion", &process );
-  tree->SetBranchAddress("angular_number", &n_bins );
-  tree->SetBranchAddress("angular_center", &bin_centers );
-  tree->SetBranchAddress("angular_width", &bin_widths );
+  // Chiral configurations in the order in which they are stored
+  const std::vector<std::string> chiralities {"LL", "LR", "RL", "RR"};
+  const std::vector<CppUtils::Symbol> pol_configs { 
+    GlobalVar::Chiral::eLpL, GlobalVar::Chiral::eLpR,
+    GlobalVar::Chiral::eRpL, GlobalVar::Chiral::eRpR 
+  };
+  size_t n_chiral = chiralities.size();
   
-  tree->SetBranchAddress("differential_sigma_LR", diff_sigma_signal_LR );
-  tree->SetBranchAddress("differential_sigma_RL", diff_sigma_signal_RL );
-  tree->SetBranchAddress("differential_sigma_RR", diff_sigma_signal_RR );
-  tree->SetBranchAddress("differential_sigma_LL", diff_sigma_signal_LL );
+  // Only read the needed branches, prefetch their baskets cluster-wise
+  tree->SetBranchStatus("*", false);
+  std::vector<std::string> branches { "describtion", "angular_number", 
+                                      "angular_center", "angular_width", 
+                                      "differential_PNPC_label" };
+  for (const auto & chirality: chiralities) {
+    branches.push_back("differential_sigma_" + chirality);
+    branches.push_back("differential_PNPC_" + chirality);
+  }
+  for (const auto & branch: branches) {
+    tree->SetBranchStatus((branch + "*").c_str(), true); // Incl. sub-branches
+  }
+  tree->SetCacheSize(-1); // Default cache size of the tree
+  tree->AddBranchToCache("*", true);
   
-  tree->SetBranchAddress("differential_PNPC_label", &diff_TGC_coeff_label );
-  tree->SetBranchAddress("differential_PNPC_LR", &diff_TGC_coeff_LR );
-  tree->SetBranchAddress("differential_PNPC_RL", &diff_TGC_coeff_RL );
-  tree->SetBranchAddress("differential_PNPC_RR", &diff_TGC_coeff_RR );
-  tree->SetBranchAddress("differential_PNPC_LL", &diff_TGC_coeff_LL );
+  // Largest number of bins of all processes (only reads this branch)
+  int n_bins {};
+  TBranch *n_bins_branch = tree->GetBranch("angular_number");
+  if ( n_bins_branch == nullptr ) {
+    throw std::invalid_argument("No angular_number branch in " + file_path);
+  }
+  n_bins_branch->SetAddress( &n_bins );
+  Long64_t n_processes = tree->GetEntries();
+  size_t max_bins = 0;
+  for (Long64_t p=0; p<n_processes; p++) {
+    n_bins_branch->GetEntry(p);
+    if (n_bins < 0) {
+      throw std::invalid_argument("Negative number of bins in " + file_path);
+    }
+    max_bins = std::max(max_bins, size_t(n_bins));
+  }
+  
+  // Parameters to read out of tree, buffers are reused for all processes
+  RKBranchObjects objs (tree, n_chiral);
+  std::vector<std::vector<double>> diff_sigma_signal (n_chiral);
+  
+  // Couple parameters to tree addresses
+  tree->SetBranchAddress("describtion", &(objs.m_process) );
+  tree->SetBranchAddress("angular_number", &n_bins );
+  tree->SetBranchAddress("angular_center", &(objs.m_bin_centers) );
+  tree->SetBranchAddress("angular_width", &(objs.m_bin_widths) );
+  tree->SetBranchAddress("differential_PNPC_label", &(objs.m_coef_label) );
+  for (size_t c=0; c<n_chiral; c++) {
+    // Array branches may have a fixed length larger than the number of bins
+    std::string sigma_name = "differential_sigma_" + chiralities[c];
+    TLeaf *sigma_leaf = tree->GetLeaf( sigma_name.c_str() );
+    if ( sigma_leaf == nullptr ) {
+      throw std::invalid_argument("No " + sigma_name + " leaf in " + file_path);
+    }
+    size_t buffer_size = std::max( 
+      max_bins, size_t(std::max(sigma_leaf->GetLenStatic(), 1)) );
+    diff_sigma_signal[c].resize( buffer_size );
+    tree->SetBranchAddress( sigma_name.c_str(), diff_sigma_signal[c].data() );
+    tree->SetBranchAddress( ("differential_PNPC_" + chiralities[c]).c_str(), 
+                            &(objs.m_coefs[c]) );
+  }
   
-  int n_processes = tree->GetEntries();
-  for(int p=0; p<n_processes; p++){
+  for(Long64_t p=0; p<n_processes; p++){
     tree->GetEntry(p);
+    size_t n = size_t(n_bins);
+    const TMatrixT<double> *bin_centers = objs.m_bin_centers;
+    const TMatrixT<double> *bin_widths = objs.m_bin_widths;
+    const std::string &process = *(objs.m_process);
     
-    // Info that identifies distribution
-    Data::DistrInfo basic_info {};
-    basic_info.m_energy = energy;
-    basic_info.m_distr_name = *process;
-    
-    Data::DistrInfo info_LL = basic_info,
-                    info_LR = basic_info,
-                    info_RL = basic_info,
-                    info_RR = basic_info;
-                    
-    info_LL.m_pol_config = GlobalVar::Chiral::eLpL;
-    info_LR.m_pol_config = GlobalVar::Chiral::eLpR;
-    info_RL.m_pol_config = GlobalVar::Chiral::eRpL;
-    info_RR.m_pol_config = GlobalVar::Chiral::eRpR;
-
-    Data::PredDistr pred_LL {}, pred_LR {}, pred_RL {}, pred_RR {};
-    pred_LL.m_info = info_LL;
-    pred_LR.m_info = info_LR;
-    pred_RL.m_info = info_RL;
-    pred_RR.m_info = info_RR;
-    
-    // Reading of actual distribution and coefficients
-    CppUtils::Vec::Matrix2D<double> bin_center_mtx 
-      = CppUtils::Root::matrix2D_from_TMatrixT( *bin_centers );
-    CppUtils::Vec::Matrix2D<double> bin_width_mtx 
-      = CppUtils::Root::matrix2D_from_TMatrixT( *bin_widths );
-    
-    Data::CoordVec coords (n_bins);
-    for (int bin=0; bin<n_bins; bin++) {
-      auto this_bin_center = bin_center_mtx[bin];
-      auto this_bin_width = bin_width_mtx[bin];
-      int n_dims = this_bin_center.size();
-      std::vector<double> edge_low (n_dims);
-      std::vector<double> edge_up (n_dims);
-      for (int dim=0; dim<n_dims; dim++) {
-        edge_low[dim] = this_bin_center[dim] - this_bin_width[dim] / 2.0;
-        edge_up[dim]  = this_bin_center[dim] + this_bin_width[dim] / 2.0;
+    // Bin coordinates from the (row-major) matrix storage
+    if ( (size_t(bin_centers->GetNrows()) < n) || 
+         (bin_widths->GetNrows() != bin_centers->GetNrows()) ||
+         (bin_widths->GetNcols() != bin_centers->GetNcols()) ) {
+      throw std::invalid_argument( "Inconsistent bin matrices for " + 
+                                   process + " in " + file_path );
+    }
+    size_t n_dims = size_t(bin_centers->GetNcols());
+    const double *centers = bin_centers->GetMatrixArray();
+    const double *widths = bin_widths->GetMatrixArray();
+    Data::CoordVec coords {};
+    coords.reserve(n);
+    for (size_t bin=0; bin<n; bin++) {
+      std::vector<double> center (n_dims), edge_low (n_dims), edge_up (n_dims);
+      for (size_t dim=0; dim<n_dims; dim++) {
+        double c = centers[bin * n_dims + dim];
+        double w = widths[bin * n_dims + dim];
+        center[dim] = c;
+        edge_low[dim] = c - w / 2.0;
+        edge_up[dim]  = c + w / 2.0;
       }
-      coords[bin] = Data::BinCoord(this_bin_center, edge_low, edge_up);
+      coords.emplace_back(center, edge_low, edge_up);
     }
     
-    pred_LL.m_coords = coords;
-    pred_LR.m_coords = coords;
-    pred_RL.m_coords = coords;
-    pred_RR.m_coords = coords;
-    
-    std::vector<std::string> coef_labels = CppUtils::Str::string_to_vec( *diff_TGC_coeff_label, ";");
+    std::vector<std::string> coef_labels = 
+      CppUtils::Str::string_to_vec( *(objs.m_coef_label), ";");
     size_t n_coefs = coef_labels.size();
     
-    std::vector<std::vector<double>> coef_vals_LL (n_coefs), 
-      coef_vals_LR (n_coefs), coef_vals_RL (n_coefs), coef_vals_RR (n_coefs);
+    // Info that identifies distribution
+    Data::DistrInfo basic_info {};
+    basic_info.m_energy = energy;
+    basic_info.m_distr_name = process;
     
-    for (int bin=0; bin<n_bins; bin++) {
-      pred_LL.m_sig_distr.push_back( diff_sigma_signal_LL[bin] );
-      pred_LR.m_sig_distr.push_back( diff_sigma_signal_LR[bin] );
-      pred_RL.m_sig_distr.push_back( diff_sigma_signal_RL[bin] );
-      pred_RR.m_sig_distr.push_back( diff_sigma_signal_RR[bin] );
+    for (size_t c=0; c<n_chiral; c++) {
+      Data::DistrInfo chiral_info = basic_info;
+      chiral_info.m_pol_config = pol_configs[c];
       
+      // RK style files don't contain background distributions => 0-entries
+      pred_distrs->push_back( Data::PredDistr{
+        chiral_info, coords,
+        std::vector<double>( diff_sigma_signal[c].begin(), 
+                             diff_sigma_signal[c].begin() + std::ptrdiff_t(n) ),
+        std::vector<double>(n)
+      } );
+      
+      // Coefficient columns from the (row-major) matrix storage
+      const TMatrixT<double> &coef_mtx = *(objs.m_coefs[c]);
+      if ( (size_t(coef_mtx.GetNrows()) < n) || 
+           (size_t(coef_mtx.GetNcols()) < n_coefs) ) {
+        throw std::invalid_argument( "Inconsistent coefficient matrix for " + 
+                                     process + " in " + file_path );
+      }
+      size_t n_cols = size_t(coef_mtx.GetNcols());
+      const double *coef_array = coef_mtx.GetMatrixArray();
+      std::vector<double> coef_vals (n);
       for (size_t coef=0; coef<n_coefs; coef++) {
-        coef_vals_LL[coef].push_back((*diff_TGC_coeff_LL)[bin][coef]);
-        coef_vals_LR[coef].push_back((*diff_TGC_coeff_LR)[bin][coef]);
-        coef_vals_RL[coef].push_back((*diff_TGC_coeff_RL)[bin][coef]);
-        coef_vals_RR[coef].push_back((*diff_TGC_coeff_RR)[bin][coef]);
+        for (size_t bin=0; bin<n; bin++) {
+          coef_vals[bin] = coef_array[bin * n_cols + coef];
+        }
+        coef_distrs->push_back(
+          Data::CoefDistr(coef_labels[coef], chiral_info, coef_vals) );
       }
     }
-    
-    Data::CoefDistrVec coefs_LL (n_coefs), coefs_LR (n_coefs), coefs_RL (n_coefs), coefs_RR (n_coefs);
-    for (size_t c=0; c<n_coefs; c++) { 
-      coefs_LL[c] = Data::CoefDistr(coef_labels[c],info_LL,coef_vals_LL[c]);
-      coefs_LR[c] = Data::CoefDistr(coef_labels[c],info_LR,coef_vals_LR[c]);
-      coefs_RL[c] = Data::CoefDistr(coef_labels[c],info_RL,coef_vals_RL[c]);
-      coefs_RR[c] = Data::CoefDistr(coef_labels[c],info_RR,coef_vals_RR[c]);
-    }
-    
-    // RK style files don't contain background distributions => 0-entry vectors
-    pred_LL.m_bkg_distr = std::vector<double>(pred_LL.m_sig_distr.size());
-    pred_LR.m_bkg_distr = std::vector<double>(pred_LR.m_sig_distr.size());
-    pred_RL.m_bkg_distr = std::vector<double>(pred_RL.m_sig_distr.size());
-    pred_RR.m_bkg_distr = std::vector<double>(pred_RR.m_sig_distr.size());
-    
-    // Saving distributions in given pointers
-    pred_distrs->push_back(pred_LL);
-    pred_distrs->push_back(pred_LR);
-    pred_distrs->push_back(pred_RL);
-    pred_distrs->push_back(pred_RR);
-    
-    for (auto & coef: coefs_LL) { coef_distrs->push_back(coef); }
-    for (auto & coef: coefs_LR) { coef_distrs->push_back(coef); }
-    for (auto & coef: coefs_RL) { coef_distrs->push_back(coef); }
-    for (auto & coef: coefs_RR) { coef_distrs->push_back(coef); }
   }
   
   spdlog::debug("Number of distributions found: {}", pred_distrs->size());
-  
-  file->Close();
 }
   
 //------------------------------------------------------------------------------
@@ -0,0 +1,176 @@
+#include <CppUtils/Sys.h>
+#include <Output/BinaryPrinter.h>
+#include <Output/Printer.h>
+
+#include <stdexcept>
+
+namespace PrEW {
+namespace Output {
+
+//------------------------------------------------------------------------------
+
+namespace {
+  const char magic[8] = {'P', 'r', 'E', 'W', 'O', 'U', 'T', '\0'};
+  const std::uint32_t byte_order = 0x01020304;
+}
+
+const std::uint32_t BinaryPrinter::version;
+
+//------------------------------------------------------------------------------
+// Constructors
+
+BinaryPrinter::BinaryPrinter(
+  const std::string & file_path,
+  const std::string & mode
+) :
+  m_file_path(file_path)
+{
+  /** Open the output file.
+      The mode determines how file is accessed. Options are:
+        "overwrite" -> Overwrites previous file content
+        "append"    -> Appends frames at end of file to previous content
+  **/
+  if (! CppUtils::Sys::file_writable(file_path)) {
+    throw std::invalid_argument("No write access to " + m_file_path);
+  }
+
+  std::ios::openmode open_mode = std::ios::binary;
+  if ( mode == "overwrite" )   { open_mode |= std::ios::trunc; }
+  else if ( mode == "append" ) { open_mode |= std::ios::app; }
+  else { throw std::invalid_argument("Unknown opening mode: " + mode); }
+  m_file.open( m_file_path.c_str(), open_mode );
+
+  // File header (only once per file)
+  m_file.seekp(0, std::ios::end);
+  if ( m_file.tellp() == std::streampos(0) ) {
+    m_file.write(magic, sizeof(magic));
+    m_file.write( reinterpret_cast<const char*>(&version), sizeof(version) );
+    m_file.write( reinterpret_cast<const char*>(&byte_order),
+                  sizeof(byte_order) );
+  }
+  if (!m_file) {
+    throw std::invalid_argument("Can't write to " + m_file_path);
+  }
+}
+
+//------------------------------------------------------------------------------
+// Internal functions
+
+template<class T>
+void BinaryPrinter::put(const T & val) {
+  const char * bytes = reinterpret_cast<const char*>(&val);
+  m_buffer.insert(m_buffer.end(), bytes, bytes + sizeof(T));
+}
+
+void BinaryPrinter::put_str(const std::string & str) {
+  this->put(std::uint64_t(str.size()));
+  m_buffer.insert(m_buffer.end(), str.begin(), str.end());
+}
+
+void BinaryPrinter::write_frame(FrameType type) {
+  /** Write the current buffer as payload of a frame of the given type and
+      clear the buffer (keeps its memory for the next frame).
+  **/
+  std::uint32_t frame_type = static_cast<std::uint32_t>(type);
+  std::uint32_t reserved = 0;
+  std::uint64_t size = m_buffer.size();
+  m_file.write( reinterpret_cast<const char*>(&frame_type),
+                sizeof(frame_type) );
+  m_file.write( reinterpret_cast<const char*>(&reserved), sizeof(reserved) );
+  m_file.write( reinterpret_cast<const char*>(&size), sizeof(size) );
+  m_file.write( m_buffer.data(), std::streamsize(m_buffer.size()) );
+  m_buffer.clear();
+  if (!m_file) {
+    throw std::runtime_error("Writing to " + m_file_path + " failed!");
+  }
+}
+
+//------------------------------------------------------------------------------
+// Writing functions
+
+void BinaryPrinter::new_setup(
+  int energy,
+  const Connect::DataConnector & connector
+) {
+  /** Start a new setup defined by the function links in the data connector and
+      the energy at which the fit is performed.
+  **/
+  m_n_fits = 0;
+  this->put(std::int32_t(energy));
+  this->put_str(Printer::setup_info(energy, connector));
+  this->write_frame(FrameType::Setup);
+}
+
+void BinaryPrinter::add_fit( const Fit::FitResult & result ) {
+  /** Append the content of a FitResult object to the file.
+  **/
+  size_t n_pars = result.m_par_names.size();
+  if ( (result.m_pars_fin.size() != n_pars) ||
+       (result.m_uncs_fin.size() != n_pars) ) {
+    throw std::invalid_argument(
+      "FitResult values don't match number of parameters!");
+  }
+  for (const auto * matrix: {&result.m_cov_matrix, &result.m_cor_matrix}) {
+    for (const auto & row: *matrix) {
+      if (row.size() != matrix->size()) {
+        throw std::invalid_argument("FitResult matrix is not quadratic!");
+      }
+    }
+  }
+
+  // Parameter names only once per setup
+  if (m_n_fits == 0) {
+    this->put(std::uint32_t(n_pars));
+    for (const auto & par_name: result.m_par_names) { this->put_str(par_name); }
+    this->write_frame(FrameType::Pars);
+  }
+
+  this->put(std::uint32_t(n_pars));
+  this->put(std::uint32_t(result.m_cov_matrix.size()));
+  this->put(std::uint32_t(result.m_cor_matrix.size()));
+  for (int val: { result.m_n_bins, result.m_n_free_pars,
+                  result.m_n_fct_calls, result.m_n_iters,
+                  result.m_min_status, result.m_cov_status }) {
+    this->put(std::int32_t(val));
+  }
+  this->put(result.m_chisq_fin);
+  this->put(result.m_edm_fin);
+  for (const auto & val: result.m_pars_fin) { this->put(val); }
+  for (const auto & val: result.m_uncs_fin) { this->put(val); }
+  for (const auto & row: result.m_cov_matrix) {
+    for (const auto & val: row) { this->put(val); }
+  }
+  for (const auto & row: result.m_cor_matrix) {
+    for (const auto & val: row) { this->put(val); }
+  }
+  this->write_frame(FrameType::Fit);
+  m_n_fits++;
+}
+
+void BinaryPrinter::add_fits( const Fit::ResultVec & results ) {
+  /** Append the content of all given FitResult objects to the file.
+  **/
+  for ( const auto & result: results ) {
+    this->add_fit(result);
+  }
+}
+
+void BinaryPrinter::flush() {
+  /** Make sure everything added so far is written to the file.
+  **/
+  m_file.flush();
+}
+
+//------------------------------------------------------------------------------
+// Access functions
+
+const std::string & BinaryPrinter::get_file_path() const {
+  return m_file_path;
+}
+
+int BinaryPrinter::get_n_fits() const { return m_n_fits; }
+
+//------------------------------------------------------------------------------
+
+}
+}
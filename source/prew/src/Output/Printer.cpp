@@ -3,8 +3,11 @@
 #include <Output/Printer.h>
 
 #include <fstream>
-#include <iostream>
 #include <stdexcept>
+#include <utility>
+
+// External
+#include "spdlog/spdlog.h"
 
 namespace PrEW {
 namespace Output {
@@ -20,6 +23,16 @@ Printer::Printer( std::string file_path ) : m_file_path(file_path) {
   }
 }
 
+Printer::~Printer() {
+  /** In streaming mode the open setup is completed and everything is written
+      before the file is closed.
+  **/
+  try { this->close(); }
+  catch (const std::exception & e) { 
+    spdlog::error("Closing {} failed: {}", m_file_path, e.what());
+  }
+}
+
 //------------------------------------------------------------------------------
 // Writing functions
 
@@ -29,19 +42,36 @@ void Printer::new_setup(
 ) {
   /** Start a new setup defined by the function links in the data connector and 
       the energy at which the fit is performed.
-      Output of any previous setup(s) is saved.
+      Output of any previous setup(s) is saved (streaming mode: written).
   **/
-  this->save_setup_output();
+  std::lock_guard<std::mutex> lock (m_mutex);
+  if (m_streaming) {
+    this->end_open_setup();
+  } else {
+    this->save_setup_output();
+  }
   this->reset_setup();
   this->add_meta_info(energy,connector);
+  if (m_streaming) {
+    this->enqueue(this->setup_begin());
+    m_setup_open = true;
+  }
 }
 
 void Printer::add_fit( const Fit::FitResult & result ) {
   /** Add the content of a FitResult object to the current setup output.
+      In streaming mode the output is handed to the writer whenever the 
+      buffer size is reached (throws if writing previous output failed).
   **/
+  std::lock_guard<std::mutex> lock (m_mutex);
+  if (m_streaming) { this->check_written(); }
   if (m_n_fits == 0) { this->add_par_info(result); } // Collect general par info
   this->add_fit_res(result);
   m_n_fits++;
+  if ( m_streaming && (m_res_str.size() >= m_buffer_size) ) {
+    this->enqueue(std::move(m_res_str));
+    m_res_str.clear();
+  }
 }
 
 void Printer::add_fits( const Fit::ResultVec & results ) {
@@ -53,19 +83,22 @@ void Printer::add_fits( const Fit::ResultVec & results ) {
   }
 }
 
-void Printer::write(const std::string & mode) const {
+void Printer::write(const std::string & mode) {
   /** Write the current output of all setups into the file at the location
       defined in the constructor.
       The mode determines how file is accessed. Options are:
         "overwrite" -> Overwrites previous file content
         "append"    -> Appends at end of file to previous content
+      In streaming mode the output is already written continuously, only the
+      pending output is flushed (mode is ignored).
   **/
+  if (m_streaming) {
+    this->flush();
+    return;
+  }
   
   // Determine file opening/writing mode
-  std::ios::openmode open_mode;
-  if ( mode == "overwrite" )    { open_mode = std::ios::trunc; }
-  else if ( mode == "append ")  { open_mode = std::ios::app; }
-  else { throw std::invalid_argument("Unknown opening mode: " + mode); }
+  std::ios::openmode open_mode = Printer::open_mode(mode);
   
   // Access file and write
   std::ofstream outfile;
@@ -74,13 +107,101 @@ void Printer::write(const std::string & mode) const {
   outfile.close(); // Close file
 }
 
+//------------------------------------------------------------------------------
+// Streaming mode
+
+void Printer::stream( const std::string & mode, size_t buffer_size ) {
+  /** Switch to streaming mode: The file is opened once (mode see write) and
+      output is written whenever a setup starts or the collected fit output
+      reaches buffer_size characters.
+      Output collected before is written immediately.
+  **/
+  std::lock_guard<std::mutex> lock (m_mutex);
+  if (m_streaming) {
+    throw std::invalid_argument("Printer is already in streaming mode!");
+  }
+  m_file.open( m_file_path.c_str(), Printer::open_mode(mode) );
+  if (!m_file) {
+    throw std::invalid_argument("Can't open " + m_file_path);
+  }
+  m_buffer_size = buffer_size;
+  m_streaming = true;
+  m_stop = false;
+  m_write_failed = false;
+  m_writer = std::thread(&Printer::writer_loop, this);
+  
+  // Hand on what was collected before
+  this->enqueue(std::move(m_compl_setups));
+  m_compl_setups.clear();
+  if (this->has_setup_to_save()) {
+    this->enqueue(this->setup_begin());
+    this->enqueue(std::move(m_res_str));
+    m_res_str.clear();
+    m_setup_open = true;
+  }
+}
+
+void Printer::flush() {
+  /** Write all output collected so far (streaming mode) and wait until it is
+      in the file.
+      The current setup stays open (its end marker follows with the next 
+      setup or when closing).
+      Throws if writing failed.
+  **/
+  {
+    std::lock_guard<std::mutex> lock (m_mutex);
+    if (!m_streaming) { return; }
+    this->enqueue(std::move(m_res_str));
+    m_res_str.clear();
+  }
+  {
+    std::unique_lock<std::mutex> queue_lock (m_queue_mutex);
+    m_cv_written.wait( queue_lock, 
+                       [this]{ return m_queue.empty() && !m_writing; } );
+  }
+  this->check_written();
+}
+
+void Printer::close() {
+  /** End streaming mode: Complete the open setup, write everything and close
+      the file.
+      Afterwards output is collected in memory again.
+      Throws if writing any of the streamed output failed.
+  **/
+  {
+    std::lock_guard<std::mutex> lock (m_mutex);
+    if (!m_streaming) { return; }
+    this->end_open_setup();
+    this->reset_setup();
+  }
+  {
+    std::lock_guard<std::mutex> queue_lock (m_queue_mutex);
+    m_stop = true;
+  }
+  m_cv_queue.notify_one();
+  m_writer.join();
+  
+  std::lock_guard<std::mutex> lock (m_mutex);
+  m_file.close();
+  m_streaming = false;
+  bool failed = m_write_failed || !m_file;
+  m_write_failed = false;
+  if (failed) {
+    throw std::runtime_error("Writing to " + m_file_path + " failed!");
+  }
+}
+
 //------------------------------------------------------------------------------
 // Functions to check current status
 
 std::string Printer::get_current_output() const {
   /** Return the current output of all added setups as it would be written into
       the output file.
+      In streaming mode only the fit output which is not yet handed to the 
+      writer is returned.
   **/
+  std::lock_guard<std::mutex> lock (m_mutex);
+  if (m_streaming) { return m_res_str; }
   return m_compl_setups + this->assemble_setup_output();
 }
 
@@ -91,71 +212,84 @@ void Printer::add_meta_info(
   int energy, 
   const Connect::DataConnector & connector
 ) {
-  /** Add information about:
+  /** Add information about the given setup (see setup_info).
+  **/
+  m_info_str += Printer::setup_info(energy, connector);
+}
+
+std::string Printer::setup_info(
+  int energy, 
+  const Connect::DataConnector & connector
+) {
+  /** Information about:
         - energy
         - polarisation configurations
         - applied functions and their parameter names
       as they were used in the given setup (defined by energy and connector).
   **/
+  std::string info_str {};
+  
   // Read energy
-  m_info_str += "Energy: " + std::to_string(energy) + "\n";
+  info_str += "Energy: " + std::to_string(energy) + "\n";
   
   // Read polarisation configurations
-  m_info_str += "Polarisation configurations: ";
-  m_info_str += "  [Name] ePol-Name pPol-Name ePol-Sign pPol-Sign\n";
+  info_str += "Polarisation configurations: ";
+  info_str += "  [Name] ePol-Name pPol-Name ePol-Sign pPol-Sign\n";
   for ( const auto & pol_link : connector.get_pol_links() ) {
     if (pol_link.get_energy() == energy) {
-      m_info_str += "  [" + pol_link.get_pol_config() + "] " +
-                    pol_link.get_eM_pol() + " " +
-                    pol_link.get_eP_pol() + " " +
-                    std::to_string(pol_link.get_eM_sgn_factor()) + " " +
-                    std::to_string(pol_link.get_eP_sgn_factor()) + "\n";
+      info_str += "  [" + pol_link.get_pol_config().str() + "] " +
+                  pol_link.get_eM_pol() + " " +
+                  pol_link.get_eP_pol() + " " +
+                  std::to_string(pol_link.get_eM_sgn_factor()) + " " +
+                  std::to_string(pol_link.get_eP_sgn_factor()) + "\n";
     }
   }
   
   // Read the function links applied to the distributions
-  m_info_str += "Applied functions:\n";
-  m_info_str += "  [Distr-Name] [Pol-Config]\n";
-  m_info_str += "    Sig/Bkg Fct-Name {Par1,Par2,...} {C1,C2,...}\n";
+  info_str += "Applied functions:\n";
+  info_str += "  [Distr-Name] [Pol-Config]\n";
+  info_str += "    Sig/Bkg Fct-Name {Par1,Par2,...} {C1,C2,...}\n";
   for ( const auto & pred_link : connector.get_pred_links() ) {
     if (pred_link.m_info.m_energy == energy) {
       
       // Read function links for signal predictions
-      m_info_str += "  [" + pred_link.m_info.m_distr_name + "] " +
-                    "[" + pred_link.m_info.m_pol_config + "]\n";
+      info_str += "  [" + pred_link.m_info.m_distr_name.str() + "] " +
+                  "[" + pred_link.m_info.m_pol_config.str() + "]\n";
                     
       for ( const auto & fct_link: pred_link.m_fcts_links_sig ) {
-        m_info_str += "    Sig " +
-                      fct_link.m_fct_name + " {";
+        info_str += "    Sig " +
+                    fct_link.m_fct_name + " {";
         for (size_t p=0; p<fct_link.m_pars.size(); p++) {
-          if (p>0) { m_info_str += ","; }
-          m_info_str += fct_link.m_pars[p];
+          if (p>0) { info_str += ","; }
+          info_str += fct_link.m_pars[p];
         }
-        m_info_str += "} {";
+        info_str += "} {";
         for (size_t c=0; c<fct_link.m_coefs.size(); c++) {
-          if (c>0) { m_info_str += ","; }
-          m_info_str += fct_link.m_coefs[c];
+          if (c>0) { info_str += ","; }
+          info_str += fct_link.m_coefs[c];
         }
-        m_info_str += "}\n";
+        info_str += "}\n";
       }
       
       // Read function links for background predictions              
       for ( const auto & fct_link: pred_link.m_fcts_links_bkg ) {
-        m_info_str += "    Bkg " +
-                      fct_link.m_fct_name + " {";
+        info_str += "    Bkg " +
+                    fct_link.m_fct_name + " {";
         for (size_t p=0; p<fct_link.m_pars.size(); p++) {
-          if (p>0) { m_info_str += ","; }
-          m_info_str += fct_link.m_pars[p];
+          if (p>0) { info_str += ","; }
+          info_str += fct_link.m_pars[p];
         }
-        m_info_str += "} {";
+        info_str += "} {";
         for (size_t c=0; c<fct_link.m_coefs.size(); c++) {
-          if (c>0) { m_info_str += ","; }
-          m_info_str += fct_link.m_coefs[c];
+          if (c>0) { info_str += ","; }
+          info_str += fct_link.m_coefs[c];
         }
-        m_info_str += "}\n";
+        info_str += "}\n";
       }
     }
   }
+  
+  return info_str;
 }
 
 void Printer::add_par_info( const Fit::FitResult & result ) {
@@ -233,15 +367,28 @@ std::string Printer::assemble_setup_output() const {
   **/
   std::string output = "";
   if (this->has_setup_to_save()) {
-    output += std::string("") +
-      "<=========================== BEGIN ==========================>\n" +
-      "<SETUP>\n" + m_info_str + "<END SETUP>\n\n" +
-      "<FITS>\n" + m_res_str + "<END FITS>\n" +
-      "<============================ END ===========================>\n";
+    output += this->setup_begin() + m_res_str + this->setup_end();
   }
   return output;
 }
 
+std::string Printer::setup_begin() const {
+  /** Output of the current setup that comes before the fit results.
+  **/
+  return std::string("") +
+    "<=========================== BEGIN ==========================>\n" +
+    "<SETUP>\n" + m_info_str + "<END SETUP>\n\n" +
+    "<FITS>\n";
+}
+
+std::string Printer::setup_end() const {
+  /** Output of the current setup that comes after the fit results.
+  **/
+  return std::string("") +
+    "<END FITS>\n" +
+    "<============================ END ===========================>\n";
+}
+
 //------------------------------------------------------------------------------
 // Internal functions to handle output
 
@@ -267,6 +414,76 @@ void Printer::reset_setup() {
   m_n_fits = 0;
 }
 
+std::ios::openmode Printer::open_mode(const std::string & mode) {
+  /** File opening mode for the given writing mode (see write).
+  **/
+  if ( mode == "overwrite" )   { return std::ios::trunc; }
+  else if ( mode == "append" ) { return std::ios::app; }
+  else { throw std::invalid_argument("Unknown opening mode: " + mode); }
+}
+
+//------------------------------------------------------------------------------
+// Internal functions for streaming mode
+
+void Printer::enqueue(std::string && block) {
+  /** Hand a block of output on to the writer thread.
+  **/
+  if (block.empty()) { return; }
+  {
+    std::lock_guard<std::mutex> queue_lock (m_queue_mutex);
+    m_queue.push_back(std::move(block));
+  }
+  m_cv_queue.notify_one();
+}
+
+void Printer::end_open_setup() {
+  /** Hand on the remaining output and the end of the current setup (if its
+      beginning was already written).
+  **/
+  if (!m_setup_open) { return; }
+  this->enqueue(std::move(m_res_str));
+  m_res_str.clear();
+  this->enqueue(this->setup_end());
+  m_setup_open = false;
+}
+
+void Printer::check_written() {
+  /** Throw if the writer thread failed to write to the file.
+  **/
+  std::lock_guard<std::mutex> queue_lock (m_queue_mutex);
+  if (m_write_failed) {
+    throw std::runtime_error("Writing to " + m_file_path + " failed!");
+  }
+}
+
+void Printer::writer_loop() {
+  /** Writer thread: Write blocks in the order they were queued, flush the 
+      file whenever the queue is empty.
+      If the file can't be written (e.g. disk full) the failure is stored
+      and further blocks are dropped (see check_written).
+  **/
+  std::unique_lock<std::mutex> queue_lock (m_queue_mutex);
+  while (true) {
+    m_cv_queue.wait( queue_lock, [this]{ return m_stop || !m_queue.empty(); } );
+    if (m_queue.empty()) { break; } // Stopped and everything written
+    
+    std::deque<std::string> blocks {};
+    blocks.swap(m_queue);
+    m_writing = true;
+    bool failed = m_write_failed;
+    queue_lock.unlock();
+    if (!failed) {
+      for (const auto & block: blocks) { m_file << block; }
+      m_file.flush();
+      failed = !m_file;
+    }
+    queue_lock.lock();
+    m_write_failed = failed;
+    m_writing = false;
+    if (m_queue.empty()) { m_cv_written.notify_all(); }
+  }
+}
+
 //------------------------------------------------------------------------------
 
 }
@@ -101,15 +101,16 @@ ToyGen::ToyGen(
         Fit::BinVec connected_bins {};
         m_connector.fill_bins(
           distribution,
-          &m_pars,
+          m_pars,
           &connected_bins
         );
         distribution.m_distribution = connected_bins;
         
         // Set measurement uncertainty to poissonian uncertainty
         // -> Should not be modified because unc. uses expectation (not truth)
+        auto par_vals = Fit::get_par_vals(m_pars);
         for ( auto & bin : distribution.m_distribution ) {
-          bin.set_val_unc( std::sqrt(bin.get_val_prd()) );
+          bin.set_val_unc( std::sqrt(bin.get_val_prd(par_vals.data())) );
         }
         
         m_diff_distrs.push_back(distribution);
@@ -139,21 +140,23 @@ Data::DiffDistrVec ToyGen::get_distrs ( int energy, bool fluctuated ) const {
   /** Get the toy distributions at a given energy.
       Sets the measured value either to the predicted value (with current 
       parameters) or a poisson fluctuated version of it.
-      Afterwards removes the prediction function because it is connected to 
-      internal members variables of the toy generator.
+      Afterwards removes the prediction function because it refers to the 
+      parameters of the toy generator.
   **/
   // Get the distributions at this energy (with measurement = prediction)
   auto distrs = Data::DistrUtils::subvec_energy(m_diff_distrs, energy);
+  auto par_vals = Fit::get_par_vals(m_pars);
   
   // Modify bin measured value and remove prediction function
   for (auto & distr: distrs) {
     for (auto & bin: distr.m_distribution) {
       if ( fluctuated ) {
         // Fluctuate measured bin value around (potentially modified) prediction
-        bin.set_val_mst( CppUtils::Rnd::poisson_fluctuate(bin.get_val_prd()) );
+        bin.set_val_mst( 
+          CppUtils::Rnd::poisson_fluctuate(bin.get_val_prd(par_vals.data())) );
       } else {
         // Set bin value to (potentially modified) prediction
-        bin.set_val_mst( bin.get_val_prd() );
+        bin.set_val_mst( bin.get_val_prd(par_vals.data()) );
       }
       
       bin.set_prd_fct({}); // Remove toy gen internal prediction function
@@ -0,0 +1,197 @@
+#include <CppUtils/Rnd.h>
+#include <Fit/ChiSqMinimizer.h>
+#include <Fit/PoissonNLLMinimizer.h>
+#include <ToyMeas/ParFlct.h>
+#include <ToyMeas/ToyRunner.h>
+
+#include "spdlog/spdlog.h"
+
+#include <mutex>
+#include <stdexcept>
+#include <vector>
+
+namespace PrEW {
+namespace ToyMeas {
+
+//------------------------------------------------------------------------------
+// Constructors
+
+ToyRunner::ToyRunner(
+  const ToyGen & toy_gen,
+  const Connect::DataConnector & connector,
+  const Fit::ParVec & pars,
+  int energy,
+  const MinimizationFct & minimization_fct,
+  size_t n_threads,
+  unsigned seed
+) :
+  m_toy_gen(toy_gen),
+  m_connector(connector),
+  m_pars(pars),
+  m_energy(energy),
+  m_minimization_fct(minimization_fct),
+  m_seed(seed),
+  m_pool(new CppUtils::ThreadPool(n_threads)),
+  m_containers(n_threads)
+{
+  if (!m_minimization_fct) {
+    throw std::invalid_argument("ToyRunner needs a minimization function!");
+  }
+}
+
+//------------------------------------------------------------------------------
+// Settings
+
+void ToyRunner::set_fluctuate_constrs(bool fluctuate_constrs) {
+  /** Choose whether the constraints of the fit parameters are fluctuated in
+      each toy (default: true).
+  **/
+  m_fluctuate_constrs = fluctuate_constrs;
+}
+
+void ToyRunner::set_compile_prds(bool compile_prds) {
+  /** Choose whether the fit containers of the toys use compiled predictions
+      (default: false).
+  **/
+  m_compile_prds = compile_prds;
+  for (auto & container: m_containers) { container.reset(); } // Refill
+}
+
+//------------------------------------------------------------------------------
+// Access functions
+
+size_t ToyRunner::get_n_threads() const { return m_pool->get_n_threads(); }
+size_t ToyRunner::get_n_toys_done() const { return m_n_toys_done; }
+
+//------------------------------------------------------------------------------
+// Internal functions
+
+Fit::FitResult ToyRunner::run_toy(size_t toy, size_t thread) {
+  /** Perform a single toy fit with its own random number stream in the fit
+      container of the thread.
+      The container is only filled for the first toy of the thread, later 
+      toys only update measurements and parameters (same result as filling 
+      a new container).
+  **/
+  CppUtils::Rnd::set_seed(m_seed, unsigned(toy));
+
+  auto distrs = m_toy_gen.get_fluctuated_distrs(m_energy);
+  Fit::ParVec pars = m_pars;
+  if (m_fluctuate_constrs) { ParFlct::fluctuate_constrs(pars); }
+
+  auto & container = m_containers[thread];
+  if (!container) {
+    container.reset(new Fit::FitContainer());
+    m_connector.fill_fit_container(distrs, pars, container.get(), 
+                                   m_compile_prds);
+  } else {
+    container->update_measurements(distrs);
+    container->update_pars(pars);
+  }
+  return m_minimization_fct(container.get());
+}
+
+//------------------------------------------------------------------------------
+// Core functionality
+
+void ToyRunner::run( size_t n_toys, const ResultFct & result_fct ) {
+  /** Run n_toys toys in parallel and call result_fct for each result.
+      result_fct is called in order of the toys (never at the same time) as
+      soon as all previous toys are done, so results can be streamed without
+      waiting for the whole batch.
+      Toy indices (and therefore random number streams) continue from
+      previous batches.
+  **/
+  size_t first_toy = m_n_toys_done;
+
+  // Finished results waiting for their previous toys
+  std::vector<std::unique_ptr<Fit::FitResult>> pending (n_toys);
+  size_t next_to_hand_on = 0;
+  std::mutex mutex {};
+
+  m_pool->run(
+    n_toys,
+    [&](size_t task, size_t thread) {
+      size_t toy = first_toy + task;
+      spdlog::debug("Running toy {}.", toy);
+      std::unique_ptr<Fit::FitResult> result (
+        new Fit::FitResult(this->run_toy(toy, thread)) );
+
+      std::lock_guard<std::mutex> lock (mutex);
+      pending[task] = std::move(result);
+      while ( (next_to_hand_on < n_toys) && pending[next_to_hand_on] ) {
+        result_fct(first_toy + next_to_hand_on, *(pending[next_to_hand_on]));
+        pending[next_to_hand_on].reset();
+        next_to_hand_on++;
+      }
+    }
+  );
+  m_n_toys_done += n_toys;
+}
+
+void ToyRunner::run( size_t n_toys, Output::Printer * printer ) {
+  /** Run n_toys toys and add the results to the current setup of the printer
+      (in order of the toys).
+  **/
+  this->run(
+    n_toys,
+    [printer](size_t, const Fit::FitResult & result) {
+      printer->add_fit(result);
+    }
+  );
+}
+
+Fit::ResultVec ToyRunner::run( size_t n_toys ) {
+  /** Run n_toys toys and return the results (in order of the toys).
+  **/
+  Fit::ResultVec results {};
+  this->run(
+    n_toys,
+    [&results](size_t, const Fit::FitResult & result) {
+      results.push_back(result);
+    }
+  );
+  return results;
+}
+
+//------------------------------------------------------------------------------
+// Standard minimizations
+
+ToyRunner::MinimizationFct ToyRunner::chisq_minimization(
+  const Fit::MinuitFactory & factory,
+  const Fit::FitResult & start
+) {
+  /** Chi-squared minimization (single threaded, parallelisation is over
+      toys).
+      All toys are started from the given result if there is one (e.g. the
+      fit to the unfluctuated distributions), see ChiSqMinimizer::set_start.
+  **/
+  return [factory, start](Fit::FitContainer * container) {
+    Fit::ChiSqMinimizer minimizer (container, factory);
+    minimizer.set_start(start);
+    minimizer.minimize();
+    return minimizer.get_result();
+  };
+}
+
+ToyRunner::MinimizationFct ToyRunner::nll_minimization(
+  const Fit::MinuitFactory & factory,
+  const Fit::FitResult & start
+) {
+  /** Poisson negative log-likelihood minimization (single threaded,
+      parallelisation is over toys).
+      All toys are started from the given result if there is one (e.g. the
+      fit to the unfluctuated distributions), see PoissonNLLMinimizer::set_start.
+  **/
+  return [factory, start](Fit::FitContainer * container) {
+    Fit::PoissonNLLMinimizer minimizer (container, factory);
+    minimizer.set_start(start);
+    minimizer.minimize();
+    return minimizer.get_result();
+  };
+}
+
+//------------------------------------------------------------------------------
+
+}
+}
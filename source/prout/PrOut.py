@@ -4,6 +4,7 @@
 #-------------------------------------------------------------------------------
 
 import numpy as np
+import struct
   
 #-------------------------------------------------------------------------------
 #=== Storage classes ===========================================================
@@ -238,4 +239,101 @@ class Reader:
       run_reader = RunReader(run)
       self.run_results.append(run_reader.interpret())
 
-#-------------------------------------------------------------------------------
\ No newline at end of file
+#-------------------------------------------------------------------------------
+class BinaryReader:
+  """ Interface class to read a binary PrEW output file (written by the 
+      BinaryPrinter).
+      Call simply using 
+        reader = BinaryReader(file_path)
+        reader.read()
+        results = reader.run_results
+      Results are the same as for the text Reader, the file is read frame by 
+      frame.
+  """
+  magic = b"PrEWOUT\0"
+  version = 1
+  frame_setup = 1
+  frame_pars = 2
+  frame_fit = 3
+  
+  def __init__(self,file_path):
+    """ Constructor take the PrEW output file path
+    """
+    self.file_path = file_path
+    self.run_results = [] # Results after reading the file
+    self.setup_infos = [] # Setup description text of each run
+    self.endian = "<"     # Byte order of the file
+    
+  def read_header(self,f):
+    """ Check the file header and determine the byte order.
+    """
+    if f.read(8) != self.magic:
+      raise ValueError("Not a binary PrEW output file: " + self.file_path)
+    header = f.read(8)
+    for endian in ["<",">"]:
+      version, byte_order = struct.unpack(endian + "II", header)
+      if byte_order == 0x01020304:
+        self.endian = endian
+        break
+    else:
+      raise ValueError("Unknown byte order in " + self.file_path)
+    if version != self.version:
+      raise ValueError("Unknown version {} of {}".format(version,self.file_path))
+    
+  def read_str(self,payload,pos):
+    """ Read a string (length + characters) from the payload.
+    """
+    length, = struct.unpack_from(self.endian + "Q", payload, pos)
+    pos += 8
+    return payload[pos:pos+length].decode(), pos + length
+    
+  def read_fit(self,payload):
+    """ Interpret the payload of a fit frame.
+    """
+    fit_result = FitResult()
+    e = self.endian
+    n_pars, n_cov, n_cor = struct.unpack_from(e + "III", payload, 0)
+    ( fit_result.n_bins, fit_result.n_free_pars, fit_result.n_fct_calls, 
+      fit_result.n_iters, fit_result.min_status, fit_result.cov_status,
+      fit_result.chisq_fin, fit_result.edm_fin ) = \
+      struct.unpack_from(e + "iiiiiidd", payload, 12)
+    vals = np.frombuffer(payload, dtype=np.dtype(e + "f8"), offset=52)
+    fit_result.pars_fin = vals[:n_pars].copy()
+    fit_result.uncs_fin = vals[n_pars:2*n_pars].copy()
+    pos = 2*n_pars
+    fit_result.cov_matrix = vals[pos:pos+n_cov*n_cov].reshape(n_cov,n_cov).copy()
+    pos += n_cov*n_cov
+    fit_result.cor_matrix = vals[pos:pos+n_cor*n_cor].reshape(n_cor,n_cor).copy()
+    return fit_result
+
+  def read(self):
+    """ Read and interpret the frames of the input file.
+    """
+    with open(self.file_path, "rb") as f:
+      self.read_header(f)
+      e = self.endian
+      while True:
+        frame_header = f.read(16)
+        if len(frame_header) < 16: break # End of file
+        frame_type, _, size = struct.unpack(e + "IIQ", frame_header)
+        payload = f.read(size)
+        if len(payload) < size: break # Incomplete last frame
+        
+        if frame_type == self.frame_setup:
+          # New setup starts a new run
+          self.run_results.append(RunResult())
+          info, _ = self.read_str(payload, 4)
+          self.setup_infos.append(info)
+        elif frame_type == self.frame_pars:
+          n_pars, = struct.unpack_from(e + "I", payload, 0)
+          pos = 4
+          par_names = []
+          for p in range(n_pars):
+            name, pos = self.read_str(payload, pos)
+            par_names.append(name)
+          self.run_results[-1].par_names = par_names
+        elif frame_type == self.frame_fit:
+          self.run_results[-1].fit_results.append(self.read_fit(payload))
+        # Frames of unknown type are skipped
+
+#-------------------------------------------------------------------------------
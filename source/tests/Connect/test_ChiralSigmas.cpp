@@ -0,0 +1,64 @@
+#include <Connect/ChiralSigmas.h>
+#include <CppUtils/Num.h>
+
+#include <gtest/gtest.h>
+
+#include <functional>
+#include <stdexcept>
+#include <vector>
+
+using namespace PrEW::Connect;
+using namespace PrEW::CppUtils;
+
+//------------------------------------------------------------------------------
+// Tests for modified chiral cross sections shared between predictions
+
+TEST(TestChiralSigmas, SharedCalculation) {
+  /** Check that polarised predictions from precalculated modified cross
+      sections are the same as when they are calculated on the way.
+  **/
+  std::vector<double> par_vals {0.0, 2.0};
+  PrEW::Fcts::BoundFct alpha = [](const double * p) { return p[1]; };
+
+  // Signal LR/RL, background LR/RL
+  ChiralSigmas sigmas ( {1.0, 2.0, 0.5, 0.0},
+                        {{alpha}, {}, {alpha, alpha}, {}} );
+  ASSERT_EQ( sigmas.get_n_sigmas(), 4 );
+
+  auto constant = [](double val) {
+    return PrEW::Fcts::BoundFct([val](const double *){return val;});
+  };
+  std::vector<PrEW::Fcts::BoundFct> pol_factors_1 {
+    constant(0.5), constant(0.25) };
+  std::vector<PrEW::Fcts::BoundFct> pol_factors_2 {
+    constant(0.0), constant(1.0) };
+  std::vector<PrEW::Fcts::BoundFct> alphas_sig { constant(2.0) };
+
+  std::vector<double> sigmas_mod (4);
+  sigmas.calc_modified(par_vals.data(), sigmas_mod.data());
+  ASSERT_EQ( sigmas_mod, std::vector<double>({2.0, 2.0, 2.0, 0.0}) );
+
+  // (0.5*1*2 + 0.25*2)*2 + 0.5*0.5*2*2 = 4
+  // (0*1*2 + 1*2)*2 + 0*0.5*2*2 = 4
+  for (const auto & pol_factors: {pol_factors_1, pol_factors_2}) {
+    ASSERT_TRUE( Num::equal_to_eps(
+      sigmas.get_polarised(par_vals.data(), pol_factors, alphas_sig, {}),
+      4.0, 1e-9) );
+    ASSERT_EQ(
+      ChiralSigmas::polarise( par_vals.data(), sigmas_mod.data(), pol_factors,
+                              alphas_sig, {} ),
+      sigmas.get_polarised(par_vals.data(), pol_factors, alphas_sig, {}) );
+  }
+
+  par_vals[1] = 1.0;
+  ASSERT_TRUE( Num::equal_to_eps(
+    sigmas.get_polarised(par_vals.data(), pol_factors_1, {}, {}),
+    1.25, 1e-9) );
+
+  // Needs one polarisation factor per chirality
+  ASSERT_THROW( sigmas.get_polarised(par_vals.data(), {constant(1.0)}, {}, {}),
+                std::invalid_argument );
+  ASSERT_THROW( ChiralSigmas({1.0}, {{}}), std::invalid_argument );
+}
+
+//------------------------------------------------------------------------------
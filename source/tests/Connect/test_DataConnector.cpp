@@ -9,10 +9,15 @@
 #include <Fit/FitBin.h>
 #include <Fit/FitContainer.h>
 #include <Fit/FitPar.h>
+#include <Fit/PrdEvaluator.h>
 #include <GlobalVar/Chiral.h>
 
 #include <gtest/gtest.h>
 
+#include <algorithm>
+#include <thread>
+#include <vector>
+
 using namespace PrEW::Connect;
 using namespace PrEW::CppUtils;
 using namespace PrEW::Data;
@@ -98,11 +103,11 @@ TEST(TestDataConnector, DistrFilling) {
   
   // Test on single distribution
   BinVec bins {};
-  connector.fill_bins(diff_distr, &pars, &bins);
+  connector.fill_bins(diff_distr, pars, &bins);
   
   double bin0_val = bins[0].get_val_mst();
   double bin0_unc = bins[0].get_val_unc();
-  double bin0_pred = bins[0].get_val_prd();
+  double bin0_pred = bins[0].get_val_prd(get_par_vals(pars).data());
   ASSERT_EQ( Num::equal_to_eps(bin0_val, 0.8, 1e-9), true );
   ASSERT_EQ( Num::equal_to_eps(bin0_unc, 0.2, 1e-9), true );
   ASSERT_EQ( Num::equal_to_eps(bin0_pred, 0.70354465956, 1e-9), true )
@@ -114,6 +119,268 @@ TEST(TestDataConnector, DistrFilling) {
   connector.fill_fit_container( distr_vec, pars, &fit_container );
   ASSERT_EQ( fit_container.m_fit_pars.size(), 6 );
   ASSERT_EQ( fit_container.m_fit_bins.size(), 2 );
+  ASSERT_EQ( fit_container.m_distr_binnings.size(), 1 );
+  ASSERT_EQ( fit_container.m_distr_binnings[0].m_n_bins, 2 );
+  
+  // Measurements can only be updated with distributions of the same binning
+  DiffDistr shifted_distr = diff_distr;
+  shifted_distr.m_coords[1] = {{2}, {1.5}, {2.5}};
+  ASSERT_THROW( fit_container.update_measurements({shifted_distr}),
+                std::invalid_argument );
+  diff_distr.m_distribution[0].set_val_mst(0.9);
+  fit_container.update_measurements({diff_distr});
+  ASSERT_EQ( fit_container.m_fit_bins[0].get_val_mst(), 0.9 );
+}
+
+//------------------------------------------------------------------------------
+
+TEST(TestDataConnector, CompiledDistrFilling) {
+  // Test that compiled predictions are identical to the bound ones
+  DistrInfo info_pol {"test", "e-p+", 500};
+  DistrInfo info_LR {"test", Chiral::eLpR, 500};
+  DistrInfo info_RL {"test", Chiral::eRpL, 500};
+  DistrInfo info_RR {"test", Chiral::eRpR, 500};
+  CoordVec coords = {{{0}, {-0.5}, {0.5}}, {{1}, {0.5}, {1.5}}};
+  DiffDistr diff_distr { info_pol, coords, {{0.8,0.2},{1,0.2}} };
+  PredDistrVec pred_distrs { 
+    { info_LR, coords, {1, 2}, {0.5, 0.1} },
+    { info_RL, coords, {3, 1}, {0, 0.2} },
+    { info_RR, coords, {0.2, 0.3}, {0.1, 0} },
+  };
+  ParVec pars { 
+    {"A_pol", 1, 0},
+    {"A_LR", 1, 0},
+    {"mu", 0, 0},
+    {"sigma", 0.5, 0},
+    {"c", 0.1, 0},
+    {"ePol", 0.80, 0},
+    {"pPol", 0.30, 0},
+    {"unused", 0, 0}
+  };
+  CoefDistrVec coef_distrs {
+    { "Coef", info_RL, std::vector<double>{0.9, 1.1} },
+    { "Glob", info_pol, 1.2 }
+  };
+  PredLinkVec  pred_links {
+    { info_LR, { {"Gaussian1D", {"A_LR", "mu", "sigma"}} }, {} },
+    { info_RL, { {"ConstantCoef", {}, {"Coef"}} }, 
+               { {"Constant", {"c"}} } },
+    { info_pol, { {"Gaussian1D", {"A_pol", "mu", "sigma"}} }, 
+                { {"ConstantCoef", {}, {"Glob"}} } }
+  };
+  PolLinkVec   pol_links {
+    PolLink(500, "e-p+", "ePol", "pPol", "-", "+")
+  };
+  
+  DataConnector connector {pred_distrs,coef_distrs,pred_links,pol_links};
+  DiffDistrVec distr_vec {diff_distr, diff_distr};
+  
+  FitContainer bound_container {};
+  connector.fill_fit_container( distr_vec, pars, &bound_container );
+  FitContainer compiled_container {};
+  connector.fill_fit_container( distr_vec, pars, &compiled_container, true );
+  
+  const auto & program = compiled_container.m_prd_program;
+  ASSERT_EQ( compiled_container.m_fit_bins.size(), 4 );
+  ASSERT_EQ( program.get_n_bins(), 4 );
+  ASSERT_EQ( program.get_n_segments(), 3 );
+  ASSERT_TRUE( program.has_gradient() ); // All used functions have derivatives
+  
+  // Only one polarisation configuration => nothing to share between bound 
+  // predictions
+  ASSERT_TRUE( bound_container.m_prd_terms.is_empty() );
+  
+  // Bin-independent factors are scalars, shared between the distributions:
+  // 4 polarisation factors, Constant "c" and ConstantCoef "Glob"
+  ASSERT_EQ( program.get_n_scalars(), 6 );
+  
+  // All used parameters affect the bins of both distributions
+  const auto & index = compiled_container.m_par_bin_index;
+  for (size_t par=0; par<7; par++) {
+    const auto & ranges = index.get_bin_ranges(par);
+    ASSERT_EQ( ranges.size(), 1 ) << "Parameter " << par;
+    ASSERT_EQ( ranges[0].m_begin, 0 );
+    ASSERT_EQ( ranges[0].m_end, 4 );
+  }
+  ASSERT_TRUE( index.get_bin_ranges(7).empty() );
+  
+  // Check for initial and modified parameters
+  for (int i_set=0; i_set<2; i_set++) {
+    std::vector<double> par_vals {};
+    for (const auto & par: bound_container.m_fit_pars) {
+      par_vals.push_back(par.m_val_mod);
+    }
+    auto prds = compiled_container.get_val_prd(par_vals);
+    ASSERT_EQ( prds.size(), 4 );
+    
+    for (size_t bin=0; bin<prds.size(); bin++) {
+      ASSERT_EQ( compiled_container.m_fit_bins[bin].get_val_mst(), 
+                 bound_container.m_fit_bins[bin].get_val_mst() );
+      ASSERT_EQ( prds[bin],
+                 bound_container.m_fit_bins[bin].get_val_prd(par_vals.data()) )
+        << "Bin " << bin << " with parameter set " << i_set;
+    }
+    
+    for (auto & par: bound_container.m_fit_pars) { par.m_val_mod += 0.05; }
+  }
+  
+  // Container can only be filled once
+  ASSERT_THROW(
+    connector.fill_fit_container( distr_vec, pars, &compiled_container, true ),
+    std::invalid_argument
+  );
+  
+  // Distributions need a polarisation link
+  DiffDistr unknown_pol_distr { {"test", "e+p-", 500}, coords, {{1,1},{1,1}} };
+  FitContainer unknown_pol_container {};
+  ASSERT_THROW(
+    connector.fill_fit_container( {unknown_pol_distr}, pars, 
+                                  &unknown_pol_container ),
+    std::invalid_argument
+  );
 }
 
-//------------------------------------------------------------------------------
\ No newline at end of file
+//------------------------------------------------------------------------------
+
+TEST(TestDataConnector, SharedChiralSigmas) {
+  /** Check that distributions which only differ in the polarisation 
+      configuration give the same predictions with shared modified chiral 
+      cross sections as when they are connected separately.
+  **/
+  DistrInfo info_mp {"test", "e-p+", 500};
+  DistrInfo info_pm {"test", "e+p-", 500};
+  DistrInfo info_LR {"test", Chiral::eLpR, 500};
+  DistrInfo info_RL {"test", Chiral::eRpL, 500};
+  CoordVec coords = {{{0}, {-0.5}, {0.5}}, {{1}, {0.5}, {1.5}}};
+  DiffDistrVec distr_vec {
+    { info_mp, coords, {{0.8,0.2},{1,0.2}} },
+    { info_pm, coords, {{0.5,0.2},{0.7,0.2}} }
+  };
+  PredDistrVec pred_distrs { 
+    { info_LR, coords, {1, 2}, {0.5, 0.1} },
+    { info_RL, coords, {3, 1}, {0, 0.2} },
+  };
+  ParVec pars { 
+    {"A_LR", 1, 0},
+    {"mu", 0, 0},
+    {"sigma", 0.5, 0},
+    {"c", 0.1, 0},
+    {"ePol", 0.80, 0},
+    {"pPol", 0.30, 0}
+  };
+  PredLinkVec  pred_links {
+    { info_LR, { {"Gaussian1D", {"A_LR", "mu", "sigma"}} }, {} },
+    { info_RL, {}, { {"Constant", {"c"}} } },
+    { info_pm, { {"Constant", {"c"}} }, {} }
+  };
+  PolLinkVec   pol_links {
+    PolLink(500, "e-p+", "ePol", "pPol", "-", "+"),
+    PolLink(500, "e+p-", "ePol", "pPol", "+", "-")
+  };
+  
+  // Distribution without a partner in another polarisation configuration
+  distr_vec.push_back( { {"other", "e-p+", 500}, coords, {{1,0.2},{1,0.2}} } );
+  pred_distrs.push_back( { {"other", Chiral::eLpR, 500}, coords, {2, 2}, 
+                           {0, 0} } );
+  
+  DataConnector connector {pred_distrs,{},pred_links,pol_links};
+  FitContainer container {};
+  connector.fill_fit_container( distr_vec, pars, &container );
+  ASSERT_EQ( container.m_fit_bins.size(), 6 );
+  
+  // One group of shared terms per bin of the shared distribution: signal and
+  // background per chirality
+  const auto & terms = container.m_prd_terms;
+  ASSERT_EQ( terms.get_n_groups(), 2 );
+  ASSERT_EQ( terms.get_n_vals(), pars.size() + 2 * 8 );
+  ASSERT_EQ( terms.get_par_idxs(0), std::vector<size_t>({0, 1, 2, 3}) );
+  
+  // Parameter values have to match the container
+  ASSERT_THROW( container.get_val_prd(std::vector<double>(pars.size() - 1)), 
+                std::invalid_argument );
+  
+  // Changed parameters have to be picked up by all configurations
+  PrdEvaluator evaluator (&container, 2, 1);
+  for (int i_set=0; i_set<3; i_set++) {
+    auto par_vals = get_par_vals(container.m_fit_pars);
+    auto prds = container.get_val_prd(par_vals);
+    BinVec separate_bins {};
+    for (const auto & distr: distr_vec) {
+      connector.fill_bins(distr, container.m_fit_pars, &separate_bins);
+    }
+    evaluator.evaluate_changed([](size_t, size_t, size_t) {});
+    ASSERT_EQ( prds.size(), separate_bins.size() );
+    for (size_t bin=0; bin<separate_bins.size(); bin++) {
+      ASSERT_EQ( prds[bin], 
+                 separate_bins[bin].get_val_prd(par_vals.data()) )
+        << "Bin " << bin << " with parameter set " << i_set;
+      ASSERT_EQ( evaluator.get_prds()[bin], 
+                 separate_bins[bin].get_val_prd(par_vals.data()) )
+        << "Bin " << bin << " with parameter set " << i_set;
+    }
+    container.m_fit_pars[i_set].m_val_mod += 0.05;
+  }
+  
+  // Compiled predictions share them in a shared segment of the program
+  // => scalar segment, shared segment, one segment per distribution
+  FitContainer compiled {};
+  connector.fill_fit_container( distr_vec, container.m_fit_pars, &compiled, 
+                                true );
+  ASSERT_EQ( compiled.m_prd_program.get_n_segments(), 1 + 1 + 3 );
+  ASSERT_TRUE( compiled.m_prd_terms.is_empty() );
+  auto par_vals = get_par_vals(container.m_fit_pars);
+  ASSERT_EQ( compiled.get_val_prd(par_vals), container.get_val_prd(par_vals) );
+  
+  // Gradient through the shared segment matches the one without sharing
+  PrdProgram separate_program {};
+  for (const auto & distr: distr_vec) {
+    connector.compile_bins(distr, container.m_fit_pars, &separate_program);
+  }
+  std::vector<double> weights {1, -2, 0.5, 3, 0.2, -1};
+  std::vector<double> separate_grad (pars.size(), 0.0);
+  PrdProgram::Workspace ws {};
+  separate_program.gradient( par_vals.data(), weights, &ws, &separate_grad );
+  PrdEvaluator compiled_evaluator (&compiled, 2, 1);
+  std::vector<double> grad {};
+  compiled_evaluator.evaluate_gradient(
+    [&weights]( size_t, size_t bin_begin, size_t bin_end, 
+                double * chunk_weights ) {
+      std::copy( weights.begin() + bin_begin, weights.begin() + bin_end, 
+                 chunk_weights );
+    },
+    &grad, par_vals.data()
+  );
+  ASSERT_EQ( grad.size(), separate_grad.size() );
+  for (size_t par=0; par<grad.size(); par++) {
+    ASSERT_NEAR( grad[par], separate_grad[par], 1e-12 ) << "Parameter " << par;
+  }
+  ASSERT_NE( grad[0], 0.0 );
+  
+  // Copies of the container share no mutable state => can be evaluated in
+  // parallel at different parameters
+  std::vector<FitContainer> copies (4, container);
+  std::vector<std::vector<double>> serial_prds {}, parallel_prds (4);
+  for (size_t i=0; i<copies.size(); i++) {
+    copies[i].m_fit_pars[i].m_val_mod += 0.1;
+    PrdEvaluator copy_evaluator (&copies[i]);
+    copy_evaluator.evaluate([](size_t, size_t, size_t) {});
+    const auto & prds = copy_evaluator.get_prds();
+    serial_prds.emplace_back(prds.begin(), prds.end());
+  }
+  std::vector<std::thread> threads {};
+  for (size_t i=0; i<copies.size(); i++) {
+    threads.emplace_back( [&copies, &parallel_prds, i]() {
+      PrdEvaluator copy_evaluator (&copies[i]);
+      for (int n=0; n<100; n++) {
+        copy_evaluator.evaluate([](size_t, size_t, size_t) {});
+      }
+      const auto & prds = copy_evaluator.get_prds();
+      parallel_prds[i].assign(prds.begin(), prds.end());
+    } );
+  }
+  for (auto & thread: threads) { thread.join(); }
+  ASSERT_EQ( parallel_prds, serial_prds );
+  ASSERT_NE( serial_prds[0], serial_prds[1] );
+}
+
+//------------------------------------------------------------------------------
@@ -18,6 +18,12 @@ using namespace PrEW::Fit;
 //------------------------------------------------------------------------------
 // Tests for Linker class that creates connected and easily callable functions
 
+static double eval(const PrEW::Fcts::BoundFct & fct, const ParVec & pars) {
+  /** Evaluate bound function with the current parameter values **/
+  return fct(get_par_vals(pars).data());
+}
+
+
 TEST(TestLinker, GaussianTest) {
   // Test that linker can give out correct functions that gives values for a 
   // gaussian at a given x value, gaussian values must change when gaussian 
@@ -50,27 +56,27 @@ TEST(TestLinker, GaussianTest) {
   // --- Get functions from linker which are linked to parameters
   Linker linker = Linker(fct_links, coords, coefs);
   
-  int n_fcts = linker.get_all_bonded_fcts_at_bin(0,&pars).size();
+  int n_fcts = linker.get_all_bonded_fcts_at_bin(0,pars).size();
   ASSERT_EQ(n_fcts, 1) << "Got more than one function";
   
-  auto gaussian_bin0 = linker.get_all_bonded_fcts_at_bin(0,&pars)[0];
-  auto gaussian_bin1 = linker.get_all_bonded_fcts_at_bin(1,&pars)[0];
-  auto gaussian_bin2 = linker.get_all_bonded_fcts_at_bin(2,&pars)[0];
-  auto gaussian_bin3 = linker.get_all_bonded_fcts_at_bin(3,&pars)[0];
-  auto gaussian_bin4 = linker.get_all_bonded_fcts_at_bin(4,&pars)[0];
+  auto gaussian_bin0 = linker.get_all_bonded_fcts_at_bin(0,pars)[0];
+  auto gaussian_bin1 = linker.get_all_bonded_fcts_at_bin(1,pars)[0];
+  auto gaussian_bin2 = linker.get_all_bonded_fcts_at_bin(2,pars)[0];
+  auto gaussian_bin3 = linker.get_all_bonded_fcts_at_bin(3,pars)[0];
+  auto gaussian_bin4 = linker.get_all_bonded_fcts_at_bin(4,pars)[0];
   
   // --- Check (changing) function output
   // Looked up exact expected values in WolframAlpha -> compare
-  ASSERT_EQ(Num::equal_to_eps(gaussian_bin0(), 0.2419707245, 1e-9), true)
-    << "Got " << gaussian_bin0() << " expected " << 0.2419707245;
-  ASSERT_EQ(Num::equal_to_eps(gaussian_bin1(), 0.3989422804, 1e-9), true)
-    << "Got " << gaussian_bin1() << " expected " << 0.3989422804;
-  ASSERT_EQ(Num::equal_to_eps(gaussian_bin2(), 0.2419707245, 1e-9), true)
-    << "Got " << gaussian_bin2() << " expected " << 0.2419707245;
-  ASSERT_EQ(Num::equal_to_eps(gaussian_bin3(), 0.1295175957, 1e-9), true)
-    << "Got " << gaussian_bin3() << " expected " << 0.1295175957;
-  ASSERT_EQ(Num::equal_to_eps(gaussian_bin4(), 0.0539909665, 1e-9), true)
-    << "Got " << gaussian_bin4() << " expected " << 0.0539909665;
+  ASSERT_EQ(Num::equal_to_eps(eval(gaussian_bin0, pars), 0.2419707245, 1e-9), true)
+    << "Got " << eval(gaussian_bin0, pars) << " expected " << 0.2419707245;
+  ASSERT_EQ(Num::equal_to_eps(eval(gaussian_bin1, pars), 0.3989422804, 1e-9), true)
+    << "Got " << eval(gaussian_bin1, pars) << " expected " << 0.3989422804;
+  ASSERT_EQ(Num::equal_to_eps(eval(gaussian_bin2, pars), 0.2419707245, 1e-9), true)
+    << "Got " << eval(gaussian_bin2, pars) << " expected " << 0.2419707245;
+  ASSERT_EQ(Num::equal_to_eps(eval(gaussian_bin3, pars), 0.1295175957, 1e-9), true)
+    << "Got " << eval(gaussian_bin3, pars) << " expected " << 0.1295175957;
+  ASSERT_EQ(Num::equal_to_eps(eval(gaussian_bin4, pars), 0.0539909665, 1e-9), true)
+    << "Got " << eval(gaussian_bin4, pars) << " expected " << 0.0539909665;
     
   // Changing parameters (same bin coordinates!)
   pars[0].m_val_mod = 2; // Amplitude
@@ -79,12 +85,12 @@ TEST(TestLinker, GaussianTest) {
   
   // Did function outputs change?
   // -> If so succesfully established link between parameters and functions
-  ASSERT_EQ(Num::equal_to_eps(gaussian_bin1(), 0.0177273936, 1e-9), true)
-    << "Got " << gaussian_bin1() << " expected " << 0.0177273936;
-  ASSERT_EQ(Num::equal_to_eps(gaussian_bin2(), 0.9678828981, 1e-9), true)
-    << "Got " << gaussian_bin2() << " expected " << 0.9678828981;
-  ASSERT_EQ(Num::equal_to_eps(gaussian_bin3(), 1.5957691216, 1e-9), true)
-    << "Got " << gaussian_bin3() << " expected " << 1.5957691216;
+  ASSERT_EQ(Num::equal_to_eps(eval(gaussian_bin1, pars), 0.0177273936, 1e-9), true)
+    << "Got " << eval(gaussian_bin1, pars) << " expected " << 0.0177273936;
+  ASSERT_EQ(Num::equal_to_eps(eval(gaussian_bin2, pars), 0.9678828981, 1e-9), true)
+    << "Got " << eval(gaussian_bin2, pars) << " expected " << 0.9678828981;
+  ASSERT_EQ(Num::equal_to_eps(eval(gaussian_bin3, pars), 1.5957691216, 1e-9), true)
+    << "Got " << eval(gaussian_bin3, pars) << " expected " << 1.5957691216;
 }
 
 TEST(TestLinker, GaussianManyValuesTest) {
@@ -118,9 +124,9 @@ TEST(TestLinker, GaussianManyValuesTest) {
   Linker linker = Linker(fct_links, coords, coefs);
   
   // Get all bin functions
-  std::vector<std::function<double()>> gaussian_at_bins {};
+  std::vector<PrEW::Fcts::BoundFct> gaussian_at_bins {};
   for (int bin=0; bin<coords.size(); bin++) {
-    auto bin_fcts = linker.get_all_bonded_fcts_at_bin(bin,&pars);
+    auto bin_fcts = linker.get_all_bonded_fcts_at_bin(bin,pars);
     ASSERT_EQ(bin_fcts.size(), 1) << "Got more than one function";
     gaussian_at_bins.push_back(bin_fcts[0]);
   }
@@ -129,7 +135,7 @@ TEST(TestLinker, GaussianManyValuesTest) {
   // Check that no zero value occured
   bool found_zero_val = false;
   for (const auto & gaussian_at_bin: gaussian_at_bins ) {
-    if (gaussian_at_bin() == 0) {
+    if (eval(gaussian_at_bin, pars) == 0) {
       found_zero_val = true;
       break;
     }
@@ -140,7 +146,7 @@ TEST(TestLinker, GaussianManyValuesTest) {
   pars[0].m_val_mod = 0;
   bool found_nonzero_val = false;
   for (const auto & gaussian_at_bin: gaussian_at_bins ) {
-    if (gaussian_at_bin() != 0) {
+    if (eval(gaussian_at_bin, pars) != 0) {
       found_nonzero_val = true;
       break;
     }
@@ -176,24 +182,73 @@ TEST(TestLinker, MultiFunctionTest) {
   
   // --- Get functions from linker which are linked to parameters
   Linker linker = Linker(fct_links, coords, coefs);
-  auto all_bin_fcts = linker.get_all_bonded_fcts_at_bin(0,&pars);
+  auto all_bin_fcts = linker.get_all_bonded_fcts_at_bin(0,pars);
   ASSERT_EQ( all_bin_fcts.size(), 2 );
   
   auto gaussian_bin  = all_bin_fcts.at(0);
   auto quadratic_bin = all_bin_fcts.at(1);
 
   // --- Check for expected output
-  ASSERT_EQ(Num::equal_to_eps(gaussian_bin(), 0.3989422804, 1e-9), true)
-    << "Got " << gaussian_bin() << " expected " << 0.3989422804;
-  ASSERT_EQ(Num::equal_to_eps(quadratic_bin(), 6.0, 1e-9), true) // 1+2+3=6
-    << "Got " << quadratic_bin() << " expected " << 6;
+  ASSERT_EQ(Num::equal_to_eps(eval(gaussian_bin, pars), 0.3989422804, 1e-9), true)
+    << "Got " << eval(gaussian_bin, pars) << " expected " << 0.3989422804;
+  ASSERT_EQ(Num::equal_to_eps(eval(quadratic_bin, pars), 6.0, 1e-9), true) // 1+2+3=6
+    << "Got " << eval(quadratic_bin, pars) << " expected " << 6;
     
   // Change one(!) parameter -> Both outputs should change!
   pars[0].m_val_mod = 2; // -> Amplite/Offset doubled
   
-  ASSERT_EQ(Num::equal_to_eps(gaussian_bin(), 2.0*0.3989422804, 1e-9), true)
-    << "Got " << gaussian_bin() << " expected " << 2.0*0.3989422804;
-  ASSERT_EQ(Num::equal_to_eps(quadratic_bin(), 7.0, 1e-9), true) // 2+2+3=6
-    << "Got " << quadratic_bin() << " expected " << 2;
+  ASSERT_EQ(Num::equal_to_eps(eval(gaussian_bin, pars), 2.0*0.3989422804, 1e-9), true)
+    << "Got " << eval(gaussian_bin, pars) << " expected " << 2.0*0.3989422804;
+  ASSERT_EQ(Num::equal_to_eps(eval(quadratic_bin, pars), 7.0, 1e-9), true) // 2+2+3=6
+    << "Got " << eval(quadratic_bin, pars) << " expected " << 2;
+}
+//------------------------------------------------------------------------------
+
+TEST(TestLinker, AllBinsAtOnce) {
+  // Binding all bins at once gives same functions as binding bin by bin,
+  // unknown coefficients and parameters are found
+  CoordVec coords { {{0.5},{0},{1}}, {{1.5},{1},{2}}, {{2.5},{2},{3}} };
+  CoefDistrVec coefs {
+    {"Other", {"test", "LR", 250}, std::vector<double>{5, 5, 5}},
+    {"Coef", {"test", "LR", 250}, std::vector<double>{1, 2, 3}}
+  };
+  ParVec pars = { FitPar("a", 2, 0), FitPar("b", 3, 0) };
+  FctLinkVec fct_links {
+    {"ConstantCoef", {}, {"Coef"}},
+    {"Quadratic1DPolynomial", {"b","a","b"}, {}}
+  };
+  
+  Linker linker = Linker(fct_links, coords, coefs);
+  auto all_fcts = linker.get_all_bonded_fcts(pars);
+  ASSERT_EQ( all_fcts.size(), 3 );
+  for (size_t bin=0; bin<3; bin++) {
+    auto bin_fcts = linker.get_all_bonded_fcts_at_bin(bin,pars);
+    ASSERT_EQ( all_fcts[bin].size(), 2 );
+    for (size_t fct=0; fct<2; fct++) {
+      ASSERT_EQ( eval(all_fcts[bin][fct], pars), eval(bin_fcts[fct], pars) );
+    }
+    ASSERT_EQ( eval(all_fcts[bin][0], pars), double(bin+1) );
+  }
+  pars[1].m_val_mod = 1;
+  ASSERT_EQ( eval(all_fcts[0][1], pars), 1 + 2*0.5 + 0.25 );
+  
+  Linker bad_coef_linker ({{"ConstantCoef", {}, {"Unknown"}}}, coords, coefs);
+  ASSERT_THROW( bad_coef_linker.get_all_bonded_fcts(pars), 
+                std::invalid_argument );
+  Linker bad_par_linker ({{"Constant", {"c"}, {}}}, coords, coefs);
+  ASSERT_THROW( bad_par_linker.get_all_bonded_fcts(pars), 
+                std::invalid_argument );
+}
+
+//------------------------------------------------------------------------------
+
+TEST(TestLinker, WrongArity) {
+  // Number of linked parameters and coefficients has to match the function
+  CoordVec coords { {{1.0},{1.0},{1.0}} };
+  ParVec pars = { FitPar("A", 1, 0), FitPar("mu", 0, 0) };
+  FctLinkVec fct_links { {"Gaussian1D", {"A","mu"}, {}} };
+  Linker linker = Linker(fct_links, coords, {});
+  ASSERT_THROW( linker.get_all_bonded_fcts_at_bin(0,pars), 
+                std::invalid_argument );
 }
 //------------------------------------------------------------------------------
@@ -0,0 +1,106 @@
+#include <CppUtils/Symbol.h>
+#include <Data/DistrInfo.h>
+#include <GlobalVar/Chiral.h>
+
+#include <gtest/gtest.h>
+
+#include <sstream>
+#include <string>
+#include <thread>
+#include <unordered_set>
+#include <vector>
+
+using namespace PrEW::CppUtils;
+
+//------------------------------------------------------------------------------
+// Tests for interned strings
+//------------------------------------------------------------------------------
+
+TEST(TestSymbol, RoundTrip) {
+  Symbol empty {};
+  ASSERT_TRUE( empty.empty() );
+  ASSERT_EQ( empty.get_id(), 0 );
+  ASSERT_EQ( empty.str(), "" );
+  ASSERT_EQ( Symbol(""), empty );
+  
+  std::string str = "TestSymbol-RoundTrip";
+  Symbol symbol (str);
+  ASSERT_FALSE( symbol.empty() );
+  ASSERT_EQ( symbol.str(), str );
+  ASSERT_STREQ( symbol.c_str(), str.c_str() );
+  
+  // Implicit conversion to string
+  const std::string & ref = symbol;
+  ASSERT_EQ( ref, str );
+  
+  std::stringstream ss {};
+  ss << symbol;
+  ASSERT_EQ( ss.str(), str );
+}
+
+TEST(TestSymbol, Interning) {
+  size_t n_before = Symbol::get_n_symbols();
+  Symbol a ("TestSymbol-Interning-a");
+  Symbol a_clone (std::string("TestSymbol-Interning-a"));
+  Symbol b ("TestSymbol-Interning-b");
+  
+  // Same string => same ID, only distinct strings are added
+  ASSERT_EQ( a.get_id(), a_clone.get_id() );
+  ASSERT_NE( a.get_id(), b.get_id() );
+  ASSERT_EQ( a, a_clone );
+  ASSERT_NE( a, b );
+  ASSERT_TRUE( (a < b) != (b < a) );
+  ASSERT_EQ( Symbol::get_n_symbols(), n_before + 2 );
+  
+  // Comparison with strings
+  ASSERT_TRUE( a == "TestSymbol-Interning-a" );
+  ASSERT_TRUE( a != std::string("TestSymbol-Interning-b") );
+  
+  // Hashing
+  std::unordered_set<Symbol> set {a, a_clone, b};
+  ASSERT_EQ( set.size(), 2 );
+}
+
+TEST(TestSymbol, ThreadSafety) {
+  // Same strings interned from many threads get the same IDs
+  size_t n_threads = 4, n_strs = 200;
+  std::vector<std::vector<Symbol>> symbols (n_threads);
+  std::vector<std::thread> threads {};
+  for (size_t t=0; t<n_threads; t++) {
+    threads.emplace_back(
+      [t, n_strs, &symbols]() {
+        for (size_t i=0; i<n_strs; i++) {
+          symbols[t].push_back(
+            Symbol("TestSymbol-ThreadSafety-" + std::to_string(i)) );
+        }
+      }
+    );
+  }
+  for (auto & thread: threads) { thread.join(); }
+  
+  for (size_t t=1; t<n_threads; t++) { ASSERT_EQ( symbols[t], symbols[0] ); }
+  for (size_t i=0; i<n_strs; i++) {
+    ASSERT_EQ( symbols[0][i].str(), 
+               "TestSymbol-ThreadSafety-" + std::to_string(i) );
+  }
+}
+
+TEST(TestSymbol, DistrIdentifiers) {
+  using namespace PrEW;
+  
+  // Chiralities are interned, round trip gives the full strings
+  ASSERT_EQ( GlobalVar::Chiral::eLpR.str(), 
+             "PrEW-internal-GenLevel-ElectronL-PositronR" );
+  ASSERT_EQ( GlobalVar::Chiral::eLpR, 
+             Symbol("PrEW-internal-GenLevel-ElectronL-PositronR") );
+  
+  // Distribution info from strings compares equal to interned version
+  Data::DistrInfo info {"TestSymbol-Distr", GlobalVar::Chiral::eRpL, 250};
+  Data::DistrInfo info_str 
+    {std::string("TestSymbol-Distr"), 
+     std::string("PrEW-internal-GenLevel-ElectronR-PositronL"), 250};
+  ASSERT_EQ( info, info_str );
+  ASSERT_EQ( info.m_distr_name.str(), "TestSymbol-Distr" );
+}
+
+//------------------------------------------------------------------------------
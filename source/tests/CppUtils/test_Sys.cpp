@@ -2,6 +2,10 @@
 
 #include <CppUtils/Sys.h>
 
+#include <cstdio>
+#include <fstream>
+#include <stdexcept>
+
 using namespace PrEW::CppUtils;
 
 //------------------------------------------------------------------------------
@@ -37,4 +41,23 @@ TEST(TestSys, CheckFileWritability) {
   EXPECT_EQ(Sys::file_writable("/gobblegobblgobble/test.txt"), false);
 }
 
-//------------------------------------------------------------------------------
\ No newline at end of file
+//------------------------------------------------------------------------------
+TEST(TestSys, ListFiles) {
+  /** Test that files with the extension are found in sorted order.
+  **/
+  for (const auto & name: {"b.listtest", "a.listtest", "c.other"}) {
+    std::ofstream file (name);
+  }
+  auto file_paths = Sys::list_files(".", ".listtest");
+  ASSERT_EQ( file_paths.size(), 2 );
+  ASSERT_EQ( file_paths[0], "./a.listtest" );
+  ASSERT_EQ( file_paths[1], "./b.listtest" );
+  ASSERT_GE( Sys::list_files(".").size(), 3 );
+  ASSERT_THROW( Sys::list_files("./obviously_wrong_path"),
+                std::invalid_argument );
+  for (const auto & name: {"b.listtest", "a.listtest", "c.other"}) {
+    std::remove(name);
+  }
+}
+
+//------------------------------------------------------------------------------
@@ -0,0 +1,56 @@
+#include <gtest/gtest.h>
+
+#include <CppUtils/ThreadPool.h>
+
+#include <stdexcept>
+#include <vector>
+
+using namespace PrEW::CppUtils;
+
+//------------------------------------------------------------------------------
+// Tests for thread pool
+
+TEST(TestThreadPool, Constructor) {
+  ASSERT_THROW( ThreadPool(0), std::invalid_argument );
+  ThreadPool single {};
+  ASSERT_EQ( single.get_n_threads(), 1 );
+  ThreadPool multi (4);
+  ASSERT_EQ( multi.get_n_threads(), 4 );
+}
+
+TEST(TestThreadPool, AllTasksRunOnce) {
+  /** Every task has to be performed exactly once, also for repeated runs.
+  **/
+  for (size_t n_threads: {1, 2, 5}) {
+    ThreadPool pool (n_threads);
+    for (size_t n_tasks: {0, 1, 3, 100}) {
+      std::vector<int> counts (n_tasks, 0);
+      std::vector<size_t> threads (n_tasks, 0);
+      pool.run(n_tasks, [&counts, &threads](size_t task, size_t thread) {
+        counts[task]++;
+        threads[task] = thread;
+      });
+      for (size_t task=0; task<n_tasks; task++) {
+        ASSERT_EQ( counts[task], 1 );
+        ASSERT_LT( threads[task], n_threads );
+      }
+    }
+  }
+}
+
+TEST(TestThreadPool, ExceptionPropagation) {
+  /** Exceptions in tasks are rethrown by run, pool is usable afterwards.
+  **/
+  ThreadPool pool (3);
+  ASSERT_THROW(
+    pool.run(10, [](size_t task, size_t) {
+      if (task == 7) { throw std::runtime_error("Task failed"); }
+    }),
+    std::runtime_error
+  );
+  std::vector<int> counts (10, 0);
+  pool.run(10, [&counts](size_t task, size_t) { counts[task]++; });
+  ASSERT_EQ( counts, std::vector<int>(10, 1) );
+}
+
+//------------------------------------------------------------------------------
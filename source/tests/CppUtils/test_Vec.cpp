@@ -2,6 +2,9 @@
 
 #include <gtest/gtest.h>
 
+#include <cstdint>
+#include <limits>
+#include <new>
 #include <vector>
 #include <string>
 
@@ -44,3 +47,30 @@ TEST(TestVec, ElementFinding) {
 }
 
 //------------------------------------------------------------------------------
+
+TEST(TestVec, AlignedVec) {
+  /** Test that aligned vectors start at aligned addresses (also after 
+      reallocation) and behave like normal vectors.
+  **/
+  Vec::AlignedVec<double> vec (3, 1.5);
+  for (int i=0; i<100; i++) {
+    ASSERT_EQ( reinterpret_cast<std::uintptr_t>(vec.data()) % 64, 0 );
+    vec.push_back(double(i));
+  }
+  ASSERT_EQ( vec.size(), 103 );
+  ASSERT_EQ( vec[1], 1.5 );
+  ASSERT_EQ( vec[102], 99.0 );
+  
+  Vec::AlignedVec<double> copy = vec;
+  ASSERT_EQ( copy, vec );
+  ASSERT_EQ( reinterpret_cast<std::uintptr_t>(copy.data()) % 64, 0 );
+  
+  // Sizes that overflow when converted to bytes are rejected
+  Vec::AlignedAllocator<double> allocator {};
+  ASSERT_THROW( allocator.allocate(allocator.max_size() + 1), 
+                std::bad_array_new_length );
+  ASSERT_THROW( allocator.allocate(std::numeric_limits<size_t>::max()), 
+                std::bad_array_new_length );
+}
+
+//------------------------------------------------------------------------------
@@ -9,6 +9,7 @@
 
 #include <cmath>
 #include <string>
+#include <vector>
 
 using namespace PrEW::CppUtils;
 using namespace PrEW::Data;
@@ -53,6 +54,39 @@ TEST(TestDistrUtils, SubVecEnergyName) {
   ASSERT_EQ(DistrUtils::subvec_energy_and_name(vec,200,good_name).size(), 3);
 }
 
+TEST(TestDistrUtils, IndexedSubVecEnergyName) {
+  // Index gives same sub-vectors (same order) as the scan
+  DistrInfo info_1 {"d1","LR",200};
+  DistrInfo info_2 {"d1","RL",200};
+  DistrInfo info_3 {"d2","LR",200};
+  DistrInfo info_4 {"d1","LR",400};
+  
+  DiffDistrVec vec {
+    {info_1, {}, {}},
+    {info_3, {}, {}},
+    {info_2, {}, {}},
+    {info_4, {}, {}},
+    {info_1, {}, {}},
+  };
+  auto idx_map = DistrUtils::index_energy_and_name(vec);
+  ASSERT_EQ(idx_map.at(200).at("d1"), std::vector<size_t>({0, 2, 4}));
+  
+  for (const auto & info: {info_1, info_3, info_4}) {
+    auto indexed = DistrUtils::subvec_energy_and_name(
+      vec, idx_map, info.m_energy, info.m_distr_name);
+    auto scanned = DistrUtils::subvec_energy_and_name(
+      vec, info.m_energy, info.m_distr_name);
+    ASSERT_EQ(indexed.size(), scanned.size());
+    for (size_t i=0; i<indexed.size(); i++) {
+      ASSERT_EQ(indexed[i].m_info, scanned[i].m_info);
+    }
+  }
+  
+  // Unknown energy or name => empty
+  ASSERT_EQ(DistrUtils::subvec_energy_and_name(vec,idx_map,500,"d1").size(), 0);
+  ASSERT_EQ(DistrUtils::subvec_energy_and_name(vec,idx_map,200,"d3").size(), 0);
+}
+
 TEST(TestDistrUtils, SubVecEnergy) {
   // Test if distributions are correctly extracted by energy
   DistrInfo info_good1 {"d1","LR",200};
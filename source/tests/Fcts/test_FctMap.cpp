@@ -0,0 +1,93 @@
+#include <Data/BinCoord.h>
+#include <Fcts/FctMap.h>
+
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <cmath>
+#include <string>
+#include <vector>
+
+using namespace PrEW::Data;
+using namespace PrEW::Fcts;
+
+//------------------------------------------------------------------------------
+// Check that the registered derivatives match the registered functions
+//------------------------------------------------------------------------------
+
+struct GradTestPoint {
+  // Input at which the derivatives of a function are tested
+  std::string m_fct_name {};
+  BinCoord m_x {};
+  std::vector<double> m_c {};
+  std::vector<double> m_p {};
+};
+
+//------------------------------------------------------------------------------
+
+TEST(TestFctMap, GradientsMatchNumerical) {
+  // Compare analytic derivatives to central differences (away from kinks)
+  BinCoord x_1D {{0.3}, {0.2}, {0.4}};
+  BinCoord x_costh {{-0.05}, {-0.1}, {0.0}};
+  std::vector<GradTestPoint> points {
+    {"Constant", x_1D, {}, {1.3}},
+    {"Linear3DPolynomial_Coeff", x_1D, {1.0, 2.0, -2.0, 0.5}, {1.0, 3.0, 4.0}},
+    {"Quadratic1DPolynomial", x_1D, {}, {1.0, -2.0, 0.5}},
+    {"Quadratic3DPolynomial_Coeff", x_1D,
+      {1.0, 2.0, -2.0, 0.5, 0.3, -0.2, 0.1, 0.7, -0.4, 0.9}, {1.0, -3.0, 2.0}},
+    {"Gaussian1D", x_1D, {}, {2.0, 0.1, 0.5}},
+    {"AsymmFactor0_2allowed", x_1D, {3.0, 2.0}, {0.1}},
+    {"AsymmFactor1_2allowed", x_1D, {3.0, 2.0}, {0.1}},
+    {"AsymmFactor0_3allowed", x_1D, {3.0, 2.0, 1.0}, {0.1, -0.2}},
+    {"AsymmFactor1_3allowed", x_1D, {3.0, 2.0, 1.0}, {0.1, -0.2}},
+    {"AsymmFactor2_3allowed", x_1D, {3.0, 2.0, 1.0}, {0.1, -0.2}},
+    {"General2fParam_LR", x_costh, {1.0, 1.5, 0.5, 0},
+      {10.0, 0.2, 0.3, 0.1, 0.05, -0.02}},
+    {"General2fParam_RL", x_costh, {1.0, 1.5, 0.5, 0},
+      {10.0, 0.2, 0.3, 0.1, 0.05, -0.02}},
+    {"Unpol2fParam", x_costh, {1.0, 1.5, 0.5, 0}, {10.0, 0.3, 0.1}},
+    {"PolarisationFactor", x_1D, {-1, 1, 1, 1}, {0.8, -0.3}},
+    {"LuminosityFraction", x_1D, {0.25}, {1.1}},
+    {"AcceptanceBox", x_1D, {0, 0.2}, {0.0, 0.7}},
+    {"AcceptanceBoxPolynomial", x_1D, {0.5, 0.1, -0.2, 0.05, 0.03, 0.02},
+      {0.3, -0.4}}
+  };
+
+  for (const auto & point: points) {
+    ASSERT_NE(prew_fct_map.find(point.m_fct_name), prew_fct_map.end());
+    ASSERT_NE(prew_grad_map.find(point.m_fct_name), prew_grad_map.end());
+    const auto & fct = prew_fct_map.at(point.m_fct_name);
+    const auto & grad = prew_grad_map.at(point.m_fct_name);
+
+    std::vector<double> p_vals = point.m_p;
+    std::vector<double*> p_ptrs {};
+    for (double & p: p_vals) { p_ptrs.push_back(&p); }
+
+    std::vector<double> analytic (p_vals.size());
+    grad(point.m_x, point.m_c, p_ptrs, &analytic);
+
+    double h = 1e-6;
+    for (size_t i=0; i<p_vals.size(); i++) {
+      p_vals[i] = point.m_p[i] + h;
+      double f_up = fct(point.m_x, point.m_c, p_ptrs);
+      p_vals[i] = point.m_p[i] - h;
+      double f_down = fct(point.m_x, point.m_c, p_ptrs);
+      p_vals[i] = point.m_p[i];
+
+      double numeric = (f_up - f_down) / (2.0 * h);
+      ASSERT_NEAR(analytic[i], numeric, 1e-6 * std::max(1.0, std::abs(numeric)))
+        << "Wrong derivative " << i << " of " << point.m_fct_name;
+    }
+  }
+}
+
+//------------------------------------------------------------------------------
+
+TEST(TestFctMap, GradientsOnlyForKnownFunctions) {
+  for (const auto & grad: prew_grad_map) {
+    ASSERT_NE(prew_fct_map.find(grad.first), prew_fct_map.end())
+      << "Derivative for unknown function " << grad.first;
+  }
+}
+
+//------------------------------------------------------------------------------
@@ -0,0 +1,156 @@
+#include <Data/BinCoord.h>
+#include <Fcts/FctMap.h>
+#include <Fcts/FctRegistry.h>
+
+#include <gtest/gtest.h>
+
+#include <cmath>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+using namespace PrEW::Data;
+using namespace PrEW::Fcts;
+
+//------------------------------------------------------------------------------
+// Check that the typed versions of the registered functions match the general
+// (vector) versions
+//------------------------------------------------------------------------------
+
+static std::vector<double> test_vals(size_t n, double offset) {
+  // Some arbitrary (but valid) input values
+  std::vector<double> vals {};
+  for (size_t i=0; i<n; i++) { vals.push_back(offset + 0.1 * double(i+1)); }
+  return vals;
+}
+
+//------------------------------------------------------------------------------
+
+TEST(TestFctRegistry, TypedMatchesGeneral) {
+  // Coefficients can be coordinate indices => enough coordinates for all
+  auto coords = std::make_shared<const CoordVec>( CoordVec{
+    {{0.3, 0.1, 0.2, 0.3}, {0.2, 0.0, 0.1, 0.2}, {0.4, 0.2, 0.3, 0.4}},
+    {{-0.5, -0.1, 0.5, -0.7}, {-0.6, -0.2, 0.4, -0.8}, {-0.4, 0.0, 0.6, -0.6}},
+    {{0.05, 0.7, -0.3, 0.1}, {0.0, 0.6, -0.4, 0.0}, {0.1, 0.8, -0.2, 0.2}}
+  } );
+
+  for (const auto & name_entry: prew_fct_registry) {
+    const auto & name = name_entry.first;
+    const auto & entry = name_entry.second;
+
+    // Coefficients are different in each bin
+    std::vector<std::vector<double>> coef_cols {};
+    for (size_t c=0; c<entry.m_n_coefs; c++) {
+      coef_cols.push_back(test_vals(coords->size(), 0.5 + double(c)));
+    }
+    std::vector<double> p_vals = test_vals(entry.m_n_pars, 0.2);
+    std::vector<double*> p_ptrs {};
+    for (auto & p_val: p_vals) { p_ptrs.push_back(&p_val); }
+
+    // Bound functions find their parameters by index in a larger array
+    std::vector<size_t> p_idxs {};
+    for (size_t p=0; p<p_vals.size(); p++) { p_idxs.push_back(p + 1); }
+    auto all_vals = [&p_vals]() {
+      std::vector<double> vals {-1.0};
+      vals.insert(vals.end(), p_vals.begin(), p_vals.end());
+      return vals;
+    };
+
+    // Row-wise evaluation takes prepared columns if function has preparation
+    auto rows_cols = coef_cols;
+    if (entry.m_prep) {
+      rows_cols.assign(entry.m_n_prep, std::vector<double>(coords->size()));
+      std::vector<double> c (entry.m_n_coefs), q (entry.m_n_prep);
+      for (size_t bin=0; bin<coords->size(); bin++) {
+        for (size_t i=0; i<c.size(); i++) { c[i] = coef_cols[i][bin]; }
+        entry.m_prep((*coords)[bin], c.data(), q.data());
+        for (size_t i=0; i<q.size(); i++) { rows_cols[i][bin] = q[i]; }
+      }
+    }
+    std::vector<const double*> col_ptrs {};
+    std::vector<size_t> strides (rows_cols.size(), 1);
+    for (const auto & col: rows_cols) { col_ptrs.push_back(col.data()); }
+    std::vector<double> rows_out (coords->size());
+    entry.m_rows( coords->data(), coords->size(), col_ptrs.data(),
+                  strides.data(), p_ptrs.data(), rows_out.data() );
+    
+    // Batch evaluation with contiguous coefficient columns
+    std::vector<const double*> coef_ptrs {};
+    for (const auto & col: coef_cols) { coef_ptrs.push_back(col.data()); }
+    std::vector<double> batch_out (coords->size());
+    Registry::eval_batch( name, entry, *coords, coef_ptrs, p_ptrs, 
+                          batch_out.data() );
+
+    for (size_t bin=0; bin<coords->size(); bin++) {
+      std::vector<double> c {};
+      for (const auto & col: coef_cols) { c.push_back(col[bin]); }
+      double expected = entry.m_fct((*coords)[bin], c, p_ptrs);
+
+      // Bound function
+      auto bound_fct = entry.m_bind(coords, bin, c, p_idxs);
+      ASSERT_NEAR( bound_fct(all_vals().data()), expected, 1e-12 ) 
+        << name << " bin " << bin;
+      ASSERT_NEAR( rows_out[bin], expected, 1e-12 ) << name << " bin " << bin;
+      ASSERT_NEAR( batch_out[bin], expected, 1e-12 ) << name << " bin " << bin;
+    }
+
+    // Bound function follows the parameters
+    for (auto & p_val: p_vals) { p_val += 0.05; }
+    std::vector<double> c {};
+    for (const auto & col: coef_cols) { c.push_back(col[0]); }
+    auto bound_fct = entry.m_bind(coords, 0, c, p_idxs);
+    ASSERT_NEAR( bound_fct(all_vals().data()), 
+                 entry.m_fct((*coords)[0], c, p_ptrs), 1e-12 ) << name;
+  }
+}
+
+//------------------------------------------------------------------------------
+
+TEST(TestFctRegistry, Arity) {
+  const auto & entry = Registry::find_entry(prew_fct_registry, "Gaussian1D");
+  ASSERT_EQ( entry.m_n_coefs, 0 );
+  ASSERT_EQ( entry.m_n_pars, 3 );
+  ASSERT_NO_THROW( Registry::check_arity("Gaussian1D", entry, 0, 3) );
+  ASSERT_THROW( Registry::check_arity("Gaussian1D", entry, 0, 2),
+                std::invalid_argument );
+  ASSERT_THROW( Registry::check_arity("Gaussian1D", entry, 1, 3),
+                std::invalid_argument );
+  ASSERT_THROW( Registry::find_entry(prew_fct_registry, "NotAFunction"),
+                std::invalid_argument );
+  std::vector<double> out (1);
+  ASSERT_THROW( Registry::eval_batch( "Gaussian1D", entry, {{{0}, {0}, {0}}}, 
+                                      {}, {}, out.data() ),
+                std::invalid_argument );
+
+  // Maps only contain functions of the registry (derivatives if known)
+  ASSERT_EQ( prew_fct_map.size(), prew_fct_registry.size() );
+  ASSERT_EQ( prew_grad_map.count("ConstantCoef"), 0 );
+  ASSERT_EQ( prew_grad_map.count("Gaussian1D"), 1 );
+}
+
+//------------------------------------------------------------------------------
+
+TEST(TestFctRegistry, PreparedFcts) {
+  // Difermion parametrisations prepare their bin integrals
+  for (const auto & name: {"General2fParam_LR", "General2fParam_RL",
+                           "Unpol2fParam"}) {
+    const auto & entry = Registry::find_entry(prew_fct_registry, name);
+    ASSERT_EQ( entry.m_n_prep, 4 ) << name;
+    ASSERT_TRUE( entry.m_prep ) << name;
+  }
+  ASSERT_FALSE( Registry::find_entry(prew_fct_registry, "Gaussian1D").m_prep );
+
+  // Integrals of 1, x and x^2 over [-0.5, 0.25] and cross section fraction
+  BinCoord x {{0.9, -0.125}, {0.8, -0.5}, {1.0, 0.25}};
+  std::vector<double> c {20.0, 40.0, 60.0, 1};
+  std::vector<double> q (4);
+  Registry::find_entry(prew_fct_registry, "Unpol2fParam").m_prep(
+    x, c.data(), q.data() );
+  ASSERT_NEAR( q[0], 0.75, 1e-12 );
+  ASSERT_NEAR( q[1], 0.5 * (0.0625 - 0.25), 1e-12 );
+  ASSERT_NEAR( q[2], (0.015625 + 0.125) / 3.0, 1e-12 );
+  ASSERT_NEAR( q[3], 0.2, 1e-12 );
+}
+
+//------------------------------------------------------------------------------
@@ -0,0 +1,119 @@
+#ifndef TESTS_PARABOLAFIXTURE_H
+#define TESTS_PARABOLAFIXTURE_H 1
+
+#include <Data/BinCoord.h>
+#include <Data/DiffDistr.h>
+#include <Fcts/FctMap.h>
+#include <Fit/FitBin.h>
+#include <Fit/FitContainer.h>
+#include <Fit/FitPar.h>
+
+#include <random>
+#include <string>
+#include <vector>
+
+//------------------------------------------------------------------------------
+// Parabola c + b*x + a*x^2 fitted to fluctuated points (shared by fit tests)
+
+namespace ParabolaFixture {
+
+  struct Parabola { double c, b, a; };
+
+  inline PrEW::Fit::ParVec get_pars(
+    const Parabola & start = {5, -0.5, 2.0},
+    const std::string & suffix = ""
+  ) {
+    /** Parameters c, b, a (names with given suffix) with the given start
+        values.
+    **/
+    return PrEW::Fit::ParVec {
+      PrEW::Fit::FitPar ("c" + suffix, start.c, 0.2),
+      PrEW::Fit::FitPar ("b" + suffix, start.b, 0.1),
+      PrEW::Fit::FitPar ("a" + suffix, start.a, 0.5)
+    };
+  }
+
+  inline PrEW::Data::DiffDistr get_distr(
+    unsigned int seed,
+    const Parabola & truth = {4.3, -0.3, 2.5},
+    size_t n_bins = 20,
+    double bin_width = 0.5,
+    bool poisson = false
+  ) {
+    /** Gauss-fluctuated measurements (uncertainty 0.1) or poissonian counts
+        (uncertainty 1) of the true parabola in bins starting at x=-5.
+    **/
+    std::mt19937 gen (seed);
+    PrEW::Data::DiffDistr distr {};
+    for (size_t i_bin=0; i_bin<n_bins; i_bin++) {
+      double x = -5.0 + bin_width * double(i_bin);
+      double val = truth.a*x*x + truth.b*x + truth.c;
+      if (poisson) {
+        std::poisson_distribution<> measurement_func{val};
+        distr.m_distribution.push_back(
+          PrEW::Fit::FitBin(measurement_func(gen), 1.0) );
+      } else {
+        std::normal_distribution<> measurement_func{val, 0.1};
+        distr.m_distribution.push_back(
+          PrEW::Fit::FitBin(measurement_func(gen), 0.1) );
+      }
+      distr.m_coords.push_back( PrEW::Data::BinCoord(
+        {x}, {x - 0.5*bin_width}, {x + 0.5*bin_width}) );
+    }
+    return distr;
+  }
+
+  inline void add_compiled(
+    PrEW::Fit::FitContainer * container,
+    const PrEW::Data::CoordVec & coords,
+    const std::vector<size_t> & par_idxs = {0, 1, 2},
+    bool with_grad = true
+  ) {
+    /** Compile the predictions of bins with the given coordinates as
+        parabola of the parameters c, b, a at the given indices (with or
+        without derivatives).
+    **/
+    auto & program = container->m_prd_program;
+    size_t seg = program.add_segment(coords);
+    const auto & fct = PrEW::Fcts::prew_fct_map.at("Quadratic1DPolynomial");
+    program.add_bins(seg, with_grad ?
+      program.add_call(
+        seg, "Quadratic1DPolynomial", fct, {}, par_idxs,
+        PrEW::Fcts::prew_grad_map.at("Quadratic1DPolynomial") ) :
+      program.add_call( seg, "Quadratic1DPolynomial", fct, {}, par_idxs ) );
+  }
+
+  inline void add_bins(
+    PrEW::Fit::FitContainer * container,
+    const PrEW::Data::DiffDistr & distr,
+    bool compile = false
+  ) {
+    /** Add the bins of the distribution with their predictions bound to the
+        parameters c, b, a (first three container parameters).
+        If requested, the predictions are also compiled (with derivatives).
+    **/
+    for (size_t i_bin=0; i_bin<distr.m_distribution.size(); i_bin++) {
+      double x = distr.m_coords[i_bin].get_center()[0];
+      PrEW::Fit::FitBin bin = distr.m_distribution[i_bin];
+      bin.set_prd_fct(
+        [x](const double * p) { return p[0] + p[1] * x + p[2] * x*x; } );
+      container->m_fit_bins.push_back(bin);
+    }
+    if (compile) { add_compiled(container, distr.m_coords); }
+  }
+
+  inline PrEW::Fit::FitContainer get_container(unsigned int seed) {
+    /** Container with the default parameters and bound bins of
+        gauss-fluctuated measurements.
+    **/
+    PrEW::Fit::FitContainer container {};
+    container.m_fit_pars = get_pars();
+    add_bins(&container, get_distr(seed));
+    return container;
+  }
+
+}
+
+//------------------------------------------------------------------------------
+
+#endif
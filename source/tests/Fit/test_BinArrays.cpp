@@ -0,0 +1,67 @@
+#include <Fit/BinArrays.h>
+
+#include <gtest/gtest.h>
+
+#include <cmath>
+#include <cstdint>
+#include <random>
+
+using namespace PrEW::Fit;
+
+//------------------------------------------------------------------------------
+// Tests for structure-of-arrays bin storage
+
+TEST(TestBinArrays, Construction) {
+  BinArrays empty {};
+  ASSERT_EQ( empty.size(), 0 );
+  
+  BinVec bins { FitBin(1.0, 2.0), FitBin(3.0, 0.5), FitBin(0.0, 1.0) };
+  BinArrays arrays (bins);
+  ASSERT_EQ( arrays.size(), 3 );
+  ASSERT_EQ( arrays.m_vals_mst[1], 3.0 );
+  ASSERT_EQ( arrays.m_inv_vars[0], 0.25 );
+  ASSERT_EQ( arrays.m_inv_vars[1], 4.0 );
+  ASSERT_EQ( arrays.m_prds.size(), 3 );
+  for (const auto * data: { arrays.m_vals_mst.data(), arrays.m_inv_vars.data(), 
+                            arrays.m_prds.data() }) {
+    ASSERT_EQ( reinterpret_cast<std::uintptr_t>(data) % 64, 0 );
+  }
+}
+
+TEST(TestBinArrays, ChiSq) {
+  // Chi-squared and derivatives match the bin-by-bin expressions
+  std::mt19937 gen{1}; // Random seed = 1
+  std::uniform_real_distribution<> value_func{0.1, 10.0};
+  
+  BinVec bins {};
+  for (int i_bin=0; i_bin<103; i_bin++) {
+    bins.push_back( FitBin(value_func(gen), value_func(gen)) );
+  }
+  BinArrays arrays (bins);
+  for (auto & prd: arrays.m_prds) { prd = value_func(gen); }
+  
+  for (size_t bin_begin: {0, 5, 50}) {
+    for (size_t bin_end: {50, 53, 103}) {
+      double expected = 0;
+      for (size_t i=bin_begin; i<bin_end; i++) {
+        expected += std::pow( ( bins[i].get_val_mst() - arrays.m_prds[i] ) / 
+                              bins[i].get_val_unc(), 2 );
+      }
+      ASSERT_NEAR( arrays.calc_chisq(bin_begin, bin_end), expected, 
+                   1e-12 * expected );
+    }
+  }
+  
+  std::vector<double> derivs (10);
+  arrays.calc_chisq_derivs(20, 30, derivs.data());
+  for (size_t i=20; i<30; i++) {
+    ASSERT_NEAR( derivs[i-20], 
+                 -2.0 * ( bins[i].get_val_mst() - arrays.m_prds[i] ) / 
+                 std::pow(bins[i].get_val_unc(), 2), 1e-12 );
+  }
+  
+  ASSERT_THROW( arrays.calc_chisq(50, 104), std::out_of_range );
+  ASSERT_THROW( arrays.calc_chisq(50, 40), std::out_of_range );
+}
+
+//------------------------------------------------------------------------------
@@ -1,7 +1,15 @@
 #include <gtest/gtest.h>
+#include <Data/BinCoord.h>
+#include <Data/DiffDistr.h>
+#include <Fcts/FctMap.h>
 #include <Fit/ChiSqMinimizer.h>
 
+#include "ParabolaFixture.h"
+
+#include <cmath>
 #include <random>
+#include <stdexcept>
+#include <utility>
 
 using namespace PrEW::Fit;
 
@@ -15,7 +23,7 @@ TEST(TestChiSqMinimizer, TrivialConstructor) {
 
 TEST(TestChiSqMinimizer, SimpleConstructor) {
   // Test with singular FitBin that should give chisq=1
-  std::function<double()> trivial_prd = []() { return 0; }; // Prediction = 0
+  PrdFct trivial_prd = [](const double *) { return 0; }; // Prediction = 0
   FitBin fb (1.0, 1.0, trivial_prd); // Measurement = Unc = 1
   ParVec fit_pars {}; 
   BinVec fit_bins {fb};
@@ -30,7 +38,7 @@ TEST(TestChiSqMinimizer, SimpleConstructor) {
 TEST(TestChiSqMinimizer, ManyBinsConstructor) {
   // Test with n FitBin's, range n from small to very large 
   // (testing mainly calc_chisq)
-  std::function<double()> trivial_prd = []() { return 0; }; // Prediction = 0
+  PrdFct trivial_prd = [](const double *) { return 0; }; // Prediction = 0
   std::vector<int> n_bins = {20, 200, 2000, 20000, 200000};
   MinuitFactory factory (ROOT::Minuit2::kMigrad, 100, 200, 0.05); // Simple Factory
   for ( auto n : n_bins ) {
@@ -48,11 +56,10 @@ TEST(TestChiSqMinimizer, MultiBinPlusFitParConstructor) {
   // Test with two FitBin's and predicition that uses FitPar
   // => Is change of FitPar value properly reflected in construction?
   FitPar fp ("fp", 0.0, 0.01);
-  FitPar * fp_ptr = &fp;
-  std::function<double()> bin_prd = [fp_ptr]() { return 2*fp_ptr->m_val_mod; };
+  PrdFct bin_prd = [](const double * p) { return 2*p[0]; };
   FitBin fb1 (1.0, 1.0, bin_prd); // Measurement = Unc = 1
   FitBin fb2 (-1.0, 1.0, bin_prd); // Measurement -1, Unc = 1
-  ParVec fit_pars {}; 
+  ParVec fit_pars {fp}; 
   BinVec fit_bins {fb1, fb2};
   FitContainer container {};
   container.m_fit_pars = fit_pars;
@@ -62,7 +69,7 @@ TEST(TestChiSqMinimizer, MultiBinPlusFitParConstructor) {
   ChiSqMinimizer chi_sq_minimizer (&container, factory);
   ASSERT_EQ(chi_sq_minimizer.get_chisq(), 2);
   
-  fp.m_val_mod = 0.5;
+  container.m_fit_pars[0].m_val_mod = 0.5;
   ChiSqMinimizer chi_sq_minimizer_mod (&container, factory);
   // ((1-1)/1)^2 + ((1-(-1))/1)^2 = 4
   ASSERT_EQ(chi_sq_minimizer_mod.get_chisq(), 4);
@@ -70,7 +77,7 @@ TEST(TestChiSqMinimizer, MultiBinPlusFitParConstructor) {
 
 TEST(TestChiSqMinimizer, ChiSqWithBinsAndConstr) {
   // Test with one bin and one parameter constraint
-  std::function<double()> trivial_prd = []() { return 0; }; // Prediction = 0
+  PrdFct trivial_prd = [](const double *) { return 0; }; // Prediction = 0
   FitContainer container {};
   
   FitBin fb (1.0, 1.0, trivial_prd); // Measurement = Unc = 1
@@ -89,6 +96,27 @@ TEST(TestChiSqMinimizer, ChiSqWithBinsAndConstr) {
   ASSERT_EQ(chi_sq_minimizer.get_chisq(), 1.25);
 }
 
+TEST(TestChiSqMinimizer, ThreadIndependentChiSq) {
+  // Chi-squared has to be bit-identical for any number of threads
+  std::mt19937 gen{1}; // Random seed = 1
+  std::uniform_real_distribution<> value_func{0.1, 10.0};
+  
+  FitContainer container {};
+  for (int i_bin=0; i_bin<10000; i_bin++) {
+    double prd = value_func(gen);
+    PrdFct bin_prd = [prd](const double *) { return prd; };
+    container.m_fit_bins.push_back( 
+      FitBin(value_func(gen), value_func(gen), bin_prd) );
+  }
+  
+  MinuitFactory factory (ROOT::Minuit2::kMigrad, 100, 200, 0.05); // Simple Factory
+  ChiSqMinimizer chi_sq_minimizer (&container, factory);
+  for (size_t n_threads: {2, 3, 8}) {
+    ChiSqMinimizer chi_sq_minimizer_mt (&container, factory, n_threads);
+    ASSERT_EQ(chi_sq_minimizer_mt.get_chisq(), chi_sq_minimizer.get_chisq());
+  }
+}
+
 
 
 TEST(TestChiSqMinimizer, SecondOrderPolynomialFit) {
@@ -110,7 +138,7 @@ TEST(TestChiSqMinimizer, SecondOrderPolynomialFit) {
     FitPar ("c", 5, 0.2) 
   };
 
-  auto full_prediction = [](double* a, double* b, double* c, double x) { return (*a)*std::pow(x,2) + (*b)* x + (*c); }; 
+  auto full_prediction = [](double a, double b, double c, double x) { return a*std::pow(x,2) + b* x + c; }; 
   
   // For bins with random gaussian fluctuation
   std::mt19937 gen{1}; // Random seed = 1
@@ -121,7 +149,7 @@ TEST(TestChiSqMinimizer, SecondOrderPolynomialFit) {
   double x_start = -5.0;
   for (auto i_bin=0; i_bin<n_bins; i_bin++) {
     double x_bin = -5.0 + double(i_bin);
-    std::function<double()> connected_prediction = std::bind(full_prediction, &container.m_fit_pars[0].m_val_mod, &container.m_fit_pars[1].m_val_mod, &container.m_fit_pars[2].m_val_mod, x_bin);
+    PrdFct connected_prediction = [full_prediction, x_bin](const double * p) { return full_prediction(p[0], p[1], p[2], x_bin); };
     
     std::normal_distribution<> measurement_func{true_parabola(x_bin),fluctuation};
     double measurement = measurement_func(gen);
@@ -191,4 +219,163 @@ TEST(TestChiSqMinimizer, SecondOrderPolynomialFit) {
   EXPECT_EQ( limited_result_a <=    0, true);
   EXPECT_EQ( limited_result_b <=   15, true);
   EXPECT_EQ( limited_result_c <=   -4, true);
-}
\ No newline at end of file
+}
+
+TEST(TestChiSqMinimizer, CompiledFitWithGradient) {
+  // Fit of compiled predictions with analytic gradient gives same result as
+  // fit of bound predictions
+  // Parabola c + b*x + a*x^2, constraint on c
+  auto fill_container = [](FitContainer * container, bool compile) {
+    container->m_fit_pars = ParabolaFixture::get_pars();
+    container->m_fit_pars[0].set_constrgauss(4.5, 0.5);
+    ParabolaFixture::add_bins(container, ParabolaFixture::get_distr(1), 
+                              compile);
+  };
+  
+  MinuitFactory factory (ROOT::Minuit2::kMigrad, 100, 200, 0.05); // Simple Factory
+  FitContainer bound_container {};
+  fill_container(&bound_container, false);
+  ChiSqMinimizer bound_minimizer (&bound_container, factory);
+  bound_minimizer.minimize();
+  
+  FitContainer compiled_container {};
+  fill_container(&compiled_container, true);
+  ChiSqMinimizer compiled_minimizer (&compiled_container, factory, 2);
+  compiled_minimizer.minimize();
+  
+  const auto & bound_result = bound_minimizer.get_result();
+  const auto & compiled_result = compiled_minimizer.get_result();
+  for (size_t i_par=0; i_par<3; i_par++) {
+    EXPECT_NEAR( compiled_result.m_pars_fin[i_par], 
+                 bound_result.m_pars_fin[i_par], 1e-4 );
+    EXPECT_NEAR( compiled_result.m_uncs_fin[i_par], 
+                 bound_result.m_uncs_fin[i_par], 1e-4 );
+  }
+  EXPECT_NEAR( compiled_result.m_chisq_fin, bound_result.m_chisq_fin, 1e-6 );
+}
+
+TEST(TestChiSqMinimizer, IncrementalFitIdentical) {
+  // Fit that only re-evaluates bins of changed parameters (using the 
+  // parameter-bin index) is bit-identical to the fit that evaluates all bins
+  // Two parabolas c + b*x + a*x^2 with separate parameters
+  auto fill_container = [](FitContainer * container, bool use_index) {
+    container->m_fit_pars = ParabolaFixture::get_pars({4, 0, 2.0}, "1");
+    for (const auto & par: ParabolaFixture::get_pars({1, 1, 0.5}, "2")) {
+      container->m_fit_pars.push_back(par);
+    }
+    
+    std::vector<ParabolaFixture::Parabola> truths {
+      {4.3, -0.3, 2.5}, {0.8, 1.2, 0.7} };
+    for (size_t i_distr=0; i_distr<2; i_distr++) {
+      auto distr = ParabolaFixture::get_distr(1 + i_distr, truths[i_distr], 
+                                              1500, 0.005);
+      for (const auto & bin: distr.m_distribution) {
+        container->m_fit_bins.push_back(bin);
+      }
+      
+      // No derivatives => no analytic gradient
+      std::vector<size_t> par_idxs {3*i_distr, 3*i_distr+1, 3*i_distr+2};
+      ParabolaFixture::add_compiled(container, distr.m_coords, par_idxs, 
+                                    false);
+      if (use_index) {
+        container->m_par_bin_index.add_bins(par_idxs, 1500*i_distr, 
+                                            1500*(i_distr+1));
+      }
+    }
+  };
+  
+  MinuitFactory factory (ROOT::Minuit2::kMigrad, 100, 200, 0.05); // Simple Factory
+  FitContainer full_container {};
+  fill_container(&full_container, false);
+  ChiSqMinimizer full_minimizer (&full_container, factory);
+  full_minimizer.minimize();
+  
+  FitContainer indexed_container {};
+  fill_container(&indexed_container, true);
+  ChiSqMinimizer indexed_minimizer (&indexed_container, factory, 2);
+  indexed_minimizer.minimize();
+  
+  const auto & full_result = full_minimizer.get_result();
+  const auto & indexed_result = indexed_minimizer.get_result();
+  ASSERT_EQ( indexed_result.m_pars_fin, full_result.m_pars_fin );
+  ASSERT_EQ( indexed_result.m_uncs_fin, full_result.m_uncs_fin );
+  ASSERT_EQ( indexed_result.m_chisq_fin, full_result.m_chisq_fin );
+  EXPECT_NEAR( indexed_result.m_pars_fin[2], 2.5, 0.01 );
+  EXPECT_NEAR( indexed_result.m_pars_fin[5], 0.7, 0.01 );
+}
+
+TEST(TestChiSqMinimizer, ResetForNewMeasurements) {
+  // Refit of an updated container with a reset minimizer gives same result as
+  // a new minimizer on a new container
+  // Parabola c + b*x + a*x^2, constraint on c
+  auto get_pars = [](double c_constr) {
+    ParVec pars = ParabolaFixture::get_pars();
+    pars[0].set_constrgauss(c_constr, 0.5);
+    return pars;
+  };
+  auto fill_container = [](FitContainer * container, const ParVec & pars,
+                           const PrEW::Data::DiffDistr & distr) {
+    container->m_fit_pars = pars;
+    ParabolaFixture::add_bins(container, distr);
+  };
+  
+  MinuitFactory factory (ROOT::Minuit2::kMigrad, 100, 200, 0.05); // Simple Factory
+  FitContainer container {};
+  fill_container(&container, get_pars(4.5), ParabolaFixture::get_distr(1));
+  ChiSqMinimizer minimizer (&container, factory);
+  minimizer.minimize();
+  auto first_result = minimizer.get_result();
+  
+  container.update_measurements({ParabolaFixture::get_distr(2)});
+  container.update_pars(get_pars(4.0));
+  minimizer.reset();
+  ASSERT_EQ( minimizer.get_result(), FitResult() );
+  
+  FitContainer new_container {};
+  fill_container(&new_container, get_pars(4.0), ParabolaFixture::get_distr(2));
+  ChiSqMinimizer new_minimizer (&new_container, factory);
+  ASSERT_EQ( minimizer.get_chisq(), new_minimizer.get_chisq() );
+  
+  minimizer.minimize();
+  new_minimizer.minimize();
+  ASSERT_EQ( minimizer.get_result(), new_minimizer.get_result() );
+  ASSERT_NE( minimizer.get_result(), first_result );
+}
+
+TEST(TestChiSqMinimizer, StartFromResult) {
+  // Fit started from a previous result finds the same minimum, fixed 
+  // parameters keep their values from the container
+  // Parabola c + b*x + a*x^2
+  auto container = ParabolaFixture::get_container(3);
+  auto start_container = container;
+  
+  MinuitFactory factory (ROOT::Minuit2::kMigrad, 1000, 1000, 0.01);
+  ChiSqMinimizer minimizer (&container, factory);
+  minimizer.minimize();
+  auto result = minimizer.get_result();
+  
+  ChiSqMinimizer start_minimizer (&start_container, factory);
+  start_minimizer.set_start(result);
+  start_minimizer.minimize();
+  auto start_result = start_minimizer.get_result();
+  for (size_t i_par=0; i_par<3; i_par++) {
+    EXPECT_NEAR( start_result.m_pars_fin[i_par], result.m_pars_fin[i_par], 
+                 1e-3 * result.m_uncs_fin[i_par] );
+  }
+  EXPECT_LE( start_result.m_n_fct_calls, result.m_n_fct_calls );
+  
+  start_container.m_fit_pars[0].m_val_mod = 4.0;
+  start_container.m_fit_pars[0].fix();
+  start_minimizer.minimize();
+  ASSERT_EQ( start_minimizer.get_result().m_pars_fin[0], 4.0 );
+  
+  // Start needs the same parameters, empty result removes start
+  auto wrong_result = result;
+  std::swap(wrong_result.m_par_names[0], wrong_result.m_par_names[1]);
+  ASSERT_THROW( start_minimizer.set_start(wrong_result), 
+                std::invalid_argument );
+  wrong_result.m_pars_fin.pop_back();
+  ASSERT_THROW( start_minimizer.set_start(wrong_result), 
+                std::invalid_argument );
+  ASSERT_NO_THROW( start_minimizer.set_start(FitResult()) );
+}
@@ -1,6 +1,9 @@
 #include <gtest/gtest.h>
 #include <Fit/FitBin.h>
 
+#include <functional>
+#include <vector>
+
 using namespace PrEW::Fit;
 
 TEST(TestFitbin, TrivialConstructor) {
@@ -31,32 +34,37 @@ TEST(TestFitbin, ValSetting) {
 }
 
 TEST(TestFitbin, CorrectTrivialPrediction) {
-  std::function<double()> trivial_prd = []() { return 2.1; };
+  PrdFct trivial_prd = [](const double *) { return 2.1; };
   FitBin fb (0, 0, trivial_prd);
-  ASSERT_EQ(fb.get_val_prd(), 2.1);
+  ASSERT_EQ(fb.get_val_prd(nullptr), 2.1);
 }
 
 TEST(TestFitbin, CorrectChangedPrediction) {
-  /** Test that if I connect a function that depends on a pointer the 
-      prediction changes with pointer content.
+  /** Test that if I connect a function that depends on a parameter the 
+      prediction changes with the given parameter values.
   **/
-  double x = 1.0;
-  double * x_ptr = &x;
-  std::function<double()> trivial_prd = [x_ptr]() { return *x_ptr; };
+  std::vector<double> par_vals {0.0, 1.0};
+  PrdFct trivial_prd = [](const double * p) { return p[1]; };
   FitBin fb (0, 0, trivial_prd);
-  x = -3.5;
-  ASSERT_EQ(fb.get_val_prd(), -3.5);
+  ASSERT_EQ(fb.get_val_prd(par_vals.data()), 1.0);
+  par_vals[1] = -3.5;
+  ASSERT_EQ(fb.get_val_prd(par_vals.data()), -3.5);
+  
+  // Copies share the prediction function
+  FitBin fb_copy = fb;
+  ASSERT_EQ(fb_copy.get_val_prd(par_vals.data()), -3.5);
 }
 
 TEST(TestFitbin, PredictionFunctionSetting) {
   // Test that setting of a prediction function works properly
   FitBin fb {}; // Empty bin, no fit function
-  auto fct_1 = [](){return 2.5;};
-  auto fct_2 = [](){return -4000.0;};
+  auto fct_1 = [](const double *){return 2.5;};
+  auto fct_2 = [](const double *){return -4000.0;};
+  ASSERT_THROW(fb.get_val_prd(nullptr), std::bad_function_call);
 
   fb.set_prd_fct(fct_1);
-  ASSERT_EQ(fb.get_val_prd(), 2.5);
+  ASSERT_EQ(fb.get_val_prd(nullptr), 2.5);
 
   fb.set_prd_fct(fct_2);
-  ASSERT_EQ(fb.get_val_prd(), -4000.0);
+  ASSERT_EQ(fb.get_val_prd(nullptr), -4000.0);
 }
\ No newline at end of file
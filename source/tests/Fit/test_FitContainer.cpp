@@ -0,0 +1,112 @@
+#include <Data/DiffDistr.h>
+#include <Data/DistrInfo.h>
+#include <Fit/FitContainer.h>
+
+#include <gtest/gtest.h>
+
+#include <memory>
+#include <stdexcept>
+#include <vector>
+
+using namespace PrEW::Data;
+using namespace PrEW::Fit;
+
+//------------------------------------------------------------------------------
+// Tests for updating a filled fit container
+
+TEST(TestFitContainer, UpdateMeasurements) {
+  FitContainer container {};
+  container.m_fit_bins = BinVec { FitBin(1, 0.1), FitBin(2, 0.2), FitBin(3, 0.3) };
+  
+  DiffDistr distr_1 {}, distr_2 {};
+  distr_1.m_distribution = BinVec { FitBin(4, 0.4) };
+  distr_2.m_distribution = BinVec { FitBin(5, 0.5), FitBin(6, 0.6) };
+  container.update_measurements({distr_1, distr_2});
+  
+  std::vector<double> vals_mst {}, vals_unc {};
+  for (const auto & bin: container.m_fit_bins) {
+    vals_mst.push_back(bin.get_val_mst());
+    vals_unc.push_back(bin.get_val_unc());
+  }
+  ASSERT_EQ( vals_mst, std::vector<double>({4, 5, 6}) );
+  ASSERT_EQ( vals_unc, std::vector<double>({0.4, 0.5, 0.6}) );
+  
+  // Number of bins has to match
+  ASSERT_THROW( container.update_measurements({distr_2}), 
+                std::invalid_argument );
+  
+  // With known binning every distribution has to match
+  distr_1.m_info = DistrInfo {"test", "e-p+", 250};
+  distr_2.m_info = DistrInfo {"test", "e+p-", 250};
+  container.m_distr_binnings = { 
+    {distr_1.m_info, {}, 1}, {distr_2.m_info, {}, 2} 
+  };
+  container.update_measurements({distr_1, distr_2});
+  DiffDistr distr_3 = distr_2, distr_4 = distr_1;
+  distr_3.m_distribution.pop_back();
+  distr_4.m_distribution.push_back( FitBin(7, 0.7) );
+  ASSERT_THROW( container.update_measurements({distr_4, distr_3}), 
+                std::invalid_argument );
+  ASSERT_THROW( container.update_measurements({distr_2, distr_1}), 
+                std::invalid_argument );
+}
+
+TEST(TestFitContainer, UpdatePars) {
+  // Bins stay connected to the updated parameters
+  FitContainer container {};
+  container.m_fit_pars = ParVec { FitPar("a", 1, 0.1), FitPar("b", 2, 0.1) };
+  container.m_fit_bins = BinVec { 
+    FitBin(0, 1, [](const double * p) { return p[0]; }) };
+  container.m_fit_pars[0].m_val_mod = 5;
+  
+  ParVec new_pars { FitPar("a", 1, 0.1), FitPar("b", 2, 0.1) };
+  new_pars[1].set_constrgauss(2.5, 0.3);
+  container.update_pars(new_pars);
+  ASSERT_EQ( container.m_fit_bins[0].get_val_prd(
+               get_par_vals(container.m_fit_pars).data() ), 1 );
+  ASSERT_TRUE( container.m_fit_pars[1].has_constraint() );
+  ASSERT_EQ( container.m_fit_pars[1].get_constr_val(), 2.5 );
+  
+  container.m_fit_pars[0].m_val_mod = -1;
+  ASSERT_EQ( container.m_fit_bins[0].get_val_prd(
+               get_par_vals(container.m_fit_pars).data() ), -1 );
+  
+  // Copies are independent of the original parameters
+  FitContainer copy = container;
+  copy.m_fit_pars[0].m_val_mod = 3;
+  ASSERT_EQ( copy.m_fit_bins[0].get_val_prd(
+               get_par_vals(copy.m_fit_pars).data() ), 3 );
+  ASSERT_EQ( container.m_fit_bins[0].get_val_prd(
+               get_par_vals(container.m_fit_pars).data() ), -1 );
+  
+  // Parameters have to match
+  ASSERT_THROW( container.update_pars({FitPar("a", 1, 0.1)}), 
+                std::invalid_argument );
+  ASSERT_THROW( container.update_pars({FitPar("b", 1, 0.1), FitPar("a", 1, 0.1)}), 
+                std::invalid_argument );
+}
+
+//------------------------------------------------------------------------------
+
+TEST(TestFitContainer, GetValPrd) {
+  // Bound predictions get the parameter values followed by the shared terms
+  FitContainer container {};
+  container.m_fit_pars = ParVec { FitPar("a", 1, 0.1), FitPar("b", 2, 0.1) };
+  container.m_fit_bins = BinVec { 
+    FitBin(0, 1, [](const double * p) { return p[0] + p[1]; }) };
+  ASSERT_EQ( container.get_val_prd({1, 2}), std::vector<double>({3}) );
+  
+  container.m_prd_terms = PrdTerms(2);
+  size_t term = container.m_prd_terms.add_group( 1, 
+    std::make_shared<const std::vector<size_t>>(std::vector<size_t>{1}),
+    [](const double * p, double * t) { t[0] = 10 * p[1]; } );
+  container.m_fit_bins.push_back( 
+    FitBin(0, 1, [term](const double * p) { return p[0] * p[term]; }) );
+  ASSERT_EQ( container.get_val_prd({1, 2}), std::vector<double>({3, 20}) );
+  
+  // Number of parameter values is checked
+  ASSERT_THROW( container.get_val_prd({1}), std::invalid_argument );
+  ASSERT_THROW( container.get_val_prd({1, 2, 3}), std::invalid_argument );
+}
+
+//------------------------------------------------------------------------------
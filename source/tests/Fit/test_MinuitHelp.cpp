@@ -0,0 +1,52 @@
+#include <Fit/FitPar.h>
+#include <Fit/FitResult.h>
+#include <Fit/MinuitFactory.h>
+#include <Fit/MinuitHelp.h>
+
+#include <gtest/gtest.h>
+
+#include <stdexcept>
+
+using namespace PrEW::Fit;
+
+//------------------------------------------------------------------------------
+// Tests for the common minimizer setup
+
+TEST(TestMinuitHelp, StartVariables) {
+  ParVec pars { FitPar("A", 1.0, 0.1), FitPar("B", 2.0, 0.2, true) };
+  MinuitFactory factory (ROOT::Minuit2::kMigrad, 100, 100, 0.01);
+  auto minimizer = factory.create_minimizer();
+
+  // Without start the parameter values are used
+  MinuitHelp::set_variables(pars, FitResult(), minimizer.get());
+  ASSERT_EQ( minimizer->NDim(), 2 );
+  ASSERT_EQ( minimizer->NFree(), 1 );
+  ASSERT_EQ( minimizer->VariableName(1), "B" );
+  ASSERT_EQ( minimizer->X()[0], 1.0 );
+  ASSERT_EQ( minimizer->X()[1], 2.0 );
+
+  // Free parameters start at the start result, fixed ones keep their value
+  FitResult start {};
+  start.m_par_names = {"A", "B"};
+  start.m_pars_fin = {3.0, 4.0};
+  start.m_uncs_fin = {0.3, 0.4};
+  start.m_cov_matrix = {{0.09, 0.0}, {0.0, 0.16}};
+  ASSERT_NO_THROW( MinuitHelp::check_start(start, pars) );
+  minimizer->Clear();
+  MinuitHelp::set_variables(pars, start, minimizer.get());
+  ASSERT_EQ( minimizer->X()[0], 3.0 );
+  ASSERT_EQ( minimizer->X()[1], 2.0 );
+
+  // Start needs the same parameters, empty start is always fine
+  ASSERT_NO_THROW( MinuitHelp::check_start(FitResult(), pars) );
+  auto wrong_start = start;
+  wrong_start.m_par_names = {"B", "A"};
+  ASSERT_THROW( MinuitHelp::check_start(wrong_start, pars),
+                std::invalid_argument );
+  wrong_start = start;
+  wrong_start.m_uncs_fin.pop_back();
+  ASSERT_THROW( MinuitHelp::check_start(wrong_start, pars),
+                std::invalid_argument );
+}
+
+//------------------------------------------------------------------------------
@@ -0,0 +1,65 @@
+#include <Fit/ParArrays.h>
+
+#include <gtest/gtest.h>
+
+#include <stdexcept>
+#include <vector>
+
+using namespace PrEW::Fit;
+
+//------------------------------------------------------------------------------
+// Tests for structure-of-arrays parameter storage
+
+TEST(TestParArrays, ActiveConstraints) {
+  /** Only constraints of free parameters are stored and they give the same
+      chi-squared as the parameters themselves.
+  **/
+  ParVec pars {
+    FitPar("A", 1.0, 0.1), FitPar("B", 2.0, 0.1), FitPar("C", 3.0, 0.1)
+  };
+  pars[0].set_constrgauss(1.5, 0.5);
+  pars[1].set_constrgauss(2.0, 1.0);
+  pars[1].fix();
+  pars[2].set_constrgauss(2.0, 0.25);
+
+  ParArrays arrays (pars);
+  ASSERT_EQ( arrays.size(), 3 );
+  ASSERT_EQ( arrays.m_vals, std::vector<double>({1.0, 2.0, 3.0}) );
+  ASSERT_EQ( arrays.get_n_constrs(), 2 );
+  ASSERT_EQ( arrays.m_constr_idxs, std::vector<size_t>({0, 2}) );
+
+  // Values are taken from contiguous array
+  std::vector<double> vals {0.5, 2.5, 2.25};
+  arrays.set_vals(vals.data());
+  ASSERT_EQ( arrays.m_vals, vals );
+  for (size_t c=0; c<arrays.get_n_constrs(); c++) {
+    auto & par = pars[arrays.m_constr_idxs[c]];
+    par.m_val_mod = vals[arrays.m_constr_idxs[c]];
+    ASSERT_DOUBLE_EQ( arrays.calc_constr_chisq(c), par.calc_constr_chisq() );
+    ASSERT_DOUBLE_EQ( arrays.calc_constr_chisq_deriv(c),
+                      par.calc_constr_chisq_deriv() );
+  }
+
+  // Releasing a parameter needs a refill
+  pars[1].release();
+  arrays.set_pars(pars);
+  ASSERT_EQ( arrays.get_n_constrs(), 3 );
+}
+
+TEST(TestParArrays, WriteValues) {
+  ParVec pars { FitPar("A", 1.0, 0.1), FitPar("B", 2.0, 0.1) };
+  ParArrays arrays (pars);
+  std::vector<double> vals {-1.0, 4.0};
+  arrays.set_vals(vals.data());
+  ASSERT_EQ( pars[0].m_val_mod, 1.0 );
+
+  arrays.write_vals(&pars);
+  ASSERT_EQ( pars[0].m_val_mod, -1.0 );
+  ASSERT_EQ( pars[1].m_val_mod, 4.0 );
+  ASSERT_EQ( pars[1].get_val_ini(), 2.0 );
+
+  pars.push_back(FitPar("C", 0.0, 0.1));
+  ASSERT_THROW( arrays.write_vals(&pars), std::invalid_argument );
+}
+
+//------------------------------------------------------------------------------
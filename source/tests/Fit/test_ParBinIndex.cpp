@@ -0,0 +1,66 @@
+#include <gtest/gtest.h>
+
+#include <Fit/ParBinIndex.h>
+
+#include <utility>
+#include <vector>
+
+using namespace PrEW::Fit;
+
+//------------------------------------------------------------------------------
+// Helper to compare bin ranges
+
+static std::vector<std::pair<size_t,size_t>> as_pairs(
+  const std::vector<BinRange> & ranges
+) {
+  std::vector<std::pair<size_t,size_t>> pairs {};
+  for (const auto & range: ranges) {
+    pairs.push_back({range.m_begin, range.m_end});
+  }
+  return pairs;
+}
+
+using Pairs = std::vector<std::pair<size_t,size_t>>;
+
+//------------------------------------------------------------------------------
+// Tests for the parameter-bin index
+
+TEST(TestParBinIndex, EmptyIndex) {
+  ParBinIndex index {};
+  ASSERT_TRUE( index.is_empty() );
+  ASSERT_EQ( index.get_n_pars(), 0 );
+  ASSERT_TRUE( index.get_bin_ranges(3).empty() );
+  ASSERT_TRUE( index.get_bin_ranges(std::vector<size_t>{0, 1}).empty() );
+}
+
+TEST(TestParBinIndex, AddAndMerge) {
+  ParBinIndex index {};
+  index.add_bins({0, 2}, 10, 20);
+  index.add_bins({2}, 0, 5);
+  index.add_bins({0}, 20, 25); // Adjacent => merged
+  index.add_bins({2}, 3, 12);  // Overlapping => merged
+  index.add_bins({0}, 30, 30); // Empty range => ignored
+  ASSERT_FALSE( index.is_empty() );
+  ASSERT_EQ( index.get_n_pars(), 3 );
+  
+  ASSERT_EQ( as_pairs(index.get_bin_ranges(0)), Pairs({{10, 25}}) );
+  ASSERT_TRUE( index.get_bin_ranges(1).empty() );
+  ASSERT_EQ( as_pairs(index.get_bin_ranges(2)), Pairs({{0, 20}}) );
+  
+  // Union over parameters
+  index.add_bins({1}, 40, 50);
+  ASSERT_EQ( as_pairs(index.get_bin_ranges(std::vector<size_t>{0, 1})), 
+             Pairs({{10, 25}, {40, 50}}) );
+  ASSERT_EQ( as_pairs(index.get_bin_ranges(std::vector<size_t>{1, 2, 0})), 
+             Pairs({{0, 25}, {40, 50}}) );
+  
+  index.clear();
+  ASSERT_TRUE( index.is_empty() );
+}
+
+TEST(TestParBinIndex, InvalidInput) {
+  ParBinIndex index {};
+  ASSERT_THROW( index.add_bins({0}, 5, 4), std::invalid_argument );
+}
+
+//------------------------------------------------------------------------------
@@ -1,11 +1,16 @@
 #include <gtest/gtest.h>
 
 #include <CppUtils/Num.h>
+#include <Data/BinCoord.h>
+#include <Fcts/FctMap.h>
 #include <Fit/PoissonNLLMinimizer.h>
 
+#include "ParabolaFixture.h"
+
 #include <functional>
 #include <limits>
 #include <map>
+#include <random>
 #include <vector>
 
 using namespace PrEW::CppUtils;
@@ -49,7 +54,7 @@ TEST(TestPoissonNLLMinimizer, TestAllCases) {
     double mu = n_mu_res.first.second;
     double res = n_mu_res.second;
     
-    std::function<double()> prd = [mu]() { return mu; };
+    PrdFct prd = [mu](const double *) { return mu; };
     FitBin fb (n, 0, prd); // Measurement = 1 (uncertainty ignored)
     FitContainer container {};
     container.m_fit_bins = {fb};
@@ -73,7 +78,7 @@ TEST(TestPoissonNLLMinimizer, TestAllCases) {
 
 TEST(TestPoissonNLLMinimizer, ManyBinsConstructor) {
   // Test with n FitBin's, range n from small to very large 
-  std::function<double()> trivial_prd = []() { return 0.5; }; // Prediction = 0
+  PrdFct trivial_prd = [](const double *) { return 0.5; }; // Prediction = 0
   std::vector<int> n_bins = {20, 200, 2000, 20000, 200000};
   MinuitFactory factory (ROOT::Minuit2::kMigrad, 100, 200, 0.05); // Simple Factory
   
@@ -91,4 +96,68 @@ TEST(TestPoissonNLLMinimizer, ManyBinsConstructor) {
   }
 }
 
-//------------------------------------------------------------------------------
\ No newline at end of file
+//------------------------------------------------------------------------------
+
+TEST(TestPoissonNLLMinimizer, ThreadIndependentNLL) {
+  // NLL has to be bit-identical for any number of threads
+  std::mt19937 gen{1}; // Random seed = 1
+  std::uniform_real_distribution<> prd_func{0.5, 50.0};
+  std::uniform_int_distribution<> mst_func{0, 50};
+  
+  FitContainer container {};
+  for (int i_bin=0; i_bin<10000; i_bin++) {
+    double prd = prd_func(gen);
+    PrdFct bin_prd = [prd](const double *) { return prd; };
+    container.m_fit_bins.push_back( FitBin(mst_func(gen), 1.0, bin_prd) );
+  }
+  
+  MinuitFactory factory (ROOT::Minuit2::kMigrad, 100, 200, 0.05); // Simple Factory
+  PoissonNLLMinimizer pnll_minimizer (&container, factory);
+  for (size_t n_threads: {2, 3, 8}) {
+    PoissonNLLMinimizer pnll_minimizer_mt (&container, factory, n_threads);
+    ASSERT_EQ(pnll_minimizer_mt.get_nll(), pnll_minimizer.get_nll());
+  }
+  
+  // Infinite NLL found in any chunk
+  container.m_fit_bins[7777] = FitBin(5, 1.0, [](const double *) { return -1.0; });
+  PoissonNLLMinimizer pnll_minimizer_inf (&container, factory, 4);
+  ASSERT_EQ(pnll_minimizer_inf.get_nll(), std::numeric_limits<double>::infinity());
+}
+
+//------------------------------------------------------------------------------
+
+TEST(TestPoissonNLLMinimizer, CompiledFitWithGradient) {
+  // Fit of compiled predictions with analytic gradient gives same result as
+  // fit of bound predictions
+  // Parabola c + b*x + a*x^2 (poissonian and gaussian bins), constraint on c
+  auto fill_container = [](FitContainer * container, bool compile) {
+    container->m_fit_pars = ParabolaFixture::get_pars({9, -0.5, 2.0});
+    container->m_fit_pars[0].set_constrgauss(10.0, 1.0);
+    ParabolaFixture::add_bins( 
+      container, ParabolaFixture::get_distr(1, {10.0, -0.3, 2.0}, 20, 0.5, true),
+      compile );
+  };
+  
+  MinuitFactory factory (ROOT::Minuit2::kMigrad, 100, 200, 0.05); // Simple Factory
+  FitContainer bound_container {};
+  fill_container(&bound_container, false);
+  PoissonNLLMinimizer bound_minimizer (&bound_container, factory);
+  bound_minimizer.minimize();
+  
+  FitContainer compiled_container {};
+  fill_container(&compiled_container, true);
+  PoissonNLLMinimizer compiled_minimizer (&compiled_container, factory, 2);
+  compiled_minimizer.minimize();
+  
+  const auto & bound_result = bound_minimizer.get_result();
+  const auto & compiled_result = compiled_minimizer.get_result();
+  for (size_t i_par=0; i_par<3; i_par++) {
+    EXPECT_NEAR( compiled_result.m_pars_fin[i_par], 
+                 bound_result.m_pars_fin[i_par], 1e-4 );
+    EXPECT_NEAR( compiled_result.m_uncs_fin[i_par], 
+                 bound_result.m_uncs_fin[i_par], 1e-4 );
+  }
+  EXPECT_NEAR( compiled_result.m_chisq_fin, bound_result.m_chisq_fin, 1e-6 );
+}
+
+//------------------------------------------------------------------------------
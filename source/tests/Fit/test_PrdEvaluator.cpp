@@ -0,0 +1,254 @@
+#include <gtest/gtest.h>
+
+#include <Data/BinCoord.h>
+#include <Fcts/FctMap.h>
+#include <Fcts/ParametrisationFct.h>
+#include <Fit/FitContainer.h>
+#include <Fit/PrdEvaluator.h>
+
+#include <cmath>
+#include <functional>
+#include <memory>
+#include <vector>
+
+using namespace PrEW::Data;
+using namespace PrEW::Fcts;
+using namespace PrEW::Fit;
+
+//------------------------------------------------------------------------------
+// Tests for chunked evaluation of bin predictions
+
+TEST(TestPrdEvaluator, BoundPredictions) {
+  // Predictions from bin prediction functions, all chunks are evaluated
+  FitContainer container {};
+  container.m_fit_pars = ParVec { FitPar("a", 2.0, 0.1) };
+  for (int i_bin=0; i_bin<10; i_bin++) {
+    container.m_fit_bins.push_back(
+      FitBin(0, 1, [i_bin](const double * p) { return p[0] * i_bin; }) );
+  }
+  
+  for (size_t n_threads: {1, 3}) {
+    PrdEvaluator evaluator (&container, n_threads, 3);
+    ASSERT_EQ( evaluator.get_n_threads(), n_threads );
+    ASSERT_EQ( evaluator.get_n_chunks(), 4 );
+    
+    std::vector<size_t> chunk_begins (4), chunk_ends (4);
+    evaluator.evaluate(
+      [&chunk_begins, &chunk_ends](size_t chunk, size_t begin, size_t end) {
+        chunk_begins[chunk] = begin;
+        chunk_ends[chunk] = end;
+      }
+    );
+    ASSERT_EQ( chunk_begins, std::vector<size_t>({0, 3, 6, 9}) );
+    ASSERT_EQ( chunk_ends, std::vector<size_t>({3, 6, 9, 10}) );
+    for (int i_bin=0; i_bin<10; i_bin++) {
+      ASSERT_EQ( evaluator.get_prds()[i_bin], 2.0 * i_bin );
+    }
+  }
+}
+
+TEST(TestPrdEvaluator, CompiledPredictions) {
+  // Predictions from compiled program use current parameter values
+  static const ParametrisationFct par_fct =
+    []( const BinCoord &x, const std::vector<double> &,
+        const std::vector<double*> &p ) {
+      return x.get_center()[0] * *(p[0]);
+    };
+  
+  FitContainer container {};
+  container.m_fit_pars = ParVec { FitPar("a", 2.0, 0.1) };
+  CoordVec coords {};
+  for (int i_bin=0; i_bin<10; i_bin++) {
+    coords.push_back( BinCoord({double(i_bin)}, {0}, {10}) );
+    container.m_fit_bins.push_back( FitBin(0, 1) );
+  }
+  auto & program = container.m_prd_program;
+  size_t seg = program.add_segment(coords);
+  program.add_bins(seg, program.add_call(seg, "par", par_fct, {}, {0}));
+  
+  PrdEvaluator evaluator (&container, 2, 4);
+  container.m_fit_pars[0].m_val_mod = -1.0;
+  evaluator.evaluate([](size_t, size_t, size_t) {});
+  for (int i_bin=0; i_bin<10; i_bin++) {
+    ASSERT_EQ( evaluator.get_prds()[i_bin], -1.0 * i_bin );
+  }
+  
+  // Program must fit to bins
+  container.m_fit_bins.pop_back();
+  ASSERT_THROW( PrdEvaluator {&container}, std::invalid_argument );
+}
+
+TEST(TestPrdEvaluator, EvaluateChanged) {
+  // Only chunks with bins depending on changed parameters are re-evaluated
+  static const ParametrisationFct par_fct =
+    []( const BinCoord &x, const std::vector<double> &,
+        const std::vector<double*> &p ) {
+      return x.get_center()[0] * *(p[0]);
+    };
+  
+  FitContainer container {};
+  container.m_fit_pars = ParVec { FitPar("a", 2.0, 0.1), FitPar("b", 3.0, 0.1) };
+  CoordVec coords {};
+  for (int i_bin=0; i_bin<6; i_bin++) {
+    coords.push_back( BinCoord({double(i_bin)}, {0}, {10}) );
+    container.m_fit_bins.push_back( FitBin(0, 1) );
+    container.m_fit_bins.push_back( FitBin(0, 1) );
+  }
+  // Bins [0,6) depend on a, bins [6,12) on b
+  auto & program = container.m_prd_program;
+  for (size_t par: {0, 1}) {
+    size_t seg = program.add_segment(coords);
+    program.add_bins(seg, program.add_call(seg, "par", par_fct, {}, {par}));
+    container.m_par_bin_index.add_bins({par}, 6*par, 6*par + 6);
+  }
+  
+  PrdEvaluator evaluator (&container, 2, 4);
+  std::vector<int> updated (3, 0); // Per chunk => no race between threads
+  auto chunk_fct = [&updated](size_t chunk, size_t, size_t) {
+    updated[chunk] = 1;
+  };
+  
+  // First evaluation always updates all chunks
+  evaluator.evaluate_changed(chunk_fct);
+  ASSERT_EQ( updated, std::vector<int>({1, 1, 1}) );
+  
+  // Nothing changed => nothing to do
+  updated.assign(3, 0);
+  evaluator.evaluate_changed(chunk_fct);
+  ASSERT_EQ( updated, std::vector<int>({0, 0, 0}) );
+  
+  // Bins of b are in chunks 1 and 2
+  container.m_fit_pars[1].m_val_mod = -1.0;
+  evaluator.evaluate_changed(chunk_fct);
+  ASSERT_EQ( updated, std::vector<int>({0, 1, 1}) );
+  
+  // Same predictions as full evaluation
+  PrdEvaluator full_evaluator (&container, 1, 4);
+  full_evaluator.evaluate([](size_t, size_t, size_t) {});
+  ASSERT_EQ( evaluator.get_prds(), full_evaluator.get_prds() );
+  
+  // Values can be given as array instead (container is not touched)
+  std::vector<double> par_vals {4.0, -1.0};
+  updated.assign(3, 0);
+  evaluator.evaluate_changed(chunk_fct, par_vals.data());
+  ASSERT_EQ( updated, std::vector<int>({1, 1, 0}) );
+  ASSERT_EQ( evaluator.get_prds()[1], 4.0 );
+  ASSERT_EQ( container.m_fit_pars[0].m_val_mod, 2.0 );
+  
+  // New measurements => everything re-evaluated
+  updated.assign(3, 0);
+  evaluator.update_measurements();
+  evaluator.evaluate_changed(chunk_fct);
+  ASSERT_EQ( updated, std::vector<int>({1, 1, 1}) );
+  
+  // Without index all chunks are re-evaluated
+  container.m_par_bin_index.clear();
+  updated.assign(3, 0);
+  container.m_fit_pars[1].m_val_mod = 5.0;
+  evaluator.evaluate_changed(chunk_fct);
+  ASSERT_EQ( updated, std::vector<int>({1, 1, 1}) );
+}
+
+TEST(TestPrdEvaluator, SharedTerms) {
+  // Bound predictions read the shared terms behind the parameter values,
+  // only groups depending on changed parameters are recalculated
+  FitContainer container {};
+  container.m_fit_pars = ParVec { FitPar("a", 2.0, 0.1), FitPar("b", 3.0, 0.1) };
+  container.m_prd_terms = PrdTerms(2);
+  std::vector<int> n_calls (2, 0); // Evaluated in different threads
+  std::vector<size_t> term_idxs {};
+  for (size_t par: {0, 1}) {
+    term_idxs.push_back( container.m_prd_terms.add_group( 
+      1, std::make_shared<const std::vector<size_t>>(std::vector<size_t>{par}),
+      [par, &n_calls](const double * p, double * t) { 
+        n_calls[par]++;
+        t[0] = p[par] * p[par]; 
+      } ) );
+  }
+  for (int i_bin=0; i_bin<6; i_bin++) {
+    size_t idx = term_idxs[size_t(i_bin) / 3];
+    container.m_fit_bins.push_back(
+      FitBin(0, 1, [idx, i_bin](const double * v) { return v[idx] * i_bin; }) );
+  }
+  
+  PrdEvaluator evaluator (&container, 2, 1);
+  evaluator.evaluate_changed([](size_t, size_t, size_t) {});
+  ASSERT_EQ( n_calls, std::vector<int>({1, 1}) );
+  ASSERT_EQ( evaluator.get_prds()[2], 4.0 * 2 );
+  ASSERT_EQ( evaluator.get_prds()[4], 9.0 * 4 );
+  
+  container.m_fit_pars[1].m_val_mod = -1.0;
+  evaluator.evaluate_changed([](size_t, size_t, size_t) {});
+  ASSERT_EQ( n_calls, std::vector<int>({1, 2}) );
+  ASSERT_EQ( evaluator.get_prds()[2], 4.0 * 2 );
+  ASSERT_EQ( evaluator.get_prds()[4], 1.0 * 4 );
+  
+  evaluator.evaluate([](size_t, size_t, size_t) {});
+  ASSERT_EQ( n_calls, std::vector<int>({2, 3}) );
+  
+  // Terms have to fit to parameters
+  container.m_fit_pars.pop_back();
+  ASSERT_THROW( PrdEvaluator {&container}, std::invalid_argument );
+}
+
+//------------------------------------------------------------------------------
+
+TEST(TestPrdEvaluator, CompiledGradient) {
+  // Gradient of weighted predictions through scalars and columns,
+  // bit-identical for any number of threads
+  FitContainer container {};
+  container.m_fit_pars = ParVec { 
+    FitPar("p0", 1.0, 0.1), FitPar("p1", -0.5, 0.1), FitPar("p2", 0.2, 0.1),
+    FitPar("norm", 2.0, 0.1)
+  };
+  CoordVec coords {};
+  std::vector<double> weights {};
+  for (int i_bin=0; i_bin<1000; i_bin++) {
+    double x = -1.0 + 0.002 * i_bin;
+    coords.push_back( BinCoord({x}, {x-0.001}, {x+0.001}) );
+    container.m_fit_bins.push_back( FitBin(0, 1) );
+    weights.push_back( std::sin(0.1 * i_bin) );
+  }
+  auto & program = container.m_prd_program;
+  auto norm = program.add_call( 0, "Constant", prew_fct_map.at("Constant"), 
+                                {}, {3}, prew_grad_map.at("Constant") );
+  size_t seg = program.add_segment(coords);
+  auto quad = 
+    program.add_call( seg, "Quadratic1DPolynomial", 
+                      prew_fct_map.at("Quadratic1DPolynomial"), {}, {0, 1, 2},
+                      prew_grad_map.at("Quadratic1DPolynomial") );
+  program.add_bins(seg, program.add_prod(seg, {quad, norm}));
+  
+  std::vector<double> par_vals {1.0, -0.5, 0.2, 2.0};
+  PrdProgram::Workspace ws {};
+  std::vector<double> expected (4, 0.0);
+  program.gradient(par_vals.data(), weights, &ws, &expected);
+  
+  auto weight_fct = 
+    [&weights](size_t, size_t begin, size_t end, double * chunk_weights) {
+      for (size_t i=begin; i<end; i++) { chunk_weights[i-begin] = weights[i]; }
+    };
+  PrdEvaluator evaluator (&container, 1, 64);
+  ASSERT_TRUE( evaluator.has_gradient() );
+  std::vector<double> grad {};
+  evaluator.evaluate_gradient(weight_fct, &grad);
+  ASSERT_EQ( grad.size(), 4 );
+  for (size_t p=0; p<4; p++) { ASSERT_NEAR( grad[p], expected[p], 1e-9 ); }
+  
+  for (size_t n_threads: {2, 5}) {
+    PrdEvaluator evaluator_mt (&container, n_threads, 64);
+    std::vector<double> grad_mt {};
+    evaluator_mt.evaluate_gradient(weight_fct, &grad_mt);
+    ASSERT_EQ( grad_mt, grad );
+    ASSERT_EQ( evaluator_mt.get_prds(), evaluator.get_prds() );
+  }
+  
+  // No gradient without compiled program
+  container.m_prd_program = PrdProgram();
+  PrdEvaluator bound_evaluator (&container);
+  ASSERT_FALSE( bound_evaluator.has_gradient() );
+  ASSERT_THROW( bound_evaluator.evaluate_gradient(weight_fct, &grad),
+                std::invalid_argument );
+}
+
+//------------------------------------------------------------------------------
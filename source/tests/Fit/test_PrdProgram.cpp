@@ -0,0 +1,323 @@
+#include <Data/BinCoord.h>
+#include <Fcts/ParametrisationFct.h>
+#include <Fit/PrdProgram.h>
+
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <vector>
+
+using namespace PrEW::Data;
+using namespace PrEW::Fcts;
+using namespace PrEW::Fit;
+
+//------------------------------------------------------------------------------
+// Simple functions to test the program with
+
+// c[0] * x + p[0]
+static const ParametrisationFct linear_fct =
+  []( const BinCoord &x, const std::vector<double> &c,
+      const std::vector<double*> &p ) {
+    return c[0] * x.get_center()[0] + *(p[0]);
+  };
+
+// p[0] * p[1]
+static const ParametrisationFct par_prod_fct =
+  []( const BinCoord &, const std::vector<double> &,
+      const std::vector<double*> &p ) {
+    return *(p[0]) * *(p[1]);
+  };
+
+// Derivatives of the functions above
+static const ParametrisationGrad linear_grad =
+  []( const BinCoord &, const std::vector<double> &,
+      const std::vector<double*> &, std::vector<double> *grad ) {
+    (*grad)[0] = 1.0;
+  };
+
+static const ParametrisationGrad par_prod_grad =
+  []( const BinCoord &, const std::vector<double> &,
+      const std::vector<double*> &p, std::vector<double> *grad ) {
+    (*grad)[0] = *(p[1]);
+    (*grad)[1] = *(p[0]);
+  };
+
+// Coordinates (bin center and edges)
+static const BinCoord x_1 {{1}, {0.5}, {1.5}};
+static const BinCoord x_2 {{2}, {1.5}, {2.5}};
+static const BinCoord x_3 {{3}, {2.5}, {3.5}};
+static const BinCoord x_5 {{5}, {4.5}, {5.5}};
+
+//------------------------------------------------------------------------------
+// Tests for compiled prediction program
+
+TEST(TestPrdProgram, EmptyProgram) {
+  PrdProgram program {};
+  ASSERT_EQ(program.get_n_bins(), 0);
+  ASSERT_EQ(program.get_n_segments(), 1); // Scalar segment always there
+  ASSERT_EQ(program.get_n_ops(), 0);
+
+  PrdProgram::Workspace ws {};
+  std::vector<double> prds {1.0};
+  program.evaluate(nullptr, &ws, &prds);
+  ASSERT_EQ(prds.size(), 0);
+}
+
+TEST(TestPrdProgram, SimpleEvaluation) {
+  // Program: pred = sigma * (c*x + p0) + p1*p2
+  PrdProgram program {};
+  size_t segment = program.add_segment({x_1, x_2, x_3});
+
+  auto scalar = program.add_call(0, "par_prod", par_prod_fct, {}, {1,2});
+  auto coef = program.add_const(std::vector<double>{1, 2, 3});
+  auto linear = program.add_call(segment, "linear", linear_fct, {coef}, {0});
+  auto sigma = program.add_const(std::vector<double>{0.5, 1, 2});
+  auto prod = program.add_prod(segment, {linear}, sigma);
+  program.add_bins(segment, program.add_sum(segment, {prod, scalar}));
+
+  ASSERT_EQ(program.get_n_bins(), 3);
+  ASSERT_EQ(program.get_n_segments(), 2);
+  ASSERT_EQ(program.get_n_ops(), 4);
+
+  std::vector<double> par_vals {1, 2, 3};
+  PrdProgram::Workspace ws {};
+  std::vector<double> prds {};
+  program.evaluate(par_vals.data(), &ws, &prds);
+  ASSERT_EQ(prds, std::vector<double>({0.5*2+6, 1*5+6, 2*10+6}));
+
+  // Changing parameters changes predictions
+  par_vals = {0, 1, -1};
+  program.evaluate(par_vals.data(), &ws, &prds);
+  ASSERT_EQ(prds, std::vector<double>({0.5*1-1, 1*4-1, 2*9-1}));
+}
+
+TEST(TestPrdProgram, MultipleSegments) {
+  // Bins of multiple segments are in order of adding
+  PrdProgram program {};
+  auto global_coef = program.add_const(2.0);
+
+  size_t seg_1 = program.add_segment({x_1, x_2});
+  auto lin_1 = program.add_call(seg_1, "linear", linear_fct, {global_coef}, {0});
+  program.add_bins(seg_1, lin_1);
+
+  size_t seg_2 = program.add_segment({x_5});
+  auto lin_2 = program.add_call(seg_2, "linear", linear_fct, {global_coef}, {1});
+  program.add_bins(seg_2, program.add_prod(seg_2, {lin_2, lin_2}));
+
+  std::vector<double> par_vals {1, -1};
+  PrdProgram::Workspace ws {};
+  std::vector<double> prds {};
+  program.evaluate(par_vals.data(), &ws, &prds);
+  ASSERT_EQ(prds, std::vector<double>({3, 5, 81}));
+}
+
+TEST(TestPrdProgram, PartialEvaluation) {
+  // Evaluating bin ranges gives the same as evaluating all bins
+  PrdProgram program {};
+  auto scalar = program.add_call(0, "par_prod", par_prod_fct, {}, {0,1});
+  auto coef = program.add_const(std::vector<double>{1, 2, 3});
+  for (size_t i_seg=0; i_seg<3; i_seg++) {
+    size_t seg = program.add_segment({x_1, x_2, x_3});
+    auto lin = program.add_call(seg, "linear", linear_fct, {coef}, {i_seg});
+    program.add_bins(seg, program.add_prod(seg, {lin, scalar}));
+  }
+  ASSERT_EQ(program.get_n_bins(), 9);
+  
+  std::vector<double> par_vals {1, 2, 3};
+  PrdProgram::Workspace ws {};
+  std::vector<double> prds_all {};
+  program.evaluate(par_vals.data(), &ws, &prds_all);
+  
+  std::vector<double> vals (program.get_n_vals());
+  PrdProgram::Scratch scratch {};
+  program.evaluate_scalars(par_vals.data(), vals.data(), &scratch);
+  std::vector<double> prds (9);
+  for (size_t bin_begin: {0, 2, 5, 8}) {
+    size_t bin_end = std::min(bin_begin + 3, size_t(9));
+    program.evaluate_bins( bin_begin, bin_end, par_vals.data(), vals.data(),
+                           &scratch, prds.data() + bin_begin );
+  }
+  ASSERT_EQ(prds, prds_all);
+  
+  ASSERT_THROW(
+    program.evaluate_bins( 5, 10, par_vals.data(), vals.data(), &scratch, 
+                           prds.data() ),
+    std::out_of_range
+  );
+}
+
+TEST(TestPrdProgram, SharedScalarCalls) {
+  // Identical calls in the scalar segment are only evaluated once
+  PrdProgram program {};
+  auto scalar_1 = program.add_call( 0, "par_prod", par_prod_fct, 
+                                    {program.add_const(2.0)}, {0,1} );
+  auto scalar_2 = program.add_call( 0, "par_prod", par_prod_fct, 
+                                    {program.add_const(2.0)}, {0,1} );
+  ASSERT_EQ( scalar_1.m_offset, scalar_2.m_offset );
+  ASSERT_EQ( program.get_n_scalars(), 1 );
+  
+  // Different coefficient values or parameters => different calls
+  auto scalar_3 = program.add_call( 0, "par_prod", par_prod_fct, 
+                                    {program.add_const(3.0)}, {0,1} );
+  auto scalar_4 = program.add_call( 0, "par_prod", par_prod_fct, 
+                                    {program.add_const(2.0)}, {1,0} );
+  ASSERT_NE( scalar_3.m_offset, scalar_1.m_offset );
+  ASSERT_NE( scalar_4.m_offset, scalar_1.m_offset );
+  ASSERT_EQ( program.get_n_scalars(), 3 );
+  
+  // Calls in other segments are not shared
+  size_t seg = program.add_segment({x_1});
+  auto coef = program.add_const(2.0);
+  auto col_1 = program.add_call(seg, "linear", linear_fct, {coef}, {0});
+  auto col_2 = program.add_call(seg, "linear", linear_fct, {coef}, {0});
+  ASSERT_NE( col_1.m_offset, col_2.m_offset );
+  program.add_bins(seg, program.add_sum(seg, {col_1, col_2, scalar_3}));
+  
+  std::vector<double> par_vals {1, 2};
+  PrdProgram::Workspace ws {};
+  std::vector<double> prds {};
+  program.evaluate(par_vals.data(), &ws, &prds);
+  ASSERT_EQ(prds, std::vector<double>({3 + 3 + 2}));
+}
+
+TEST(TestPrdProgram, InvalidInput) {
+  PrdProgram program {};
+  ASSERT_THROW(program.add_segment({}), std::invalid_argument);
+
+  size_t seg_1 = program.add_segment({x_1, x_2});
+  auto too_short = program.add_const(std::vector<double>{1});
+  ASSERT_THROW(
+    program.add_call(seg_1, "linear", linear_fct, {too_short}, {0}),
+    std::out_of_range
+  );
+  auto coef = program.add_const(std::vector<double>{1, 2});
+  auto lin_1 = program.add_call(seg_1, "linear", linear_fct, {coef}, {0});
+  ASSERT_THROW(program.add_sum(seg_1, {}), std::invalid_argument);
+  ASSERT_THROW(program.add_prod(seg_1, {}), std::invalid_argument);
+
+  // Columns can't be used in other segments, old segments can't be extended
+  size_t seg_2 = program.add_segment({x_1, x_2});
+  ASSERT_THROW(program.add_sum(seg_2, {lin_1}), std::invalid_argument);
+  ASSERT_THROW(program.add_sum(seg_1, {lin_1}), std::invalid_argument);
+  ASSERT_THROW(program.add_sum(5, {lin_1}), std::out_of_range);
+  
+  // Bins only once per non-scalar segment
+  auto lin_2 = program.add_call(seg_2, "linear", linear_fct, {coef}, {0});
+  program.add_bins(seg_2, lin_2);
+  ASSERT_THROW(program.add_bins(seg_2, lin_2), std::invalid_argument);
+  auto scalar = program.add_call(0, "par_prod", par_prod_fct, {}, {0,0});
+  ASSERT_THROW(program.add_bins(0, scalar), std::invalid_argument);
+}
+
+//------------------------------------------------------------------------------
+
+TEST(TestPrdProgram, SharedSegments) {
+  // Columns of a shared segment are evaluated once (with the scalars) and can
+  // be used in all later segments with the same number of rows
+  // Program: shared = c*x + p0, pred = shared * p1*p3 and shared * p2*p3
+  PrdProgram program {};
+  auto coef = program.add_const(std::vector<double>{1, 2, 3});
+  size_t shared_seg = program.add_shared_segment({x_1, x_2, x_3});
+  auto shared = program.add_call( shared_seg, "linear", linear_fct, {coef}, 
+                                  {0}, linear_grad );
+  ASSERT_THROW(program.add_bins(shared_seg, shared), std::invalid_argument);
+  for (size_t i_par: {1, 2}) {
+    size_t seg = program.add_segment({x_1, x_2, x_3});
+    auto scalar = program.add_call( 0, "par_prod", par_prod_fct, {}, 
+                                    {i_par, 3}, par_prod_grad );
+    program.add_bins(seg, program.add_prod(seg, {shared, scalar}));
+  }
+  ASSERT_EQ(program.get_n_bins(), 6);
+  ASSERT_EQ(program.get_n_scalars(), 2);
+  ASSERT_EQ(program.get_n_scalar_adjs(), 2 + 3);
+  
+  std::vector<double> par_vals {1, 2, 3, 0.5};
+  PrdProgram::Workspace ws {};
+  std::vector<double> prds_all {};
+  program.evaluate(par_vals.data(), &ws, &prds_all);
+  ASSERT_EQ(prds_all, std::vector<double>({2, 5, 10, 3, 7.5, 15}));
+  
+  // Bins can still be evaluated in parts after the shared columns
+  std::vector<double> vals (program.get_n_vals());
+  PrdProgram::Scratch scratch {};
+  program.evaluate_scalars(par_vals.data(), vals.data(), &scratch);
+  std::vector<double> prds (6);
+  for (size_t bin_begin: {0, 2, 4}) {
+    program.evaluate_bins( bin_begin, bin_begin + 2, par_vals.data(), 
+                           vals.data(), &scratch, prds.data() + bin_begin );
+  }
+  ASSERT_EQ(prds, prds_all);
+  
+  // Gradient through shared columns matches numerical derivative
+  // (polynomial of degree 1 in each parameter => exact up to rounding)
+  std::vector<double> weights {1, -2, 0.5, 3, 0, -1};
+  std::vector<double> grad (4, 0.0);
+  program.gradient(par_vals.data(), weights, &ws, &grad);
+  for (size_t p=0; p<par_vals.size(); p++) {
+    double h = 0.5, sum_up = 0, sum_down = 0;
+    par_vals[p] += h;
+    program.evaluate(par_vals.data(), &ws, &prds);
+    for (size_t i=0; i<prds.size(); i++) { sum_up += weights[i] * prds[i]; }
+    par_vals[p] -= 2*h;
+    program.evaluate(par_vals.data(), &ws, &prds);
+    for (size_t i=0; i<prds.size(); i++) { sum_down += weights[i] * prds[i]; }
+    par_vals[p] += h;
+    ASSERT_NEAR(grad[p], (sum_up - sum_down) / (2*h), 1e-9) << "Parameter " << p;
+  }
+  
+  // Shared columns need the same number of rows and can't be scalars
+  size_t other_seg = program.add_segment({x_1, x_2});
+  ASSERT_THROW(program.add_sum(other_seg, {shared}), std::invalid_argument);
+  ASSERT_THROW(program.add_sum(0, {shared}), std::invalid_argument);
+}
+
+//------------------------------------------------------------------------------
+
+TEST(TestPrdProgram, Gradient) {
+  // Gradient of weighted prediction sum matches numerical derivative
+  // Program: pred = sigma * (c*x + p0) * p1*p2 + p1*p2 (twice as many bins)
+  PrdProgram program {};
+  auto scalar = 
+    program.add_call(0, "par_prod", par_prod_fct, {}, {1,2}, par_prod_grad);
+  auto coef = program.add_const(std::vector<double>{1, 2, 3});
+  auto sigma = program.add_const(std::vector<double>{0.5, 1, 2});
+  for (int i_seg=0; i_seg<2; i_seg++) {
+    size_t seg = program.add_segment({x_1, x_2, x_3});
+    auto lin = 
+      program.add_call(seg, "linear", linear_fct, {coef}, {0}, linear_grad);
+    auto prod = program.add_prod(seg, {lin, scalar}, sigma);
+    program.add_bins(seg, program.add_sum(seg, {prod, scalar}));
+  }
+  ASSERT_TRUE(program.has_gradient());
+  
+  std::vector<double> par_vals {1, 2, 3};
+  std::vector<double> weights {1, -2, 0.5, 3, 0, -1};
+  PrdProgram::Workspace ws {};
+  std::vector<double> grad (3, 0.0);
+  program.gradient(par_vals.data(), weights, &ws, &grad);
+  
+  // Predictions are polynomials of degree 2 in each parameter 
+  // => central differences exact up to rounding
+  std::vector<double> prds {};
+  for (size_t p=0; p<par_vals.size(); p++) {
+    double h = 0.5, sum_up = 0, sum_down = 0;
+    par_vals[p] += h;
+    program.evaluate(par_vals.data(), &ws, &prds);
+    for (size_t i=0; i<prds.size(); i++) { sum_up += weights[i] * prds[i]; }
+    par_vals[p] -= 2*h;
+    program.evaluate(par_vals.data(), &ws, &prds);
+    for (size_t i=0; i<prds.size(); i++) { sum_down += weights[i] * prds[i]; }
+    par_vals[p] += h;
+    ASSERT_NEAR(grad[p], (sum_up - sum_down) / (2*h), 1e-9) << "Parameter " << p;
+  }
+  
+  // Without derivatives no gradient
+  PrdProgram no_grad_program {};
+  size_t seg = no_grad_program.add_segment({x_1});
+  auto lin = no_grad_program.add_call( seg, "linear", linear_fct, 
+                                       {no_grad_program.add_const(1.0)}, {0} );
+  no_grad_program.add_bins(seg, lin);
+  ASSERT_FALSE(no_grad_program.has_gradient());
+}
+
+//------------------------------------------------------------------------------
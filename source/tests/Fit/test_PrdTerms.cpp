@@ -0,0 +1,55 @@
+#include <Fit/PrdTerms.h>
+
+#include <gtest/gtest.h>
+
+#include <memory>
+#include <stdexcept>
+#include <vector>
+
+using namespace PrEW::Fit;
+
+//------------------------------------------------------------------------------
+// Tests for prediction terms shared between bound predictions
+
+TEST(TestPrdTerms, Groups) {
+  PrdTerms terms (2);
+  ASSERT_TRUE( terms.is_empty() );
+  ASSERT_EQ( terms.get_n_vals(), 2 );
+
+  // Terms are placed behind the parameter values
+  auto par_idxs_0 = std::make_shared<const std::vector<size_t>>(
+    std::vector<size_t>{0});
+  auto par_idxs_1 = std::make_shared<const std::vector<size_t>>(
+    std::vector<size_t>{0, 1});
+  size_t begin_0 = terms.add_group( 2, par_idxs_0,
+    [](const double * p, double * t) { t[0] = 2 * p[0]; t[1] = 3 * p[0]; } );
+  size_t begin_1 = terms.add_group( 1, par_idxs_1,
+    [](const double * p, double * t) { t[0] = p[0] + p[1]; } );
+  ASSERT_EQ( begin_0, 2 );
+  ASSERT_EQ( begin_1, 4 );
+  ASSERT_FALSE( terms.is_empty() );
+  ASSERT_EQ( terms.get_n_pars(), 2 );
+  ASSERT_EQ( terms.get_n_vals(), 5 );
+  ASSERT_EQ( terms.get_n_groups(), 2 );
+  ASSERT_EQ( terms.get_par_idxs(1), std::vector<size_t>({0, 1}) );
+
+  std::vector<double> par_vals {1.0, -3.0};
+  ASSERT_EQ( terms.get_vals(par_vals.data()),
+             std::vector<double>({1.0, -3.0, 2.0, 3.0, -2.0}) );
+
+  // Groups can be evaluated separately, copies are independent
+  PrdTerms copy = terms;
+  std::vector<double> vals {2.0, -3.0, 0.0, 0.0, 0.0};
+  copy.evaluate_group(1, vals.data());
+  ASSERT_EQ( vals, std::vector<double>({2.0, -3.0, 0.0, 0.0, -1.0}) );
+
+  // Groups need a function and may only depend on known parameters
+  ASSERT_THROW( terms.add_group(1, par_idxs_0, {}), std::invalid_argument );
+  auto unknown_idxs = std::make_shared<const std::vector<size_t>>(
+    std::vector<size_t>{2});
+  ASSERT_THROW(
+    terms.add_group(1, unknown_idxs, [](const double *, double *) {}),
+    std::out_of_range );
+}
+
+//------------------------------------------------------------------------------
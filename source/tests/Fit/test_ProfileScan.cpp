@@ -0,0 +1,164 @@
+#include <Connect/DataConnector.h>
+#include <Data/BinCoord.h>
+#include <Data/DistrInfo.h>
+#include <Data/PolLink.h>
+#include <Data/PredDistr.h>
+#include <Fit/ChiSqMinimizer.h>
+#include <Fit/ProfileScan.h>
+#include <GlobalVar/Chiral.h>
+
+#include "ParabolaFixture.h"
+
+#include <gtest/gtest.h>
+
+#include <stdexcept>
+#include <vector>
+
+using namespace PrEW::Fit;
+
+//------------------------------------------------------------------------------
+
+static const MinuitFactory factory (ROOT::Minuit2::kMigrad, 1000, 1000, 0.01);
+
+//------------------------------------------------------------------------------
+// Tests for profile scans of fit parameters
+
+TEST(TestProfileScan, Scan1D) {
+  auto container = ParabolaFixture::get_container(5);
+  ChiSqMinimizer minimizer (&container, factory);
+  minimizer.minimize();
+  auto best_fit = minimizer.get_result();
+  double c_fin = best_fit.m_pars_fin[0];
+  double c_unc = best_fit.m_uncs_fin[0];
+
+  std::vector<double> grid {};
+  for (int i=-3; i<=3; i++) { grid.push_back(c_fin + c_unc * double(i)); }
+  ProfileScan scan ( ParabolaFixture::get_container(5),
+                     ProfileScan::chisq_minimization(factory) );
+  scan.set_start(best_fit);
+  auto points = scan.scan("c", grid);
+  ASSERT_EQ( points.size(), grid.size() );
+
+  // Profile is a parabola with minimum at the best fit, +1 at 1 sigma
+  for (size_t i=0; i<points.size(); i++) {
+    double n_sigma = double(i) - 3.0;
+    ASSERT_EQ( points[i].m_scan_vals, std::vector<double>({grid[i]}) );
+    ASSERT_EQ( points[i].m_result.m_pars_fin[0], grid[i] );
+    EXPECT_NEAR( points[i].m_result.m_chisq_fin - best_fit.m_chisq_fin,
+                 n_sigma * n_sigma, 0.01 * (1.0 + n_sigma * n_sigma) );
+  }
+
+  // Same results for any number of threads
+  for (size_t n_threads: {2, 3}) {
+    ProfileScan scan_mt ( ParabolaFixture::get_container(5),
+                          ProfileScan::chisq_minimization(factory),
+                          n_threads );
+    ASSERT_EQ( scan_mt.get_n_threads(), n_threads );
+    scan_mt.set_start(best_fit);
+    auto points_mt = scan_mt.scan("c", grid);
+    for (size_t i=0; i<points.size(); i++) {
+      ASSERT_EQ( points_mt[i].m_result, points[i].m_result );
+    }
+  }
+}
+
+TEST(TestProfileScan, Scan2D) {
+  ProfileScan scan ( ParabolaFixture::get_container(5),
+                     ProfileScan::chisq_minimization(factory),
+                     4 );
+  std::vector<double> grid_a {2.4, 2.5, 2.6}, grid_b {-0.4, -0.3};
+  auto points = scan.scan("a", grid_a, "b", grid_b);
+  ASSERT_EQ( points.size(), 6 );
+
+  // Last parameter runs fastest, only c is free
+  for (size_t i_a=0; i_a<grid_a.size(); i_a++) {
+    for (size_t i_b=0; i_b<grid_b.size(); i_b++) {
+      const auto & point = points[i_a * grid_b.size() + i_b];
+      ASSERT_EQ( point.m_scan_vals,
+                 std::vector<double>({grid_a[i_a], grid_b[i_b]}) );
+      ASSERT_EQ( point.m_result.m_pars_fin[2], grid_a[i_a] );
+      ASSERT_EQ( point.m_result.m_pars_fin[1], grid_b[i_b] );
+      ASSERT_EQ( point.m_result.m_n_free_pars, 1 );
+    }
+  }
+
+  // Profile is smallest close to the true values
+  const auto & true_point = points[1 * grid_b.size() + 1];
+  for (const auto & point: points) {
+    ASSERT_GE( point.m_result.m_chisq_fin, true_point.m_result.m_chisq_fin );
+  }
+}
+
+TEST(TestProfileScan, BoundContainer) {
+  /** Scan of a container filled with bound predictions (with modified chiral
+      cross sections shared between the polarisation configurations) gives
+      the same results with several threads.
+  **/
+  using namespace PrEW::Data;
+  namespace Chiral = PrEW::GlobalVar::Chiral;
+  DistrInfo info_mp {"test", "e-p+", 500};
+  DistrInfo info_pm {"test", "e+p-", 500};
+  DistrInfo info_LR {"test", Chiral::eLpR, 500};
+  DistrInfo info_RL {"test", Chiral::eRpL, 500};
+  CoordVec coords = {{{0}, {-0.5}, {0.5}}, {{1}, {0.5}, {1.5}}};
+  DiffDistrVec distr_vec {
+    { info_mp, coords, {{0.8,0.2},{1,0.2}} },
+    { info_pm, coords, {{0.5,0.2},{0.7,0.2}} }
+  };
+  PredDistrVec pred_distrs {
+    { info_LR, coords, {1, 2}, {0.5, 0.1} },
+    { info_RL, coords, {3, 1}, {0, 0.2} },
+  };
+  ParVec pars {
+    {"A_LR", 1, 0.1},
+    {"mu", 0, 0.1, true},
+    {"sigma", 0.5, 0.1, true},
+    {"c", 0.1, 0.1},
+    {"ePol", 0.80, 0.01, true},
+    {"pPol", 0.30, 0.01, true}
+  };
+  PredLinkVec pred_links {
+    { info_LR, { {"Gaussian1D", {"A_LR", "mu", "sigma"}} }, {} },
+    { info_RL, {}, { {"Constant", {"c"}} } },
+    { info_pm, { {"Constant", {"c"}} }, {} }
+  };
+  PolLinkVec pol_links {
+    PolLink(500, "e-p+", "ePol", "pPol", "-", "+"),
+    PolLink(500, "e+p-", "ePol", "pPol", "+", "-")
+  };
+  PrEW::Connect::DataConnector connector {pred_distrs,{},pred_links,pol_links};
+  FitContainer container {};
+  connector.fill_fit_container( distr_vec, pars, &container );
+  ASSERT_FALSE( container.m_prd_terms.is_empty() );
+
+  std::vector<double> grid {0.8, 0.9, 1.0, 1.1, 1.2};
+  ProfileScan scan (container, ProfileScan::chisq_minimization(factory));
+  auto points = scan.scan("A_LR", grid);
+  ProfileScan scan_mt (container, ProfileScan::chisq_minimization(factory), 2);
+  auto points_mt = scan_mt.scan("A_LR", grid);
+  ASSERT_EQ( points_mt.size(), grid.size() );
+  for (size_t i=0; i<points.size(); i++) {
+    ASSERT_EQ( points[i].m_result.m_pars_fin[0], grid[i] );
+    ASSERT_EQ( points[i].m_result.m_n_free_pars, 1 );
+    ASSERT_EQ( points_mt[i].m_result, points[i].m_result ) << "Point " << i;
+  }
+}
+
+TEST(TestProfileScan, InvalidInput) {
+  auto container = ParabolaFixture::get_container(5);
+  auto fct = ProfileScan::chisq_minimization(factory);
+  ASSERT_THROW( ProfileScan(container, {}), std::invalid_argument );
+
+  ProfileScan scan (container, fct);
+  ASSERT_THROW( scan.scan("d", {1.0}), std::invalid_argument );
+  ASSERT_THROW( scan.scan("c", {}), std::invalid_argument );
+  ASSERT_THROW( scan.scan("c", {1.0}, "c", {2.0}), std::invalid_argument );
+
+  FitResult wrong_start {};
+  wrong_start.m_par_names = {"c", "b"};
+  wrong_start.m_pars_fin = {1.0, 2.0};
+  ASSERT_THROW( scan.set_start(wrong_start), std::invalid_argument );
+  ASSERT_NO_THROW( scan.set_start(FitResult()) );
+}
+
+//------------------------------------------------------------------------------
@@ -0,0 +1,128 @@
+#include <gtest/gtest.h>
+
+#include <Input/BinaryCache.h>
+
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <iterator>
+#include <stdexcept>
+#include <string>
+
+using namespace PrEW::Data;
+using namespace PrEW::Input;
+
+//------------------------------------------------------------------------------
+// Tests for BinaryCache class
+
+TEST(TestBinaryCache, RoundTrip) {
+  /** Check that predictions and coefficients written to a binary cache are
+      read back unchanged (views and copies).
+  **/
+  DistrInfo info_LR {"costheta", "LR", 250};
+  DistrInfo info_RL {"costheta", "RL", 250};
+  PredDistrVec preds {
+    { info_LR,
+      { {{-0.5, 0.1}, {-1.0, 0.0}, {0.0, 0.2}},
+        {{0.5, 0.1}, {0.0, 0.0}, {1.0, 0.2}} },
+      {10.5, 20.25}, {1.0, 2.0} },
+    { info_RL, {{{0.0}, {-1.0}, {1.0}}}, {3.0}, {0.5} }
+  };
+  CoefDistrVec coefs {
+    CoefDistr("Acceptance", info_LR, std::vector<double>{0.9, 0.8}),
+    CoefDistr("Lumi", info_RL, 2.5)
+  };
+
+  std::string file_path = "./test_BinaryCache_RoundTrip.bin";
+  BinaryCache::write(file_path, preds, coefs);
+  {
+    BinaryCache cache (file_path);
+    ASSERT_EQ( cache.get_n_preds(), 2 );
+    ASSERT_EQ( cache.get_n_coefs(), 2 );
+
+    // Views point into the file
+    const auto & pred_view = cache.get_pred(0);
+    ASSERT_EQ( pred_view.m_info, info_LR );
+    ASSERT_EQ( pred_view.m_n_bins, 2 );
+    ASSERT_EQ( pred_view.m_dim, 2 );
+    ASSERT_DOUBLE_EQ( pred_view.m_centers[2], 0.5 );
+    ASSERT_DOUBLE_EQ( pred_view.m_edges_up[1], 0.2 );
+    ASSERT_DOUBLE_EQ( pred_view.m_sig_distr[1], 20.25 );
+    ASSERT_TRUE( cache.get_coef(1).m_is_global );
+    ASSERT_EQ( cache.get_coef(1).m_coef_name.str(), "Lumi" );
+    ASSERT_DOUBLE_EQ( cache.get_coef(1).m_vals[0], 2.5 );
+
+    // Copies are identical to the original objects
+    ASSERT_EQ( cache.get_pred_distrs(), preds );
+    auto read_coefs = cache.get_coef_distrs();
+    ASSERT_EQ( read_coefs.size(), coefs.size() );
+    for (size_t i=0; i<coefs.size(); i++) {
+      ASSERT_EQ( read_coefs[i].get_coef_name(), coefs[i].get_coef_name() );
+      ASSERT_EQ( read_coefs[i].get_info(), coefs[i].get_info() );
+      ASSERT_EQ( read_coefs[i].is_global(), coefs[i].is_global() );
+      ASSERT_EQ( read_coefs[i].get_coefs(), coefs[i].get_coefs() );
+    }
+
+    ASSERT_THROW( cache.get_pred(2), std::out_of_range );
+    ASSERT_THROW( cache.get_coef(2), std::out_of_range );
+  }
+  std::remove(file_path.c_str());
+}
+
+//------------------------------------------------------------------------------
+
+TEST(TestBinaryCache, InvalidFiles) {
+  /** Check that missing files, files that are not binary caches and
+      inconsistent input are rejected.
+  **/
+  ASSERT_THROW( BinaryCache("./obviously_wrong_file_path.bin"),
+                std::invalid_argument );
+
+  std::string file_path = "./test_BinaryCache_InvalidFiles.bin";
+  {
+    std::ofstream file (file_path);
+    file << "This is not a binary cache, but it is long enough to have a "
+            "header that could be read.";
+  }
+  ASSERT_THROW( BinaryCache{file_path}, std::invalid_argument );
+
+  // Truncated cache and sizes that overflow when multiplied
+  PredDistrVec valid_preds { { {"costheta", "LR", 250},
+                               {{{0.0}, {-1.0}, {1.0}}}, {3.0}, {0.5} } };
+  BinaryCache::write(file_path, valid_preds, {});
+  std::string content {};
+  {
+    std::ifstream file (file_path, std::ios::binary);
+    content.assign( std::istreambuf_iterator<char>(file),
+                    std::istreambuf_iterator<char>() );
+  }
+  {
+    std::ofstream file (file_path, std::ios::binary | std::ios::trunc);
+    file.write(content.data(), std::streamsize(content.size() - 8));
+  }
+  ASSERT_THROW( BinaryCache{file_path}, std::invalid_argument );
+
+  std::uint64_t preds_offset {};
+  std::memcpy(&preds_offset, content.data() + 40, sizeof(preds_offset));
+  std::uint32_t dim = 4;
+  std::uint64_t n_bins = std::uint64_t(1) << 62; // n_bins * dim wraps to 0
+  content.replace(preds_offset + 12, sizeof(dim),
+                  reinterpret_cast<const char*>(&dim), sizeof(dim));
+  content.replace(preds_offset + 16, sizeof(n_bins),
+                  reinterpret_cast<const char*>(&n_bins), sizeof(n_bins));
+  {
+    std::ofstream file (file_path, std::ios::binary | std::ios::trunc);
+    file.write(content.data(), std::streamsize(content.size()));
+  }
+  ASSERT_THROW( BinaryCache{file_path}, std::invalid_argument );
+
+  // Number of bins in coordinates and distributions differ
+  PredDistrVec preds { { {"costheta", "LR", 250}, {{{0.0}, {-1.0}, {1.0}}},
+                         {3.0, 4.0}, {0.5, 0.5} } };
+  ASSERT_THROW( BinaryCache::write(file_path, preds, {}),
+                std::invalid_argument );
+  std::remove(file_path.c_str());
+}
+
+//------------------------------------------------------------------------------
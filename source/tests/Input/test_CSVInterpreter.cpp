@@ -7,6 +7,7 @@
 #include <Input/CSVInterpreter.h>
 
 // Standard library
+#include <stdexcept>
 #include <string>
 
 using namespace PrEW::CppUtils;
@@ -40,3 +41,13 @@ TEST(TestCSVInterpreter, TestDataReading) {
 }
 
 //------------------------------------------------------------------------------
+
+TEST(TestCSVInterpreter, ThrowExceptionFaultyFiles) {
+  std::string non_existant{"./blablabla"};
+  std::string no_metadata{"../testdata/test_without_header.csv"};
+
+  ASSERT_THROW(CSVInterpreter{non_existant}, std::invalid_argument);
+  ASSERT_THROW(CSVInterpreter{no_metadata}, std::invalid_argument);
+}
+
+//------------------------------------------------------------------------------
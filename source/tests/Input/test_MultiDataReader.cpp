@@ -0,0 +1,104 @@
+#include <gtest/gtest.h>
+
+#include <Input/BinaryCache.h>
+#include <Input/DataReader.h>
+#include <Input/MultiDataReader.h>
+
+#include <cstdio>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+using namespace PrEW::Data;
+using namespace PrEW::Input;
+
+//------------------------------------------------------------------------------
+// Tests for MultiDataReader class
+
+static std::vector<std::string> write_test_files(size_t n_files) {
+  /** Write binary cache files with one prediction and coefficient each.
+  **/
+  std::vector<std::string> file_paths {};
+  for (size_t f=0; f<n_files; f++) {
+    std::string file_path = "./test_MultiDataReader_" + std::to_string(f) +
+                            ".multitest";
+    DistrInfo info {"distr_" + std::to_string(f), "LR", 250};
+    double val = double(f);
+    BinaryCache::write(
+      file_path,
+      {{info, {{{0.0}, {-1.0}, {1.0}}}, {val}, {val + 0.5}}},
+      {CoefDistr("Coef", info, val)}
+    );
+    file_paths.push_back(file_path);
+  }
+  return file_paths;
+}
+
+//------------------------------------------------------------------------------
+
+TEST(TestMultiDataReader, SameAsSequentialReading) {
+  /** Check that reading files in parallel gives the same (ordered) result as
+      reading them one after another.
+  **/
+  auto file_paths = write_test_files(10);
+  std::vector<InputInfo> infos {};
+  for (const auto & file_path: file_paths) {
+    infos.push_back({file_path, "Binary"});
+  }
+  std::vector<InputInfo*> info_ptrs {};
+  for (auto & info: infos) { info_ptrs.push_back(&info); }
+
+  PredDistrVec expected_preds {};
+  for (auto & info: infos) {
+    DataReader reader (&info);
+    reader.read_file();
+    expected_preds.insert( expected_preds.end(),
+                           reader.get_pred_distrs().begin(),
+                           reader.get_pred_distrs().end() );
+  }
+
+  for (size_t n_threads: {1, 3, 16}) {
+    MultiDataReader reader (info_ptrs, n_threads);
+    reader.read_files();
+    ASSERT_EQ( reader.get_pred_distrs(), expected_preds );
+    ASSERT_EQ( reader.get_coef_distrs().size(), file_paths.size() );
+    for (size_t f=0; f<file_paths.size(); f++) {
+      const auto & coef = reader.get_coef_distrs()[f];
+      ASSERT_EQ( coef.get_info(), expected_preds[f].m_info );
+      ASSERT_DOUBLE_EQ( coef.get_coef(0), double(f) );
+    }
+  }
+
+  // Directory input finds the files in the same (sorted) order
+  MultiDataReader dir_reader (".", "Binary", ".multitest", 4);
+  ASSERT_EQ( dir_reader.get_n_files(), file_paths.size() );
+  dir_reader.read_files();
+  ASSERT_EQ( dir_reader.get_pred_distrs().size(), file_paths.size() );
+
+  // Reading again replaces the previous results
+  dir_reader.read_files();
+  ASSERT_EQ( dir_reader.get_pred_distrs(), expected_preds );
+  ASSERT_EQ( dir_reader.get_coef_distrs().size(), file_paths.size() );
+
+  for (const auto & file_path: file_paths) { std::remove(file_path.c_str()); }
+}
+
+//------------------------------------------------------------------------------
+
+TEST(TestMultiDataReader, Exceptions) {
+  /** Check that missing files and reading errors are reported.
+  **/
+  InputInfo missing {"./obviously_wrong_file_path.csv", "CSV"};
+  ASSERT_THROW( MultiDataReader({&missing}), std::invalid_argument );
+
+  auto file_paths = write_test_files(2);
+  InputInfo good {file_paths[0], "Binary"};
+  InputInfo bad {file_paths[1], "cheese"};
+  MultiDataReader reader ({&good, &bad}, 2);
+  ASSERT_THROW( reader.read_files(), std::invalid_argument );
+  ASSERT_EQ( reader.get_pred_distrs().size(), 0 );
+
+  for (const auto & file_path: file_paths) { std::remove(file_path.c_str()); }
+}
+
+//------------------------------------------------------------------------------
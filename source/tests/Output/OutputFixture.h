@@ -0,0 +1,41 @@
+#ifndef TESTS_OUTPUTFIXTURE_H
+#define TESTS_OUTPUTFIXTURE_H 1
+
+#include <Connect/DataConnector.h>
+#include <Data/DistrInfo.h>
+#include <Data/PolLink.h>
+#include <Fit/FitResult.h>
+#include <GlobalVar/Chiral.h>
+
+//------------------------------------------------------------------------------
+// Setup and fit result written by the output tests
+
+namespace OutputFixture {
+
+  inline PrEW::Connect::DataConnector test_connector() {
+    PrEW::Data::DistrInfo info_LR {
+      "test", PrEW::GlobalVar::Chiral::eLpR, 250 };
+    return PrEW::Connect::DataConnector(
+      {{ info_LR, {{}}, {1}, {0} }},
+      {},
+      {{ info_LR, { {"Gaussian1D", {"A_LR", "mu", "sigma"}} }, {} }},
+      {PrEW::Data::PolLink(250, "e-p+", "ePol", "pPol", "-", "+")}
+    );
+  }
+
+  inline PrEW::Fit::FitResult test_result() {
+    PrEW::Fit::FitResult result {};
+    result.m_par_names = {"A", "B"};
+    result.m_pars_fin = {1.0, 2.0};
+    result.m_uncs_fin = {0.1, 0.2};
+    result.m_cov_matrix = {{0.01, 0.0}, {0.0, 0.04}};
+    result.m_cor_matrix = {{1.0, 0.0}, {0.0, 1.0}};
+    result.m_chisq_fin = 3.5;
+    return result;
+  }
+
+}
+
+//------------------------------------------------------------------------------
+
+#endif
@@ -0,0 +1,84 @@
+#include <Connect/DataConnector.h>
+#include <Output/BinaryPrinter.h>
+
+#include "OutputFixture.h"
+
+#include <gtest/gtest.h>
+
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <iterator>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+using namespace PrEW::Connect;
+using namespace PrEW::Fit;
+using namespace PrEW::Output;
+
+//------------------------------------------------------------------------------
+// Tests for the BinaryPrinter output class
+
+static std::vector<char> read_bytes(const std::string & file_path) {
+  std::ifstream file (file_path, std::ios::binary);
+  return std::vector<char>( std::istreambuf_iterator<char>(file),
+                            std::istreambuf_iterator<char>() );
+}
+
+//------------------------------------------------------------------------------
+
+TEST(TestBinaryPrinter, ExceptionOnInaccessibleFile) {
+  ASSERT_THROW(BinaryPrinter(""), std::invalid_argument);
+  ASSERT_THROW(BinaryPrinter("./test_BinaryPrinter.bin", "cheese"),
+               std::invalid_argument);
+}
+
+TEST(TestBinaryPrinter, FramesAreAppended) {
+  /** Check that each fit is written as a frame when it is added and that
+      appending to a file doesn't repeat the file header.
+  **/
+  std::string file_path = "./test_BinaryPrinter.bin";
+  DataConnector connector = OutputFixture::test_connector();
+  FitResult result = OutputFixture::test_result();
+
+  size_t header_size = 16, frame_header_size = 16;
+  size_t fit_size = frame_header_size + 52 + 12 * sizeof(double);
+  {
+    BinaryPrinter printer (file_path);
+    printer.new_setup(250, connector);
+    printer.flush();
+    size_t setup_size = read_bytes(file_path).size();
+    ASSERT_GT( setup_size, header_size );
+
+    printer.add_fits({result, result});
+    printer.flush();
+    ASSERT_EQ( printer.get_n_fits(), 2 );
+    size_t pars_size = frame_header_size + 4 + 2 * (8 + 1);
+    ASSERT_EQ( read_bytes(file_path).size(),
+               setup_size + pars_size + 2 * fit_size );
+  }
+  auto bytes = read_bytes(file_path);
+  ASSERT_EQ( std::memcmp(bytes.data(), "PrEWOUT", 8), 0 );
+
+  // Last fit frame ends with the correlation matrix
+  double last_val {};
+  std::memcpy(&last_val, bytes.data() + bytes.size() - sizeof(double),
+              sizeof(double));
+  ASSERT_DOUBLE_EQ( last_val, 1.0 );
+
+  {
+    BinaryPrinter printer (file_path, "append");
+    printer.new_setup(250, connector);
+  }
+  ASSERT_NE( std::memcmp(read_bytes(file_path).data() + bytes.size(),
+                         "PrEWOUT", 8), 0 );
+
+  // Inconsistent results are rejected
+  result.m_cov_matrix = {{0.01}, {0.0, 0.04}};
+  BinaryPrinter printer (file_path);
+  ASSERT_THROW( printer.add_fit(result), std::invalid_argument );
+  std::remove(file_path.c_str());
+}
+
+//------------------------------------------------------------------------------
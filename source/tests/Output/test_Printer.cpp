@@ -1,7 +1,20 @@
+#include <Connect/DataConnector.h>
 #include <Output/Printer.h>
 
+#include "OutputFixture.h"
+
 #include <gtest/gtest.h>
 
+#include <cstdio>
+#include <fstream>
+#include <stdexcept>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+using namespace PrEW::Connect;
+using namespace PrEW::Fit;
 using namespace PrEW::Output;
 
 //------------------------------------------------------------------------------
@@ -16,4 +29,101 @@ TEST(TestPrinter, TrivialConstructor) {
   ASSERT_STREQ(Printer("../build/Makefile").get_current_output().c_str(), "");
 }
 
-//------------------------------------------------------------------------------
\ No newline at end of file
+//------------------------------------------------------------------------------
+
+static std::string read_file(const std::string & file_path) {
+  std::ifstream file (file_path);
+  std::stringstream content {};
+  content << file.rdbuf();
+  return content.str();
+}
+
+//------------------------------------------------------------------------------
+
+TEST(TestPrinter, WriteModes) {
+  std::string file_path = "./test_Printer_WriteModes.out";
+  Printer printer (file_path);
+  printer.new_setup(250, OutputFixture::test_connector());
+  printer.add_fit(OutputFixture::test_result());
+  std::string output = printer.get_current_output();
+
+  printer.write("overwrite");
+  ASSERT_EQ( read_file(file_path), output );
+  printer.write("append");
+  ASSERT_EQ( read_file(file_path), output + output );
+  ASSERT_THROW( printer.write("append "), std::invalid_argument );
+  std::remove(file_path.c_str());
+}
+
+TEST(TestPrinter, StreamingMatchesInMemoryOutput) {
+  /** Check that streaming mode writes the same output as the in-memory mode
+      and that output is in the file after each flush.
+  **/
+  auto connector = OutputFixture::test_connector();
+  auto result = OutputFixture::test_result();
+
+  Printer memory_printer ("./test_Printer_Memory.out");
+  for (int setup=0; setup<2; setup++) {
+    memory_printer.new_setup(250, connector);
+    memory_printer.add_fits({result, result, result});
+  }
+  std::string expected = memory_printer.get_current_output();
+
+  std::string file_path = "./test_Printer_Streaming.out";
+  {
+    Printer printer (file_path);
+    printer.new_setup(250, connector); // Before streaming => written at start
+    printer.add_fit(result);
+    printer.stream("overwrite", 1);
+    printer.add_fits({result, result});
+    printer.flush();
+    std::string first_setup = read_file(file_path);
+    ASSERT_EQ( first_setup.find("[END F2]"), first_setup.size() - 9 );
+
+    printer.new_setup(250, connector);
+    printer.add_fits({result, result, result});
+  } // Closed when destroyed
+  ASSERT_EQ( read_file(file_path), expected );
+  std::remove(file_path.c_str());
+}
+
+TEST(TestPrinter, StreamingFromThreads) {
+  std::string file_path = "./test_Printer_Threads.out";
+  auto result = OutputFixture::test_result();
+  {
+    Printer printer (file_path);
+    printer.stream("overwrite", 256);
+    printer.new_setup(250, OutputFixture::test_connector());
+    std::vector<std::thread> threads {};
+    for (int t=0; t<4; t++) {
+      threads.emplace_back( [&printer, &result]() {
+        for (int fit=0; fit<25; fit++) { printer.add_fit(result); }
+      } );
+    }
+    for (auto & thread: threads) { thread.join(); }
+    printer.close();
+  }
+  std::string output = read_file(file_path);
+  for (int fit=0; fit<100; fit++) {
+    ASSERT_NE( output.find("[END F" + std::to_string(fit) + "]"),
+               std::string::npos ) << fit;
+  }
+  ASSERT_EQ( output.find("[F100]"), std::string::npos );
+  ASSERT_EQ( output.find("Parameters:"), output.rfind("Parameters:") );
+  std::remove(file_path.c_str());
+}
+
+TEST(TestPrinter, StreamingWriteFailure) {
+  /** Failed writes (here: device without space) are not lost silently.
+  **/
+  Printer printer ("/dev/full");
+  printer.stream("append", 1);
+  printer.new_setup(250, OutputFixture::test_connector());
+  printer.add_fit(OutputFixture::test_result());
+  ASSERT_THROW( printer.flush(), std::runtime_error );
+  ASSERT_THROW( printer.add_fit(OutputFixture::test_result()), std::runtime_error );
+  ASSERT_THROW( printer.close(), std::runtime_error );
+  ASSERT_NO_THROW( printer.close() );
+}
+
+//------------------------------------------------------------------------------
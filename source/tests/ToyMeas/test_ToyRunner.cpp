@@ -0,0 +1,169 @@
+#include <Connect/DataConnector.h>
+#include <Data/CoefDistr.h>
+#include <Data/PredDistr.h>
+#include <Data/PredLink.h>
+#include <Data/PolLink.h>
+#include <Fit/FitPar.h>
+#include <Fit/MinuitFactory.h>
+#include <GlobalVar/Chiral.h>
+#include <ToyMeas/ToyGen.h>
+#include <ToyMeas/ToyRunner.h>
+
+#include <gtest/gtest.h>
+
+#include <cmath>
+#include <vector>
+
+using namespace PrEW::Connect;
+using namespace PrEW::Data;
+using namespace PrEW::Fit;
+using namespace PrEW::GlobalVar;
+using namespace PrEW::ToyMeas;
+
+//------------------------------------------------------------------------------
+// Simple setup to run toys with: Normalisation of a flat distribution plus
+// constrained polarisations
+
+static DataConnector get_connector() {
+  DistrInfo info_pol {"test", "e-p+", 500};
+  DistrInfo info_LR {"test", Chiral::eLpR, 500};
+  DistrInfo info_RL {"test", Chiral::eRpL, 500};
+  CoordVec coords {};
+  std::vector<double> sig_LR {}, sig_RL {}, zeros {};
+  for (int bin=0; bin<10; bin++) {
+    coords.push_back( BinCoord({double(bin)}, {bin-0.5}, {bin+0.5}) );
+    sig_LR.push_back(400.0 + 20.0 * bin);
+    sig_RL.push_back(300.0 - 10.0 * bin);
+    zeros.push_back(0);
+  }
+  PredDistrVec pred_distrs {
+    { info_LR, coords, sig_LR, zeros },
+    { info_RL, coords, sig_RL, zeros }
+  };
+  PredLinkVec pred_links {
+    { info_LR, { {"Constant", {"A_LR"}} }, {} },
+    { info_RL, { {"Constant", {"A_RL"}} }, {} },
+    { info_pol, {}, {} }
+  };
+  PolLinkVec pol_links { PolLink(500, "e-p+", "ePol", "pPol", "-", "+") };
+  return DataConnector {pred_distrs, {}, pred_links, pol_links};
+}
+
+static ParVec get_pars() {
+  ParVec pars {
+    {"A_LR", 1, 0.1},
+    {"A_RL", 1, 0.1},
+    {"ePol", 0.80, 0.01},
+    {"pPol", 0.30, 0.01}
+  };
+  pars[2].set_constrgauss(0.80, 0.01);
+  pars[3].set_constrgauss(0.30, 0.01);
+  return pars;
+}
+
+static const MinuitFactory factory (ROOT::Minuit2::kMigrad, 1000, 1000, 0.01);
+
+//------------------------------------------------------------------------------
+// Tests for running batches of toy fits
+
+TEST(TestToyRunner, ResultsIndependentOfThreads) {
+  auto connector = get_connector();
+  auto pars = get_pars();
+  ToyGen toy_gen (connector, pars);
+
+  ToyRunner runner (toy_gen, connector, pars, 500,
+                    ToyRunner::chisq_minimization(factory), 1, 42);
+  auto results = runner.run(6);
+  ASSERT_EQ( results.size(), 6 );
+  ASSERT_EQ( runner.get_n_toys_done(), 6 );
+
+  // Toys are different, fits find the (well determined) LR normalisation
+  ASSERT_NE( results[0], results[1] );
+  for (const auto & result: results) {
+    ASSERT_EQ( result.m_pars_fin.size(), 4 );
+    EXPECT_NEAR( result.m_pars_fin[0], 1.0, 0.1 );
+  }
+
+  // Same results (in same order) for any number of threads
+  for (size_t n_threads: {2, 4}) {
+    ToyRunner runner_mt (toy_gen, connector, pars, 500,
+                         ToyRunner::chisq_minimization(factory), n_threads, 42);
+    ASSERT_EQ( runner_mt.get_n_threads(), n_threads );
+    ASSERT_EQ( runner_mt.run(6), results );
+  }
+
+  // Different seed => different toys
+  ToyRunner other_runner (toy_gen, connector, pars, 500,
+                          ToyRunner::chisq_minimization(factory), 1, 43);
+  ASSERT_NE( other_runner.run(1)[0], results[0] );
+}
+
+TEST(TestToyRunner, StreamingAndBatches) {
+  auto connector = get_connector();
+  auto pars = get_pars();
+  ToyGen toy_gen (connector, pars);
+
+  ToyRunner runner (toy_gen, connector, pars, 500,
+                    ToyRunner::nll_minimization(factory), 3, 1);
+  runner.set_compile_prds(true);
+  auto all_results = runner.run(5);
+
+  // Results are streamed in toy order, batches continue the toy indices
+  ToyRunner batch_runner (toy_gen, connector, pars, 500,
+                          ToyRunner::nll_minimization(factory), 3, 1);
+  batch_runner.set_compile_prds(true);
+  std::vector<size_t> toys {};
+  ResultVec streamed_results {};
+  auto result_fct =
+    [&toys, &streamed_results](size_t toy, const FitResult & result) {
+      toys.push_back(toy);
+      streamed_results.push_back(result);
+    };
+  batch_runner.run(2, result_fct);
+  batch_runner.run(3, result_fct);
+  ASSERT_EQ( toys, std::vector<size_t>({0, 1, 2, 3, 4}) );
+  ASSERT_EQ( streamed_results, all_results );
+
+  // Without fluctuated constraints only the distributions differ
+  ToyRunner fixed_constr_runner (toy_gen, connector, pars, 500,
+                                 ToyRunner::nll_minimization(factory), 2, 1);
+  fixed_constr_runner.set_compile_prds(true);
+  fixed_constr_runner.set_fluctuate_constrs(false);
+  ASSERT_NE( fixed_constr_runner.run(5), all_results );
+}
+
+TEST(TestToyRunner, StartFromResult) {
+  // Toys started from a previous result find the same minima
+  auto connector = get_connector();
+  auto pars = get_pars();
+  ToyGen toy_gen (connector, pars);
+
+  ToyRunner runner (toy_gen, connector, pars, 500,
+                    ToyRunner::chisq_minimization(factory), 2, 7);
+  auto results = runner.run(4);
+  ToyRunner start_runner (toy_gen, connector, pars, 500,
+                          ToyRunner::chisq_minimization(factory, results[0]),
+                          2, 7);
+  auto start_results = start_runner.run(4);
+  for (size_t toy=0; toy<results.size(); toy++) {
+    for (size_t i_par=0; i_par<pars.size(); i_par++) {
+      EXPECT_NEAR( start_results[toy].m_pars_fin[i_par], 
+                   results[toy].m_pars_fin[i_par], 
+                   0.01 * results[toy].m_uncs_fin[i_par] );
+    }
+  }
+}
+
+TEST(TestToyRunner, InvalidInput) {
+  auto connector = get_connector();
+  auto pars = get_pars();
+  ToyGen toy_gen (connector, pars);
+  ASSERT_THROW(
+    (ToyRunner(toy_gen, connector, pars, 500, {})), std::invalid_argument );
+  ASSERT_THROW(
+    (ToyRunner(toy_gen, connector, pars, 500,
+               ToyRunner::chisq_minimization(factory), 0)),
+    std::invalid_argument );
+}
+
+//------------------------------------------------------------------------------